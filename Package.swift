@@ -9,8 +9,13 @@ let package = Package(
     products: [
         .library(name: "ModuleCore", targets: ["ModuleCore"]),
         .library(name: "MixerCore", targets: ["MixerCore"]),
+        .library(name: "PlayerCore", targets: ["PlayerCore"]),
         .executable(name: "mc_dump", targets: ["mc_dump"]),
         .executable(name: "vtx_render_bounded_xm", targets: ["vtx_render_bounded_xm"]),
+        .executable(name: "vtx_mixer_bench", targets: ["vtx_mixer_bench"]),
+        .executable(name: "vtx_mixer_diff", targets: ["vtx_mixer_diff"]),
+        .executable(name: "vtx_render", targets: ["vtx_render"]),
+        .executable(name: "vtx_audio_compare", targets: ["vtx_audio_compare"]),
     ],
     targets: [
         .target(
@@ -29,6 +34,15 @@ let package = Package(
                 .headerSearchPath("include")
             ]
         ),
+        .target(
+            name: "PlayerCore",
+            dependencies: ["ModuleCore", "MixerCore"],
+            path: "core/PlayerCore",
+            publicHeadersPath: "include",
+            cSettings: [
+                .headerSearchPath("include")
+            ]
+        ),
         .executableTarget(
             name: "mc_dump",
             dependencies: ["ModuleCore"],
@@ -39,6 +53,25 @@ let package = Package(
             dependencies: ["VoodooTrackerXPlaybackSupport"],
             path: "tools/vtx_render_bounded_xm"
         ),
+        .executableTarget(
+            name: "vtx_mixer_bench",
+            dependencies: ["MixerCore"],
+            path: "tools/vtx_mixer_bench"
+        ),
+        .executableTarget(
+            name: "vtx_mixer_diff",
+            dependencies: ["MixerCore"],
+            path: "tools/vtx_mixer_diff"
+        ),
+        .executableTarget(
+            name: "vtx_render",
+            dependencies: ["PlayerCore"],
+            path: "tools/vtx_render"
+        ),
+        .executableTarget(
+            name: "vtx_audio_compare",
+            path: "tools/vtx_audio_compare"
+        ),
         .target(
             name: "VoodooTrackerXPlaybackSupport",
             dependencies: ["ModuleCore", "MixerCore"],
@@ -73,7 +106,7 @@ let package = Package(
         ),
         .testTarget(
             name: "ModuleCoreTests",
-            dependencies: ["ModuleCore"],
+            dependencies: ["ModuleCore", "PlayerCore"],
             path: "tests",
             exclude: ["vtx_render_bounded_xm"],
             sources: ["core"],
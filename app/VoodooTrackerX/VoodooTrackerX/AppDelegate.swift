@@ -219,6 +219,7 @@ final class AppDelegate: NSObject, NSApplicationDelegate {
         panel.allowsMultipleSelection = false
         panel.allowedContentTypes = [.data]
         panel.message = "Choose a MOD or XM module file"
+        panel.delegate = self
 
         guard panel.runModal() == .OK, let url = panel.url else {
             return
@@ -990,3 +991,12 @@ final class AppDelegate: NSObject, NSApplicationDelegate {
     }
 
 }
+
+extension AppDelegate: NSOpenSavePanelDelegate {
+    func panel(_ sender: Any, shouldEnable url: URL) -> Bool {
+        if (try? url.resourceValues(forKeys: [.isDirectoryKey]).isDirectory) == true {
+            return true
+        }
+        return metadataLoader.isModuleFile(atPath: url.path)
+    }
+}
@@ -877,6 +877,18 @@ private struct RuntimeCMixerOutputMetrics: Equatable {
     )
 }
 
+private extension RuntimeCMixerOutputMetrics {
+    init(_ meter: VTXCMixerOutputMeter) {
+        self.init(
+            sampleCount: Int(clamping: meter.sample_count),
+            peak: meter.peak,
+            squareSum: meter.square_sum,
+            overrangeSampleCount: Int(clamping: meter.overrange_sample_count),
+            clippingSampleCount: Int(clamping: meter.clipping_sample_count)
+        )
+    }
+}
+
 struct RuntimeCMixerTriggerResult: Equatable {
     let succeeded: Bool
     let reason: String?
@@ -1161,6 +1173,7 @@ final class RuntimeCMixerRenderCore: @unchecked Sendable {
     private var lastOutputRMS = Float(0)
     private var overrangeSampleCount: UInt64 = 0
     private var clippingSampleCount: UInt64 = 0
+    private var callbackOutputMeter = VTXCMixerOutputMeter()
     private var adapterEventSchedule = [RuntimeCMixerQueuedAdapterEvent]()
     private var nextAdapterEventScheduleIndex = 0
     private var appliedAdapterEventDiagnostics = [RuntimeCMixerAppliedAdapterEventDiagnostic]()
@@ -1182,6 +1195,7 @@ final class RuntimeCMixerRenderCore: @unchecked Sendable {
         self.outputPolicy = outputPolicy
         self.maximumRenderFrames = max(1, maximumRenderFrames)
         mixer = CSoftwareMixer(config: config)
+        mixer.outputGain = outputPolicy.outputGain
         scratchInterleavedPCM = Array(repeating: 0, count: self.maximumRenderFrames * mixer.config.channelCount)
     }
 
@@ -2524,6 +2538,7 @@ final class RuntimeCMixerRenderCore: @unchecked Sendable {
         let callbackEndFrame = callbackStartFrame.addingReportingOverflow(UInt64(safeFrameCount)).overflow
             ? UInt64.max
             : callbackStartFrame + UInt64(safeFrameCount)
+        callbackOutputMeter = VTXCMixerOutputMeter()
         renderCallbackWithScheduledAdapterEventsLocked(
             into: outputInterleavedPCM,
             frameCount: safeFrameCount,
@@ -2531,8 +2546,6 @@ final class RuntimeCMixerRenderCore: @unchecked Sendable {
             callbackEndFrame: callbackEndFrame,
             callbackIndex: renderCallbackCount &+ 1
         )
-        let sampleCount = safeFrameCount * mixer.config.channelCount
-        applyOutputGain(outputInterleavedPCM, sampleCount: sampleCount)
         recordRenderCompletionLocked(
             requestedFrameCount: safeFrameCount,
             renderedFrameCount: safeFrameCount,
@@ -2542,7 +2555,7 @@ final class RuntimeCMixerRenderCore: @unchecked Sendable {
             zeroFilled: false,
             activeVoiceCountBefore: activeVoiceCountBefore,
             loadedVoiceCountBefore: loadedVoiceCountBefore,
-            outputMetrics: outputMetrics(outputInterleavedPCM, sampleCount: sampleCount)
+            outputMetrics: RuntimeCMixerOutputMetrics(callbackOutputMeter)
         )
         return true
     }
@@ -2617,13 +2630,20 @@ final class RuntimeCMixerRenderCore: @unchecked Sendable {
               sampleOffset + sampleCount <= outputInterleavedPCM.count else {
             return
         }
-        _ = mixer.render(
+        let renderedFrameCount = mixer.render(
             into: UnsafeMutableBufferPointer(
                 start: baseAddress.advanced(by: sampleOffset),
                 count: sampleCount
             ),
             frames: safeFrameCount
         )
+        // The last-render meter only describes this subrange when the render wrote all of it.
+        guard renderedFrameCount == safeFrameCount else {
+            return
+        }
+        // The C core applied the output gain and metered this subrange while writing it.
+        var subrangeMeter = mixer.lastRenderOutputMeter
+        vtx_c_mixer_output_meter_merge(&callbackOutputMeter, &subrangeMeter)
     }
 
     private func applyQueuedAdapterEventLocked(
@@ -2927,53 +2947,6 @@ final class RuntimeCMixerRenderCore: @unchecked Sendable {
         }
     }
 
-    private func outputMetrics(
-        _ outputInterleavedPCM: UnsafeMutableBufferPointer<Float>,
-        sampleCount: Int
-    ) -> RuntimeCMixerOutputMetrics {
-        let boundedSampleCount = min(max(0, sampleCount), outputInterleavedPCM.count)
-        guard boundedSampleCount > 0 else {
-            return .silence
-        }
-        var peak = Float(0)
-        var squareSum = Double(0)
-        var overrangeCount = 0
-        var clippingCount = 0
-        for index in 0..<boundedSampleCount {
-            let sample = outputInterleavedPCM[index].isFinite ? outputInterleavedPCM[index] : 0
-            let absolute = abs(sample)
-            peak = max(peak, absolute)
-            squareSum += Double(sample) * Double(sample)
-            if absolute > 1 {
-                overrangeCount += 1
-            }
-            if absolute >= 1 {
-                clippingCount += 1
-            }
-        }
-        return RuntimeCMixerOutputMetrics(
-            sampleCount: boundedSampleCount,
-            peak: peak,
-            squareSum: squareSum,
-            overrangeSampleCount: overrangeCount,
-            clippingSampleCount: clippingCount
-        )
-    }
-
-    private func applyOutputGain(
-        _ outputInterleavedPCM: UnsafeMutableBufferPointer<Float>,
-        sampleCount: Int
-    ) {
-        let gain = outputPolicy.outputGain
-        guard gain != 1 else {
-            return
-        }
-        let boundedSampleCount = min(max(0, sampleCount), outputInterleavedPCM.count)
-        for index in 0..<boundedSampleCount {
-            outputInterleavedPCM[index] *= gain
-        }
-    }
-
     private func runtimeGain(sample: PlaybackSample, volumeScale: Float) -> Float {
         PlaybackVolumeCalculator.finalAppliedVolume(sampleVolume: sample.volume, nodeVolumeScale: volumeScale)
     }
@@ -4,6 +4,9 @@ private let toolName = "vtx_render_bounded_xm"
 
 public enum BoundedXMRenderToolCLI {
     public static func main(argv: [String]) -> Int {
+        if argv.contains("--manifest") {
+            return batchMain(argv: argv)
+        }
         do {
             let arguments = try RenderToolArguments.parse(argv)
             let result = try RenderTool().run(arguments)
@@ -18,6 +21,24 @@ public enum BoundedXMRenderToolCLI {
             return 1
         }
     }
+
+    static func batchMain(argv: [String]) -> Int {
+        do {
+            let arguments = try BatchRenderToolArguments.parse(argv)
+            let tool = BatchRenderTool()
+            let jobs = try tool.loadManifest(fromPath: arguments.manifestPath)
+            let report = tool.run(jobs, workerCount: arguments.workerCount ?? ProcessInfo.processInfo.activeProcessorCount)
+            printBatchSummary(report)
+            return report.failedJobCount == 0 ? 0 : 1
+        } catch RenderToolError.helpRequested {
+            print(renderToolUsage())
+            return 0
+        } catch {
+            let message = (error as? LocalizedError)?.errorDescription ?? String(describing: error)
+            FileHandle.standardError.write(Data("\(toolName): \(message)\n\n\(renderToolUsage())\n".utf8))
+            return 1
+        }
+    }
 }
 
 enum RenderToolError: LocalizedError, Equatable {
@@ -35,6 +56,7 @@ enum RenderToolError: LocalizedError, Equatable {
     case invalidRenderLimit(String)
     case invalidWindowRows(String)
     case invalidExportGainPolicy(String)
+    case invalidManifest(String)
     case longRenderRequiresAllowLongRender(frames: Int, defaultLimit: Int)
 
     var errorDescription: String? {
@@ -60,7 +82,8 @@ enum RenderToolError: LocalizedError, Equatable {
              let .invalidOrderRange(message),
              let .invalidRenderLimit(message),
              let .invalidWindowRows(message),
-             let .invalidExportGainPolicy(message):
+             let .invalidExportGainPolicy(message),
+             let .invalidManifest(message):
             return message
         case let .longRenderRequiresAllowLongRender(frames, defaultLimit):
             return "Requested render cap \(frames) frames exceeds the default safety clamp \(defaultLimit) frames. Pass --allow-long-render intentionally for longer local renders."
@@ -499,15 +522,18 @@ struct RenderTool {
     let fileManager: FileManager
     let currentDirectory: URL
     let progressOutput: (String) -> Void
+    let songCache: PlaybackSongCache?
 
     init(
         fileManager: FileManager = .default,
         currentDirectory: URL = URL(fileURLWithPath: FileManager.default.currentDirectoryPath),
-        progressOutput: @escaping (String) -> Void = RenderTool.writeProgressToStandardError
+        progressOutput: @escaping (String) -> Void = RenderTool.writeProgressToStandardError,
+        songCache: PlaybackSongCache? = nil
     ) {
         self.fileManager = fileManager
         self.currentDirectory = currentDirectory
         self.progressOutput = progressOutput
+        self.songCache = songCache
     }
 
     func run(_ arguments: RenderToolArguments) throws -> PlaybackSongOfflineRenderResult {
@@ -522,10 +548,17 @@ struct RenderTool {
             try validateDiagnosticsOutput(diagnosticsURL)
         }
 
-        emitProgress("loading module", arguments: arguments)
-        let metadata = try ModuleMetadataLoader().load(fromPath: inputURL.path)
-        emitProgress("building playback song", arguments: arguments)
-        let song = try PlaybackSongBuilder.build(from: metadata, modulePath: inputURL.path)
+        let song: PlaybackSong
+        if let songCache {
+            emitProgress("loading module", arguments: arguments)
+            emitProgress("building playback song", arguments: arguments)
+            song = try songCache.song(forPath: inputURL.path)
+        } else {
+            emitProgress("loading module", arguments: arguments)
+            let metadata = try ModuleMetadataLoader().load(fromPath: inputURL.path)
+            emitProgress("building playback song", arguments: arguments)
+            song = try PlaybackSongBuilder.build(from: metadata, modulePath: inputURL.path)
+        }
         try validateOrderRange(start: arguments.order, count: arguments.orderCount, orderTotal: song.orders.count)
 
         let config = MixerRenderConfig(sampleRate: arguments.sampleRate, channelCount: MixerRenderConfig.defaultChannelCount)
@@ -975,6 +1008,300 @@ struct RenderTool {
     }
 }
 
+struct BatchRenderToolArguments: Equatable {
+    let manifestPath: String
+    let workerCount: Int?
+
+    static func parse(_ argv: [String]) throws -> BatchRenderToolArguments {
+        var manifestPath: String?
+        var workerCount: Int?
+        var seen = Set<String>()
+        var index = 0
+
+        while index < argv.count {
+            let argument = argv[index]
+            if argument == "--help" || argument == "-h" {
+                throw RenderToolError.helpRequested
+            }
+            guard argument == "--manifest" || argument == "--jobs" else {
+                throw RenderToolError.unknownArgument(argument)
+            }
+            let nextIndex = index + 1
+            guard nextIndex < argv.count, !argv[nextIndex].hasPrefix("--") else {
+                throw RenderToolError.missingValue(argument)
+            }
+            if !seen.insert(argument).inserted {
+                throw RenderToolError.duplicateArgument(argument)
+            }
+            let value = argv[nextIndex]
+            if argument == "--manifest" {
+                manifestPath = value
+            } else {
+                guard let parsed = Int(value), parsed > 0 else {
+                    throw RenderToolError.invalidInteger(name: argument, value: value)
+                }
+                workerCount = parsed
+            }
+            index = nextIndex + 1
+        }
+
+        guard let manifestPath else {
+            throw RenderToolError.missingRequiredArgument("--manifest")
+        }
+        return BatchRenderToolArguments(manifestPath: manifestPath, workerCount: workerCount)
+    }
+}
+
+/// Parsed modules shared read-only by the jobs of one batch. Each module is
+/// loaded and its samples decoded by the first job that asks for it; jobs for
+/// other modules load concurrently. A module is dropped once its last job has
+/// released it, so a long manifest holds only the modules still in use.
+final class PlaybackSongCache: @unchecked Sendable {
+    private final class Entry {
+        let lock = NSLock()
+        var result: Result<PlaybackSong, Error>?
+        var remainingUses: Int
+
+        init(remainingUses: Int) {
+            self.remainingUses = remainingUses
+        }
+    }
+
+    private let lock = NSLock()
+    private var entries = [String: Entry]()
+
+    init(inputPaths: [String]) {
+        for path in inputPaths.map(Self.key(forInputPath:)) {
+            if let entry = entries[path] {
+                entry.remainingUses += 1
+            } else {
+                entries[path] = Entry(remainingUses: 1)
+            }
+        }
+    }
+
+    static func key(forInputPath path: String) -> String {
+        URL(fileURLWithPath: path).standardizedFileURL.path
+    }
+
+    func song(forPath path: String) throws -> PlaybackSong {
+        let entry = self.entry(forKey: Self.key(forInputPath: path))
+        entry.lock.lock()
+        defer { entry.lock.unlock() }
+        if entry.result == nil {
+            entry.result = Result<PlaybackSong, Error>(catching: {
+                let metadata = try ModuleMetadataLoader().load(fromPath: path)
+                return try PlaybackSongBuilder.build(from: metadata, modulePath: path)
+            })
+        }
+        return try entry.result!.get()
+    }
+
+    func release(inputPath path: String) {
+        let key = Self.key(forInputPath: path)
+        lock.lock()
+        defer { lock.unlock() }
+        guard let entry = entries[key] else {
+            return
+        }
+        entry.remainingUses -= 1
+        if entry.remainingUses <= 0 {
+            entries[key] = nil
+        }
+    }
+
+    private func entry(forKey key: String) -> Entry {
+        lock.lock()
+        defer { lock.unlock() }
+        if let entry = entries[key] {
+            return entry
+        }
+        let entry = Entry(remainingUses: 1)
+        entries[key] = entry
+        return entry
+    }
+}
+
+struct BatchRenderJobOutcome {
+    let index: Int
+    let arguments: RenderToolArguments
+    let summary: String?
+    let errorMessage: String?
+}
+
+struct BatchRenderReport {
+    let outcomes: [BatchRenderJobOutcome]
+    let moduleCount: Int
+    let workerCount: Int
+
+    var failedJobCount: Int {
+        outcomes.filter { $0.errorMessage != nil }.count
+    }
+}
+
+/// Hands out job indices to the workers and collects their outcomes. Workers
+/// take the next unstarted job as soon as they finish one, so a long render
+/// never leaves short jobs waiting behind it on a busy thread.
+private final class BatchRenderJobBoard: @unchecked Sendable {
+    private let lock = NSLock()
+    private let jobCount: Int
+    private let progressOutput: (String) -> Void
+    private var nextIndex = 0
+    private var outcomes: [BatchRenderJobOutcome?]
+
+    init(jobCount: Int, progressOutput: @escaping (String) -> Void) {
+        self.jobCount = jobCount
+        self.progressOutput = progressOutput
+        outcomes = Array(repeating: nil, count: jobCount)
+    }
+
+    func takeNextJob() -> Int? {
+        lock.lock()
+        defer { lock.unlock() }
+        guard nextIndex < jobCount else {
+            return nil
+        }
+        nextIndex += 1
+        return nextIndex - 1
+    }
+
+    func record(_ outcome: BatchRenderJobOutcome, progressLines: [String]) {
+        lock.lock()
+        defer { lock.unlock() }
+        if !progressLines.isEmpty {
+            progressOutput("[\(toolName)] batch job \(outcome.index + 1) of \(jobCount)")
+            progressLines.forEach(progressOutput)
+        }
+        outcomes[outcome.index] = outcome
+    }
+
+    func collectedOutcomes() -> [BatchRenderJobOutcome] {
+        lock.lock()
+        defer { lock.unlock() }
+        return outcomes.compactMap { $0 }
+    }
+}
+
+/// Runs a manifest of single-render jobs in one process. Every job goes
+/// through RenderTool.run with the same arguments it would get on the command
+/// line, so WAVs, diagnostics JSON and summaries match separate runs.
+struct BatchRenderTool {
+    let fileManager: FileManager
+    let currentDirectory: URL
+    let progressOutput: (String) -> Void
+
+    init(
+        fileManager: FileManager = .default,
+        currentDirectory: URL = URL(fileURLWithPath: FileManager.default.currentDirectoryPath),
+        progressOutput: @escaping (String) -> Void = RenderTool.writeProgressToStandardError
+    ) {
+        self.fileManager = fileManager
+        self.currentDirectory = currentDirectory
+        self.progressOutput = progressOutput
+    }
+
+    /// The manifest is a JSON array with one entry per job; each entry is the
+    /// array of arguments a single run would take.
+    func loadManifest(fromPath path: String) throws -> [RenderToolArguments] {
+        let url = URL(fileURLWithPath: path).standardizedFileURL
+        guard let data = fileManager.contents(atPath: url.path) else {
+            throw RenderToolError.invalidManifest("Manifest does not exist or cannot be read: \(url.path)")
+        }
+        guard let entries = (try? JSONSerialization.jsonObject(with: data)) as? [Any] else {
+            throw RenderToolError.invalidManifest("Manifest must be a JSON array of argument arrays: \(url.path)")
+        }
+        guard !entries.isEmpty else {
+            throw RenderToolError.invalidManifest("Manifest contains no jobs: \(url.path)")
+        }
+
+        var jobs = [RenderToolArguments]()
+        var jobNumberByOutputPath = [String: Int]()
+        for (index, entry) in entries.enumerated() {
+            let jobNumber = index + 1
+            guard let argv = entry as? [String] else {
+                throw RenderToolError.invalidManifest("Manifest job \(jobNumber) must be an array of argument strings.")
+            }
+            let arguments: RenderToolArguments
+            do {
+                arguments = try RenderToolArguments.parse(argv)
+            } catch RenderToolError.helpRequested {
+                throw RenderToolError.invalidManifest("Manifest job \(jobNumber): --help is not a render argument.")
+            } catch {
+                let message = (error as? LocalizedError)?.errorDescription ?? String(describing: error)
+                throw RenderToolError.invalidManifest("Manifest job \(jobNumber): \(message)")
+            }
+            for outputPath in [arguments.outputPath] + (arguments.diagnosticsJSONPath.map { [$0] } ?? []) {
+                let standardizedPath = URL(fileURLWithPath: outputPath).standardizedFileURL.path
+                if let earlierJobNumber = jobNumberByOutputPath[standardizedPath] {
+                    throw RenderToolError.invalidManifest(
+                        "Manifest jobs \(earlierJobNumber) and \(jobNumber) both write \(standardizedPath)."
+                    )
+                }
+                jobNumberByOutputPath[standardizedPath] = jobNumber
+            }
+            jobs.append(arguments)
+        }
+        return jobs
+    }
+
+    func run(_ jobs: [RenderToolArguments], workerCount requestedWorkerCount: Int) -> BatchRenderReport {
+        let inputPaths = jobs.map(\.inputPath)
+        let songCache = PlaybackSongCache(inputPaths: inputPaths)
+        let board = BatchRenderJobBoard(jobCount: jobs.count, progressOutput: progressOutput)
+        let workerCount = max(1, min(requestedWorkerCount, jobs.count))
+
+        DispatchQueue.concurrentPerform(iterations: workerCount) { _ in
+            while let index = board.takeNextJob() {
+                var progressLines = [String]()
+                let outcome = runJob(
+                    index: index,
+                    arguments: jobs[index],
+                    songCache: songCache,
+                    progressOutput: { progressLines.append($0) }
+                )
+                board.record(outcome, progressLines: progressLines)
+            }
+        }
+
+        return BatchRenderReport(
+            outcomes: board.collectedOutcomes(),
+            moduleCount: Set(inputPaths.map(PlaybackSongCache.key(forInputPath:))).count,
+            workerCount: workerCount
+        )
+    }
+
+    private func runJob(
+        index: Int,
+        arguments: RenderToolArguments,
+        songCache: PlaybackSongCache,
+        progressOutput: @escaping (String) -> Void
+    ) -> BatchRenderJobOutcome {
+        defer { songCache.release(inputPath: arguments.inputPath) }
+        let tool = RenderTool(
+            fileManager: fileManager,
+            currentDirectory: currentDirectory,
+            progressOutput: progressOutput,
+            songCache: songCache
+        )
+        do {
+            let result = try tool.run(arguments)
+            return BatchRenderJobOutcome(
+                index: index,
+                arguments: arguments,
+                summary: renderToolSummary(arguments: arguments, result: result),
+                errorMessage: nil
+            )
+        } catch {
+            return BatchRenderJobOutcome(
+                index: index,
+                arguments: arguments,
+                summary: nil,
+                errorMessage: (error as? LocalizedError)?.errorDescription ?? String(describing: error)
+            )
+        }
+    }
+}
+
 enum PlaybackSongDiagnosticsJSONExporter {
     static func write(
         _ result: PlaybackSongOfflineRenderResult,
@@ -2706,6 +3033,13 @@ func renderToolUsage() -> String {
       --progress            Print render percentage and phase/status messages to stderr.
       --help                Show this help.
 
+    Batch mode:
+      \(toolName) --manifest /tmp/vtx-jobs.json [--jobs N]
+      --manifest PATH       JSON array of jobs; each job is the argument array of one single run.
+      --jobs N              Worker threads. Default: active processor count.
+    Each module is parsed and its samples decoded once, then shared read-only by its jobs.
+    Each job's WAV, diagnostics JSON and summary match a single run with the same arguments.
+
     Default safety clamp: \(PlaybackSongOfflineRenderRequest.defaultMaximumFrameCount) frames (60 seconds at 44100 Hz).
     --gain, --headroom-db, and --auto-headroom are mutually exclusive and do not change mixer math or runtime playback.
     --progress reports render percentage by rendered frames or row windows, then a coarse WAV-writing phase.
@@ -2934,3 +3268,22 @@ private func printSummary(
 ) {
     print(renderToolSummary(arguments: arguments, result: result))
 }
+
+func batchRenderSummaryLine(_ report: BatchRenderReport) -> String {
+    let failed = report.failedJobCount
+    return "Batch render: \(report.outcomes.count - failed) succeeded, \(failed) failed, \(report.outcomes.count) jobs over \(report.moduleCount) modules on \(report.workerCount) workers."
+}
+
+private func printBatchSummary(_ report: BatchRenderReport) {
+    for outcome in report.outcomes {
+        let label = "Batch job \(outcome.index + 1) of \(report.outcomes.count)"
+        if let summary = outcome.summary {
+            print("\(label):")
+            print(summary)
+            print("")
+        } else if let errorMessage = outcome.errorMessage {
+            FileHandle.standardError.write(Data("\(toolName): \(label) failed: \(errorMessage)\n".utf8))
+        }
+    }
+    print(batchRenderSummaryLine(report))
+}
@@ -138,6 +138,26 @@ final class CSoftwareMixer {
         vtx_c_mixer_current_frame(&state)
     }
 
+    /// Linear gain the C core applies to each rendered block in the pass that meters it.
+    var outputGain: Float {
+        get {
+            vtx_c_mixer_output_gain(&state)
+        }
+        set {
+            Self.requireOK(vtx_c_mixer_set_output_gain(&state, newValue))
+        }
+    }
+
+    /// Post-gain peak, square sum, overrange and clipping counts of the block written by the last render.
+    var lastRenderOutputMeter: VTXCMixerOutputMeter {
+        vtx_c_mixer_last_render_meter(&state)
+    }
+
+    /// Post-gain meters accumulated over every render since this mixer was created.
+    var cumulativeOutputMeter: VTXCMixerOutputMeter {
+        vtx_c_mixer_cumulative_output_meter(&state)
+    }
+
     init(config: MixerRenderConfig = MixerRenderConfig()) {
         self.config = config
         state = VTXCMixerState()
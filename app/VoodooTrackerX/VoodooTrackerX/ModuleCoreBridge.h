@@ -1,7 +1,15 @@
 #ifndef ModuleCoreBridge_h
 #define ModuleCoreBridge_h
 
+#include "module_handle.h"
 #include "module_types.h"
+#include "xm_instrument.h"
+#include "xm_sample.h"
+#include "xm_writer.h"
 #include "vtx_c_mixer.h"
+#include "vtx_c_sink.h"
+#include "vtx_c_trace.h"
+#include "vtx_c_player.h"
+#include "vtx_c_player_timeline.h"
 
 #endif
@@ -19,6 +19,18 @@ struct XMPatternEventCell: Equatable {
     )
 }
 
+extension XMPatternEventCell {
+    init(_ cell: mc_pattern_cell) {
+        self.init(
+            note: cell.note,
+            instrument: cell.instrument,
+            volumeColumn: cell.volume,
+            effectType: cell.effect_type,
+            effectParam: cell.effect_param
+        )
+    }
+}
+
 struct XMPatternData: Equatable {
     let index: Int
     let rowCount: Int
@@ -88,37 +100,46 @@ public struct ModuleMetadataLoader {
     }
 
     func load(fromPath path: String) throws -> ParsedModuleMetadata {
-        let info = mc_parse_file(path)
-        guard info.ok != 0 else {
-            throw ModuleMetadataLoaderError.parseFailed(Self.string(from: info.error))
+        var error = [CChar](repeating: 0, count: 128)
+        guard let module = mc_module_open(path, &error, error.count) else {
+            throw ModuleMetadataLoaderError.parseFailed(String(cString: error))
+        }
+        defer { mc_module_close(module) }
+        guard let header = mc_module_get_header(module)?.pointee else {
+            throw ModuleMetadataLoaderError.parseFailed("missing module header")
         }
 
-        let typeName = String(cString: mc_module_type_name(info.type))
+        let typeName = String(cString: mc_module_type_name(header.type))
         let version: String?
-        if info.type == MC_MODULE_TYPE_XM {
-            version = "\(info.version_major).\(info.version_minor)"
+        if header.type == MC_MODULE_TYPE_XM {
+            version = "\(header.version_major).\(header.version_minor)"
         } else {
             version = nil
         }
-        let orderTable = Self.parseOrderTable(from: info)
-        let xmPatterns = Self.parseXMPatterns(from: info, path: path)
+        let orderTable = Self.parseOrderTable(from: module, songLength: Int(header.song_length))
+        let xmPatterns = try Self.parseXMPatterns(from: module, header: header)
 
         return ParsedModuleMetadata(
             type: typeName,
-            title: Self.string(from: info.title),
+            title: Self.string(from: header.title),
             version: version,
-            channels: Int(info.channels),
-            patterns: Int(info.patterns),
-            instruments: Int(info.instruments),
-            xmFlags: Int(info.xm_flags),
-            defaultTempo: Int(info.default_tempo),
-            defaultBPM: Int(info.default_bpm),
-            songLength: Int(info.song_length),
+            channels: Int(header.channels),
+            patterns: Int(header.patterns),
+            instruments: Int(header.instruments),
+            xmFlags: Int(header.xm_flags),
+            defaultTempo: Int(header.default_tempo),
+            defaultBPM: Int(header.default_bpm),
+            songLength: Int(header.song_length),
             orderTable: orderTable,
             xmPatterns: xmPatterns
         )
     }
 
+    /// Header-only check for file pickers: reads about 1 KB instead of the whole module.
+    func isModuleFile(atPath path: String) -> Bool {
+        mc_probe_file(path).ok != 0
+    }
+
     static func formatXMCell(_ cell: XMPatternEventCell) -> String {
         let note = formatXMNote(cell.note)
         let instrument = cell.instrument == 0 ? ".." : String(format: "%02X", cell.instrument)
@@ -292,254 +313,53 @@ public struct ModuleMetadataLoader {
         }
     }
 
-    private static func parseXMPatterns(from info: mc_module_info, path: String) -> [XMPatternData] {
-        guard info.type == MC_MODULE_TYPE_XM else {
-            return []
-        }
-        if let decoded = parseXMPatternsFromFile(path: path, channels: Int(info.channels), patternCount: Int(info.patterns)) {
-            return decoded
-        }
-        return parseXMPatternsFromInfo(info)
-    }
-
-    private static func parseXMPatternsFromInfo(_ info: mc_module_info) -> [XMPatternData] {
-        guard info.type == MC_MODULE_TYPE_XM else {
+    private static func parseXMPatterns(from module: OpaquePointer, header: mc_module_header) throws -> [XMPatternData] {
+        guard header.type == MC_MODULE_TYPE_XM else {
             return []
         }
 
-        let channelCount = max(1, Int(info.channels))
-        let patternCount = Int(info.patterns)
-        guard patternCount > 0 else {
-            return []
-        }
-
-        let rowCounts: [UInt16] = withUnsafePointer(to: info.pattern_row_counts) {
-            $0.withMemoryRebound(to: UInt16.self, capacity: Int(MC_MAX_PATTERN_ROW_COUNTS)) {
-                Array(UnsafeBufferPointer(start: $0, count: Int(MC_MAX_PATTERN_ROW_COUNTS)))
-            }
-        }
-
-        var patterns = [XMPatternData]()
-        patterns.reserveCapacity(patternCount)
-
-        for patternIndex in 0..<patternCount {
-            let rowCount = patternIndex < Int(info.pattern_row_count_count) ? max(1, Int(rowCounts[patternIndex])) : 64
-            let rows = Array(
-                repeating: Array(repeating: XMPatternEventCell.empty, count: channelCount),
-                count: rowCount
-            )
-            patterns.append(
-                XMPatternData(
-                    index: patternIndex,
-                    rowCount: rowCount,
-                    channels: channelCount,
-                    rows: rows
-                )
-            )
-        }
-
-        let xmEvents: [mc_xm_event] = withUnsafePointer(to: info.xm_events) {
-            $0.withMemoryRebound(to: mc_xm_event.self, capacity: Int(MC_MAX_XM_EVENTS)) {
-                Array(UnsafeBufferPointer(start: $0, count: Int(MC_MAX_XM_EVENTS)))
-            }
-        }
-
-        for event in xmEvents.prefix(Int(info.xm_event_count)) {
-            let patternIndex = Int(event.pattern)
-            let rowIndex = Int(event.row)
-            let channelIndex = Int(event.channel)
-
-            guard patterns.indices.contains(patternIndex) else {
-                continue
-            }
-            guard rowIndex >= 0, rowIndex < patterns[patternIndex].rowCount else {
-                continue
-            }
-            guard channelIndex >= 0, channelIndex < patterns[patternIndex].channels else {
-                continue
-            }
-
-            patterns[patternIndex].rows[rowIndex][channelIndex] = XMPatternEventCell(
-                note: event.note,
-                instrument: event.instrument,
-                volumeColumn: event.volume,
-                effectType: event.effect_type,
-                effectParam: event.effect_param
-            )
-        }
-
-        return patterns
-    }
-
-    private static func parseXMPatternsFromFile(path: String, channels: Int, patternCount: Int) -> [XMPatternData]? {
-        guard patternCount > 0 else {
-            return []
-        }
-        guard let data = try? Data(contentsOf: URL(fileURLWithPath: path)),
-              data.count >= 80,
-              data.starts(with: Data("Extended Module: ".utf8)) else {
-            return nil
+        let stride = Int(header.channels)
+        let channelCount = max(1, stride)
+        // The editor wants every pattern, so decode them all up front across
+        // the CPUs; afterwards each load below is a cache hit.
+        var failedPattern: UInt16 = 0
+        guard mc_module_decode_patterns(module, 0, nil, &failedPattern) != 0 else {
+            throw ModuleMetadataLoaderError.parseFailed("invalid pattern data in pattern \(failedPattern)")
         }
-        let headerSize = Int(readLE32(data, offset: 60))
-        let totalHeader = 60 + headerSize
-        guard headerSize >= 20, totalHeader <= data.count else {
-            return nil
-        }
-
-        var patterns = [XMPatternData]()
-        patterns.reserveCapacity(patternCount)
-        var patternOffset = totalHeader
-        let channelCount = max(1, channels)
-
-        for patternIndex in 0..<patternCount {
-            guard patternOffset + 9 <= data.count else {
-                return nil
-            }
-            let patternHeaderLength = Int(readLE32(data, offset: patternOffset))
-            guard patternHeaderLength >= 9, patternOffset + patternHeaderLength <= data.count else {
-                return nil
+        return try (0..<Int(mc_module_pattern_count(module))).map { patternIndex in
+            var loaded: UnsafePointer<mc_pattern_cell>?
+            guard mc_module_load_pattern(module, UInt16(patternIndex), &loaded) != 0 else {
+                throw ModuleMetadataLoaderError.parseFailed("invalid pattern data in pattern \(patternIndex)")
             }
-            let rowCount = max(1, Int(readLE16(data, offset: patternOffset + 5)))
-            let packedSize = Int(readLE16(data, offset: patternOffset + 7))
-            let patternDataStart = patternOffset + patternHeaderLength
-            let patternDataEnd = patternDataStart + packedSize
-            guard patternDataEnd <= data.count else {
-                return nil
-            }
-
+            let storedRows = Int(mc_module_pattern_rows(module, UInt16(patternIndex)))
+            let rowCount = max(1, storedRows)
             var rows = Array(
                 repeating: Array(repeating: XMPatternEventCell.empty, count: channelCount),
                 count: rowCount
             )
-
-            if packedSize > 0 {
-                var eventOffset = 0
-                for row in 0..<rowCount {
-                    for channel in 0..<channelCount {
-                        guard let decoded = decodeXMPatternEvent(
-                            data: data,
-                            start: patternDataStart,
-                            length: packedSize,
-                            offset: eventOffset
-                        ) else {
-                            return nil
-                        }
-                        eventOffset = decoded.nextOffset
-                        rows[row][channel] = decoded.cell
+            if let cells = loaded {
+                for row in 0..<storedRows {
+                    for channel in 0..<stride {
+                        rows[row][channel] = XMPatternEventCell(cells[row * stride + channel])
                     }
                 }
             }
-
-            patterns.append(
-                XMPatternData(
-                    index: patternIndex,
-                    rowCount: rowCount,
-                    channels: channelCount,
-                    rows: rows
-                )
+            return XMPatternData(
+                index: patternIndex,
+                rowCount: rowCount,
+                channels: channelCount,
+                rows: rows
             )
-
-            patternOffset = patternDataEnd
-        }
-
-        return patterns
-    }
-
-    private static func decodeXMPatternEvent(
-        data: Data,
-        start: Int,
-        length: Int,
-        offset: Int
-    ) -> (cell: XMPatternEventCell, nextOffset: Int)? {
-        guard offset < length else { return nil }
-        let firstByte = data[start + offset]
-        var nextOffset = offset + 1
-        var note: UInt8 = 0
-        var instrument: UInt8 = 0
-        var volume: UInt8 = 0
-        var effectType: UInt8 = 0
-        var effectParam: UInt8 = 0
-
-        if (firstByte & 0x80) != 0 {
-            if (firstByte & 0x01) != 0 {
-                guard nextOffset < length else { return nil }
-                note = data[start + nextOffset]
-                nextOffset += 1
-            }
-            if (firstByte & 0x02) != 0 {
-                guard nextOffset < length else { return nil }
-                instrument = data[start + nextOffset]
-                nextOffset += 1
-            }
-            if (firstByte & 0x04) != 0 {
-                guard nextOffset < length else { return nil }
-                volume = data[start + nextOffset]
-                nextOffset += 1
-            }
-            if (firstByte & 0x08) != 0 {
-                guard nextOffset < length else { return nil }
-                effectType = data[start + nextOffset]
-                nextOffset += 1
-            }
-            if (firstByte & 0x10) != 0 {
-                guard nextOffset < length else { return nil }
-                effectParam = data[start + nextOffset]
-                nextOffset += 1
-            }
-        } else {
-            guard nextOffset + 4 <= length else { return nil }
-            note = firstByte
-            instrument = data[start + nextOffset]
-            nextOffset += 1
-            volume = data[start + nextOffset]
-            nextOffset += 1
-            effectType = data[start + nextOffset]
-            nextOffset += 1
-            effectParam = data[start + nextOffset]
-            nextOffset += 1
         }
-
-        return (
-            XMPatternEventCell(
-                note: note,
-                instrument: instrument,
-                volumeColumn: volume,
-                effectType: effectType,
-                effectParam: effectParam
-            ),
-            nextOffset
-        )
-    }
-
-    private static func readLE16(_ data: Data, offset: Int) -> UInt16 {
-        UInt16(data[offset]) | (UInt16(data[offset + 1]) << 8)
-    }
-
-    private static func readLE32(_ data: Data, offset: Int) -> UInt32 {
-        UInt32(data[offset]) |
-            (UInt32(data[offset + 1]) << 8) |
-            (UInt32(data[offset + 2]) << 16) |
-            (UInt32(data[offset + 3]) << 24)
     }
 
-    private static func parseOrderTable(from info: mc_module_info) -> [Int] {
-        let count = Int(info.order_table_length)
-        guard count > 0 else {
+    private static func parseOrderTable(from module: OpaquePointer, songLength: Int) -> [Int] {
+        var count: UInt16 = 0
+        guard let orders = mc_module_order_table(module, &count), count > 0 else {
             return []
         }
-        let songLength = Int(info.song_length)
-        let effectiveCount: Int
-        if songLength > 0 {
-            effectiveCount = min(count, songLength)
-        } else {
-            effectiveCount = count
-        }
-        let values: [UInt8] = withUnsafePointer(to: info.order_table) {
-            $0.withMemoryRebound(to: UInt8.self, capacity: Int(MC_MAX_ORDER_ENTRIES)) {
-                Array(UnsafeBufferPointer(start: $0, count: Int(MC_MAX_ORDER_ENTRIES)))
-            }
-        }
-        return values.prefix(effectiveCount).map(Int.init)
+        let effectiveCount = songLength > 0 ? min(Int(count), songLength) : Int(count)
+        return UnsafeBufferPointer(start: orders, count: effectiveCount).map(Int.init)
     }
 
     private static func centered(_ value: String, width: Int) -> String {
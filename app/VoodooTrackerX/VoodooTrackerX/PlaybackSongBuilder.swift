@@ -1,4 +1,7 @@
 import Foundation
+#if canImport(ModuleCore)
+import ModuleCore
+#endif
 
 enum PlaybackSongBuilderError: LocalizedError, Equatable {
     case unsupportedModuleType(String)
@@ -81,84 +84,30 @@ enum PlaybackSongBuilder {
 
     private static func loadXMSampleInstruments(fromPath path: String, metadata: ParsedModuleMetadata) -> [Int: PlaybackInstrument] {
         guard metadata.type == "XM",
-              let data = try? Data(contentsOf: URL(fileURLWithPath: path)),
-              data.count >= 80,
-              data.starts(with: Data("Extended Module: ".utf8)) else {
+              let module = mc_module_open(path, nil, 0) else {
             return [:]
         }
-        let headerSize = Int(readLE32(data, offset: 60))
-        let totalHeader = 60 + headerSize
-        guard headerSize >= 20, totalHeader <= data.count else {
+        defer { mc_module_close(module) }
+        guard let table = mc_module_xm_instruments(module)?.pointee else {
             return [:]
         }
 
-        var offset = totalHeader
-        for _ in 0..<metadata.patterns {
-            guard offset + 9 <= data.count else {
-                return [:]
-            }
-            let patternHeaderLength = Int(readLE32(data, offset: offset))
-            let packedSize = Int(readLE16(data, offset: offset + 7))
-            guard patternHeaderLength >= 9,
-                  offset + patternHeaderLength + packedSize <= data.count else {
-                return [:]
-            }
-            offset += patternHeaderLength + packedSize
-        }
-
         var instruments = [Int: PlaybackInstrument]()
-        guard metadata.instruments > 0 else {
-            return instruments
-        }
-        for instrumentIndex in 1...metadata.instruments {
-            guard offset + 29 <= data.count else {
-                break
-            }
-            let instrumentHeaderSize = Int(readLE32(data, offset: offset))
-            let sampleCount = Int(readLE16(data, offset: offset + 27))
-            guard instrumentHeaderSize >= 29,
-                  offset + instrumentHeaderSize <= data.count else {
-                break
-            }
-            guard sampleCount > 0 else {
-                offset += instrumentHeaderSize
+        for instrumentOffset in 0..<Int(table.instrument_count) {
+            let instrument = table.instruments[instrumentOffset]
+            guard instrument.sample_count > 0 else {
                 continue
             }
-            guard offset + 33 <= data.count else {
-                break
-            }
-            let volumeEnvelope = readVolumeEnvelope(data, instrumentOffset: offset, instrumentHeaderSize: instrumentHeaderSize)
-            let sampleHeaderSize = max(40, Int(readLE32(data, offset: offset + 29)))
-            let sampleHeaderOffset = offset + instrumentHeaderSize
-            let sampleDataOffset = sampleHeaderOffset + (sampleHeaderSize * sampleCount)
-            guard sampleDataOffset <= data.count else {
-                break
-            }
-
-            let noteSampleMap = readNoteSampleMap(
-                data,
-                instrumentOffset: offset,
-                instrumentHeaderSize: instrumentHeaderSize
-            )
-            var sampleHeaders = [XMSampleHeader]()
-            sampleHeaders.reserveCapacity(sampleCount)
-            for sampleIndex in 0..<sampleCount {
-                let headerOffset = sampleHeaderOffset + (sampleIndex * sampleHeaderSize)
-                guard headerOffset + 40 <= data.count else {
-                    break
-                }
-                sampleHeaders.append(readSampleHeader(data, offset: headerOffset))
-            }
-
-            var dataOffset = sampleDataOffset
-            let samples = sampleHeaders.enumerated().compactMap { sampleIndex, header -> PlaybackSample? in
+            let instrumentIndex = instrumentOffset + 1
+            let samples = (0..<Int(instrument.sample_count)).compactMap { sampleIndex -> PlaybackSample? in
+                let tableIndex = Int(instrument.first_sample) + sampleIndex
+                let header = XMSampleHeader(table.samples[tableIndex].header)
+                var view = mc_xm_sample_view()
                 guard header.length > 0,
-                      dataOffset + header.length <= data.count else {
-                    dataOffset += max(0, header.length)
+                      mc_module_xm_sample_view(module, UInt32(tableIndex), &view) != 0 else {
                     return nil
                 }
-                let pcm = decodeSamplePCM(data, offset: dataOffset, header: header)
-                dataOffset += header.length
+                let pcm = decodeSamplePCM(view, header: header)
                 return PlaybackSample(
                     instrumentIndex: instrumentIndex,
                     sampleIndex: sampleIndex,
@@ -176,158 +125,81 @@ enum PlaybackSongBuilder {
             instruments[instrumentIndex] = PlaybackInstrument(
                 index: instrumentIndex,
                 samples: samples,
-                volumeEnvelope: volumeEnvelope,
-                noteSampleMap: noteSampleMap
+                volumeEnvelope: volumeEnvelope(from: instrument),
+                noteSampleMap: instrument.has_keymap != 0 ? noteSampleMap(from: instrument) : nil
             )
-            offset = dataOffset
         }
         return instruments
     }
 
-    private static func readNoteSampleMap(
-        _ data: Data,
-        instrumentOffset: Int,
-        instrumentHeaderSize: Int
-    ) -> [Int]? {
-        let mapOffset = instrumentOffset + 33
-        let mapLength = 96
-        guard instrumentHeaderSize >= 33 + mapLength,
-              mapOffset + mapLength <= instrumentOffset + instrumentHeaderSize,
-              mapOffset + mapLength <= data.count else {
-            return nil
+    private static func noteSampleMap(from instrument: mc_xm_instrument) -> [Int] {
+        withUnsafeBytes(of: instrument.keymap) { keymap in
+            keymap.map(Int.init)
         }
-        return data[mapOffset..<mapOffset + mapLength].map(Int.init)
     }
 
-    private static func readVolumeEnvelope(
-        _ data: Data,
-        instrumentOffset: Int,
-        instrumentHeaderSize: Int
-    ) -> PlaybackVolumeEnvelope {
-        let envelopePointOffset = instrumentOffset + 129
-        let minimumEnvelopeHeaderSize = 241
-        guard instrumentHeaderSize >= minimumEnvelopeHeaderSize,
-              instrumentOffset + minimumEnvelopeHeaderSize <= data.count,
-              instrumentOffset + instrumentHeaderSize <= data.count else {
+    private static func volumeEnvelope(from instrument: mc_xm_instrument) -> PlaybackVolumeEnvelope {
+        guard instrument.has_envelopes != 0 else {
             return .disabled
         }
-
-        let pointCount = min(12, Int(data[instrumentOffset + 225]))
-        var points = [PlaybackEnvelopePoint]()
-        points.reserveCapacity(pointCount)
-        for pointIndex in 0..<pointCount {
-            let pointOffset = envelopePointOffset + (pointIndex * 4)
-            guard pointOffset + 4 <= instrumentOffset + instrumentHeaderSize,
-                  pointOffset + 4 <= data.count else {
-                break
-            }
-            points.append(PlaybackEnvelopePoint(
-                tick: Int(readLE16(data, offset: pointOffset)),
-                value: Int(readLE16(data, offset: pointOffset + 2))
-            ))
+        let envelope = instrument.volume_envelope
+        let points = withUnsafeBytes(of: envelope.points) { raw in
+            raw.bindMemory(to: mc_xm_envelope_point.self)
+                .prefix(Int(envelope.point_count))
+                .map { PlaybackEnvelopePoint(tick: Int($0.tick), value: Int($0.value)) }
         }
-
-        let typeFlags = data[instrumentOffset + 233]
-        let sustainIndex = Int(data[instrumentOffset + 227])
-        let loopStartIndex = Int(data[instrumentOffset + 228])
-        let loopEndIndex = Int(data[instrumentOffset + 229])
-        let fadeout = Int(readLE16(data, offset: instrumentOffset + 239))
+        let sustainIndex = Int(envelope.sustain_point)
+        let loopStartIndex = Int(envelope.loop_start_point)
+        let loopEndIndex = Int(envelope.loop_end_point)
 
         return PlaybackVolumeEnvelope(
-            enabled: (typeFlags & 0x01) != 0 && !points.isEmpty,
+            enabled: (envelope.flags & UInt8(MC_XM_ENVELOPE_ON)) != 0 && !points.isEmpty,
             points: points,
             sustainPointIndex: points.indices.contains(sustainIndex) ? sustainIndex : nil,
             loopStartPointIndex: points.indices.contains(loopStartIndex) ? loopStartIndex : nil,
             loopEndPointIndex: points.indices.contains(loopEndIndex) && loopEndIndex >= loopStartIndex ? loopEndIndex : nil,
-            typeFlags: typeFlags,
-            fadeout: max(0, min(65_536, fadeout))
+            typeFlags: envelope.flags,
+            fadeout: max(0, min(65_536, Int(instrument.fadeout)))
         )
     }
 
+    /// Swift view of a ModuleCore `mc_xm_sample_header`; loop bounds come from
+    /// the C frame helpers so both layers agree on 16-bit length handling.
     private struct XMSampleHeader {
+        let cHeader: mc_xm_sample_header
         let length: Int
-        let loopStart: Int
-        let loopLength: Int
         let volume: UInt8
         let finetune: Int
-        let type: UInt8
         let relativeNote: Int
-
-        var is16Bit: Bool {
-            (type & 0x10) != 0
-        }
-
-        var loopType: Int {
-            Int(type & 0x03)
+        let loopType: Int
+        let safeLoopStartInSamples: Int
+        let safeLoopLengthInSamples: Int
+
+        init(_ header: mc_xm_sample_header) {
+            var header = header
+            cHeader = header
+            length = Int(header.length_bytes)
+            volume = header.volume
+            finetune = Int(header.finetune)
+            relativeNote = Int(header.relative_note)
+            loopType = Int(mc_xm_sample_loop_type(&header))
+            safeLoopStartInSamples = Int(mc_xm_sample_loop_start_frame(&header))
+            safeLoopLengthInSamples = Int(mc_xm_sample_loop_length_frames(&header))
         }
-
-        var bytesPerSample: Int {
-            is16Bit ? 2 : 1
-        }
-
-        var lengthInSamples: Int {
-            length / bytesPerSample
-        }
-
-        var safeLoopStartInSamples: Int {
-            min(max(0, loopStart / bytesPerSample), lengthInSamples)
-        }
-
-        var safeLoopLengthInSamples: Int {
-            guard loopType != 0 else {
-                return 0
-            }
-            let start = safeLoopStartInSamples
-            let requestedLength = max(0, loopLength / bytesPerSample)
-            return min(requestedLength, max(0, lengthInSamples - start))
-        }
-    }
-
-    private static func readSampleHeader(_ data: Data, offset: Int) -> XMSampleHeader {
-        XMSampleHeader(
-            length: Int(readLE32(data, offset: offset)),
-            loopStart: Int(readLE32(data, offset: offset + 4)),
-            loopLength: Int(readLE32(data, offset: offset + 8)),
-            volume: data[offset + 12],
-            finetune: Int(Int8(bitPattern: data[offset + 13])),
-            type: data[offset + 14],
-            relativeNote: Int(Int8(bitPattern: data[offset + 16]))
-        )
     }
 
-    private static func decodeSamplePCM(_ data: Data, offset: Int, header: XMSampleHeader) -> [Float] {
-        if header.is16Bit {
-            let sampleCount = header.length / 2
-            var pcm = [Float]()
-            pcm.reserveCapacity(sampleCount)
-            var accumulator = Int16(0)
-            for sampleIndex in 0..<sampleCount {
-                let delta = Int16(bitPattern: readLE16(data, offset: offset + (sampleIndex * 2)))
-                accumulator = accumulator &+ delta
-                pcm.append(max(-1, min(1, Float(accumulator) / 32768.0)))
-            }
-            return pcm
-        }
-
-        var pcm = [Float]()
-        pcm.reserveCapacity(header.length)
-        var accumulator = Int8(0)
-        for sampleIndex in 0..<header.length {
-            let delta = Int8(bitPattern: data[offset + sampleIndex])
-            accumulator = accumulator &+ delta
-            pcm.append(max(-1, min(1, Float(accumulator) / 128.0)))
+    private static func decodeSamplePCM(_ view: mc_xm_sample_view, header: XMSampleHeader) -> [Float] {
+        var cHeader = header.cHeader
+        let frameCount = Int(mc_xm_sample_frame_count(&cHeader))
+        return [Float](unsafeUninitializedCapacity: frameCount) { buffer, initializedCount in
+            let decoded = mc_xm_decode_sample_float(
+                &cHeader,
+                view.data,
+                view.length_bytes,
+                buffer.baseAddress,
+                frameCount
+            )
+            initializedCount = decoded != 0 ? frameCount : 0
         }
-        return pcm
-    }
-
-    private static func readLE16(_ data: Data, offset: Int) -> UInt16 {
-        UInt16(data[offset]) | (UInt16(data[offset + 1]) << 8)
-    }
-
-    private static func readLE32(_ data: Data, offset: Int) -> UInt32 {
-        UInt32(data[offset]) |
-            (UInt32(data[offset + 1]) << 8) |
-            (UInt32(data[offset + 2]) << 16) |
-            (UInt32(data[offset + 3]) << 24)
     }
 }
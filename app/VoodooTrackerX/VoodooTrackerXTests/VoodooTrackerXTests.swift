@@ -869,6 +869,424 @@ final class VoodooTrackerXTests: XCTestCase {
         )
     }
 
+    func testCMixerCoreCountsSampleAllocationsOnlyWhenVoicesAreAdded() {
+        var state = VTXCMixerState()
+        XCTAssertEqual(vtx_c_mixer_init(&state, vtx_c_mixer_default_config()), VTX_C_MIXER_STATUS_OK)
+        XCTAssertEqual(vtx_c_mixer_sample_allocation_count(&state), 0)
+
+        let sample: [Float] = [0.5, 0.25, 0, -0.25]
+        XCTAssertEqual(
+            sample.withUnsafeBufferPointer { buffer in
+                vtx_c_mixer_add_one_shot_sample(&state, buffer.baseAddress, UInt32(buffer.count), 1, 0, nil)
+            },
+            VTX_C_MIXER_STATUS_OK
+        )
+        XCTAssertEqual(vtx_c_mixer_sample_allocation_count(&state), 1)
+        XCTAssertEqual(vtx_c_mixer_sample_allocation_byte_count(&state), UInt64(sample.count * MemoryLayout<Float>.size))
+
+        var output = Array(repeating: Float(0), count: 16)
+        XCTAssertEqual(
+            output.withUnsafeMutableBufferPointer { buffer in
+                vtx_c_mixer_render(&state, buffer.baseAddress, 8)
+            },
+            VTX_C_MIXER_STATUS_OK
+        )
+        XCTAssertEqual(vtx_c_mixer_sample_allocation_count(&state), 1)
+        XCTAssertEqual(vtx_c_mixer_clear_voices(&state), VTX_C_MIXER_STATUS_OK)
+    }
+
+    func testCSinkStreamsPCM16WAVThroughBackgroundWriterAndPatchesHeader() throws {
+        let url = URL(fileURLWithPath: NSTemporaryDirectory(), isDirectory: true)
+            .appendingPathComponent("vtx_c_sink_\(UUID().uuidString).wav")
+        defer { try? FileManager.default.removeItem(at: url) }
+
+        var config = vtx_c_sink_default_config()
+        config.sample_rate = 48_000
+        config.buffer_frames = 3
+        config.background_writer = 1
+        var sink: OpaquePointer?
+        XCTAssertEqual(vtx_c_sink_open_path(url.path, config, &sink), VTX_C_SINK_STATUS_OK)
+
+        let floats: [Float] = [0, 0.5, -0.5, 1.5, -1.5, .nan, 0.25, -0.25, 0.999, -0.999]
+        let ints: [Int16] = [1, -1, Int16.max, Int16.min, 1234, -1234]
+        XCTAssertEqual(vtx_c_sink_write_float32(sink, floats, UInt32(floats.count / 2)), VTX_C_SINK_STATUS_OK)
+        XCTAssertEqual(vtx_c_sink_write_int16(sink, ints, UInt32(ints.count / 2)), VTX_C_SINK_STATUS_OK)
+        XCTAssertEqual(vtx_c_sink_frame_count(sink), 8)
+        XCTAssertEqual(vtx_c_sink_close(sink), VTX_C_SINK_STATUS_OK)
+
+        let wav = try parsePCM16WAV(try Data(contentsOf: url))
+        XCTAssertEqual(wav.sampleRate, 48_000)
+        XCTAssertEqual(wav.channelCount, 2)
+        XCTAssertEqual(wav.dataSize, 32)
+        XCTAssertEqual(wav.riffSize, 36 + 32)
+        XCTAssertEqual(wav.samples, floats.map { MixerWAVExporter.pcm16Sample(from: $0) } + ints)
+    }
+
+    func testCMixerCoreMetersGainedOutputPerRenderAndCumulatively() {
+        let sample: [Float] = (0..<64).map { index in
+            Float(sin(Double(index) * 0.4)) * 1.3
+        }
+        var state = VTXCMixerState()
+        XCTAssertEqual(vtx_c_mixer_init(&state, vtx_c_mixer_default_config()), VTX_C_MIXER_STATUS_OK)
+        XCTAssertEqual(vtx_c_mixer_output_gain(&state), 1)
+        XCTAssertEqual(vtx_c_mixer_set_output_gain(&state, -1), VTX_C_MIXER_STATUS_INVALID_ARGUMENT)
+        XCTAssertEqual(vtx_c_mixer_set_output_gain(&state, .nan), VTX_C_MIXER_STATUS_INVALID_ARGUMENT)
+
+        var voice: UInt32 = 0
+        sample.withUnsafeBufferPointer { buffer in
+            XCTAssertEqual(
+                vtx_c_mixer_add_sample_voice_with_step(
+                    &state, buffer.baseAddress, UInt32(buffer.count), 1, 1, 0,
+                    VTX_C_MIXER_LOOP_FORWARD, 0, 64, &voice
+                ),
+                VTX_C_MIXER_STATUS_OK
+            )
+        }
+
+        func renderBlock(gain: Float) -> [Float] {
+            XCTAssertEqual(vtx_c_mixer_set_output_gain(&state, gain), VTX_C_MIXER_STATUS_OK)
+            var output = Array(repeating: Float(0), count: 50 * 2)
+            XCTAssertEqual(
+                output.withUnsafeMutableBufferPointer { buffer in
+                    vtx_c_mixer_render(&state, buffer.baseAddress, 50)
+                },
+                VTX_C_MIXER_STATUS_OK
+            )
+            return output
+        }
+
+        let unity = renderBlock(gain: 1)
+        XCTAssertEqual(vtx_c_mixer_reset(&state), VTX_C_MIXER_STATUS_OK)
+        let halved = renderBlock(gain: 0.5)
+        XCTAssertEqual(halved.map(\.bitPattern), unity.map { ($0 * 0.5).bitPattern })
+
+        let halvedMeter = vtx_c_mixer_last_render_meter(&state)
+        XCTAssertEqual(halvedMeter.sample_count, 100)
+        XCTAssertEqual(halvedMeter.peak, halved.map(abs).max())
+        XCTAssertEqual(halvedMeter.square_sum, halved.reduce(0) { $0 + Double($1) * Double($1) }, accuracy: 1e-9)
+        XCTAssertEqual(halvedMeter.overrange_sample_count, 0)
+
+        let doubled = renderBlock(gain: 2)
+        let doubledMeter = vtx_c_mixer_last_render_meter(&state)
+        XCTAssertEqual(doubledMeter.overrange_sample_count, UInt64(doubled.filter { abs($0) > 1 }.count))
+        XCTAssertEqual(doubledMeter.clipping_sample_count, UInt64(doubled.filter { abs($0) >= 1 }.count))
+        XCTAssertGreaterThan(doubledMeter.overrange_sample_count, 0)
+
+        var cumulative = vtx_c_mixer_cumulative_output_meter(&state)
+        XCTAssertEqual(cumulative.sample_count, 300)
+        XCTAssertEqual(cumulative.peak, doubledMeter.peak)
+        XCTAssertEqual(cumulative.overrange_sample_count, doubledMeter.overrange_sample_count)
+        XCTAssertEqual(vtx_c_mixer_output_meter_rms(&cumulative), sqrt(cumulative.square_sum / 300), accuracy: 1e-12)
+
+        XCTAssertEqual(vtx_c_mixer_reset_output_meters(&state), VTX_C_MIXER_STATUS_OK)
+        cumulative = vtx_c_mixer_cumulative_output_meter(&state)
+        XCTAssertEqual(cumulative.sample_count, 0)
+        XCTAssertEqual(vtx_c_mixer_clear_voices(&state), VTX_C_MIXER_STATUS_OK)
+    }
+
+    func testCMixerCoreTraceRingRecordsVoiceLifecycleWithAbsoluteFrames() {
+        let sample = Array(repeating: Float(0.5), count: 100)
+        for engine in [VTX_C_MIXER_RENDER_ENGINE_REFERENCE, VTX_C_MIXER_RENDER_ENGINE_VOICE_MAJOR] {
+            var ring: OpaquePointer?
+            XCTAssertEqual(vtx_c_trace_ring_create(100, &ring), VTX_C_TRACE_STATUS_OK)
+            XCTAssertEqual(vtx_c_trace_ring_capacity(ring), 128)
+            var state = VTXCMixerState()
+            XCTAssertEqual(vtx_c_mixer_init(&state, vtx_c_mixer_default_config()), VTX_C_MIXER_STATUS_OK)
+            XCTAssertEqual(vtx_c_mixer_set_render_engine(&state, engine), VTX_C_MIXER_STATUS_OK)
+            XCTAssertEqual(vtx_c_mixer_set_trace_ring(&state, ring), VTX_C_MIXER_STATUS_OK)
+
+            var tagged: UInt32 = 0
+            var faded: UInt32 = 0
+            sample.withUnsafeBufferPointer { buffer in
+                XCTAssertEqual(
+                    vtx_c_mixer_add_scheduled_sample_voice(
+                        &state, buffer.baseAddress, 100, 1, 0, VTX_C_MIXER_LOOP_NONE, 0, 0, 10, &tagged
+                    ),
+                    VTX_C_MIXER_STATUS_OK
+                )
+                XCTAssertEqual(
+                    vtx_c_mixer_add_scheduled_sample_voice(
+                        &state, buffer.baseAddress, 100, 1, 0, VTX_C_MIXER_LOOP_FORWARD, 0, 100, 0, &faded
+                    ),
+                    VTX_C_MIXER_STATUS_OK
+                )
+            }
+            XCTAssertEqual(vtx_c_mixer_set_voice_channel_tag(&state, tagged, 7), VTX_C_MIXER_STATUS_OK)
+            XCTAssertEqual(vtx_c_mixer_set_voice_key_off_frame(&state, faded, 50, 0.05), VTX_C_MIXER_STATUS_OK)
+            XCTAssertEqual(
+                vtx_c_mixer_schedule_voice_gain_pan_update(&state, faded, 40, 1, 0.5, 0, 0),
+                VTX_C_MIXER_STATUS_OK
+            )
+
+            var output = Array(repeating: Float(0), count: 37 * 2)
+            for _ in 0..<5 {
+                XCTAssertEqual(
+                    output.withUnsafeMutableBufferPointer { buffer in
+                        vtx_c_mixer_render(&state, buffer.baseAddress, 37)
+                    },
+                    VTX_C_MIXER_STATUS_OK
+                )
+            }
+
+            var records = Array(repeating: VTXCTraceRecord(), count: 64)
+            let count = Int(records.withUnsafeMutableBufferPointer { buffer in
+                vtx_c_trace_ring_pop(ring, buffer.baseAddress, UInt32(buffer.count))
+            })
+            let voiceRecords = records[0..<count]
+                .filter { $0.voice_index != VTX_C_TRACE_NO_VOICE }
+                .map { [UInt64($0.kind), $0.frame, UInt64($0.voice_index), UInt64($0.channel_tag)] }
+            XCTAssertEqual(voiceRecords, [
+                [UInt64(VTX_C_TRACE_KIND_VOICE_START.rawValue), 10, UInt64(tagged), 7],
+                [UInt64(VTX_C_TRACE_KIND_VOICE_START.rawValue), 0, UInt64(faded), UInt64(VTX_C_TRACE_NO_CHANNEL_TAG)],
+                [UInt64(VTX_C_TRACE_KIND_EVENT_APPLY.rawValue), 40, UInt64(faded), UInt64(VTX_C_TRACE_NO_CHANNEL_TAG)],
+                [UInt64(VTX_C_TRACE_KIND_RAMP.rawValue), 40, UInt64(faded), UInt64(VTX_C_TRACE_NO_CHANNEL_TAG)],
+                [UInt64(VTX_C_TRACE_KIND_KEY_OFF.rawValue), 50, UInt64(faded), UInt64(VTX_C_TRACE_NO_CHANNEL_TAG)],
+                [UInt64(VTX_C_TRACE_KIND_VOICE_END.rawValue), 70, UInt64(faded), UInt64(VTX_C_TRACE_NO_CHANNEL_TAG)],
+                [UInt64(VTX_C_TRACE_KIND_VOICE_END.rawValue), 110, UInt64(tagged), 7],
+            ])
+            XCTAssertEqual(records[0..<count].filter { $0.kind == UInt16(VTX_C_TRACE_KIND_RENDER_BEGIN.rawValue) }.count, 5)
+            XCTAssertEqual(vtx_c_trace_ring_dropped_count(ring), 0)
+
+            XCTAssertEqual(vtx_c_mixer_set_trace_ring(&state, nil), VTX_C_MIXER_STATUS_OK)
+            XCTAssertEqual(vtx_c_mixer_clear_voices(&state), VTX_C_MIXER_STATUS_OK)
+            vtx_c_trace_ring_free(ring)
+        }
+    }
+
+    func testCMixerCoreTapsMeterChannelTagsWithoutChangingOutput() {
+        let sample: [Float] = (0..<64).map { index in
+            Float(sin(Double(index) * 0.29)) * 0.7
+        }
+
+        func render(engine: VTXCMixerRenderEngine, taps: OpaquePointer?, includeUntapped: Bool) -> [Float] {
+            var state = VTXCMixerState()
+            XCTAssertEqual(vtx_c_mixer_init(&state, vtx_c_mixer_default_config()), VTX_C_MIXER_STATUS_OK)
+            XCTAssertEqual(vtx_c_mixer_set_render_engine(&state, engine), VTX_C_MIXER_STATUS_OK)
+            XCTAssertEqual(vtx_c_mixer_set_taps(&state, taps), VTX_C_MIXER_STATUS_OK)
+
+            var tapped: UInt32 = 0
+            var untapped: UInt32 = 0
+            sample.withUnsafeBufferPointer { buffer in
+                XCTAssertEqual(
+                    vtx_c_mixer_add_sample_voice(
+                        &state, buffer.baseAddress, 64, 0.8, -0.5, VTX_C_MIXER_LOOP_FORWARD, 0, 64, &tapped
+                    ),
+                    VTX_C_MIXER_STATUS_OK
+                )
+                if includeUntapped {
+                    XCTAssertEqual(
+                        vtx_c_mixer_add_sample_voice_with_step(
+                            &state, buffer.baseAddress, 64, 0.75, 0.6, 0.25, VTX_C_MIXER_LOOP_PING_PONG, 8, 56, &untapped
+                        ),
+                        VTX_C_MIXER_STATUS_OK
+                    )
+                    XCTAssertEqual(vtx_c_mixer_set_voice_channel_tag(&state, untapped, 5), VTX_C_MIXER_STATUS_OK)
+                }
+            }
+            XCTAssertEqual(vtx_c_mixer_set_voice_channel_tag(&state, tapped, 1), VTX_C_MIXER_STATUS_OK)
+            XCTAssertEqual(
+                vtx_c_mixer_schedule_voice_gain_pan_update(&state, tapped, 200, 1, 0.4, 1, 0.5),
+                VTX_C_MIXER_STATUS_OK
+            )
+
+            var output = Array(repeating: Float(0), count: 300 * 2)
+            XCTAssertEqual(
+                output.withUnsafeMutableBufferPointer { buffer in
+                    vtx_c_mixer_render(&state, buffer.baseAddress, 300)
+                },
+                VTX_C_MIXER_STATUS_OK
+            )
+            XCTAssertEqual(vtx_c_mixer_set_taps(&state, nil), VTX_C_MIXER_STATUS_OK)
+            XCTAssertEqual(vtx_c_mixer_clear_voices(&state), VTX_C_MIXER_STATUS_OK)
+            return output
+        }
+
+        for engine in [VTX_C_MIXER_RENDER_ENGINE_REFERENCE, VTX_C_MIXER_RENDER_ENGINE_VOICE_MAJOR] {
+            var taps: OpaquePointer?
+            XCTAssertEqual(vtx_c_mixer_taps_create(2, 64, &taps), VTX_C_MIXER_STATUS_OK)
+            XCTAssertEqual(vtx_c_mixer_taps_channel_tag_count(taps), 2)
+
+            let plain = render(engine: engine, taps: nil, includeUntapped: true)
+            let tapped = render(engine: engine, taps: taps, includeUntapped: true)
+            XCTAssertEqual(tapped.map(\.bitPattern), plain.map(\.bitPattern))
+
+            let tagOnly = render(engine: engine, taps: nil, includeUntapped: false)
+            var scope = Array(repeating: Float(0), count: 48 * 2)
+            var scopeEndFrame: UInt64 = 0
+            XCTAssertEqual(
+                vtx_c_mixer_taps_read_scope(taps, 1, &scope, 48, &scopeEndFrame),
+                VTX_C_MIXER_STATUS_OK
+            )
+            XCTAssertEqual(scopeEndFrame, 300)
+            XCTAssertEqual(scope.map(\.bitPattern), tagOnly[(252 * 2)...].map(\.bitPattern))
+
+            var level = VTXCMixerTapLevel()
+            XCTAssertEqual(vtx_c_mixer_taps_read_level(taps, 1, &level), VTX_C_MIXER_STATUS_OK)
+            XCTAssertEqual(level.end_frame, 300)
+            XCTAssertEqual(level.frame_count, 300)
+            XCTAssertEqual(level.peak, tagOnly.map { abs($0) }.max() ?? 0)
+            XCTAssertGreaterThan(level.rms, 0)
+            XCTAssertEqual(vtx_c_mixer_taps_read_level(taps, 0, &level), VTX_C_MIXER_STATUS_OK)
+            XCTAssertEqual(level.peak, 0)
+            XCTAssertEqual(vtx_c_mixer_taps_read_level(taps, 2, &level), VTX_C_MIXER_STATUS_INVALID_ARGUMENT)
+            vtx_c_mixer_taps_free(taps)
+        }
+    }
+
+    func testCMixerCoreSamplePyramidSelectsLevelsByStepAndFiltersAliases() {
+        // Renders a looping sine of cyclesPerFrame at step with and without a
+        // 4-level pyramid, optionally updating the step halfway through.
+        func render(
+            cyclesPerFrame: Double,
+            step: Double,
+            stepUpdate: Double? = nil
+        ) -> (plain: [Float], pyramid: [Float], levels: [UInt32]) {
+            let pcm: [Float] = (0..<8192).map { index in
+                Float(sin(Double(index) * 2.0 * Double.pi * cyclesPerFrame))
+            }
+            return pcm.withUnsafeBufferPointer { buffer in
+                var sample = VTXCMixerSharedSample(pcm: buffer.baseAddress, frame_count: 8192, pyramid: nil)
+                var pyramid: OpaquePointer?
+                XCTAssertEqual(
+                    vtx_c_mixer_sample_pyramid_create(&sample, VTX_C_MIXER_LOOP_FORWARD, 1024, 8192, 4, &pyramid),
+                    VTX_C_MIXER_STATUS_OK
+                )
+                defer { vtx_c_mixer_sample_pyramid_free(pyramid) }
+                XCTAssertEqual(vtx_c_mixer_sample_pyramid_level_count(pyramid), 4)
+                XCTAssertGreaterThan(vtx_c_mixer_sample_pyramid_byte_count(pyramid), 0)
+
+                func renderVoice(pyramid: OpaquePointer?) -> (output: [Float], levels: [UInt32]) {
+                    var state = VTXCMixerState()
+                    var shared = VTXCMixerSharedSample(pcm: buffer.baseAddress, frame_count: 8192, pyramid: pyramid)
+                    var voice: UInt32 = 0
+                    XCTAssertEqual(vtx_c_mixer_init(&state, vtx_c_mixer_default_config()), VTX_C_MIXER_STATUS_OK)
+                    XCTAssertEqual(
+                        vtx_c_mixer_add_scheduled_shared_sample_voice(
+                            &state, &shared, step, 0, 0.5, 0, VTX_C_MIXER_LOOP_FORWARD, 1024, 8192, 0, &voice
+                        ),
+                        VTX_C_MIXER_STATUS_OK
+                    )
+                    var levels = [vtx_c_mixer_voice_sample_level(&state, voice)]
+                    if let stepUpdate = stepUpdate {
+                        XCTAssertEqual(
+                            vtx_c_mixer_schedule_voice_sample_step_update(&state, voice, 512, stepUpdate),
+                            VTX_C_MIXER_STATUS_OK
+                        )
+                    }
+                    var output = Array(repeating: Float(0), count: 1024 * 2)
+                    XCTAssertEqual(
+                        output.withUnsafeMutableBufferPointer { outputBuffer in
+                            vtx_c_mixer_render(&state, outputBuffer.baseAddress, 1024)
+                        },
+                        VTX_C_MIXER_STATUS_OK
+                    )
+                    levels.append(vtx_c_mixer_voice_sample_level(&state, voice))
+                    XCTAssertEqual(vtx_c_mixer_clear_voices(&state), VTX_C_MIXER_STATUS_OK)
+                    return (output, levels)
+                }
+
+                let plain = renderVoice(pyramid: nil)
+                let decimated = renderVoice(pyramid: pyramid)
+                return (plain.output, decimated.output, decimated.levels)
+            }
+        }
+
+        func rms(_ samples: [Float]) -> Double {
+            sqrt(samples.reduce(0.0) { $0 + Double($1) * Double($1) } / Double(samples.count))
+        }
+
+        // Steps of one frame or less read the source sample unchanged.
+        let slow = render(cyclesPerFrame: 0.3, step: 1)
+        XCTAssertEqual(slow.levels, [0, 0])
+        XCTAssertEqual(slow.pyramid.map(\.bitPattern), slow.plain.map(\.bitPattern))
+
+        // Each tone lies above the output Nyquist (0.5 / step source cycles)
+        // and folds back without a pyramid. The chosen level steps through at
+        // most one frame at a time, so its low-pass removes the tone; 3.9 and
+        // 3.5 sit near the top of the step octave that reads level 2.
+        let aliasCases: [(cyclesPerFrame: Double, step: Double, level: UInt32)] = [(0.3, 4.5, 3), (0.15, 3.9, 2), (0.2, 3.5, 2)]
+        for (cyclesPerFrame, step, level) in aliasCases {
+            let fast = render(cyclesPerFrame: cyclesPerFrame, step: step)
+            XCTAssertEqual(fast.levels, [level, level], "step \(step)")
+            XCTAssertGreaterThan(rms(fast.plain), 0.1, "step \(step)")
+            XCTAssertLessThan(rms(fast.pyramid), rms(fast.plain) * 0.05, "step \(step)")
+        }
+
+        // A tone below the output Nyquist survives the level's low-pass.
+        let passband = render(cyclesPerFrame: 0.05, step: 3.9)
+        XCTAssertEqual(passband.levels, [2, 2])
+        XCTAssertGreaterThan(rms(passband.pyramid), rms(passband.plain) * 0.8)
+
+        XCTAssertEqual(render(cyclesPerFrame: 0.3, step: 1, stepUpdate: 9).levels, [0, 4])
+        XCTAssertEqual(render(cyclesPerFrame: 0.3, step: 20, stepUpdate: 1.25).levels, [4, 1])
+    }
+
+    func testCMixerCoreVoiceMajorEngineMatchesReferenceBitForBit() {
+        let sample: [Float] = (0..<96).map { index in
+            Float(sin(Double(index) * 0.37)) * 0.8
+        }
+
+        func renderScenario(engine: VTXCMixerRenderEngine) -> [Float] {
+            var state = VTXCMixerState()
+            XCTAssertEqual(vtx_c_mixer_init(&state, vtx_c_mixer_default_config()), VTX_C_MIXER_STATUS_OK)
+            XCTAssertEqual(vtx_c_mixer_set_render_engine(&state, engine), VTX_C_MIXER_STATUS_OK)
+            XCTAssertEqual(vtx_c_mixer_render_engine(&state), engine)
+
+            var loopedVoice: UInt32 = 0
+            var releasedVoice: UInt32 = 0
+            sample.withUnsafeBufferPointer { buffer in
+                XCTAssertEqual(
+                    vtx_c_mixer_add_sample_voice_with_step(
+                        &state, buffer.baseAddress, UInt32(buffer.count), 0.75, 0.5, -0.25,
+                        VTX_C_MIXER_LOOP_PING_PONG, 16, 80, &loopedVoice
+                    ),
+                    VTX_C_MIXER_STATUS_OK
+                )
+                XCTAssertEqual(
+                    vtx_c_mixer_add_scheduled_sample_voice_with_step(
+                        &state, buffer.baseAddress, UInt32(buffer.count), 1.5, 0.4, 0.5,
+                        VTX_C_MIXER_LOOP_FORWARD, 8, 96, 23, &releasedVoice
+                    ),
+                    VTX_C_MIXER_STATUS_OK
+                )
+            }
+            XCTAssertEqual(vtx_c_mixer_set_voice_channel_tag(&state, loopedVoice, 1), VTX_C_MIXER_STATUS_OK)
+            XCTAssertEqual(vtx_c_mixer_set_voice_key_off_frame(&state, releasedVoice, 90, 0.01), VTX_C_MIXER_STATUS_OK)
+            XCTAssertEqual(
+                vtx_c_mixer_schedule_voice_gain_pan_sample_step_update(&state, loopedVoice, 41, 1, 0.3, 1, 0.75, 1.25),
+                VTX_C_MIXER_STATUS_OK
+            )
+
+            var rendered: [Float] = []
+            for block in 0..<6 {
+                if block == 4 {
+                    var rampedCount: UInt32 = 0
+                    XCTAssertEqual(
+                        vtx_c_mixer_ramp_down_voices_for_channel_tag(&state, 1, 20, &rampedCount),
+                        VTX_C_MIXER_STATUS_OK
+                    )
+                    XCTAssertEqual(rampedCount, 1)
+                }
+                var output = Array(repeating: Float(0), count: 37 * 2)
+                XCTAssertEqual(
+                    output.withUnsafeMutableBufferPointer { buffer in
+                        vtx_c_mixer_render(&state, buffer.baseAddress, 37)
+                    },
+                    VTX_C_MIXER_STATUS_OK
+                )
+                rendered.append(contentsOf: output)
+            }
+            XCTAssertEqual(vtx_c_mixer_clear_voices(&state), VTX_C_MIXER_STATUS_OK)
+            return rendered
+        }
+
+        let reference = renderScenario(engine: VTX_C_MIXER_RENDER_ENGINE_REFERENCE)
+        let voiceMajor = renderScenario(engine: VTX_C_MIXER_RENDER_ENGINE_VOICE_MAJOR)
+
+        XCTAssertTrue(reference.contains { $0 != 0 })
+        XCTAssertEqual(reference.map(\.bitPattern), voiceMajor.map(\.bitPattern))
+    }
+
     func testCSoftwareMixerInitializesWithDefaultRenderConfiguration() {
         let mixer = CSoftwareMixer()
 
@@ -1,8 +1,11 @@
 #ifndef VTX_C_MIXER_H
 #define VTX_C_MIXER_H
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include "vtx_c_trace.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -31,10 +34,21 @@ extern "C" {
 // not wired into this C-backed path yet.
 #define VTX_C_MIXER_MAX_ENVELOPE_POINTS 12u
 
+// Per-channel-tag taps render in chunks of at most this many frames and
+// publish scope data after each chunk.
+#define VTX_C_MIXER_TAP_BLOCK_FRAMES 256u
+#define VTX_C_MIXER_MAX_TAP_CHANNEL_TAGS 1024u
+#define VTX_C_MIXER_MAX_TAP_SCOPE_FRAMES 65536u
+
+// Decimated levels a sample pyramid can hold: 1/2 of the source rate down to
+// 1/64.
+#define VTX_C_MIXER_MAX_SAMPLE_PYRAMID_LEVELS 6u
+
 typedef enum {
     VTX_C_MIXER_STATUS_OK = 0,
     VTX_C_MIXER_STATUS_INVALID_ARGUMENT = 1,
     VTX_C_MIXER_STATUS_VOICE_CAPACITY_EXCEEDED = 2,
+    VTX_C_MIXER_STATUS_BUSY = 3,
 } VTXCMixerStatus;
 
 typedef enum {
@@ -43,6 +57,14 @@ typedef enum {
     VTX_C_MIXER_LOOP_PING_PONG = 2,
 } VTXCMixerLoopMode;
 
+// Render kernels selectable per mixer state. The reference engine is the scalar
+// frame-major implementation and stays the default; optimized engines must
+// produce bit-identical output (see tools/vtx_mixer_diff).
+typedef enum {
+    VTX_C_MIXER_RENDER_ENGINE_REFERENCE = 0,
+    VTX_C_MIXER_RENDER_ENGINE_VOICE_MAJOR = 1,
+} VTXCMixerRenderEngine;
+
 typedef struct {
     double sample_rate;
     uint32_t channel_count;
@@ -71,6 +93,20 @@ typedef struct {
     uint32_t loop_end_frame;
 } VTXCMixerEnvelope;
 
+typedef struct VTXCMixerSamplePyramid VTXCMixerSamplePyramid;
+
+// Caller-owned mono Float32 sample data that voices reference instead of
+// copying. Values must be finite. The data must stay alive and unchanged while
+// any voice uses it; one sample may back voices in several mixer states.
+// pyramid is optional; when it was built from this sample with the voice's
+// loop, voices stepping through the sample more than one frame at a time read
+// the decimated level they step through at most one frame at a time.
+typedef struct {
+    const float *pcm;
+    uint32_t frame_count;
+    const VTXCMixerSamplePyramid *pyramid;
+} VTXCMixerSharedSample;
+
 typedef struct {
     VTXCMixerEnvelopePoint points[VTX_C_MIXER_MAX_ENVELOPE_POINTS];
     uint32_t point_count;
@@ -85,7 +121,14 @@ typedef struct {
 
 typedef struct {
     float *sample_pcm;
+    int shares_sample_pcm;
     uint32_t sample_frame_count;
+    // Pyramid level read for the current step. Level 0 reads sample_pcm;
+    // level n reads level_pcm at sample_position * level_position_scale.
+    const VTXCMixerSamplePyramid *sample_pyramid;
+    const float *level_pcm;
+    uint32_t sample_level;
+    double level_position_scale;
     uint32_t initial_sample_frame;
     double sample_position;
     double initial_sample_step;
@@ -120,6 +163,9 @@ typedef struct {
     int has_channel_tag;
     uint32_t channel_tag;
     int active;
+    // First output frame the voice no longer contributed to, set when a
+    // render deactivates it.
+    uint64_t end_frame;
 } VTXCMixerVoice;
 
 typedef struct {
@@ -134,12 +180,44 @@ typedef struct {
     int ramp_enabled;
 } VTXCMixerVoiceStateEvent;
 
+// Level of one channel tag over the last render call, before the output gain.
+// Peak and RMS cover the first two output channels; end_frame is the first
+// frame after the measured block.
+typedef struct {
+    uint64_t end_frame;
+    uint32_t frame_count;
+    float peak;
+    float rms;
+} VTXCMixerTapLevel;
+
+typedef struct VTXCMixerTaps VTXCMixerTaps;
+
+// Output level meters, taken after the output gain. Non-finite samples meter
+// as silence. Overrange counts samples above full scale; clipping counts
+// samples at or above it.
+typedef struct {
+    uint64_t sample_count;
+    double square_sum;
+    float peak;
+    uint64_t overrange_sample_count;
+    uint64_t clipping_sample_count;
+} VTXCMixerOutputMeter;
+
 typedef struct {
     VTXCMixerConfig config;
     uint64_t current_frame;
     uint32_t voice_count;
     uint32_t voice_state_event_count;
     uint32_t next_voice_state_event_index;
+    uint64_t sample_allocation_count;
+    uint64_t sample_allocation_byte_count;
+    VTXCMixerRenderEngine render_engine;
+    float output_gain;
+    VTXCMixerOutputMeter last_render_meter;
+    VTXCMixerOutputMeter cumulative_meter;
+    VTXCTraceRing *trace_ring;
+    uint64_t trace_pending_start_mask[VTX_C_MIXER_MAX_VOICES / 64u];
+    VTXCMixerTaps *taps;
     VTXCMixerVoice voices[VTX_C_MIXER_MAX_VOICES];
     VTXCMixerVoiceStateEvent voice_state_events[VTX_C_MIXER_MAX_VOICE_STATE_EVENTS];
 } VTXCMixerState;
@@ -150,6 +228,11 @@ uint32_t vtx_c_mixer_replacement_stop_ramp_frame_count(void);
 uint32_t vtx_c_mixer_loaded_voice_count(const VTXCMixerState *state);
 uint32_t vtx_c_mixer_active_voice_count(const VTXCMixerState *state);
 uint64_t vtx_c_mixer_current_frame(const VTXCMixerState *state);
+
+// Counts heap allocations made for C-owned voice sample storage since init.
+// Rendering never allocates, so these counters only move when voices are added.
+uint64_t vtx_c_mixer_sample_allocation_count(const VTXCMixerState *state);
+uint64_t vtx_c_mixer_sample_allocation_byte_count(const VTXCMixerState *state);
 VTXCMixerStatus vtx_c_mixer_init(VTXCMixerState *state, VTXCMixerConfig config);
 VTXCMixerStatus vtx_c_mixer_reset(VTXCMixerState *state);
 VTXCMixerStatus vtx_c_mixer_configure(VTXCMixerState *state, VTXCMixerConfig config);
@@ -292,6 +375,53 @@ VTXCMixerStatus vtx_c_mixer_add_scheduled_sample_voice_with_step_at_source_frame
     uint32_t *out_voice_index
 );
 
+// Scheduled explicit-step voice that plays a shared sample in place. Nothing is
+// copied or allocated, so the sample allocation counters do not move.
+VTXCMixerStatus vtx_c_mixer_add_scheduled_shared_sample_voice(
+    VTXCMixerState *state,
+    const VTXCMixerSharedSample *sample,
+    double sample_step,
+    uint32_t initial_sample_frame,
+    float gain,
+    float pan,
+    VTXCMixerLoopMode loop_mode,
+    uint32_t loop_start_frame,
+    uint32_t loop_end_frame,
+    uint64_t scheduled_start_frame,
+    uint32_t *out_voice_index
+);
+
+// Builds up to level_count decimated copies of sample (1/2, 1/4, ... of its
+// rate) for sharing through VTXCMixerSharedSample.pyramid. Each level is
+// low-pass filtered before decimation. Inside the loop the filter reads the
+// loop's own continuation (wrapped or mirrored), so a looping voice
+// never blends in frames it will not play. Levels stop early once they would
+// hold fewer than two frames. The pyramid references sample->pcm, which must
+// outlive it; the pyramid itself is read-only and may be shared like the
+// sample.
+VTXCMixerStatus vtx_c_mixer_sample_pyramid_create(
+    const VTXCMixerSharedSample *sample,
+    VTXCMixerLoopMode loop_mode,
+    uint32_t loop_start_frame,
+    uint32_t loop_end_frame,
+    uint32_t level_count,
+    VTXCMixerSamplePyramid **out_pyramid
+);
+void vtx_c_mixer_sample_pyramid_free(VTXCMixerSamplePyramid *pyramid);
+uint32_t vtx_c_mixer_sample_pyramid_level_count(const VTXCMixerSamplePyramid *pyramid);
+size_t vtx_c_mixer_sample_pyramid_byte_count(const VTXCMixerSamplePyramid *pyramid);
+
+// Pyramid level a voice currently reads; 0 is the source sample.
+uint32_t vtx_c_mixer_voice_sample_level(const VTXCMixerState *state, uint32_t voice_index);
+
+int vtx_c_mixer_voice_is_active(const VTXCMixerState *state, uint32_t voice_index);
+
+// Releases loaded voices that have finished playing (reached their end, faded
+// out or ramped down) so their slots can be reused. Voices scheduled in the
+// future are still active and are kept. Callers must drop any voice indices
+// that were released.
+VTXCMixerStatus vtx_c_mixer_release_inactive_voices(VTXCMixerState *state, uint32_t *out_released_count);
+
 // Attaches a copied synthetic volume envelope to an existing voice.
 // Values are clamped to 0.0...1.0 and multiply the voice gain. Invalid envelopes
 // are disabled, which is equivalent to a constant 1.0 volume envelope.
@@ -393,12 +523,91 @@ VTXCMixerStatus vtx_c_mixer_schedule_voice_gain_pan_update_immediate(
     float pan
 );
 
+// Selects the kernel used by vtx_c_mixer_render. vtx_c_mixer_init resets the
+// selection to the reference engine.
+VTXCMixerStatus vtx_c_mixer_set_render_engine(VTXCMixerState *state, VTXCMixerRenderEngine engine);
+VTXCMixerRenderEngine vtx_c_mixer_render_engine(const VTXCMixerState *state);
+const char *vtx_c_mixer_render_engine_name(VTXCMixerRenderEngine engine);
+
+// Renders with the selected engine.
 VTXCMixerStatus vtx_c_mixer_render(
     VTXCMixerState *state,
     float *output_interleaved_float32,
     uint32_t frame_count
 );
 
+// Always renders with the scalar frame-major reference kernel, regardless of
+// the selected engine. Differential checks compare other engines against it.
+VTXCMixerStatus vtx_c_mixer_render_reference(
+    VTXCMixerState *state,
+    float *output_interleaved_float32,
+    uint32_t frame_count
+);
+
+// Linear gain applied to every rendered block in the same pass that meters it.
+// vtx_c_mixer_init sets 1.0, which leaves the mix untouched; reset and
+// configure keep the current gain. Non-finite or negative gains are rejected.
+VTXCMixerStatus vtx_c_mixer_set_output_gain(VTXCMixerState *state, float gain);
+float vtx_c_mixer_output_gain(const VTXCMixerState *state);
+
+// Meters of the block written by the last successful render call, and of every
+// block since init or vtx_c_mixer_reset_output_meters. Reading them is O(1);
+// hosts no longer need a second pass over the rendered audio.
+VTXCMixerOutputMeter vtx_c_mixer_last_render_meter(const VTXCMixerState *state);
+VTXCMixerOutputMeter vtx_c_mixer_cumulative_output_meter(const VTXCMixerState *state);
+VTXCMixerStatus vtx_c_mixer_reset_output_meters(VTXCMixerState *state);
+
+// Adds from into into, for callers that split one buffer across render calls.
+void vtx_c_mixer_output_meter_merge(VTXCMixerOutputMeter *into, const VTXCMixerOutputMeter *from);
+double vtx_c_mixer_output_meter_rms(const VTXCMixerOutputMeter *meter);
+
+// Records voice starts, stops, steals, ends, key-offs, applied events, ramps
+// and render-call boundaries into ring, with absolute frames. Recording never
+// allocates; a full ring drops records. The ring is caller-owned and must
+// outlive its use here; NULL turns tracing off. vtx_c_mixer_init clears it.
+// Voice starts are recorded at the next render or stop, once channel tags are
+// set, and records inside one render call are not sorted by frame.
+VTXCMixerStatus vtx_c_mixer_set_trace_ring(VTXCMixerState *state, VTXCTraceRing *ring);
+VTXCTraceRing *vtx_c_mixer_trace_ring(const VTXCMixerState *state);
+
+// Optional per-channel-tag taps. Voices tagged below channel_tag_count are
+// also summed per tag while rendering, into a level for each render call and a
+// scope ring of the most recent scope_frame_count stereo frames (mono output
+// is duplicated). Tapped rendering is bit-identical to untapped rendering and
+// allocates nothing; without taps the render path is unchanged. Each tag is
+// published under a seqlock, so any thread may read while the render thread
+// writes, without locks on either side. Taps are caller-owned, attach to one
+// mixer at a time and must outlive their use; vtx_c_mixer_init detaches them.
+
+VTXCMixerStatus vtx_c_mixer_taps_create(
+    uint32_t channel_tag_count,
+    uint32_t scope_frame_count,
+    VTXCMixerTaps **out_taps
+);
+void vtx_c_mixer_taps_free(VTXCMixerTaps *taps);
+uint32_t vtx_c_mixer_taps_channel_tag_count(const VTXCMixerTaps *taps);
+uint32_t vtx_c_mixer_taps_scope_frame_count(const VTXCMixerTaps *taps);
+VTXCMixerStatus vtx_c_mixer_set_taps(VTXCMixerState *state, VTXCMixerTaps *taps);
+VTXCMixerTaps *vtx_c_mixer_taps(const VTXCMixerState *state);
+
+// Readers. BUSY means the render thread kept rewriting the tag while it was
+// read; try again on the next UI frame or poll.
+VTXCMixerStatus vtx_c_mixer_taps_read_level(
+    const VTXCMixerTaps *taps,
+    uint32_t channel_tag,
+    VTXCMixerTapLevel *out_level
+);
+
+// Copies the newest frame_count scope frames, oldest first, as interleaved
+// stereo. Frames before the first render read as silence.
+VTXCMixerStatus vtx_c_mixer_taps_read_scope(
+    const VTXCMixerTaps *taps,
+    uint32_t channel_tag,
+    float *out_interleaved_stereo,
+    uint32_t frame_count,
+    uint64_t *out_end_frame
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,73 @@
+#ifndef VTX_C_SINK_H
+#define VTX_C_SINK_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VTX_C_SINK_DEFAULT_BUFFER_FRAMES 16384u
+#define VTX_C_SINK_WAV_HEADER_BYTES 44u
+
+typedef enum {
+    VTX_C_SINK_STATUS_OK = 0,
+    VTX_C_SINK_STATUS_INVALID_ARGUMENT = 1,
+    VTX_C_SINK_STATUS_OUT_OF_MEMORY = 2,
+    VTX_C_SINK_STATUS_IO_ERROR = 3,
+} VTXCSinkStatus;
+
+typedef enum {
+    VTX_C_SINK_FORMAT_PCM16 = 0,
+    VTX_C_SINK_FORMAT_FLOAT32 = 1,
+} VTXCSinkFormat;
+
+typedef enum {
+    VTX_C_SINK_CONTAINER_WAV = 0,
+    VTX_C_SINK_CONTAINER_RAW = 1,
+} VTXCSinkContainer;
+
+typedef struct {
+    uint32_t sample_rate;
+    uint32_t channel_count;
+    VTXCSinkFormat format;
+    VTXCSinkContainer container;
+    // Frames held per buffer before it is written out.
+    uint32_t buffer_frames;
+    // Nonzero writes full buffers on a dedicated thread while the caller fills
+    // the other one. Errors from that thread surface on the next write or on
+    // close.
+    int background_writer;
+} VTXCSinkConfig;
+
+// Streams interleaved blocks to a file descriptor as little-endian PCM,
+// converting on append. A WAV header is written first with placeholder sizes
+// and patched on close when the destination is seekable; on pipes the sizes
+// stay 0xFFFFFFFF, the usual marker for a stream of unknown length. Sizes
+// past 4 GiB are clamped. Memory use is the configured buffers only.
+typedef struct VTXCSink VTXCSink;
+
+VTXCSinkConfig vtx_c_sink_default_config(void);
+
+// Creates or truncates path. close releases the descriptor.
+VTXCSinkStatus vtx_c_sink_open_path(const char *path, VTXCSinkConfig config, VTXCSink **out_sink);
+
+// Writes at fd's current position. The descriptor stays open after close.
+VTXCSinkStatus vtx_c_sink_open_fd(int fd, VTXCSinkConfig config, VTXCSink **out_sink);
+
+// Non-finite samples are written as silence. PCM16 output clamps to -1...1
+// and rounds half away from zero, like MixerWAVExporter.
+VTXCSinkStatus vtx_c_sink_write_float32(VTXCSink *sink, const float *interleaved, uint32_t frame_count);
+VTXCSinkStatus vtx_c_sink_write_int16(VTXCSink *sink, const int16_t *interleaved, uint32_t frame_count);
+
+uint64_t vtx_c_sink_frame_count(const VTXCSink *sink);
+
+// Flushes, patches the header, joins the writer thread and frees the sink,
+// whatever the result. Returns the first error seen over the sink's life.
+VTXCSinkStatus vtx_c_sink_close(VTXCSink *sink);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef VTX_C_TRACE_H
+#define VTX_C_TRACE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VTX_C_TRACE_DEFAULT_RING_RECORDS 65536u
+#define VTX_C_TRACE_FILE_VERSION 1u
+#define VTX_C_TRACE_FILE_HEADER_BYTES 32u
+#define VTX_C_TRACE_RECORD_BYTES 32u
+#define VTX_C_TRACE_NO_VOICE 0xFFFFFFFFu
+#define VTX_C_TRACE_NO_CHANNEL_TAG 0xFFFFFFFFu
+
+typedef enum {
+    VTX_C_TRACE_STATUS_OK = 0,
+    VTX_C_TRACE_STATUS_INVALID_ARGUMENT = 1,
+    VTX_C_TRACE_STATUS_OUT_OF_MEMORY = 2,
+    VTX_C_TRACE_STATUS_IO_ERROR = 3,
+} VTXCTraceStatus;
+
+// Record kinds. frame is an absolute mixer output frame; count, value_a and
+// value_b depend on the kind:
+//   RENDER_BEGIN  count = requested frames
+//   RENDER_END    frame = first frame after the block, a = peak, b = RMS
+//   VOICE_START   frame = first audible frame, count = sample frames,
+//                 a = gain, b = pan
+//   VOICE_STOP    the voice was released immediately
+//   VOICE_STEAL   the voice was ramped out to make room for a replacement,
+//                 count = ramp frames, a = gain when the ramp started
+//   VOICE_END     frame = first frame the voice no longer contributed to
+//   KEY_OFF       frame = the voice's key-off frame
+//   EVENT_APPLY   a scheduled update took effect; flags say which fields,
+//                 a = gain, b = pan, or a = sample step for STEP alone
+//   RAMP          a gain or pan ramp started, count = ramp frames,
+//                 a = start value, b = target
+typedef enum {
+    VTX_C_TRACE_KIND_RENDER_BEGIN = 1,
+    VTX_C_TRACE_KIND_RENDER_END = 2,
+    VTX_C_TRACE_KIND_VOICE_START = 3,
+    VTX_C_TRACE_KIND_VOICE_STOP = 4,
+    VTX_C_TRACE_KIND_VOICE_STEAL = 5,
+    VTX_C_TRACE_KIND_VOICE_END = 6,
+    VTX_C_TRACE_KIND_KEY_OFF = 7,
+    VTX_C_TRACE_KIND_EVENT_APPLY = 8,
+    VTX_C_TRACE_KIND_RAMP = 9,
+} VTXCTraceKind;
+
+typedef enum {
+    VTX_C_TRACE_FLAG_GAIN = 1u << 0,
+    VTX_C_TRACE_FLAG_PAN = 1u << 1,
+    VTX_C_TRACE_FLAG_STEP = 1u << 2,
+    VTX_C_TRACE_FLAG_RAMPED = 1u << 3,
+} VTXCTraceFlag;
+
+// One fixed-size record. Files store the fields in this order, little-endian,
+// VTX_C_TRACE_RECORD_BYTES each, after a header of
+// VTX_C_TRACE_FILE_HEADER_BYTES: the magic "VTXTRACE", then u32 version,
+// u32 record size, u32 sample rate, u32 channel count and u64 dropped record
+// count.
+typedef struct {
+    uint64_t frame;
+    uint16_t kind;
+    uint16_t flags;
+    uint32_t voice_index;
+    uint32_t channel_tag;
+    uint32_t count;
+    float value_a;
+    float value_b;
+} VTXCTraceRecord;
+
+// Fixed-capacity single-producer, single-consumer record ring. Pushing never
+// allocates, locks or blocks: when the ring is full the record is dropped and
+// counted, so a slow consumer costs trace records, never audio time. One
+// thread (or callers serialized like mixer renders) may push while one other
+// thread pops.
+typedef struct VTXCTraceRing VTXCTraceRing;
+
+// capacity_records is rounded up to a power of two.
+VTXCTraceStatus vtx_c_trace_ring_create(uint32_t capacity_records, VTXCTraceRing **out_ring);
+void vtx_c_trace_ring_free(VTXCTraceRing *ring);
+uint32_t vtx_c_trace_ring_capacity(const VTXCTraceRing *ring);
+
+// Returns 1 when the record was queued and 0 when it was dropped.
+int vtx_c_trace_ring_push(VTXCTraceRing *ring, const VTXCTraceRecord *record);
+
+// Copies up to max_records of the oldest records into out and returns how many.
+uint32_t vtx_c_trace_ring_pop(VTXCTraceRing *ring, VTXCTraceRecord *out, uint32_t max_records);
+uint64_t vtx_c_trace_ring_dropped_count(const VTXCTraceRing *ring);
+
+// Drains a ring into a binary trace file. Decode it with
+// scripts/decode-mixer-trace.py.
+typedef struct VTXCTraceWriter VTXCTraceWriter;
+
+// Creates or truncates path and writes the header. A nonzero
+// drain_interval_ms starts a thread that drains ring at that interval until
+// close; otherwise the caller drains with vtx_c_trace_writer_drain from the
+// ring's consumer thread.
+VTXCTraceStatus vtx_c_trace_writer_open_path(
+    const char *path,
+    VTXCTraceRing *ring,
+    uint32_t sample_rate,
+    uint32_t channel_count,
+    uint32_t drain_interval_ms,
+    VTXCTraceWriter **out_writer
+);
+VTXCTraceStatus vtx_c_trace_writer_drain(VTXCTraceWriter *writer);
+uint64_t vtx_c_trace_writer_record_count(const VTXCTraceWriter *writer);
+
+// Stops the drain thread, drains what is left, stores the ring's dropped count
+// in the header and frees the writer, whatever the result. The ring stays
+// owned by the caller. Returns the first error seen over the writer's life.
+VTXCTraceStatus vtx_c_trace_writer_close(VTXCTraceWriter *writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
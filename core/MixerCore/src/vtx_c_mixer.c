@@ -1,6 +1,7 @@
 #include "vtx_c_mixer.h"
 
 #include <math.h>
+#include <stdatomic.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -268,6 +269,38 @@ static void vtx_c_mixer_sanitize_loop(
     }
 }
 
+struct VTXCMixerSamplePyramid {
+    const float *source_pcm;
+    uint32_t frame_count;
+    VTXCMixerLoopMode loop_mode;
+    uint32_t loop_start_frame;
+    uint32_t loop_end_frame;
+    uint32_t level_count;
+    size_t byte_count;
+    // level_pcm[n - 1] holds level n: the filtered sample at source frames
+    // 0, 2^n, 2 * 2^n, ..., plus one guard frame so interpolation from the
+    // last source frame never reads past the end.
+    float *level_pcm[VTX_C_MIXER_MAX_SAMPLE_PYRAMID_LEVELS];
+};
+
+// Picks the pyramid level for the voice's current step: level n once the step
+// exceeds 2^(n - 1), so the step through the level stays at or below one frame
+// and its low-pass keeps every tone it passes below the output Nyquist. Steps
+// of one or less keep reading the source sample unchanged.
+static void vtx_c_mixer_select_sample_level(VTXCMixerVoice *voice) {
+    const VTXCMixerSamplePyramid *pyramid = voice->sample_pyramid;
+    uint32_t level = 0u;
+
+    if (pyramid != NULL) {
+        while (level < pyramid->level_count && voice->sample_step > (double)(1u << level)) {
+            level++;
+        }
+    }
+    voice->sample_level = level;
+    voice->level_pcm = level > 0u ? pyramid->level_pcm[level - 1u] : NULL;
+    voice->level_position_scale = 1.0 / (double)(1u << level);
+}
+
 static void vtx_c_mixer_disable_envelope(VTXCMixerEnvelopeState *envelope) {
     if (envelope == NULL) {
         return;
@@ -434,6 +467,121 @@ static void vtx_c_mixer_update_voice_key_state(VTXCMixerVoice *voice, uint64_t a
     }
 }
 
+static void vtx_c_mixer_trace(
+    VTXCMixerState *state,
+    VTXCTraceKind kind,
+    uint16_t flags,
+    uint64_t frame,
+    uint32_t voice_index,
+    uint32_t count,
+    float value_a,
+    float value_b
+) {
+    VTXCTraceRecord record;
+    const VTXCMixerVoice *voice = voice_index < VTX_C_MIXER_MAX_VOICES ? &state->voices[voice_index] : NULL;
+
+    record.frame = frame;
+    record.kind = (uint16_t)kind;
+    record.flags = flags;
+    record.voice_index = voice_index;
+    record.channel_tag = voice != NULL && voice->has_channel_tag ? voice->channel_tag : VTX_C_TRACE_NO_CHANNEL_TAG;
+    record.count = count;
+    record.value_a = value_a;
+    record.value_b = value_b;
+    vtx_c_trace_ring_push(state->trace_ring, &record);
+}
+
+// Starts are recorded late so the record carries the channel tag, which
+// callers attach after adding the voice.
+static void vtx_c_mixer_trace_pending_starts(VTXCMixerState *state) {
+    uint32_t word_index;
+
+    for (word_index = 0u; word_index < VTX_C_MIXER_MAX_VOICES / 64u; word_index++) {
+        uint64_t mask = state->trace_pending_start_mask[word_index];
+        while (mask != 0u) {
+            uint32_t bit = 0u;
+            uint32_t voice_index;
+            VTXCMixerVoice *voice;
+
+            while (((mask >> bit) & 1u) == 0u) {
+                bit++;
+            }
+            mask &= ~((uint64_t)1u << bit);
+            voice_index = word_index * 64u + bit;
+            voice = &state->voices[voice_index];
+            if (voice_index < state->voice_count && voice->active) {
+                vtx_c_mixer_trace(
+                    state,
+                    VTX_C_TRACE_KIND_VOICE_START,
+                    0u,
+                    voice->scheduled_start_frame > state->current_frame
+                        ? voice->scheduled_start_frame
+                        : state->current_frame,
+                    voice_index,
+                    voice->sample_frame_count,
+                    voice->gain,
+                    voice->pan
+                );
+            }
+        }
+        state->trace_pending_start_mask[word_index] = 0u;
+    }
+}
+
+// Ramps that start and end on the same value are left out; the player
+// reschedules unchanged gain and pan every tick.
+static void vtx_c_mixer_trace_event(
+    VTXCMixerState *state,
+    const VTXCMixerVoiceStateEvent *event,
+    uint64_t absolute_frame
+) {
+    const VTXCMixerVoice *voice = &state->voices[event->voice_index];
+    uint16_t flags = 0u;
+
+    if (event->update_gain || event->update_pan) {
+        flags = (uint16_t)((event->update_gain ? VTX_C_TRACE_FLAG_GAIN : 0u) |
+            (event->update_pan ? VTX_C_TRACE_FLAG_PAN : 0u) |
+            (event->ramp_enabled ? VTX_C_TRACE_FLAG_RAMPED : 0u));
+        vtx_c_mixer_trace(state, VTX_C_TRACE_KIND_EVENT_APPLY, flags, absolute_frame, event->voice_index, 0u, voice->gain, voice->pan);
+    }
+    if (event->update_sample_step) {
+        vtx_c_mixer_trace(
+            state,
+            VTX_C_TRACE_KIND_EVENT_APPLY,
+            VTX_C_TRACE_FLAG_STEP,
+            absolute_frame,
+            event->voice_index,
+            0u,
+            (float)voice->sample_step,
+            0.0f
+        );
+    }
+    if (event->update_gain && voice->gain_ramp_active && voice->gain_ramp_start != voice->gain_ramp_target) {
+        vtx_c_mixer_trace(
+            state,
+            VTX_C_TRACE_KIND_RAMP,
+            VTX_C_TRACE_FLAG_GAIN,
+            absolute_frame,
+            event->voice_index,
+            voice->gain_ramp_total_frames,
+            voice->gain_ramp_start,
+            voice->gain_ramp_target
+        );
+    }
+    if (event->update_pan && voice->pan_ramp_active && voice->pan_ramp_start != voice->pan_ramp_target) {
+        vtx_c_mixer_trace(
+            state,
+            VTX_C_TRACE_KIND_RAMP,
+            VTX_C_TRACE_FLAG_PAN,
+            absolute_frame,
+            event->voice_index,
+            voice->pan_ramp_total_frames,
+            voice->pan_ramp_start,
+            voice->pan_ramp_target
+        );
+    }
+}
+
 static void vtx_c_mixer_apply_voice_state_events(VTXCMixerState *state, uint64_t absolute_frame) {
     if (state == NULL) {
         return;
@@ -462,6 +610,10 @@ static void vtx_c_mixer_apply_voice_state_events(VTXCMixerState *state, uint64_t
             }
             if (event->update_sample_step) {
                 voice->sample_step = vtx_c_mixer_sanitized_sample_step(event->sample_step);
+                vtx_c_mixer_select_sample_level(voice);
+            }
+            if (state->trace_ring != NULL) {
+                vtx_c_mixer_trace_event(state, event, absolute_frame);
             }
         }
         state->next_voice_state_event_index++;
@@ -546,6 +698,21 @@ static uint32_t vtx_c_mixer_interpolation_next_source_index(
     }
 }
 
+// Pyramid levels already hold the loop's continuation after the loop end, so
+// the next level frame needs no wrap handling.
+static float vtx_c_mixer_level_interpolated_sample(const VTXCMixerVoice *voice) {
+    double level_position = voice->sample_position * voice->level_position_scale;
+    uint32_t level_index = (uint32_t)level_position;
+    double fraction = level_position - (double)level_index;
+    float current_sample = voice->level_pcm[level_index];
+
+    if (fraction <= 0.0) {
+        return current_sample;
+    }
+    return (float)(((double)current_sample * (1.0 - fraction)) +
+        ((double)voice->level_pcm[level_index + 1u] * fraction));
+}
+
 static float vtx_c_mixer_linear_interpolated_sample(
     const VTXCMixerVoice *voice,
     uint32_t source_index
@@ -555,6 +722,9 @@ static float vtx_c_mixer_linear_interpolated_sample(
     float current_sample;
     float next_sample;
 
+    if (voice->sample_level > 0u) {
+        return vtx_c_mixer_level_interpolated_sample(voice);
+    }
     current_sample = voice->sample_pcm[source_index];
     fraction = voice->sample_position - (double)source_index;
     if (fraction <= 0.0) {
@@ -650,7 +820,9 @@ static void vtx_c_mixer_release_voice(VTXCMixerVoice *voice) {
     if (voice == NULL) {
         return;
     }
-    free(voice->sample_pcm);
+    if (!voice->shares_sample_pcm) {
+        free(voice->sample_pcm);
+    }
     memset(voice, 0, sizeof(*voice));
 }
 
@@ -734,6 +906,7 @@ static VTXCMixerStatus vtx_c_mixer_add_sample_voice_internal(
     uint64_t scheduled_start_frame,
     uint32_t initial_sample_frame,
     int reject_past_scheduled_start,
+    int share_sample_pcm,
     uint32_t *out_voice_index
 ) {
     VTXCMixerVoice *voice;
@@ -755,7 +928,9 @@ static VTXCMixerStatus vtx_c_mixer_add_sample_voice_internal(
     if (voice_index >= VTX_C_MIXER_MAX_VOICES) {
         return VTX_C_MIXER_STATUS_VOICE_CAPACITY_EXCEEDED;
     }
-    if (sample_frame_count > 0) {
+    if (sample_frame_count > 0 && share_sample_pcm) {
+        sample_copy = (float *)sample_pcm;
+    } else if (sample_frame_count > 0) {
         if ((size_t)sample_frame_count > SIZE_MAX / sizeof(float)) {
             return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
         }
@@ -763,6 +938,8 @@ static VTXCMixerStatus vtx_c_mixer_add_sample_voice_internal(
         if (sample_copy == NULL) {
             return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
         }
+        state->sample_allocation_count++;
+        state->sample_allocation_byte_count += (uint64_t)sample_frame_count * sizeof(float);
         for (sample_index = 0; sample_index < sample_frame_count; sample_index++) {
             sample_copy[sample_index] = vtx_c_mixer_sanitized_sample(sample_pcm[sample_index]);
         }
@@ -773,6 +950,7 @@ static VTXCMixerStatus vtx_c_mixer_add_sample_voice_internal(
     voice = &state->voices[voice_index];
     memset(voice, 0, sizeof(*voice));
     voice->sample_pcm = sample_copy;
+    voice->shares_sample_pcm = share_sample_pcm && sample_copy != NULL;
     voice->sample_frame_count = sample_frame_count;
     voice->initial_sample_frame = initial_sample_frame;
     voice->sample_position = (double)initial_sample_frame;
@@ -791,6 +969,9 @@ static VTXCMixerStatus vtx_c_mixer_add_sample_voice_internal(
     voice->fadeout_value = 1.0f;
     voice->fadeout_decrement_per_frame = 0.0f;
     voice->active = sample_frame_count > 0 && sample_copy != NULL && initial_sample_frame < sample_frame_count;
+    if (state->trace_ring != NULL && voice->active) {
+        state->trace_pending_start_mask[voice_index / 64u] |= (uint64_t)1u << (voice_index % 64u);
+    }
     if (out_voice_index != NULL) {
         *out_voice_index = voice_index;
     }
@@ -849,12 +1030,21 @@ uint64_t vtx_c_mixer_current_frame(const VTXCMixerState *state) {
     return state == NULL ? 0u : state->current_frame;
 }
 
+uint64_t vtx_c_mixer_sample_allocation_count(const VTXCMixerState *state) {
+    return state == NULL ? 0u : state->sample_allocation_count;
+}
+
+uint64_t vtx_c_mixer_sample_allocation_byte_count(const VTXCMixerState *state) {
+    return state == NULL ? 0u : state->sample_allocation_byte_count;
+}
+
 VTXCMixerStatus vtx_c_mixer_init(VTXCMixerState *state, VTXCMixerConfig config) {
     if (state == NULL) {
         return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
     }
     memset(state, 0, sizeof(*state));
     state->config = vtx_c_mixer_sanitized_config(config);
+    state->output_gain = 1.0f;
     return VTX_C_MIXER_STATUS_OK;
 }
 
@@ -869,6 +1059,7 @@ VTXCMixerStatus vtx_c_mixer_reset(VTXCMixerState *state) {
         VTXCMixerVoice *voice = &state->voices[voice_index];
         voice->sample_position = (double)voice->initial_sample_frame;
         voice->sample_step = voice->initial_sample_step;
+        vtx_c_mixer_select_sample_level(voice);
         voice->ping_pong_direction = 1;
         voice->gain = voice->initial_gain;
         voice->pan = voice->initial_pan;
@@ -901,7 +1092,13 @@ VTXCMixerStatus vtx_c_mixer_clear_voices(VTXCMixerState *state) {
     if (state == NULL) {
         return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
     }
+    if (state->trace_ring != NULL) {
+        vtx_c_mixer_trace_pending_starts(state);
+    }
     for (voice_index = 0; voice_index < state->voice_count; voice_index++) {
+        if (state->trace_ring != NULL && state->voices[voice_index].active) {
+            vtx_c_mixer_trace(state, VTX_C_TRACE_KIND_VOICE_STOP, 0u, state->current_frame, voice_index, 0u, 0.0f, 0.0f);
+        }
         vtx_c_mixer_release_voice(&state->voices[voice_index]);
     }
     state->voice_count = 0;
@@ -936,6 +1133,9 @@ VTXCMixerStatus vtx_c_mixer_stop_voices_for_channel_tag(
     if (state == NULL) {
         return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
     }
+    if (state->trace_ring != NULL) {
+        vtx_c_mixer_trace_pending_starts(state);
+    }
     for (voice_index = 0u; voice_index < state->voice_count; voice_index++) {
         VTXCMixerVoice *voice = &state->voices[voice_index];
         if (!vtx_c_mixer_voice_slot_is_loaded(voice) ||
@@ -943,6 +1143,9 @@ VTXCMixerStatus vtx_c_mixer_stop_voices_for_channel_tag(
             voice->channel_tag != channel_tag) {
             continue;
         }
+        if (state->trace_ring != NULL && voice->active) {
+            vtx_c_mixer_trace(state, VTX_C_TRACE_KIND_VOICE_STOP, 0u, state->current_frame, voice_index, 0u, 0.0f, 0.0f);
+        }
         vtx_c_mixer_remove_voice_state_events_for_voice(state, voice_index);
         vtx_c_mixer_release_voice(voice);
         stopped_count++;
@@ -965,6 +1168,9 @@ VTXCMixerStatus vtx_c_mixer_ramp_down_voices_for_channel_tag(
     if (state == NULL || ramp_frame_count == 0u) {
         return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
     }
+    if (state->trace_ring != NULL) {
+        vtx_c_mixer_trace_pending_starts(state);
+    }
     for (voice_index = 0u; voice_index < state->voice_count; voice_index++) {
         VTXCMixerVoice *voice = &state->voices[voice_index];
         if (!vtx_c_mixer_voice_slot_is_loaded(voice) ||
@@ -983,6 +1189,18 @@ VTXCMixerStatus vtx_c_mixer_ramp_down_voices_for_channel_tag(
             ramp_frame_count,
             1
         );
+        if (state->trace_ring != NULL) {
+            vtx_c_mixer_trace(
+                state,
+                VTX_C_TRACE_KIND_VOICE_STEAL,
+                0u,
+                state->current_frame,
+                voice_index,
+                ramp_frame_count,
+                voice->gain_ramp_start,
+                0.0f
+            );
+        }
         ramped_count++;
     }
     if (out_ramped_count != NULL) {
@@ -1090,6 +1308,7 @@ VTXCMixerStatus vtx_c_mixer_add_sample_voice_with_step_at_source_frame(
         0u,
         initial_sample_frame,
         0,
+        0,
         out_voice_index
     );
 }
@@ -1177,10 +1396,106 @@ VTXCMixerStatus vtx_c_mixer_add_scheduled_sample_voice_with_step_at_source_frame
         scheduled_start_frame,
         initial_sample_frame,
         1,
+        0,
         out_voice_index
     );
 }
 
+VTXCMixerStatus vtx_c_mixer_add_scheduled_shared_sample_voice(
+    VTXCMixerState *state,
+    const VTXCMixerSharedSample *sample,
+    double sample_step,
+    uint32_t initial_sample_frame,
+    float gain,
+    float pan,
+    VTXCMixerLoopMode loop_mode,
+    uint32_t loop_start_frame,
+    uint32_t loop_end_frame,
+    uint64_t scheduled_start_frame,
+    uint32_t *out_voice_index
+) {
+    const VTXCMixerSamplePyramid *pyramid;
+    VTXCMixerVoice *voice;
+    uint32_t voice_index = 0u;
+    VTXCMixerStatus status;
+
+    if (sample == NULL) {
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    status = vtx_c_mixer_add_sample_voice_internal(
+        state,
+        sample->pcm,
+        sample->frame_count,
+        sample_step,
+        gain,
+        pan,
+        loop_mode,
+        loop_start_frame,
+        loop_end_frame,
+        scheduled_start_frame,
+        initial_sample_frame,
+        1,
+        1,
+        &voice_index
+    );
+    if (status != VTX_C_MIXER_STATUS_OK) {
+        return status;
+    }
+    // A pyramid built for another loop would blend the wrong continuation into
+    // the loop seam, so such voices keep reading the source sample.
+    voice = &state->voices[voice_index];
+    pyramid = sample->pyramid;
+    if (pyramid != NULL &&
+        pyramid->source_pcm == sample->pcm &&
+        pyramid->frame_count == voice->sample_frame_count &&
+        pyramid->loop_mode == voice->loop_mode &&
+        pyramid->loop_start_frame == voice->loop_start_frame &&
+        pyramid->loop_end_frame == voice->loop_end_frame) {
+        voice->sample_pyramid = pyramid;
+        vtx_c_mixer_select_sample_level(voice);
+    }
+    if (out_voice_index != NULL) {
+        *out_voice_index = voice_index;
+    }
+    return VTX_C_MIXER_STATUS_OK;
+}
+
+uint32_t vtx_c_mixer_voice_sample_level(const VTXCMixerState *state, uint32_t voice_index) {
+    if (state == NULL || voice_index >= state->voice_count) {
+        return 0u;
+    }
+    return state->voices[voice_index].sample_level;
+}
+
+int vtx_c_mixer_voice_is_active(const VTXCMixerState *state, uint32_t voice_index) {
+    if (state == NULL || voice_index >= state->voice_count) {
+        return 0;
+    }
+    return state->voices[voice_index].active;
+}
+
+VTXCMixerStatus vtx_c_mixer_release_inactive_voices(VTXCMixerState *state, uint32_t *out_released_count) {
+    uint32_t voice_index;
+    uint32_t released_count = 0u;
+
+    if (state == NULL) {
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    for (voice_index = 0u; voice_index < state->voice_count; voice_index++) {
+        VTXCMixerVoice *voice = &state->voices[voice_index];
+        if (!vtx_c_mixer_voice_slot_is_loaded(voice) || voice->active) {
+            continue;
+        }
+        vtx_c_mixer_remove_voice_state_events_for_voice(state, voice_index);
+        vtx_c_mixer_release_voice(voice);
+        released_count++;
+    }
+    if (out_released_count != NULL) {
+        *out_released_count = released_count;
+    }
+    return VTX_C_MIXER_STATUS_OK;
+}
+
 VTXCMixerStatus vtx_c_mixer_set_voice_volume_envelope(
     VTXCMixerState *state,
     uint32_t voice_index,
@@ -1464,27 +1779,173 @@ VTXCMixerStatus vtx_c_mixer_schedule_voice_gain_pan_update_immediate(
     );
 }
 
-VTXCMixerStatus vtx_c_mixer_render(
-    VTXCMixerState *state,
+static void vtx_c_mixer_mix_voice_frame(
+    VTXCMixerVoice *voice,
+    float *output_frame,
+    size_t channel_count_size,
+    uint64_t absolute_frame
+) {
+    uint32_t source_index;
+    float mono_sample;
+
+    if (!voice->active) {
+        return;
+    }
+    if (absolute_frame < voice->scheduled_start_frame) {
+        return;
+    }
+    vtx_c_mixer_update_voice_key_state(voice, absolute_frame);
+    if (voice->sample_position < 0.0 || voice->sample_position > (double)UINT32_MAX) {
+        voice->active = 0;
+        voice->end_frame = absolute_frame;
+        return;
+    }
+    source_index = (uint32_t)voice->sample_position;
+    if (voice->sample_pcm == NULL || source_index >= voice->sample_frame_count) {
+        voice->active = 0;
+        voice->end_frame = absolute_frame;
+        return;
+    }
+
+    mono_sample = vtx_c_mixer_linear_interpolated_sample(voice, source_index) *
+        vtx_c_mixer_effective_gain(voice) *
+        vtx_c_mixer_evaluate_envelope(&voice->volume_envelope, 1.0f) *
+        voice->fadeout_value;
+    if (channel_count_size == 1) {
+        output_frame[0] += mono_sample;
+    } else {
+        float effective_pan = vtx_c_mixer_sanitized_pan(
+            vtx_c_mixer_effective_pan(voice) +
+            vtx_c_mixer_evaluate_envelope(&voice->pan_envelope, 0.0f)
+        );
+        output_frame[0] += mono_sample * vtx_c_mixer_left_pan_gain(effective_pan);
+        output_frame[1] += mono_sample * vtx_c_mixer_right_pan_gain(effective_pan);
+    }
+
+    vtx_c_mixer_advance_sample_position(voice);
+    vtx_c_mixer_advance_voice_envelopes(voice);
+    vtx_c_mixer_advance_value_ramps(voice);
+    vtx_c_mixer_advance_voice_fadeout(voice);
+    if (!voice->active) {
+        voice->end_frame = absolute_frame + 1u;
+    }
+}
+
+// A voice whose gain, pan and fadeout cannot change inside a segment. Its
+// per-frame contribution then reduces to interpolation times hoisted gains.
+static int vtx_c_mixer_voice_has_static_mix(const VTXCMixerVoice *voice) {
+    return !voice->gain_ramp_active &&
+        !voice->pan_ramp_active &&
+        !voice->volume_envelope.enabled &&
+        !voice->pan_envelope.enabled &&
+        voice->fadeout_decrement_per_frame <= 0.0f;
+}
+
+static void vtx_c_mixer_mix_static_voice_segment(
+    VTXCMixerVoice *voice,
     float *output_interleaved_float32,
-    uint32_t frame_count
+    size_t channel_count_size,
+    uint64_t segment_start_frame,
+    uint32_t segment_frame_count
 ) {
-    size_t frame_count_size;
-    size_t channel_count_size;
-    size_t sample_count;
-    size_t byte_count;
-    size_t frame_index;
-    uint32_t voice_index;
+    uint32_t frame_index = 0u;
+    uint64_t last_mixed_frame = 0u;
+    int mixed_any_frame = 0;
+    float gain = voice->gain;
+    float fadeout_value = voice->fadeout_value;
+    float effective_pan = vtx_c_mixer_sanitized_pan(voice->pan + 0.0f);
+    float left_gain = vtx_c_mixer_left_pan_gain(effective_pan);
+    float right_gain = vtx_c_mixer_right_pan_gain(effective_pan);
+
+    if (voice->scheduled_start_frame > segment_start_frame) {
+        uint64_t delay = voice->scheduled_start_frame - segment_start_frame;
+        if (delay >= segment_frame_count) {
+            return;
+        }
+        frame_index = (uint32_t)delay;
+    }
 
-    if (state == NULL) {
-        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    for (; frame_index < segment_frame_count; frame_index++) {
+        float *output_frame = output_interleaved_float32 + ((size_t)frame_index * channel_count_size);
+        uint32_t source_index;
+        float mono_sample;
+
+        last_mixed_frame = segment_start_frame + frame_index;
+        mixed_any_frame = 1;
+        if (voice->sample_position < 0.0 || voice->sample_position > (double)UINT32_MAX) {
+            voice->active = 0;
+            voice->end_frame = last_mixed_frame;
+            break;
+        }
+        source_index = (uint32_t)voice->sample_position;
+        if (voice->sample_pcm == NULL || source_index >= voice->sample_frame_count) {
+            voice->active = 0;
+            voice->end_frame = last_mixed_frame;
+            break;
+        }
+
+        // Same operand order as the reference kernel: the disabled volume
+        // envelope contributes an exact 1.0f factor and is omitted.
+        mono_sample = vtx_c_mixer_linear_interpolated_sample(voice, source_index) * gain * fadeout_value;
+        if (channel_count_size == 1) {
+            output_frame[0] += mono_sample;
+        } else {
+            output_frame[0] += mono_sample * left_gain;
+            output_frame[1] += mono_sample * right_gain;
+        }
+
+        vtx_c_mixer_advance_sample_position(voice);
+        if (!voice->active) {
+            voice->end_frame = last_mixed_frame + 1u;
+            break;
+        }
     }
-    if (frame_count == 0) {
-        return VTX_C_MIXER_STATUS_OK;
+    if (mixed_any_frame) {
+        vtx_c_mixer_update_voice_key_state(voice, last_mixed_frame);
     }
-    if (output_interleaved_float32 == NULL) {
-        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+}
+
+static void vtx_c_mixer_mix_voice_segment(
+    VTXCMixerVoice *voice,
+    float *output_interleaved_float32,
+    size_t channel_count_size,
+    uint64_t segment_start_frame,
+    uint32_t segment_frame_count
+) {
+    uint32_t frame_index;
+
+    if (!voice->active) {
+        return;
+    }
+    if (vtx_c_mixer_voice_has_static_mix(voice)) {
+        vtx_c_mixer_mix_static_voice_segment(
+            voice,
+            output_interleaved_float32,
+            channel_count_size,
+            segment_start_frame,
+            segment_frame_count
+        );
+        return;
+    }
+    for (frame_index = 0u; frame_index < segment_frame_count && voice->active; frame_index++) {
+        vtx_c_mixer_mix_voice_frame(
+            voice,
+            output_interleaved_float32 + ((size_t)frame_index * channel_count_size),
+            channel_count_size,
+            segment_start_frame + frame_index
+        );
     }
+}
+
+static VTXCMixerStatus vtx_c_mixer_prepare_render(
+    VTXCMixerState *state,
+    float *output_interleaved_float32,
+    uint32_t frame_count,
+    size_t *out_channel_count_size
+) {
+    size_t frame_count_size;
+    size_t channel_count_size;
+    size_t sample_count;
 
     state->config = vtx_c_mixer_sanitized_config(state->config);
     frame_count_size = (size_t)frame_count;
@@ -1497,56 +1958,990 @@ VTXCMixerStatus vtx_c_mixer_render(
         return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
     }
 
-    byte_count = sample_count * sizeof(float);
-    memset(output_interleaved_float32, 0, byte_count);
+    memset(output_interleaved_float32, 0, sample_count * sizeof(float));
+    *out_channel_count_size = channel_count_size;
+    return VTX_C_MIXER_STATUS_OK;
+}
+
+// Applies the output gain and meters the block in the same pass. Square sums
+// run in four fixed lanes so the loop can vectorize while staying
+// deterministic.
+static void vtx_c_mixer_meter_block(
+    float *samples,
+    size_t sample_count,
+    float gain,
+    VTXCMixerOutputMeter *out_meter
+) {
+    double square_sums[4] = { 0.0, 0.0, 0.0, 0.0 };
+    float peak = 0.0f;
+    uint64_t overrange_count = 0u;
+    uint64_t clipping_count = 0u;
+    int apply_gain = gain != 1.0f;
+    size_t index;
+
+    for (index = 0; index < sample_count; index++) {
+        float sample = samples[index];
+        float magnitude;
+
+        if (apply_gain) {
+            sample *= gain;
+            samples[index] = sample;
+        }
+        magnitude = isfinite(sample) ? fabsf(sample) : 0.0f;
+        peak = magnitude > peak ? magnitude : peak;
+        square_sums[index & 3u] += (double)magnitude * (double)magnitude;
+        overrange_count += magnitude > 1.0f;
+        clipping_count += magnitude >= 1.0f;
+    }
+    out_meter->sample_count = sample_count;
+    out_meter->square_sum = (square_sums[0] + square_sums[1]) + (square_sums[2] + square_sums[3]);
+    out_meter->peak = peak;
+    out_meter->overrange_sample_count = overrange_count;
+    out_meter->clipping_sample_count = clipping_count;
+}
+
+static VTXCMixerStatus vtx_c_mixer_render_frame_major(
+    VTXCMixerState *state,
+    float *output_interleaved_float32,
+    uint32_t frame_count
+) {
+    size_t channel_count_size = 0;
+    size_t frame_index;
+    uint32_t voice_index;
+    VTXCMixerStatus status;
+
+    status = vtx_c_mixer_prepare_render(state, output_interleaved_float32, frame_count, &channel_count_size);
+    if (status != VTX_C_MIXER_STATUS_OK) {
+        return status;
+    }
 
-    for (frame_index = 0; frame_index < frame_count_size; frame_index++) {
-        size_t frame_offset = frame_index * channel_count_size;
+    for (frame_index = 0; frame_index < (size_t)frame_count; frame_index++) {
+        float *output_frame = output_interleaved_float32 + (frame_index * channel_count_size);
         uint64_t absolute_frame = state->current_frame;
         vtx_c_mixer_apply_voice_state_events(state, absolute_frame);
         for (voice_index = 0; voice_index < state->voice_count; voice_index++) {
-            VTXCMixerVoice *voice = &state->voices[voice_index];
-            uint32_t source_index;
-            float mono_sample;
-
-            if (!voice->active) {
-                continue;
-            }
-            if (absolute_frame < voice->scheduled_start_frame) {
-                continue;
-            }
-            vtx_c_mixer_update_voice_key_state(voice, absolute_frame);
-            if (voice->sample_position < 0.0 || voice->sample_position > (double)UINT32_MAX) {
-                voice->active = 0;
-                continue;
-            }
-            source_index = (uint32_t)voice->sample_position;
-            if (voice->sample_pcm == NULL || source_index >= voice->sample_frame_count) {
-                voice->active = 0;
-                continue;
-            }
+            vtx_c_mixer_mix_voice_frame(&state->voices[voice_index], output_frame, channel_count_size, absolute_frame);
+        }
+        vtx_c_mixer_advance_render_cursor(state);
+    }
+    return VTX_C_MIXER_STATUS_OK;
+}
 
-            mono_sample = vtx_c_mixer_linear_interpolated_sample(voice, source_index) *
-                vtx_c_mixer_effective_gain(voice) *
-                vtx_c_mixer_evaluate_envelope(&voice->volume_envelope, 1.0f) *
-                voice->fadeout_value;
-            if (channel_count_size == 1) {
-                output_interleaved_float32[frame_offset] += mono_sample;
-            } else {
-                float effective_pan = vtx_c_mixer_sanitized_pan(
-                    vtx_c_mixer_effective_pan(voice) +
-                    vtx_c_mixer_evaluate_envelope(&voice->pan_envelope, 0.0f)
-                );
-                output_interleaved_float32[frame_offset] += mono_sample * vtx_c_mixer_left_pan_gain(effective_pan);
-                output_interleaved_float32[frame_offset + 1] += mono_sample * vtx_c_mixer_right_pan_gain(effective_pan);
-            }
+// Applies the voice state events due at the current frame and returns how
+// many frames, at most max_frame_count, can render before the next one.
+static uint32_t vtx_c_mixer_begin_segment(VTXCMixerState *state, uint32_t max_frame_count) {
+    uint64_t segment_start_frame = state->current_frame;
+    uint32_t segment_frame_count = max_frame_count;
 
-            vtx_c_mixer_advance_sample_position(voice);
-            vtx_c_mixer_advance_voice_envelopes(voice);
-            vtx_c_mixer_advance_value_ramps(voice);
-            vtx_c_mixer_advance_voice_fadeout(voice);
+    vtx_c_mixer_apply_voice_state_events(state, segment_start_frame);
+    if (state->next_voice_state_event_index < state->voice_state_event_count) {
+        uint64_t next_event_frame = state->voice_state_events[state->next_voice_state_event_index].scheduled_frame;
+        if (next_event_frame - segment_start_frame < (uint64_t)segment_frame_count) {
+            segment_frame_count = (uint32_t)(next_event_frame - segment_start_frame);
         }
+    }
+    if (UINT64_MAX - segment_start_frame < (uint64_t)segment_frame_count) {
+        // Keep the reference cursor saturation semantics at the end of the timeline.
+        segment_frame_count = 1u;
+    }
+    return segment_frame_count;
+}
+
+static void vtx_c_mixer_end_segment(VTXCMixerState *state, uint32_t segment_frame_count) {
+    if (segment_frame_count == 1u) {
         vtx_c_mixer_advance_render_cursor(state);
+    } else {
+        state->current_frame += segment_frame_count;
+    }
+}
+
+// Voice-major rendering over segments bounded by pending voice state events.
+// Events only apply at segment starts, and each output frame still receives
+// voice contributions in ascending voice order, so the result matches the
+// frame-major reference bit for bit.
+static VTXCMixerStatus vtx_c_mixer_render_voice_major(
+    VTXCMixerState *state,
+    float *output_interleaved_float32,
+    uint32_t frame_count
+) {
+    size_t channel_count_size = 0;
+    uint32_t rendered_frames = 0u;
+    uint32_t voice_index;
+    VTXCMixerStatus status;
+
+    status = vtx_c_mixer_prepare_render(state, output_interleaved_float32, frame_count, &channel_count_size);
+    if (status != VTX_C_MIXER_STATUS_OK) {
+        return status;
+    }
+
+    while (rendered_frames < frame_count) {
+        uint64_t segment_start_frame = state->current_frame;
+        uint32_t segment_frame_count = vtx_c_mixer_begin_segment(state, frame_count - rendered_frames);
+        float *segment_output = output_interleaved_float32 + ((size_t)rendered_frames * channel_count_size);
+
+        for (voice_index = 0; voice_index < state->voice_count; voice_index++) {
+            vtx_c_mixer_mix_voice_segment(
+                &state->voices[voice_index],
+                segment_output,
+                channel_count_size,
+                segment_start_frame,
+                segment_frame_count
+            );
+        }
+        vtx_c_mixer_end_segment(state, segment_frame_count);
+        rendered_frames += segment_frame_count;
     }
     return VTX_C_MIXER_STATUS_OK;
 }
+
+// Seqlock-published state of one tapped channel tag. Samples are stored as
+// float bits in relaxed atomics so readers racing the render thread stay
+// well-defined; the sequence is odd while the render thread is writing.
+typedef struct {
+    _Atomic uint32_t sequence;
+    _Atomic uint64_t level_end_frame;
+    _Atomic uint32_t level_frame_count;
+    _Atomic uint32_t level_peak_bits;
+    _Atomic uint32_t level_rms_bits;
+    _Atomic uint64_t scope_end_frame;
+    _Atomic uint32_t *scope_bits;
+    // Render-thread only: this tag's sum over the current chunk and the
+    // running level of the current render call.
+    float *mix;
+    float block_peak;
+    double block_square_sum;
+} VTXCMixerTapTag;
+
+struct VTXCMixerTaps {
+    uint32_t channel_tag_count;
+    uint32_t scope_frame_count;
+    VTXCMixerTapTag *tags;
+    float voice_scratch[VTX_C_MIXER_TAP_BLOCK_FRAMES * 2u];
+};
+
+#define VTX_C_MIXER_TAP_READ_ATTEMPTS 64u
+
+static uint32_t vtx_c_mixer_float_bits(float value) {
+    uint32_t bits;
+
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float vtx_c_mixer_bits_float(uint32_t bits) {
+    float value;
+
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static int vtx_c_mixer_voice_is_tapped(const VTXCMixerTaps *taps, const VTXCMixerVoice *voice) {
+    return voice->has_channel_tag && voice->channel_tag < taps->channel_tag_count;
+}
+
+// Adds a voice rendered alone into scratch to the output and to its tag's mix.
+// scratch starts at +0, so each scratch sample is exactly the voice's
+// contribution and the output sees the same additions, in the same voice
+// order, as the direct kernels.
+static void vtx_c_mixer_tap_accumulate(
+    float *output,
+    size_t channel_count_size,
+    float *tag_mix,
+    const float *scratch,
+    uint32_t frame_count
+) {
+    uint32_t frame_index;
+
+    if (channel_count_size == 1) {
+        for (frame_index = 0u; frame_index < frame_count; frame_index++) {
+            output[frame_index] += scratch[frame_index];
+            tag_mix[frame_index * 2u] += scratch[frame_index];
+            tag_mix[frame_index * 2u + 1u] += scratch[frame_index];
+        }
+        return;
+    }
+    for (frame_index = 0u; frame_index < frame_count; frame_index++) {
+        float *output_frame = output + ((size_t)frame_index * channel_count_size);
+        output_frame[0] += scratch[frame_index * 2u];
+        output_frame[1] += scratch[frame_index * 2u + 1u];
+        tag_mix[frame_index * 2u] += scratch[frame_index * 2u];
+        tag_mix[frame_index * 2u + 1u] += scratch[frame_index * 2u + 1u];
+    }
+}
+
+static void vtx_c_mixer_tap_voice_major_chunk(
+    VTXCMixerState *state,
+    float *output_interleaved_float32,
+    size_t channel_count_size,
+    uint32_t frame_count
+) {
+    VTXCMixerTaps *taps = state->taps;
+    // The kernels only write the first two channels, so tapped voices render
+    // into a stereo (or mono) scratch whatever the output width.
+    size_t scratch_channel_count = channel_count_size == 1 ? 1u : 2u;
+    uint32_t rendered_frames = 0u;
+    uint32_t voice_index;
+
+    while (rendered_frames < frame_count) {
+        uint64_t segment_start_frame = state->current_frame;
+        uint32_t segment_frame_count = vtx_c_mixer_begin_segment(state, frame_count - rendered_frames);
+        float *segment_output = output_interleaved_float32 + ((size_t)rendered_frames * channel_count_size);
+
+        for (voice_index = 0; voice_index < state->voice_count; voice_index++) {
+            VTXCMixerVoice *voice = &state->voices[voice_index];
+            if (!voice->active) {
+                continue;
+            }
+            if (!vtx_c_mixer_voice_is_tapped(taps, voice)) {
+                vtx_c_mixer_mix_voice_segment(
+                    voice,
+                    segment_output,
+                    channel_count_size,
+                    segment_start_frame,
+                    segment_frame_count
+                );
+                continue;
+            }
+            memset(taps->voice_scratch, 0, (size_t)segment_frame_count * scratch_channel_count * sizeof(float));
+            vtx_c_mixer_mix_voice_segment(
+                voice,
+                taps->voice_scratch,
+                scratch_channel_count,
+                segment_start_frame,
+                segment_frame_count
+            );
+            vtx_c_mixer_tap_accumulate(
+                segment_output,
+                channel_count_size,
+                taps->tags[voice->channel_tag].mix + ((size_t)rendered_frames * 2u),
+                taps->voice_scratch,
+                segment_frame_count
+            );
+        }
+        vtx_c_mixer_end_segment(state, segment_frame_count);
+        rendered_frames += segment_frame_count;
+    }
+}
+
+static void vtx_c_mixer_tap_frame_major_chunk(
+    VTXCMixerState *state,
+    float *output_interleaved_float32,
+    size_t channel_count_size,
+    uint32_t frame_count
+) {
+    VTXCMixerTaps *taps = state->taps;
+    size_t scratch_channel_count = channel_count_size == 1 ? 1u : 2u;
+    uint32_t frame_index;
+    uint32_t voice_index;
+
+    for (frame_index = 0u; frame_index < frame_count; frame_index++) {
+        float *output_frame = output_interleaved_float32 + ((size_t)frame_index * channel_count_size);
+        uint64_t absolute_frame = state->current_frame;
+        vtx_c_mixer_apply_voice_state_events(state, absolute_frame);
+        for (voice_index = 0; voice_index < state->voice_count; voice_index++) {
+            VTXCMixerVoice *voice = &state->voices[voice_index];
+            float scratch[2] = { 0.0f, 0.0f };
+            if (!voice->active) {
+                continue;
+            }
+            if (!vtx_c_mixer_voice_is_tapped(taps, voice)) {
+                vtx_c_mixer_mix_voice_frame(voice, output_frame, channel_count_size, absolute_frame);
+                continue;
+            }
+            vtx_c_mixer_mix_voice_frame(voice, scratch, scratch_channel_count, absolute_frame);
+            vtx_c_mixer_tap_accumulate(
+                output_frame,
+                channel_count_size,
+                taps->tags[voice->channel_tag].mix + ((size_t)frame_index * 2u),
+                scratch,
+                1u
+            );
+        }
+        vtx_c_mixer_advance_render_cursor(state);
+    }
+}
+
+// Folds a rendered chunk into each tag's running level and scope ring. Tags
+// with no voice in the chunk publish silence, so meters fall back to zero.
+static void vtx_c_mixer_tap_publish_chunk(VTXCMixerTaps *taps, uint64_t end_frame, uint32_t frame_count) {
+    uint32_t tag_index;
+
+    for (tag_index = 0u; tag_index < taps->channel_tag_count; tag_index++) {
+        VTXCMixerTapTag *tag = &taps->tags[tag_index];
+        uint32_t sequence = atomic_load_explicit(&tag->sequence, memory_order_relaxed);
+        uint64_t first_frame = end_frame - frame_count;
+        uint32_t frame_index;
+
+        atomic_store_explicit(&tag->sequence, sequence + 1u, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        for (frame_index = 0u; frame_index < frame_count; frame_index++) {
+            size_t slot = (size_t)((first_frame + frame_index) % taps->scope_frame_count) * 2u;
+            float left = tag->mix[frame_index * 2u];
+            float right = tag->mix[frame_index * 2u + 1u];
+            float left_magnitude = fabsf(left);
+            float right_magnitude = fabsf(right);
+
+            if (left_magnitude > tag->block_peak) {
+                tag->block_peak = left_magnitude;
+            }
+            if (right_magnitude > tag->block_peak) {
+                tag->block_peak = right_magnitude;
+            }
+            tag->block_square_sum += (double)left * (double)left + (double)right * (double)right;
+            atomic_store_explicit(&tag->scope_bits[slot], vtx_c_mixer_float_bits(left), memory_order_relaxed);
+            atomic_store_explicit(&tag->scope_bits[slot + 1u], vtx_c_mixer_float_bits(right), memory_order_relaxed);
+        }
+        atomic_store_explicit(&tag->scope_end_frame, end_frame, memory_order_relaxed);
+        atomic_store_explicit(&tag->sequence, sequence + 2u, memory_order_release);
+    }
+}
+
+static void vtx_c_mixer_tap_publish_levels(VTXCMixerTaps *taps, uint64_t end_frame, uint32_t frame_count) {
+    uint32_t tag_index;
+
+    for (tag_index = 0u; tag_index < taps->channel_tag_count; tag_index++) {
+        VTXCMixerTapTag *tag = &taps->tags[tag_index];
+        uint32_t sequence = atomic_load_explicit(&tag->sequence, memory_order_relaxed);
+        float rms = (float)sqrt(tag->block_square_sum / ((double)frame_count * 2.0));
+
+        atomic_store_explicit(&tag->sequence, sequence + 1u, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        atomic_store_explicit(&tag->level_end_frame, end_frame, memory_order_relaxed);
+        atomic_store_explicit(&tag->level_frame_count, frame_count, memory_order_relaxed);
+        atomic_store_explicit(&tag->level_peak_bits, vtx_c_mixer_float_bits(tag->block_peak), memory_order_relaxed);
+        atomic_store_explicit(&tag->level_rms_bits, vtx_c_mixer_float_bits(rms), memory_order_relaxed);
+        atomic_store_explicit(&tag->sequence, sequence + 2u, memory_order_release);
+        tag->block_peak = 0.0f;
+        tag->block_square_sum = 0.0;
+    }
+}
+
+// Renders in chunks of VTX_C_MIXER_TAP_BLOCK_FRAMES through the selected
+// engine's loop shape, splitting tapped voices out per tag.
+static VTXCMixerStatus vtx_c_mixer_render_tapped(
+    VTXCMixerState *state,
+    float *output_interleaved_float32,
+    uint32_t frame_count,
+    VTXCMixerRenderEngine engine
+) {
+    VTXCMixerTaps *taps = state->taps;
+    size_t channel_count_size = 0;
+    uint32_t rendered_frames = 0u;
+    VTXCMixerStatus status;
+
+    status = vtx_c_mixer_prepare_render(state, output_interleaved_float32, frame_count, &channel_count_size);
+    if (status != VTX_C_MIXER_STATUS_OK) {
+        return status;
+    }
+
+    while (rendered_frames < frame_count) {
+        uint32_t chunk_frame_count = frame_count - rendered_frames;
+        float *chunk_output = output_interleaved_float32 + ((size_t)rendered_frames * channel_count_size);
+        uint32_t tag_index;
+
+        if (chunk_frame_count > VTX_C_MIXER_TAP_BLOCK_FRAMES) {
+            chunk_frame_count = VTX_C_MIXER_TAP_BLOCK_FRAMES;
+        }
+        for (tag_index = 0u; tag_index < taps->channel_tag_count; tag_index++) {
+            memset(taps->tags[tag_index].mix, 0, (size_t)chunk_frame_count * 2u * sizeof(float));
+        }
+        if (engine == VTX_C_MIXER_RENDER_ENGINE_VOICE_MAJOR) {
+            vtx_c_mixer_tap_voice_major_chunk(state, chunk_output, channel_count_size, chunk_frame_count);
+        } else {
+            vtx_c_mixer_tap_frame_major_chunk(state, chunk_output, channel_count_size, chunk_frame_count);
+        }
+        vtx_c_mixer_tap_publish_chunk(taps, state->current_frame, chunk_frame_count);
+        rendered_frames += chunk_frame_count;
+    }
+    vtx_c_mixer_tap_publish_levels(taps, state->current_frame, frame_count);
+    return VTX_C_MIXER_STATUS_OK;
+}
+
+VTXCMixerStatus vtx_c_mixer_set_render_engine(VTXCMixerState *state, VTXCMixerRenderEngine engine) {
+    if (state == NULL) {
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    switch (engine) {
+    case VTX_C_MIXER_RENDER_ENGINE_REFERENCE:
+    case VTX_C_MIXER_RENDER_ENGINE_VOICE_MAJOR:
+        state->render_engine = engine;
+        return VTX_C_MIXER_STATUS_OK;
+    default:
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+}
+
+VTXCMixerRenderEngine vtx_c_mixer_render_engine(const VTXCMixerState *state) {
+    return state == NULL ? VTX_C_MIXER_RENDER_ENGINE_REFERENCE : state->render_engine;
+}
+
+const char *vtx_c_mixer_render_engine_name(VTXCMixerRenderEngine engine) {
+    switch (engine) {
+    case VTX_C_MIXER_RENDER_ENGINE_VOICE_MAJOR:
+        return "voice_major";
+    case VTX_C_MIXER_RENDER_ENGINE_REFERENCE:
+    default:
+        return "reference";
+    }
+}
+
+// Voice activity and key state before a traced render. Transitions found
+// after the render become VOICE_END and KEY_OFF records; the frames come from
+// the voice, so the kernels only pay for tracing in this outer pass.
+typedef struct {
+    uint64_t active_mask[VTX_C_MIXER_MAX_VOICES / 64u];
+    uint64_t key_on_mask[VTX_C_MIXER_MAX_VOICES / 64u];
+} VTXCMixerTraceSnapshot;
+
+static void vtx_c_mixer_trace_begin_render(
+    VTXCMixerState *state,
+    uint32_t frame_count,
+    VTXCMixerTraceSnapshot *snapshot
+) {
+    uint32_t voice_index;
+
+    memset(snapshot, 0, sizeof(*snapshot));
+    vtx_c_mixer_trace(
+        state,
+        VTX_C_TRACE_KIND_RENDER_BEGIN,
+        0u,
+        state->current_frame,
+        VTX_C_TRACE_NO_VOICE,
+        frame_count,
+        0.0f,
+        0.0f
+    );
+    vtx_c_mixer_trace_pending_starts(state);
+    for (voice_index = 0u; voice_index < state->voice_count; voice_index++) {
+        const VTXCMixerVoice *voice = &state->voices[voice_index];
+        uint64_t bit = (uint64_t)1u << (voice_index % 64u);
+        if (voice->active) {
+            snapshot->active_mask[voice_index / 64u] |= bit;
+        }
+        if (voice->key_on) {
+            snapshot->key_on_mask[voice_index / 64u] |= bit;
+        }
+    }
+}
+
+static void vtx_c_mixer_trace_end_render(VTXCMixerState *state, const VTXCMixerTraceSnapshot *snapshot) {
+    uint32_t voice_index;
+
+    for (voice_index = 0u; voice_index < state->voice_count; voice_index++) {
+        const VTXCMixerVoice *voice = &state->voices[voice_index];
+        uint64_t bit = (uint64_t)1u << (voice_index % 64u);
+        if ((snapshot->key_on_mask[voice_index / 64u] & bit) != 0u && !voice->key_on) {
+            vtx_c_mixer_trace(state, VTX_C_TRACE_KIND_KEY_OFF, 0u, voice->key_off_frame, voice_index, 0u, 0.0f, 0.0f);
+        }
+        if ((snapshot->active_mask[voice_index / 64u] & bit) != 0u && !voice->active) {
+            vtx_c_mixer_trace(state, VTX_C_TRACE_KIND_VOICE_END, 0u, voice->end_frame, voice_index, 0u, 0.0f, 0.0f);
+        }
+    }
+    vtx_c_mixer_trace(
+        state,
+        VTX_C_TRACE_KIND_RENDER_END,
+        0u,
+        state->current_frame,
+        VTX_C_TRACE_NO_VOICE,
+        0u,
+        state->last_render_meter.peak,
+        (float)vtx_c_mixer_output_meter_rms(&state->last_render_meter)
+    );
+}
+
+static VTXCMixerStatus vtx_c_mixer_render_with_engine(
+    VTXCMixerState *state,
+    float *output_interleaved_float32,
+    uint32_t frame_count,
+    VTXCMixerRenderEngine engine
+) {
+    VTXCMixerTraceSnapshot snapshot;
+    VTXCMixerStatus status;
+
+    if (frame_count == 0) {
+        memset(&state->last_render_meter, 0, sizeof(state->last_render_meter));
+        return VTX_C_MIXER_STATUS_OK;
+    }
+    if (output_interleaved_float32 == NULL) {
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    if (state->trace_ring != NULL) {
+        vtx_c_mixer_trace_begin_render(state, frame_count, &snapshot);
+    }
+    if (state->taps != NULL) {
+        status = vtx_c_mixer_render_tapped(state, output_interleaved_float32, frame_count, engine);
+    } else if (engine == VTX_C_MIXER_RENDER_ENGINE_VOICE_MAJOR) {
+        status = vtx_c_mixer_render_voice_major(state, output_interleaved_float32, frame_count);
+    } else {
+        status = vtx_c_mixer_render_frame_major(state, output_interleaved_float32, frame_count);
+    }
+    if (status != VTX_C_MIXER_STATUS_OK) {
+        return status;
+    }
+    vtx_c_mixer_meter_block(
+        output_interleaved_float32,
+        (size_t)frame_count * state->config.channel_count,
+        state->output_gain,
+        &state->last_render_meter
+    );
+    vtx_c_mixer_output_meter_merge(&state->cumulative_meter, &state->last_render_meter);
+    if (state->trace_ring != NULL) {
+        vtx_c_mixer_trace_end_render(state, &snapshot);
+    }
+    return status;
+}
+
+VTXCMixerStatus vtx_c_mixer_render_reference(
+    VTXCMixerState *state,
+    float *output_interleaved_float32,
+    uint32_t frame_count
+) {
+    if (state == NULL) {
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    return vtx_c_mixer_render_with_engine(
+        state,
+        output_interleaved_float32,
+        frame_count,
+        VTX_C_MIXER_RENDER_ENGINE_REFERENCE
+    );
+}
+
+VTXCMixerStatus vtx_c_mixer_render(
+    VTXCMixerState *state,
+    float *output_interleaved_float32,
+    uint32_t frame_count
+) {
+    if (state == NULL) {
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    return vtx_c_mixer_render_with_engine(state, output_interleaved_float32, frame_count, state->render_engine);
+}
+
+VTXCMixerStatus vtx_c_mixer_set_output_gain(VTXCMixerState *state, float gain) {
+    if (state == NULL || !isfinite(gain) || gain < 0.0f) {
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    state->output_gain = gain;
+    return VTX_C_MIXER_STATUS_OK;
+}
+
+float vtx_c_mixer_output_gain(const VTXCMixerState *state) {
+    return state == NULL ? 1.0f : state->output_gain;
+}
+
+VTXCMixerOutputMeter vtx_c_mixer_last_render_meter(const VTXCMixerState *state) {
+    VTXCMixerOutputMeter meter;
+
+    if (state == NULL) {
+        memset(&meter, 0, sizeof(meter));
+        return meter;
+    }
+    return state->last_render_meter;
+}
+
+VTXCMixerOutputMeter vtx_c_mixer_cumulative_output_meter(const VTXCMixerState *state) {
+    VTXCMixerOutputMeter meter;
+
+    if (state == NULL) {
+        memset(&meter, 0, sizeof(meter));
+        return meter;
+    }
+    return state->cumulative_meter;
+}
+
+VTXCMixerStatus vtx_c_mixer_reset_output_meters(VTXCMixerState *state) {
+    if (state == NULL) {
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    memset(&state->last_render_meter, 0, sizeof(state->last_render_meter));
+    memset(&state->cumulative_meter, 0, sizeof(state->cumulative_meter));
+    return VTX_C_MIXER_STATUS_OK;
+}
+
+void vtx_c_mixer_output_meter_merge(VTXCMixerOutputMeter *into, const VTXCMixerOutputMeter *from) {
+    if (into == NULL || from == NULL) {
+        return;
+    }
+    into->sample_count += from->sample_count;
+    into->square_sum += from->square_sum;
+    if (from->peak > into->peak) {
+        into->peak = from->peak;
+    }
+    into->overrange_sample_count += from->overrange_sample_count;
+    into->clipping_sample_count += from->clipping_sample_count;
+}
+
+double vtx_c_mixer_output_meter_rms(const VTXCMixerOutputMeter *meter) {
+    if (meter == NULL || meter->sample_count == 0u) {
+        return 0.0;
+    }
+    return sqrt(meter->square_sum / (double)meter->sample_count);
+}
+
+VTXCMixerStatus vtx_c_mixer_set_trace_ring(VTXCMixerState *state, VTXCTraceRing *ring) {
+    if (state == NULL) {
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    state->trace_ring = ring;
+    memset(state->trace_pending_start_mask, 0, sizeof(state->trace_pending_start_mask));
+    return VTX_C_MIXER_STATUS_OK;
+}
+
+VTXCTraceRing *vtx_c_mixer_trace_ring(const VTXCMixerState *state) {
+    return state == NULL ? NULL : state->trace_ring;
+}
+
+VTXCMixerStatus vtx_c_mixer_taps_create(
+    uint32_t channel_tag_count,
+    uint32_t scope_frame_count,
+    VTXCMixerTaps **out_taps
+) {
+    VTXCMixerTaps *taps;
+    uint32_t tag_index;
+
+    if (out_taps == NULL) {
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    *out_taps = NULL;
+    if (channel_tag_count == 0u ||
+        channel_tag_count > VTX_C_MIXER_MAX_TAP_CHANNEL_TAGS ||
+        scope_frame_count == 0u ||
+        scope_frame_count > VTX_C_MIXER_MAX_TAP_SCOPE_FRAMES) {
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    taps = (VTXCMixerTaps *)calloc(1u, sizeof(*taps));
+    if (taps == NULL) {
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    taps->tags = (VTXCMixerTapTag *)calloc(channel_tag_count, sizeof(*taps->tags));
+    if (taps->tags == NULL) {
+        free(taps);
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    taps->channel_tag_count = channel_tag_count;
+    taps->scope_frame_count = scope_frame_count;
+    for (tag_index = 0u; tag_index < channel_tag_count; tag_index++) {
+        VTXCMixerTapTag *tag = &taps->tags[tag_index];
+        size_t scope_sample_count = (size_t)scope_frame_count * 2u;
+        size_t sample_index;
+
+        atomic_init(&tag->sequence, 0u);
+        atomic_init(&tag->level_end_frame, 0u);
+        atomic_init(&tag->level_frame_count, 0u);
+        atomic_init(&tag->level_peak_bits, 0u);
+        atomic_init(&tag->level_rms_bits, 0u);
+        atomic_init(&tag->scope_end_frame, 0u);
+        tag->scope_bits = (_Atomic uint32_t *)malloc(scope_sample_count * sizeof(*tag->scope_bits));
+        tag->mix = (float *)malloc((size_t)VTX_C_MIXER_TAP_BLOCK_FRAMES * 2u * sizeof(float));
+        if (tag->scope_bits == NULL || tag->mix == NULL) {
+            vtx_c_mixer_taps_free(taps);
+            return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+        }
+        for (sample_index = 0u; sample_index < scope_sample_count; sample_index++) {
+            atomic_init(&tag->scope_bits[sample_index], 0u);
+        }
+    }
+    *out_taps = taps;
+    return VTX_C_MIXER_STATUS_OK;
+}
+
+void vtx_c_mixer_taps_free(VTXCMixerTaps *taps) {
+    uint32_t tag_index;
+
+    if (taps == NULL) {
+        return;
+    }
+    for (tag_index = 0u; tag_index < taps->channel_tag_count; tag_index++) {
+        free((void *)taps->tags[tag_index].scope_bits);
+        free(taps->tags[tag_index].mix);
+    }
+    free(taps->tags);
+    free(taps);
+}
+
+uint32_t vtx_c_mixer_taps_channel_tag_count(const VTXCMixerTaps *taps) {
+    return taps == NULL ? 0u : taps->channel_tag_count;
+}
+
+uint32_t vtx_c_mixer_taps_scope_frame_count(const VTXCMixerTaps *taps) {
+    return taps == NULL ? 0u : taps->scope_frame_count;
+}
+
+VTXCMixerStatus vtx_c_mixer_set_taps(VTXCMixerState *state, VTXCMixerTaps *taps) {
+    if (state == NULL) {
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    state->taps = taps;
+    return VTX_C_MIXER_STATUS_OK;
+}
+
+VTXCMixerTaps *vtx_c_mixer_taps(const VTXCMixerState *state) {
+    return state == NULL ? NULL : state->taps;
+}
+
+VTXCMixerStatus vtx_c_mixer_taps_read_level(
+    const VTXCMixerTaps *taps,
+    uint32_t channel_tag,
+    VTXCMixerTapLevel *out_level
+) {
+    VTXCMixerTapTag *tag;
+    uint32_t attempt;
+
+    if (taps == NULL || out_level == NULL || channel_tag >= taps->channel_tag_count) {
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    tag = &taps->tags[channel_tag];
+    for (attempt = 0u; attempt < VTX_C_MIXER_TAP_READ_ATTEMPTS; attempt++) {
+        uint32_t sequence = atomic_load_explicit(&tag->sequence, memory_order_acquire);
+        VTXCMixerTapLevel level;
+
+        if ((sequence & 1u) != 0u) {
+            continue;
+        }
+        level.end_frame = atomic_load_explicit(&tag->level_end_frame, memory_order_relaxed);
+        level.frame_count = atomic_load_explicit(&tag->level_frame_count, memory_order_relaxed);
+        level.peak = vtx_c_mixer_bits_float(atomic_load_explicit(&tag->level_peak_bits, memory_order_relaxed));
+        level.rms = vtx_c_mixer_bits_float(atomic_load_explicit(&tag->level_rms_bits, memory_order_relaxed));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&tag->sequence, memory_order_relaxed) == sequence) {
+            *out_level = level;
+            return VTX_C_MIXER_STATUS_OK;
+        }
+    }
+    return VTX_C_MIXER_STATUS_BUSY;
+}
+
+VTXCMixerStatus vtx_c_mixer_taps_read_scope(
+    const VTXCMixerTaps *taps,
+    uint32_t channel_tag,
+    float *out_interleaved_stereo,
+    uint32_t frame_count,
+    uint64_t *out_end_frame
+) {
+    VTXCMixerTapTag *tag;
+    uint32_t attempt;
+
+    if (taps == NULL ||
+        channel_tag >= taps->channel_tag_count ||
+        (out_interleaved_stereo == NULL && frame_count > 0u) ||
+        frame_count > taps->scope_frame_count) {
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    tag = &taps->tags[channel_tag];
+    for (attempt = 0u; attempt < VTX_C_MIXER_TAP_READ_ATTEMPTS; attempt++) {
+        uint32_t sequence = atomic_load_explicit(&tag->sequence, memory_order_acquire);
+        uint64_t end_frame;
+        uint32_t frame_index;
+
+        if ((sequence & 1u) != 0u) {
+            continue;
+        }
+        end_frame = atomic_load_explicit(&tag->scope_end_frame, memory_order_relaxed);
+        for (frame_index = 0u; frame_index < frame_count; frame_index++) {
+            uint64_t back = (uint64_t)(frame_count - frame_index);
+            float *out_frame = out_interleaved_stereo + ((size_t)frame_index * 2u);
+            size_t slot;
+
+            if (back > end_frame) {
+                out_frame[0] = 0.0f;
+                out_frame[1] = 0.0f;
+                continue;
+            }
+            slot = (size_t)((end_frame - back) % taps->scope_frame_count) * 2u;
+            out_frame[0] = vtx_c_mixer_bits_float(atomic_load_explicit(&tag->scope_bits[slot], memory_order_relaxed));
+            out_frame[1] = vtx_c_mixer_bits_float(atomic_load_explicit(&tag->scope_bits[slot + 1u], memory_order_relaxed));
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&tag->sequence, memory_order_relaxed) == sequence) {
+            if (out_end_frame != NULL) {
+                *out_end_frame = end_frame;
+            }
+            return VTX_C_MIXER_STATUS_OK;
+        }
+    }
+    return VTX_C_MIXER_STATUS_BUSY;
+}
+
+// Half-width of the decimation filter, in output frames of the level it builds.
+#define VTX_C_MIXER_PYRAMID_FILTER_HALF_WIDTH 6
+// Cutoff as a fraction of the level's Nyquist frequency, leaving room for the
+// window's transition band.
+#define VTX_C_MIXER_PYRAMID_FILTER_CUTOFF 0.9
+
+static int64_t vtx_c_mixer_positive_modulo(int64_t value, int64_t modulus) {
+    int64_t result = value % modulus;
+    return result < 0 ? result + modulus : result;
+}
+
+// Maps any signed frame offset into the loop as the voice would play it:
+// wrapped for forward loops and mirrored about the end frames for ping-pong.
+static uint32_t vtx_c_mixer_pyramid_loop_frame(const VTXCMixerSamplePyramid *pyramid, int64_t frame) {
+    int64_t loop_start = (int64_t)pyramid->loop_start_frame;
+    int64_t offset;
+
+    if (pyramid->loop_mode == VTX_C_MIXER_LOOP_PING_PONG) {
+        int64_t span = (int64_t)pyramid->loop_end_frame - 1 - loop_start;
+        offset = vtx_c_mixer_positive_modulo(frame - loop_start, span * 2);
+        if (offset > span) {
+            offset = span * 2 - offset;
+        }
+    } else {
+        offset = vtx_c_mixer_positive_modulo(frame - loop_start, (int64_t)pyramid->loop_end_frame - loop_start);
+    }
+    return (uint32_t)(loop_start + offset);
+}
+
+// The signal the filter sees around a level frame centred at center_frame.
+// Inside the loop both neighbours come from the loop itself; before it the
+// sample is read as stored, with silence before frame 0 and after the end of
+// an unlooped sample.
+static float vtx_c_mixer_pyramid_source_frame(
+    const VTXCMixerSamplePyramid *pyramid,
+    int64_t center_frame,
+    int64_t frame
+) {
+    int looped = pyramid->loop_mode != VTX_C_MIXER_LOOP_NONE;
+
+    if (looped && center_frame >= (int64_t)pyramid->loop_start_frame) {
+        return pyramid->source_pcm[vtx_c_mixer_pyramid_loop_frame(pyramid, frame)];
+    }
+    if (frame < 0) {
+        return 0.0f;
+    }
+    if (frame < (int64_t)pyramid->frame_count && (!looped || frame < (int64_t)pyramid->loop_end_frame)) {
+        return pyramid->source_pcm[frame];
+    }
+    return looped ? pyramid->source_pcm[vtx_c_mixer_pyramid_loop_frame(pyramid, frame)] : 0.0f;
+}
+
+// Blackman-windowed sinc low-pass for decimation by factor, normalized to unit
+// DC gain. taps holds 2 * half_width + 1 coefficients.
+static void vtx_c_mixer_pyramid_filter(double *taps, int64_t half_width, uint32_t factor) {
+    const double pi = 3.14159265358979323846;
+    double cutoff = VTX_C_MIXER_PYRAMID_FILTER_CUTOFF * 0.5 / (double)factor;
+    double sum = 0.0;
+    int64_t tap;
+
+    for (tap = -half_width; tap <= half_width; tap++) {
+        double x = (double)tap;
+        double window_phase = pi * (x + (double)half_width) / (double)half_width;
+        double window = 0.42 - 0.5 * cos(window_phase) + 0.08 * cos(2.0 * window_phase);
+        double sinc = tap == 0 ? 1.0 : sin(2.0 * pi * cutoff * x) / (2.0 * pi * cutoff * x);
+        taps[tap + half_width] = 2.0 * cutoff * sinc * window;
+        sum += taps[tap + half_width];
+    }
+    for (tap = 0; tap <= half_width * 2; tap++) {
+        taps[tap] /= sum;
+    }
+}
+
+static int vtx_c_mixer_pyramid_build_level(VTXCMixerSamplePyramid *pyramid, uint32_t level) {
+    uint32_t factor = 1u << level;
+    int64_t half_width = (int64_t)VTX_C_MIXER_PYRAMID_FILTER_HALF_WIDTH * factor;
+    uint32_t frame_count = ((pyramid->frame_count - 1u) >> level) + 2u;
+    int looped = pyramid->loop_mode != VTX_C_MIXER_LOOP_NONE;
+    double *taps;
+    float *pcm;
+    uint32_t level_frame;
+
+    taps = (double *)malloc((size_t)(half_width * 2 + 1) * sizeof(*taps));
+    pcm = (float *)malloc((size_t)frame_count * sizeof(*pcm));
+    if (taps == NULL || pcm == NULL) {
+        free(taps);
+        free(pcm);
+        return 0;
+    }
+    vtx_c_mixer_pyramid_filter(taps, half_width, factor);
+    for (level_frame = 0u; level_frame < frame_count; level_frame++) {
+        int64_t center = (int64_t)level_frame * factor;
+        int64_t direct_start = 0;
+        int64_t direct_end = looped ? (int64_t)pyramid->loop_end_frame : (int64_t)pyramid->frame_count;
+        double sum = 0.0;
+        int64_t tap;
+
+        if (looped && center >= (int64_t)pyramid->loop_start_frame) {
+            direct_start = (int64_t)pyramid->loop_start_frame;
+        }
+        if (center - half_width >= direct_start && center + half_width < direct_end) {
+            // Every tap reads a stored frame as is: the common case away from
+            // the sample edges and loop seams.
+            const float *source = pyramid->source_pcm + (center - half_width);
+            for (tap = 0; tap <= half_width * 2; tap++) {
+                sum += taps[tap] * (double)source[tap];
+            }
+        } else {
+            for (tap = -half_width; tap <= half_width; tap++) {
+                sum += taps[tap + half_width] * (double)vtx_c_mixer_pyramid_source_frame(pyramid, center, center + tap);
+            }
+        }
+        pcm[level_frame] = (float)sum;
+    }
+    free(taps);
+    pyramid->level_pcm[level - 1u] = pcm;
+    pyramid->byte_count += (size_t)frame_count * sizeof(*pcm);
+    return 1;
+}
+
+VTXCMixerStatus vtx_c_mixer_sample_pyramid_create(
+    const VTXCMixerSharedSample *sample,
+    VTXCMixerLoopMode loop_mode,
+    uint32_t loop_start_frame,
+    uint32_t loop_end_frame,
+    uint32_t level_count,
+    VTXCMixerSamplePyramid **out_pyramid
+) {
+    VTXCMixerSamplePyramid *pyramid;
+    uint32_t level;
+
+    if (out_pyramid == NULL) {
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    *out_pyramid = NULL;
+    if (sample == NULL ||
+        sample->pcm == NULL ||
+        sample->frame_count == 0u ||
+        level_count == 0u ||
+        level_count > VTX_C_MIXER_MAX_SAMPLE_PYRAMID_LEVELS) {
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    pyramid = (VTXCMixerSamplePyramid *)calloc(1u, sizeof(*pyramid));
+    if (pyramid == NULL) {
+        return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+    }
+    vtx_c_mixer_sanitize_loop(&loop_mode, &loop_start_frame, &loop_end_frame, sample->frame_count);
+    pyramid->source_pcm = sample->pcm;
+    pyramid->frame_count = sample->frame_count;
+    pyramid->loop_mode = loop_mode;
+    pyramid->loop_start_frame = loop_start_frame;
+    pyramid->loop_end_frame = loop_end_frame;
+    for (level = 1u; level <= level_count && ((sample->frame_count - 1u) >> level) > 0u; level++) {
+        if (!vtx_c_mixer_pyramid_build_level(pyramid, level)) {
+            vtx_c_mixer_sample_pyramid_free(pyramid);
+            return VTX_C_MIXER_STATUS_INVALID_ARGUMENT;
+        }
+        pyramid->level_count = level;
+    }
+    *out_pyramid = pyramid;
+    return VTX_C_MIXER_STATUS_OK;
+}
+
+void vtx_c_mixer_sample_pyramid_free(VTXCMixerSamplePyramid *pyramid) {
+    uint32_t level;
+
+    if (pyramid == NULL) {
+        return;
+    }
+    for (level = 0u; level < VTX_C_MIXER_MAX_SAMPLE_PYRAMID_LEVELS; level++) {
+        free(pyramid->level_pcm[level]);
+    }
+    free(pyramid);
+}
+
+uint32_t vtx_c_mixer_sample_pyramid_level_count(const VTXCMixerSamplePyramid *pyramid) {
+    return pyramid == NULL ? 0u : pyramid->level_count;
+}
+
+size_t vtx_c_mixer_sample_pyramid_byte_count(const VTXCMixerSamplePyramid *pyramid) {
+    return pyramid == NULL ? 0u : pyramid->byte_count;
+}
@@ -0,0 +1,424 @@
+#include "vtx_c_sink.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#define VTX_C_SINK_MAX_CHANNELS 64u
+#define VTX_C_SINK_MAX_BUFFER_FRAMES (1u << 20)
+
+typedef struct {
+    uint8_t *bytes;
+    size_t length;
+} VTXCSinkBuffer;
+
+struct VTXCSink {
+    int fd;
+    int owns_fd;
+    int seekable;
+    off_t header_offset;
+    VTXCSinkConfig config;
+    uint32_t bytes_per_frame;
+    size_t buffer_capacity;
+    uint64_t frame_count;
+    uint64_t data_bytes;
+    VTXCSinkStatus status;
+
+    // The caller fills buffers[filling]. With a writer thread the other
+    // buffer is either idle or owned by the thread while pending is set.
+    VTXCSinkBuffer buffers[2];
+    uint32_t filling;
+
+    int has_writer;
+    pthread_t writer;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    int pending;
+    uint32_t pending_index;
+    int stopping;
+    VTXCSinkStatus writer_status;
+};
+
+static void vtx_c_sink_put_le16(uint8_t *out, uint16_t value) {
+    out[0] = (uint8_t)(value & 0xFFu);
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static void vtx_c_sink_put_le32(uint8_t *out, uint32_t value) {
+    vtx_c_sink_put_le16(out, (uint16_t)(value & 0xFFFFu));
+    vtx_c_sink_put_le16(out + 2, (uint16_t)(value >> 16));
+}
+
+static uint32_t vtx_c_sink_bytes_per_sample(VTXCSinkFormat format) {
+    return format == VTX_C_SINK_FORMAT_FLOAT32 ? 4u : 2u;
+}
+
+static int16_t vtx_c_sink_pcm16_sample(float sample) {
+    if (!isfinite(sample)) {
+        return 0;
+    }
+    if (sample <= -1.0f) {
+        return INT16_MIN;
+    }
+    if (sample >= 1.0f) {
+        return INT16_MAX;
+    }
+    return (int16_t)lround((double)sample * 32767.0);
+}
+
+static void vtx_c_sink_put_float(uint8_t *out, float sample) {
+    uint32_t bits;
+
+    if (!isfinite(sample)) {
+        sample = 0.0f;
+    }
+    memcpy(&bits, &sample, sizeof(bits));
+    vtx_c_sink_put_le32(out, bits);
+}
+
+static VTXCSinkStatus vtx_c_sink_write_all(int fd, const uint8_t *bytes, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, bytes, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return VTX_C_SINK_STATUS_IO_ERROR;
+        }
+        bytes += written;
+        length -= (size_t)written;
+    }
+    return VTX_C_SINK_STATUS_OK;
+}
+
+static void vtx_c_sink_wav_header(const VTXCSink *sink, int final, uint8_t header[VTX_C_SINK_WAV_HEADER_BYTES]) {
+    uint64_t riff_size = sink->data_bytes + VTX_C_SINK_WAV_HEADER_BYTES - 8u;
+    uint32_t riff_field = UINT32_MAX;
+    uint32_t data_field = UINT32_MAX;
+    uint32_t block_align = sink->bytes_per_frame;
+
+    if (final) {
+        riff_field = riff_size > UINT32_MAX ? UINT32_MAX : (uint32_t)riff_size;
+        data_field = sink->data_bytes > UINT32_MAX ? UINT32_MAX : (uint32_t)sink->data_bytes;
+    }
+    memcpy(header, "RIFF", 4);
+    vtx_c_sink_put_le32(header + 4, riff_field);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    vtx_c_sink_put_le32(header + 16, 16u);
+    vtx_c_sink_put_le16(header + 20, sink->config.format == VTX_C_SINK_FORMAT_FLOAT32 ? 3u : 1u);
+    vtx_c_sink_put_le16(header + 22, (uint16_t)sink->config.channel_count);
+    vtx_c_sink_put_le32(header + 24, sink->config.sample_rate);
+    vtx_c_sink_put_le32(header + 28, sink->config.sample_rate * block_align);
+    vtx_c_sink_put_le16(header + 32, (uint16_t)block_align);
+    vtx_c_sink_put_le16(header + 34, (uint16_t)(vtx_c_sink_bytes_per_sample(sink->config.format) * 8u));
+    memcpy(header + 36, "data", 4);
+    vtx_c_sink_put_le32(header + 40, data_field);
+}
+
+static void *vtx_c_sink_writer_main(void *context) {
+    VTXCSink *sink = (VTXCSink *)context;
+
+    pthread_mutex_lock(&sink->lock);
+    for (;;) {
+        VTXCSinkBuffer *buffer;
+        VTXCSinkStatus status;
+
+        while (!sink->pending && !sink->stopping) {
+            pthread_cond_wait(&sink->changed, &sink->lock);
+        }
+        if (!sink->pending) {
+            break;
+        }
+        buffer = &sink->buffers[sink->pending_index];
+        pthread_mutex_unlock(&sink->lock);
+
+        status = vtx_c_sink_write_all(sink->fd, buffer->bytes, buffer->length);
+
+        pthread_mutex_lock(&sink->lock);
+        if (status != VTX_C_SINK_STATUS_OK && sink->writer_status == VTX_C_SINK_STATUS_OK) {
+            sink->writer_status = status;
+        }
+        buffer->length = 0;
+        sink->pending = 0;
+        pthread_cond_broadcast(&sink->changed);
+    }
+    pthread_mutex_unlock(&sink->lock);
+    return NULL;
+}
+
+// Waits for the writer thread to finish its buffer and takes its status.
+static void vtx_c_sink_wait_for_writer(VTXCSink *sink) {
+    pthread_mutex_lock(&sink->lock);
+    while (sink->pending) {
+        pthread_cond_wait(&sink->changed, &sink->lock);
+    }
+    if (sink->status == VTX_C_SINK_STATUS_OK) {
+        sink->status = sink->writer_status;
+    }
+    pthread_mutex_unlock(&sink->lock);
+}
+
+// Hands the filling buffer to the writer thread, or writes it inline.
+static void vtx_c_sink_flush_buffer(VTXCSink *sink) {
+    VTXCSinkBuffer *buffer = &sink->buffers[sink->filling];
+
+    if (buffer->length == 0) {
+        return;
+    }
+    if (!sink->has_writer) {
+        if (sink->status == VTX_C_SINK_STATUS_OK) {
+            sink->status = vtx_c_sink_write_all(sink->fd, buffer->bytes, buffer->length);
+        }
+        buffer->length = 0;
+        return;
+    }
+    vtx_c_sink_wait_for_writer(sink);
+    if (sink->status != VTX_C_SINK_STATUS_OK) {
+        buffer->length = 0;
+        return;
+    }
+    pthread_mutex_lock(&sink->lock);
+    sink->pending = 1;
+    sink->pending_index = sink->filling;
+    pthread_cond_broadcast(&sink->changed);
+    pthread_mutex_unlock(&sink->lock);
+    sink->filling ^= 1u;
+}
+
+static VTXCSinkStatus vtx_c_sink_append(
+    VTXCSink *sink,
+    const float *float_samples,
+    const int16_t *int16_samples,
+    uint32_t frame_count
+) {
+    uint32_t channels;
+    uint32_t bytes_per_sample;
+    size_t sample_index = 0;
+    size_t sample_count;
+
+    if (sink == NULL || (float_samples == NULL && int16_samples == NULL && frame_count > 0)) {
+        return VTX_C_SINK_STATUS_INVALID_ARGUMENT;
+    }
+    if (sink->status != VTX_C_SINK_STATUS_OK) {
+        return sink->status;
+    }
+    channels = sink->config.channel_count;
+    bytes_per_sample = vtx_c_sink_bytes_per_sample(sink->config.format);
+    sample_count = (size_t)frame_count * channels;
+
+    while (sample_index < sample_count) {
+        VTXCSinkBuffer *buffer = &sink->buffers[sink->filling];
+        size_t room = (sink->buffer_capacity - buffer->length) / bytes_per_sample;
+        size_t chunk = sample_count - sample_index;
+        uint8_t *out = buffer->bytes + buffer->length;
+        size_t index;
+
+        if (chunk > room) {
+            chunk = room;
+        }
+        if (sink->config.format == VTX_C_SINK_FORMAT_FLOAT32) {
+            for (index = 0; index < chunk; index++) {
+                float sample = float_samples != NULL
+                    ? float_samples[sample_index + index]
+                    : (float)int16_samples[sample_index + index] / 32768.0f;
+                vtx_c_sink_put_float(out + index * 4u, sample);
+            }
+        } else {
+            for (index = 0; index < chunk; index++) {
+                int16_t sample = float_samples != NULL
+                    ? vtx_c_sink_pcm16_sample(float_samples[sample_index + index])
+                    : int16_samples[sample_index + index];
+                vtx_c_sink_put_le16(out + index * 2u, (uint16_t)sample);
+            }
+        }
+        buffer->length += chunk * bytes_per_sample;
+        sample_index += chunk;
+        if (buffer->length == sink->buffer_capacity) {
+            vtx_c_sink_flush_buffer(sink);
+            if (sink->status != VTX_C_SINK_STATUS_OK) {
+                return sink->status;
+            }
+        }
+    }
+    sink->frame_count += frame_count;
+    sink->data_bytes += (uint64_t)sample_count * bytes_per_sample;
+    return VTX_C_SINK_STATUS_OK;
+}
+
+static void vtx_c_sink_release(VTXCSink *sink) {
+    if (sink->has_writer) {
+        pthread_mutex_lock(&sink->lock);
+        sink->stopping = 1;
+        pthread_cond_broadcast(&sink->changed);
+        pthread_mutex_unlock(&sink->lock);
+        pthread_join(sink->writer, NULL);
+        pthread_cond_destroy(&sink->changed);
+        pthread_mutex_destroy(&sink->lock);
+    }
+    if (sink->owns_fd) {
+        close(sink->fd);
+    }
+    free(sink->buffers[0].bytes);
+    free(sink->buffers[1].bytes);
+    free(sink);
+}
+
+VTXCSinkConfig vtx_c_sink_default_config(void) {
+    VTXCSinkConfig config;
+
+    memset(&config, 0, sizeof(config));
+    config.sample_rate = 44100u;
+    config.channel_count = 2u;
+    config.format = VTX_C_SINK_FORMAT_PCM16;
+    config.container = VTX_C_SINK_CONTAINER_WAV;
+    config.buffer_frames = VTX_C_SINK_DEFAULT_BUFFER_FRAMES;
+    return config;
+}
+
+static VTXCSinkStatus vtx_c_sink_open(int fd, int owns_fd, VTXCSinkConfig config, VTXCSink **out_sink) {
+    VTXCSink *sink;
+    uint32_t buffer_count;
+
+    sink = (VTXCSink *)calloc(1u, sizeof(*sink));
+    if (sink == NULL) {
+        if (owns_fd) {
+            close(fd);
+        }
+        return VTX_C_SINK_STATUS_OUT_OF_MEMORY;
+    }
+    sink->fd = fd;
+    sink->owns_fd = owns_fd;
+    sink->config = config;
+    sink->bytes_per_frame = config.channel_count * vtx_c_sink_bytes_per_sample(config.format);
+    sink->buffer_capacity = (size_t)config.buffer_frames * sink->bytes_per_frame;
+    sink->header_offset = lseek(fd, 0, SEEK_CUR);
+    sink->seekable = sink->header_offset >= 0;
+
+    buffer_count = config.background_writer ? 2u : 1u;
+    sink->buffers[0].bytes = (uint8_t *)malloc(sink->buffer_capacity);
+    sink->buffers[1].bytes = buffer_count == 2u ? (uint8_t *)malloc(sink->buffer_capacity) : NULL;
+    if (sink->buffers[0].bytes == NULL || (buffer_count == 2u && sink->buffers[1].bytes == NULL)) {
+        vtx_c_sink_release(sink);
+        return VTX_C_SINK_STATUS_OUT_OF_MEMORY;
+    }
+
+    if (config.container == VTX_C_SINK_CONTAINER_WAV) {
+        uint8_t header[VTX_C_SINK_WAV_HEADER_BYTES];
+        vtx_c_sink_wav_header(sink, 0, header);
+        if (vtx_c_sink_write_all(fd, header, sizeof(header)) != VTX_C_SINK_STATUS_OK) {
+            vtx_c_sink_release(sink);
+            return VTX_C_SINK_STATUS_IO_ERROR;
+        }
+    }
+
+    if (config.background_writer) {
+        if (pthread_mutex_init(&sink->lock, NULL) != 0) {
+            vtx_c_sink_release(sink);
+            return VTX_C_SINK_STATUS_OUT_OF_MEMORY;
+        }
+        if (pthread_cond_init(&sink->changed, NULL) != 0) {
+            pthread_mutex_destroy(&sink->lock);
+            vtx_c_sink_release(sink);
+            return VTX_C_SINK_STATUS_OUT_OF_MEMORY;
+        }
+        if (pthread_create(&sink->writer, NULL, vtx_c_sink_writer_main, sink) != 0) {
+            pthread_cond_destroy(&sink->changed);
+            pthread_mutex_destroy(&sink->lock);
+            vtx_c_sink_release(sink);
+            return VTX_C_SINK_STATUS_OUT_OF_MEMORY;
+        }
+        sink->has_writer = 1;
+    }
+    *out_sink = sink;
+    return VTX_C_SINK_STATUS_OK;
+}
+
+static int vtx_c_sink_config_is_valid(VTXCSinkConfig config) {
+    return config.sample_rate > 0u &&
+        config.channel_count > 0u &&
+        config.channel_count <= VTX_C_SINK_MAX_CHANNELS &&
+        (config.format == VTX_C_SINK_FORMAT_PCM16 || config.format == VTX_C_SINK_FORMAT_FLOAT32) &&
+        (config.container == VTX_C_SINK_CONTAINER_WAV || config.container == VTX_C_SINK_CONTAINER_RAW) &&
+        config.buffer_frames > 0u &&
+        config.buffer_frames <= VTX_C_SINK_MAX_BUFFER_FRAMES &&
+        (uint64_t)config.sample_rate * config.channel_count * 4u <= UINT32_MAX;
+}
+
+VTXCSinkStatus vtx_c_sink_open_path(const char *path, VTXCSinkConfig config, VTXCSink **out_sink) {
+    int fd;
+
+    if (out_sink == NULL) {
+        return VTX_C_SINK_STATUS_INVALID_ARGUMENT;
+    }
+    *out_sink = NULL;
+    if (path == NULL || !vtx_c_sink_config_is_valid(config)) {
+        return VTX_C_SINK_STATUS_INVALID_ARGUMENT;
+    }
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return VTX_C_SINK_STATUS_IO_ERROR;
+    }
+    return vtx_c_sink_open(fd, 1, config, out_sink);
+}
+
+VTXCSinkStatus vtx_c_sink_open_fd(int fd, VTXCSinkConfig config, VTXCSink **out_sink) {
+    if (out_sink == NULL) {
+        return VTX_C_SINK_STATUS_INVALID_ARGUMENT;
+    }
+    *out_sink = NULL;
+    if (fd < 0 || !vtx_c_sink_config_is_valid(config)) {
+        return VTX_C_SINK_STATUS_INVALID_ARGUMENT;
+    }
+    return vtx_c_sink_open(fd, 0, config, out_sink);
+}
+
+VTXCSinkStatus vtx_c_sink_write_float32(VTXCSink *sink, const float *interleaved, uint32_t frame_count) {
+    if (interleaved == NULL && frame_count > 0) {
+        return VTX_C_SINK_STATUS_INVALID_ARGUMENT;
+    }
+    return vtx_c_sink_append(sink, interleaved, NULL, frame_count);
+}
+
+VTXCSinkStatus vtx_c_sink_write_int16(VTXCSink *sink, const int16_t *interleaved, uint32_t frame_count) {
+    if (interleaved == NULL && frame_count > 0) {
+        return VTX_C_SINK_STATUS_INVALID_ARGUMENT;
+    }
+    return vtx_c_sink_append(sink, NULL, interleaved, frame_count);
+}
+
+uint64_t vtx_c_sink_frame_count(const VTXCSink *sink) {
+    return sink == NULL ? 0u : sink->frame_count;
+}
+
+VTXCSinkStatus vtx_c_sink_close(VTXCSink *sink) {
+    VTXCSinkStatus status;
+
+    if (sink == NULL) {
+        return VTX_C_SINK_STATUS_INVALID_ARGUMENT;
+    }
+    vtx_c_sink_flush_buffer(sink);
+    if (sink->has_writer) {
+        vtx_c_sink_wait_for_writer(sink);
+    }
+    if (sink->status == VTX_C_SINK_STATUS_OK &&
+        sink->config.container == VTX_C_SINK_CONTAINER_WAV &&
+        sink->seekable) {
+        uint8_t header[VTX_C_SINK_WAV_HEADER_BYTES];
+        vtx_c_sink_wav_header(sink, 1, header);
+        if (pwrite(sink->fd, header, sizeof(header), sink->header_offset) != (ssize_t)sizeof(header)) {
+            sink->status = VTX_C_SINK_STATUS_IO_ERROR;
+        }
+    }
+    status = sink->status;
+    if (sink->owns_fd && close(sink->fd) != 0 && status == VTX_C_SINK_STATUS_OK) {
+        status = VTX_C_SINK_STATUS_IO_ERROR;
+    }
+    sink->owns_fd = 0;
+    vtx_c_sink_release(sink);
+    return status;
+}
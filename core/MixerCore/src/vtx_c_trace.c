@@ -0,0 +1,365 @@
+#include "vtx_c_trace.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+#define VTX_C_TRACE_MAX_RING_RECORDS (1u << 24)
+#define VTX_C_TRACE_DRAIN_CHUNK_RECORDS 256u
+
+// The producer and consumer indices sit on separate cache lines so a drain
+// thread polling the ring does not bounce the render thread's line.
+struct VTXCTraceRing {
+    VTXCTraceRecord *records;
+    uint32_t capacity;
+    uint32_t mask;
+    char producer_padding[64];
+    _Atomic uint64_t write_index;
+    _Atomic uint64_t dropped_count;
+    char consumer_padding[64];
+    _Atomic uint64_t read_index;
+};
+
+struct VTXCTraceWriter {
+    int fd;
+    VTXCTraceRing *ring;
+    uint32_t sample_rate;
+    uint32_t channel_count;
+    uint64_t record_count;
+    VTXCTraceStatus status;
+    VTXCTraceRecord records[VTX_C_TRACE_DRAIN_CHUNK_RECORDS];
+    uint8_t bytes[VTX_C_TRACE_DRAIN_CHUNK_RECORDS * VTX_C_TRACE_RECORD_BYTES];
+
+    // Serializes drains, so the caller and the drain thread never pop the
+    // ring at the same time.
+    pthread_mutex_t lock;
+    int has_lock;
+    int has_drainer;
+    pthread_t drainer;
+    pthread_cond_t changed;
+    uint32_t drain_interval_ms;
+    int stopping;
+};
+
+static void vtx_c_trace_put_le16(uint8_t *out, uint16_t value) {
+    out[0] = (uint8_t)(value & 0xFFu);
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static void vtx_c_trace_put_le32(uint8_t *out, uint32_t value) {
+    vtx_c_trace_put_le16(out, (uint16_t)(value & 0xFFFFu));
+    vtx_c_trace_put_le16(out + 2, (uint16_t)(value >> 16));
+}
+
+static void vtx_c_trace_put_le64(uint8_t *out, uint64_t value) {
+    vtx_c_trace_put_le32(out, (uint32_t)(value & 0xFFFFFFFFu));
+    vtx_c_trace_put_le32(out + 4, (uint32_t)(value >> 32));
+}
+
+static void vtx_c_trace_put_float(uint8_t *out, float value) {
+    uint32_t bits;
+
+    memcpy(&bits, &value, sizeof(bits));
+    vtx_c_trace_put_le32(out, bits);
+}
+
+static void vtx_c_trace_encode_record(const VTXCTraceRecord *record, uint8_t out[VTX_C_TRACE_RECORD_BYTES]) {
+    vtx_c_trace_put_le64(out, record->frame);
+    vtx_c_trace_put_le16(out + 8, record->kind);
+    vtx_c_trace_put_le16(out + 10, record->flags);
+    vtx_c_trace_put_le32(out + 12, record->voice_index);
+    vtx_c_trace_put_le32(out + 16, record->channel_tag);
+    vtx_c_trace_put_le32(out + 20, record->count);
+    vtx_c_trace_put_float(out + 24, record->value_a);
+    vtx_c_trace_put_float(out + 28, record->value_b);
+}
+
+static void vtx_c_trace_file_header(
+    const VTXCTraceWriter *writer,
+    uint64_t dropped_count,
+    uint8_t header[VTX_C_TRACE_FILE_HEADER_BYTES]
+) {
+    memcpy(header, "VTXTRACE", 8u);
+    vtx_c_trace_put_le32(header + 8, VTX_C_TRACE_FILE_VERSION);
+    vtx_c_trace_put_le32(header + 12, VTX_C_TRACE_RECORD_BYTES);
+    vtx_c_trace_put_le32(header + 16, writer->sample_rate);
+    vtx_c_trace_put_le32(header + 20, writer->channel_count);
+    vtx_c_trace_put_le64(header + 24, dropped_count);
+}
+
+static VTXCTraceStatus vtx_c_trace_write_all(int fd, const uint8_t *bytes, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, bytes, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return VTX_C_TRACE_STATUS_IO_ERROR;
+        }
+        bytes += written;
+        length -= (size_t)written;
+    }
+    return VTX_C_TRACE_STATUS_OK;
+}
+
+VTXCTraceStatus vtx_c_trace_ring_create(uint32_t capacity_records, VTXCTraceRing **out_ring) {
+    VTXCTraceRing *ring;
+    uint32_t capacity = 1u;
+
+    if (out_ring == NULL) {
+        return VTX_C_TRACE_STATUS_INVALID_ARGUMENT;
+    }
+    *out_ring = NULL;
+    if (capacity_records == 0u || capacity_records > VTX_C_TRACE_MAX_RING_RECORDS) {
+        return VTX_C_TRACE_STATUS_INVALID_ARGUMENT;
+    }
+    while (capacity < capacity_records) {
+        capacity <<= 1;
+    }
+    ring = (VTXCTraceRing *)calloc(1u, sizeof(*ring));
+    if (ring == NULL) {
+        return VTX_C_TRACE_STATUS_OUT_OF_MEMORY;
+    }
+    ring->records = (VTXCTraceRecord *)calloc(capacity, sizeof(*ring->records));
+    if (ring->records == NULL) {
+        free(ring);
+        return VTX_C_TRACE_STATUS_OUT_OF_MEMORY;
+    }
+    ring->capacity = capacity;
+    ring->mask = capacity - 1u;
+    atomic_init(&ring->write_index, 0u);
+    atomic_init(&ring->dropped_count, 0u);
+    atomic_init(&ring->read_index, 0u);
+    *out_ring = ring;
+    return VTX_C_TRACE_STATUS_OK;
+}
+
+void vtx_c_trace_ring_free(VTXCTraceRing *ring) {
+    if (ring == NULL) {
+        return;
+    }
+    free(ring->records);
+    free(ring);
+}
+
+uint32_t vtx_c_trace_ring_capacity(const VTXCTraceRing *ring) {
+    return ring == NULL ? 0u : ring->capacity;
+}
+
+int vtx_c_trace_ring_push(VTXCTraceRing *ring, const VTXCTraceRecord *record) {
+    uint64_t write_index;
+    uint64_t read_index;
+
+    if (ring == NULL || record == NULL) {
+        return 0;
+    }
+    write_index = atomic_load_explicit(&ring->write_index, memory_order_relaxed);
+    read_index = atomic_load_explicit(&ring->read_index, memory_order_acquire);
+    if (write_index - read_index >= ring->capacity) {
+        atomic_fetch_add_explicit(&ring->dropped_count, 1u, memory_order_relaxed);
+        return 0;
+    }
+    ring->records[write_index & ring->mask] = *record;
+    atomic_store_explicit(&ring->write_index, write_index + 1u, memory_order_release);
+    return 1;
+}
+
+uint32_t vtx_c_trace_ring_pop(VTXCTraceRing *ring, VTXCTraceRecord *out, uint32_t max_records) {
+    uint64_t read_index;
+    uint64_t write_index;
+    uint32_t count;
+    uint32_t record_index;
+
+    if (ring == NULL || out == NULL) {
+        return 0u;
+    }
+    read_index = atomic_load_explicit(&ring->read_index, memory_order_relaxed);
+    write_index = atomic_load_explicit(&ring->write_index, memory_order_acquire);
+    count = write_index - read_index < (uint64_t)max_records
+        ? (uint32_t)(write_index - read_index)
+        : max_records;
+    for (record_index = 0u; record_index < count; record_index++) {
+        out[record_index] = ring->records[(read_index + record_index) & ring->mask];
+    }
+    atomic_store_explicit(&ring->read_index, read_index + count, memory_order_release);
+    return count;
+}
+
+uint64_t vtx_c_trace_ring_dropped_count(const VTXCTraceRing *ring) {
+    if (ring == NULL) {
+        return 0u;
+    }
+    return atomic_load_explicit(&((VTXCTraceRing *)ring)->dropped_count, memory_order_relaxed);
+}
+
+// Callers hold writer->lock.
+static void vtx_c_trace_writer_drain_locked(VTXCTraceWriter *writer) {
+    uint32_t count;
+
+    while (writer->status == VTX_C_TRACE_STATUS_OK &&
+        (count = vtx_c_trace_ring_pop(writer->ring, writer->records, VTX_C_TRACE_DRAIN_CHUNK_RECORDS)) > 0u) {
+        uint32_t record_index;
+
+        for (record_index = 0u; record_index < count; record_index++) {
+            vtx_c_trace_encode_record(
+                &writer->records[record_index],
+                writer->bytes + (size_t)record_index * VTX_C_TRACE_RECORD_BYTES
+            );
+        }
+        writer->status = vtx_c_trace_write_all(writer->fd, writer->bytes, (size_t)count * VTX_C_TRACE_RECORD_BYTES);
+        writer->record_count += count;
+    }
+}
+
+static void *vtx_c_trace_drainer_main(void *context) {
+    VTXCTraceWriter *writer = (VTXCTraceWriter *)context;
+
+    pthread_mutex_lock(&writer->lock);
+    while (!writer->stopping) {
+        struct timespec deadline;
+
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += (time_t)(writer->drain_interval_ms / 1000u);
+        deadline.tv_nsec += (long)(writer->drain_interval_ms % 1000u) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&writer->changed, &writer->lock, &deadline);
+        vtx_c_trace_writer_drain_locked(writer);
+    }
+    pthread_mutex_unlock(&writer->lock);
+    return NULL;
+}
+
+static void vtx_c_trace_writer_release(VTXCTraceWriter *writer) {
+    if (writer->has_drainer) {
+        pthread_mutex_lock(&writer->lock);
+        writer->stopping = 1;
+        pthread_cond_broadcast(&writer->changed);
+        pthread_mutex_unlock(&writer->lock);
+        pthread_join(writer->drainer, NULL);
+        pthread_cond_destroy(&writer->changed);
+    }
+    if (writer->has_lock) {
+        pthread_mutex_destroy(&writer->lock);
+    }
+    if (writer->fd >= 0) {
+        close(writer->fd);
+    }
+    free(writer);
+}
+
+VTXCTraceStatus vtx_c_trace_writer_open_path(
+    const char *path,
+    VTXCTraceRing *ring,
+    uint32_t sample_rate,
+    uint32_t channel_count,
+    uint32_t drain_interval_ms,
+    VTXCTraceWriter **out_writer
+) {
+    VTXCTraceWriter *writer;
+    uint8_t header[VTX_C_TRACE_FILE_HEADER_BYTES];
+
+    if (out_writer == NULL) {
+        return VTX_C_TRACE_STATUS_INVALID_ARGUMENT;
+    }
+    *out_writer = NULL;
+    if (path == NULL || ring == NULL) {
+        return VTX_C_TRACE_STATUS_INVALID_ARGUMENT;
+    }
+    writer = (VTXCTraceWriter *)calloc(1u, sizeof(*writer));
+    if (writer == NULL) {
+        return VTX_C_TRACE_STATUS_OUT_OF_MEMORY;
+    }
+    writer->ring = ring;
+    writer->sample_rate = sample_rate;
+    writer->channel_count = channel_count;
+    writer->drain_interval_ms = drain_interval_ms;
+    writer->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (writer->fd < 0) {
+        free(writer);
+        return VTX_C_TRACE_STATUS_IO_ERROR;
+    }
+    if (pthread_mutex_init(&writer->lock, NULL) != 0) {
+        vtx_c_trace_writer_release(writer);
+        return VTX_C_TRACE_STATUS_OUT_OF_MEMORY;
+    }
+    writer->has_lock = 1;
+
+    vtx_c_trace_file_header(writer, 0u, header);
+    if (vtx_c_trace_write_all(writer->fd, header, sizeof(header)) != VTX_C_TRACE_STATUS_OK) {
+        vtx_c_trace_writer_release(writer);
+        return VTX_C_TRACE_STATUS_IO_ERROR;
+    }
+
+    if (drain_interval_ms > 0u) {
+        if (pthread_cond_init(&writer->changed, NULL) != 0) {
+            vtx_c_trace_writer_release(writer);
+            return VTX_C_TRACE_STATUS_OUT_OF_MEMORY;
+        }
+        if (pthread_create(&writer->drainer, NULL, vtx_c_trace_drainer_main, writer) != 0) {
+            pthread_cond_destroy(&writer->changed);
+            vtx_c_trace_writer_release(writer);
+            return VTX_C_TRACE_STATUS_OUT_OF_MEMORY;
+        }
+        writer->has_drainer = 1;
+    }
+    *out_writer = writer;
+    return VTX_C_TRACE_STATUS_OK;
+}
+
+VTXCTraceStatus vtx_c_trace_writer_drain(VTXCTraceWriter *writer) {
+    VTXCTraceStatus status;
+
+    if (writer == NULL) {
+        return VTX_C_TRACE_STATUS_INVALID_ARGUMENT;
+    }
+    pthread_mutex_lock(&writer->lock);
+    vtx_c_trace_writer_drain_locked(writer);
+    status = writer->status;
+    pthread_mutex_unlock(&writer->lock);
+    return status;
+}
+
+uint64_t vtx_c_trace_writer_record_count(const VTXCTraceWriter *writer) {
+    return writer == NULL ? 0u : writer->record_count;
+}
+
+VTXCTraceStatus vtx_c_trace_writer_close(VTXCTraceWriter *writer) {
+    VTXCTraceStatus status;
+
+    if (writer == NULL) {
+        return VTX_C_TRACE_STATUS_INVALID_ARGUMENT;
+    }
+    if (writer->has_drainer) {
+        pthread_mutex_lock(&writer->lock);
+        writer->stopping = 1;
+        pthread_cond_broadcast(&writer->changed);
+        pthread_mutex_unlock(&writer->lock);
+        pthread_join(writer->drainer, NULL);
+        pthread_cond_destroy(&writer->changed);
+        writer->has_drainer = 0;
+    }
+    vtx_c_trace_writer_drain_locked(writer);
+    if (writer->status == VTX_C_TRACE_STATUS_OK) {
+        uint8_t header[VTX_C_TRACE_FILE_HEADER_BYTES];
+        vtx_c_trace_file_header(writer, vtx_c_trace_ring_dropped_count(writer->ring), header);
+        if (pwrite(writer->fd, header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+            writer->status = VTX_C_TRACE_STATUS_IO_ERROR;
+        }
+    }
+    status = writer->status;
+    if (close(writer->fd) != 0 && status == VTX_C_TRACE_STATUS_OK) {
+        status = VTX_C_TRACE_STATUS_IO_ERROR;
+    }
+    writer->fd = -1;
+    vtx_c_trace_writer_release(writer);
+    return status;
+}
@@ -6,6 +6,65 @@
 
 #include "module_types.h"
 
-int mc_parse_mod_header_bytes(const uint8_t *data, size_t size, mc_module_info *out_info);
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    MC_MOD_HEADER_SIZE = 1084,
+    MC_MOD_SAMPLE_COUNT = 31,
+    MC_MOD_ROWS_PER_PATTERN = 64,
+    MC_MOD_CELL_BYTES = 4,
+};
+
+// One 30-byte MOD sample header with lengths converted from words to bytes.
+// Loop lengths of one word or less mean the sample does not loop.
+typedef struct {
+    char name[23];
+    uint32_t length_bytes;
+    int8_t finetune;
+    uint8_t volume;
+    uint32_t loop_start_bytes;
+    uint32_t loop_length_bytes;
+} mc_mod_sample_header;
+
+// A borrowed view of one 8-bit signed sample body inside the module buffer.
+typedef struct {
+    const int8_t *data;
+    size_t length_bytes;
+} mc_mod_sample_view;
+
+// out_orders points into data and holds out_order_count entries.
+int mc_mod_parse_header(
+    const uint8_t *data,
+    size_t size,
+    mc_module_header *out_header,
+    const uint8_t **out_orders,
+    uint16_t *out_order_count
+);
+
+// Copies the trimmed name of sample index (0-30) from a MOD header. Returns 0
+// for an out-of-range index or a buffer too short for the header.
+int mc_mod_sample_name(const uint8_t *data, size_t size, uint16_t index, char *out_name, size_t out_size);
+
+// Parses sample header index (0-30). Volume is clamped to 64.
+int mc_mod_parse_sample_header(const uint8_t *data, size_t size, uint16_t index, mc_mod_sample_header *out_header);
+
+// Bytes of pattern data per pattern: 64 rows of 4-byte cells per channel.
+size_t mc_mod_pattern_size(uint16_t channels);
+
+// Maps an Amiga period to an XM-style note number (1 = C-0), where
+// ProTracker's C-1 (period 856) is C-3, matching FastTracker II's MOD import.
+// Periods between table entries round to the nearest note; 0 stays 0.
+uint8_t mc_mod_period_to_note(uint16_t period);
+
+// Decodes one pattern of mc_mod_pattern_size(channels) bytes into a dense
+// row-major grid of 64 * channels cells. MOD has no volume column, so volume
+// is always 0.
+void mc_mod_decode_pattern(const uint8_t *data, uint16_t channels, mc_pattern_cell *out_cells);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif
@@ -0,0 +1,40 @@
+#ifndef MC_MODULE_FILE_H
+#define MC_MODULE_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Read-only bytes of a module file. Regular files are memory-mapped so parsed
+// structures and sample views can point straight at page-cache-backed file
+// data. Empty files, pipes and failed mappings fall back to one read() into a
+// heap buffer. Either way data stays valid until mc_file_bytes_close.
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+    int mapped;
+} mc_file_bytes;
+
+int mc_file_bytes_open(const char *path, mc_file_bytes *out_bytes, char *error, size_t error_size);
+void mc_file_bytes_close(mc_file_bytes *bytes);
+
+// Reads up to capacity bytes from the start of path without mapping the rest.
+// out_file_size is the size reported by fstat, or out_size for pipes.
+int mc_file_read_prefix(
+    const char *path,
+    uint8_t *buffer,
+    size_t capacity,
+    size_t *out_size,
+    uint64_t *out_file_size,
+    char *error,
+    size_t error_size
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef MC_MODULE_HANDLE_H
+#define MC_MODULE_HANDLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mod_header.h"
+#include "module_types.h"
+#include "xm_instrument.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// An open module. The handle owns the file bytes (memory-mapped when possible),
+// the parsed header, the pattern index and decoded cell grids, and the XM
+// instrument table or MOD sample headers. Pointers and sample views returned
+// by the accessors below borrow from the handle and, except for lazily decoded
+// pattern grids, are valid until mc_module_close.
+typedef struct mc_module mc_module;
+
+enum {
+    // Decode and validate every pattern during open and keep all grids
+    // resident. An XM file with malformed pattern data then fails to open,
+    // exactly as mc_parse_file does.
+    MC_MODULE_OPEN_EAGER_PATTERNS = 0x01,
+    // Eager decoding spread over several threads with
+    // mc_module_decode_patterns. Implies MC_MODULE_OPEN_EAGER_PATTERNS.
+    MC_MODULE_OPEN_PARALLEL_PATTERNS = 0x02,
+    MC_MODULE_DEFAULT_PATTERN_CACHE = 8,
+    MC_MODULE_MAX_DECODE_THREADS = 64,
+};
+
+typedef void (*mc_pattern_task)(void *task_context, size_t index);
+
+// A caller-provided thread pool. parallel_for must run task(task_context, i)
+// exactly once for every i in [0, count), in any order and on any threads,
+// and return only after all of them have finished.
+typedef struct {
+    void (*parallel_for)(void *context, size_t count, mc_pattern_task task, void *task_context);
+    void *context;
+} mc_pattern_executor;
+
+typedef struct {
+    uint32_t flags;
+    // Decoded grids kept by a lazy handle; 0 selects the default.
+    uint16_t pattern_cache_capacity;
+    // Used with MC_MODULE_OPEN_PARALLEL_PATTERNS; see
+    // mc_module_decode_patterns.
+    uint16_t decode_threads;
+    const mc_pattern_executor *executor;
+} mc_module_open_options;
+
+// Returns NULL and fills error when the file cannot be read or is not a
+// supported module. The error strings match mc_parse_file.
+//
+// By default only the pattern layout (offset, row count, packed size) is
+// indexed at open; a pattern is decoded on first access and kept in a small
+// least-recently-used cache. options may be NULL.
+mc_module *mc_module_open(const char *path, char *error, size_t error_size);
+mc_module *mc_module_open_with_options(
+    const char *path,
+    const mc_module_open_options *options,
+    char *error,
+    size_t error_size
+);
+void mc_module_close(mc_module *module);
+
+const mc_module_header *mc_module_get_header(const mc_module *module);
+const uint8_t *mc_module_order_table(const mc_module *module, uint16_t *out_count);
+
+// Pattern grids. MOD patterns use the same grids, 64 rows each, with periods
+// converted to notes; their packed size is the raw pattern size. A MOD file
+// cut off inside its pattern data reports zero patterns here while the header
+// still carries the count.
+uint16_t mc_module_pattern_count(const mc_module *module);
+uint16_t mc_module_pattern_rows(const mc_module *module, uint16_t pattern);
+uint16_t mc_module_pattern_packed_size(const mc_module *module, uint16_t pattern);
+
+// Decodes the pattern if it is not cached. On success *out_cells is a
+// row-major grid of rows * header->channels cells, or NULL when the pattern
+// stores no packed data and every cell is empty. Returns 0 for an out-of-range
+// index, malformed packed data, or out of memory. On a lazy handle the grid
+// stays valid until pattern_cache_capacity other patterns have been decoded;
+// grids on an eager handle live until mc_module_close.
+int mc_module_load_pattern(mc_module *module, uint16_t pattern, const mc_pattern_cell **out_cells);
+
+// Decodes every pattern that is not resident yet, concurrently, and keeps all
+// grids resident until mc_module_close; afterwards the handle behaves like an
+// eagerly opened one. Patterns are decoded on executor when it is non-NULL,
+// otherwise on up to thread_count internal threads (0 means one per online
+// CPU, and small modules use fewer). Returns 1 when every pattern decoded.
+// Otherwise returns 0 and sets *out_failed_pattern to the lowest pattern
+// that is malformed or could not be allocated, which is the pattern a serial
+// mc_module_load_pattern loop would have stopped at. Must not run
+// concurrently with other calls on the same handle.
+int mc_module_decode_patterns(
+    mc_module *module,
+    uint16_t thread_count,
+    const mc_pattern_executor *executor,
+    uint16_t *out_failed_pattern
+);
+
+// mc_module_load_pattern without the status: NULL for empty or undecodable
+// patterns.
+const mc_pattern_cell *mc_module_pattern_cells(mc_module *module, uint16_t pattern);
+
+// Out-of-range coordinates and empty or undecodable patterns return an empty
+// cell.
+mc_pattern_cell mc_module_pattern_cell(mc_module *module, uint16_t pattern, uint16_t row, uint16_t channel);
+
+// Editing. These return a mutable grid, instrument or sample header and mark
+// the pattern or instrument dirty so mc_module_write_xm (xm_writer.h)
+// re-encodes it; everything else is copied from the source bytes when saving.
+// An edited grid stays resident until mc_module_close, and a pattern with no
+// packed data gets a zeroed grid. Editing a sample header marks its
+// instrument dirty; sample counts and lengths cannot change. Editing discards
+// any summary returned by mc_module_get_info. Each returns NULL for an
+// out-of-range index, a MOD handle, malformed pattern data, or out of memory.
+mc_pattern_cell *mc_module_edit_pattern(mc_module *module, uint16_t pattern);
+mc_xm_instrument *mc_module_edit_xm_instrument(mc_module *module, uint16_t instrument);
+mc_xm_sample_header *mc_module_edit_xm_sample(mc_module *module, uint32_t sample_index);
+int mc_module_pattern_is_dirty(const mc_module *module, uint16_t pattern);
+int mc_module_xm_instrument_is_dirty(const mc_module *module, uint16_t instrument);
+
+// The fixed-capacity mc_module_info summary, built on first use and owned by
+// the handle. Decodes every pattern; returns NULL when a pattern is malformed
+// or when out of memory.
+const mc_module_info *mc_module_get_info(mc_module *module);
+
+const uint8_t *mc_module_bytes(const mc_module *module, size_t *out_size);
+int mc_module_is_mapped(const mc_module *module);
+
+// NULL for MOD files.
+const mc_xm_instrument_table *mc_module_xm_instruments(const mc_module *module);
+int mc_module_xm_sample_view(const mc_module *module, uint32_t sample_index, mc_xm_sample_view *out_view);
+
+// The 31 MOD sample headers; NULL with a zero count for XM files.
+const mc_mod_sample_header *mc_module_mod_samples(const mc_module *module, uint16_t *out_count);
+// Signed 8-bit PCM borrowed from the module buffer, clamped to the bytes a
+// truncated file actually holds. An empty sample yields a NULL view and 1.
+int mc_module_mod_sample_view(const mc_module *module, uint16_t sample, mc_mod_sample_view *out_view);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
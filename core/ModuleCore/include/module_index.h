@@ -0,0 +1,100 @@
+#ifndef MC_MODULE_INDEX_H
+#define MC_MODULE_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "module_handle.h"
+#include "module_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    MC_INDEX_NAME_SIZE = 23,
+    MC_INDEX_MATCH_TITLE = 0x01,
+    MC_INDEX_MATCH_INSTRUMENT = 0x02,
+};
+
+// Parsed metadata for one file. ok is 0 for files that are not supported
+// modules; they stay in the index so they are not re-opened on every update.
+// Instrument names are XM instrument names or MOD sample names.
+typedef struct {
+    char *path;
+    uint64_t size;
+    int64_t mtime_sec;
+    uint32_t mtime_nsec;
+    uint64_t content_hash;
+
+    int ok;
+    mc_module_type type;
+    char title[21];
+    uint16_t channels;
+    uint16_t patterns;
+    uint16_t instruments;
+    uint16_t song_length;
+    uint32_t duration_ms;
+    uint16_t order_count;
+    uint8_t orders[MC_MAX_ORDER_ENTRIES];
+    uint16_t instrument_name_count;
+    char (*instrument_names)[MC_INDEX_NAME_SIZE];
+} mc_index_entry;
+
+// Entries are kept sorted by path.
+typedef struct {
+    mc_index_entry *entries;
+    size_t count;
+} mc_module_index;
+
+typedef struct {
+    // Same path, size and mtime: reused without reading the file.
+    size_t unchanged;
+    // Size or mtime changed but the content hash did not.
+    size_t rehashed;
+    size_t parsed;
+    size_t removed;
+} mc_index_update_stats;
+
+// Loads an index written by mc_index_save. A missing file, or one written by
+// an older version, yields an empty index and returns 1; a corrupt or foreign
+// file returns 0 with an error.
+int mc_index_load(const char *path, mc_module_index *out_index, char *error, size_t error_size);
+
+// Writes the index to a new temp file next to path, syncs it and renames it
+// into place. An existing index keeps its permission bits.
+int mc_index_save(const mc_module_index *index, const char *path, char *error, size_t error_size);
+
+// Makes the index describe exactly the given files. Entries whose size and
+// mtime are unchanged are kept as-is; other files are hashed and only
+// re-parsed when their content changed. Files that cannot be read are
+// dropped. Returns 0 when out of memory, leaving the index unchanged.
+int mc_index_update(
+    mc_module_index *index,
+    const char *const *paths,
+    size_t path_count,
+    mc_index_update_stats *out_stats
+);
+
+// Returns the first entry at or after start whose title and/or instrument
+// names (per fields) contain needle, ignoring ASCII case, or index->count.
+size_t mc_index_find(const mc_module_index *index, const char *needle, uint32_t fields, size_t start);
+
+void mc_index_free(mc_module_index *index);
+
+// 64-bit hash of a file's bytes used for change detection. Not
+// cryptographic.
+uint64_t mc_index_content_hash(const uint8_t *data, size_t size);
+
+// Song length of one pass from order 0, walked with mc_song_walk
+// (module_song_walk.h): speed, tempo, position jump, pattern break, pattern
+// loop and pattern delay apply as in the player, and the pass stops when an
+// order position repeats. Matches the player timeline's total to within a
+// millisecond.
+uint32_t mc_index_estimate_duration_ms(mc_module *module);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
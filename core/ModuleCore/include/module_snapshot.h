@@ -0,0 +1,77 @@
+#ifndef MC_MODULE_SNAPSHOT_H
+#define MC_MODULE_SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "module_handle.h"
+#include "module_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    MC_SNAPSHOT_VERSION = 1,
+};
+
+typedef struct {
+    uint16_t row_count;
+    uint16_t packed_size;
+    // Range of this pattern's cells in mc_module_snapshot.events.
+    size_t first_event;
+    size_t event_count;
+} mc_snapshot_pattern;
+
+// The parsed contents of a module with no fixed caps: header, order table,
+// and every non-empty pattern cell ordered by pattern, row and channel.
+typedef struct {
+    mc_module_header header;
+    uint16_t order_count;
+    uint8_t *orders;
+    uint16_t pattern_count;
+    mc_snapshot_pattern *patterns;
+    size_t event_count;
+    mc_xm_event *events;
+} mc_module_snapshot;
+
+typedef void (*mc_snapshot_difference_fn)(void *context, const char *description);
+
+// Decodes every pattern of module. Returns 0 with an error for malformed
+// pattern data or when out of memory.
+int mc_snapshot_capture(mc_module *module, mc_module_snapshot *out_snapshot, char *error, size_t error_size);
+
+// Serializes to the versioned little-endian binary format. *out_data is
+// heap-allocated and owned by the caller. Returns 0 when out of memory.
+int mc_snapshot_encode(const mc_module_snapshot *snapshot, uint8_t **out_data, size_t *out_size);
+
+// 1 when data starts with the snapshot magic, whatever its version.
+int mc_snapshot_is_encoded(const uint8_t *data, size_t size);
+
+// Reads a buffer written by mc_snapshot_encode. Rejects other versions and
+// truncated or inconsistent data.
+int mc_snapshot_decode(
+    const uint8_t *data,
+    size_t size,
+    mc_module_snapshot *out_snapshot,
+    char *error,
+    size_t error_size
+);
+
+void mc_snapshot_free(mc_module_snapshot *snapshot);
+
+// Compares two snapshots field by field and cell by cell, calling report
+// (when not NULL) with a one-line description of each difference. Returns
+// the number of differences.
+size_t mc_snapshot_diff(
+    const mc_module_snapshot *a,
+    const mc_module_snapshot *b,
+    mc_snapshot_difference_fn report,
+    void *context
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef MC_MODULE_SONG_WALK_H
+#define MC_MODULE_SONG_WALK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "module_handle.h"
+#include "module_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    // Channels whose effects the walk reads; the player mixes the same
+    // number (VTX_C_PLAYER_MAX_CHANNELS).
+    MC_SONG_WALK_MAX_CHANNELS = 32,
+    MC_SONG_WALK_DEFAULT_SPEED = 6,
+    MC_SONG_WALK_DEFAULT_BPM = 125,
+    // Rows of a missing or empty pattern.
+    MC_SONG_WALK_EMPTY_PATTERN_ROWS = 64,
+};
+
+// Position and control state of one pass through a song, applying only the
+// effects that decide timing: speed and BPM, position jump, pattern break,
+// pattern loop and pattern delay, in the order the player applies them.
+// Nothing is mixed and no samples are decoded. The player drives its own
+// position through one, so anything built on a walk agrees with playback.
+typedef struct {
+    mc_module *module;
+    const uint8_t *orders;
+    uint16_t song_length;
+    uint16_t restart_order;
+    uint16_t channel_count;
+    uint16_t pattern_channel_count;
+    uint16_t order;
+    uint16_t pattern;
+    uint16_t row;
+    uint16_t row_count;
+    const mc_pattern_cell *cells;
+    uint16_t speed;
+    uint16_t bpm;
+    uint8_t pattern_delay;
+    int jump_pending;
+    uint16_t jump_order;
+    int break_pending;
+    uint16_t break_row;
+    int loop_pending;
+    uint16_t loop_row;
+    uint16_t channel_loop_rows[MC_SONG_WALK_MAX_CHANNELS];
+    uint8_t channel_loop_counts[MC_SONG_WALK_MAX_CHANNELS];
+    uint8_t visited_orders[MC_MAX_ORDER_ENTRIES];
+    // Set after mc_song_walk_begin; zero by default. With loop set, leaving
+    // the last order continues at restart_order and revisited orders play
+    // again instead of ending the song. A non-zero range_count ends the song
+    // on entering an order outside range_start .. range_start + range_count - 1.
+    int loop;
+    uint16_t range_start;
+    uint16_t range_count;
+} mc_song_walk;
+
+// Starts at row 0 of start_order with the header's speed and BPM. Returns 0
+// for a module with no orders or a start_order past the song length.
+int mc_song_walk_begin(mc_song_walk *walk, mc_module *module, uint16_t start_order);
+
+// Applies the control effects of the current row and returns how many ticks
+// it lasts: speed times one plus its pattern delay.
+uint32_t mc_song_walk_process_row(mc_song_walk *walk);
+
+// Moves to the next row. An out-of-range break target plays row 0. Returns 0
+// when the song ends, that is when the next order is past the song length,
+// was already visited or is outside the range, with the position a looping
+// player would continue from in *loop_order and *loop_row. The walk's
+// position is left unchanged then.
+int mc_song_walk_advance(mc_song_walk *walk, uint16_t *loop_order, uint16_t *loop_row);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
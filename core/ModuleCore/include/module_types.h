@@ -1,6 +1,7 @@
 #ifndef MC_MODULE_TYPES_H
 #define MC_MODULE_TYPES_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -17,6 +18,9 @@ enum {
     MC_MAX_ORDER_ENTRIES = 256,
     MC_MAX_PATTERN_ROW_COUNTS = 256,
     MC_MAX_XM_EVENTS = 2048,
+    // mc_probe_file reads this much: the MOD header ends with its signature
+    // at offset 1080, and a standard XM header with 256 orders is shorter.
+    MC_PROBE_BYTES = 1084,
 };
 
 typedef struct {
@@ -37,6 +41,40 @@ typedef struct {
     uint8_t effect_param;
 } mc_xm_event;
 
+// One decoded pattern cell. Zero in every field means an empty cell.
+typedef struct {
+    uint8_t note;
+    uint8_t instrument;
+    uint8_t volume;
+    uint8_t effect_type;
+    uint8_t effect_param;
+} mc_pattern_cell;
+
+// Header fields shared by every module type. Unlike mc_module_info it carries
+// no fixed-size order, pattern or event arrays; those live on mc_module.
+typedef struct {
+    mc_module_type type;
+    char warning[128];
+
+    char title[21];
+    char first_instrument_name[23];
+
+    uint16_t version_major;
+    uint16_t version_minor;
+    uint16_t channels;
+    uint16_t patterns;
+    uint16_t instruments;
+    uint16_t xm_flags;
+    uint16_t song_length;
+    uint16_t restart_position;
+    uint16_t default_tempo;
+    uint16_t default_bpm;
+
+    mc_mod_sample_metadata first_mod_sample;
+} mc_module_header;
+
+// Fixed-capacity summary kept for mc_dump and existing callers. It is filled
+// from an mc_module handle; xm_events stops at MC_MAX_XM_EVENTS with a warning.
 typedef struct {
     mc_module_type type;
     int ok;
@@ -70,7 +108,26 @@ typedef struct {
     mc_mod_sample_metadata first_mod_sample;
 } mc_module_info;
 
+// Header-only result of mc_probe_file. header holds the fields stored before
+// the first pattern; for XM, first_instrument_name is empty because the
+// instruments follow the pattern data. Patterns are not read, so a file that
+// probes ok can still be rejected by mc_module_open.
+typedef struct {
+    int ok;
+    char error[128];
+    uint64_t file_size;
+    mc_module_header header;
+} mc_module_probe;
+
 mc_module_info mc_parse_file(const char *path);
+
+// Identifies a module from its leading bytes: the "Extended Module: "
+// signature for XM, a printable tag at offset 1080 for MOD.
+mc_module_type mc_identify_module(const uint8_t *data, size_t size);
+
+// Reads only the first MC_PROBE_BYTES of path (more only for an XM whose
+// declared header is larger) and fills the basic header fields.
+mc_module_probe mc_probe_file(const char *path);
 const char *mc_module_type_name(mc_module_type type);
 
 #ifdef __cplusplus
@@ -6,6 +6,43 @@
 
 #include "module_types.h"
 
-int mc_parse_xm_header_bytes(const uint8_t *data, size_t size, mc_module_info *out_info);
+// Location of one pattern's packed event data in the file buffer.
+typedef struct {
+    uint16_t row_count;
+    uint16_t packed_size;
+    size_t data_offset;
+} mc_xm_pattern_span;
+
+// Parses the fixed module header. out_orders points into data and holds
+// out_order_count entries, bounded by the declared header size.
+// out_pattern_offset is the byte offset of the first pattern header.
+int mc_xm_parse_header(
+    const uint8_t *data,
+    size_t size,
+    mc_module_header *out_header,
+    const uint8_t **out_orders,
+    uint16_t *out_order_count,
+    size_t *out_pattern_offset
+);
+
+// Reads the pattern header at *offset and advances *offset past its packed
+// data. Returns 0 when the header or its data does not fit in the buffer.
+int mc_xm_next_pattern(const uint8_t *data, size_t size, size_t *offset, mc_xm_pattern_span *out_span);
+
+// Decodes packed pattern data into row_count * channels cells, row-major.
+// The data must decode to exactly packed_size bytes; empty packed data yields
+// an all-empty grid.
+int mc_xm_decode_pattern(
+    const uint8_t *packed,
+    size_t packed_size,
+    uint16_t row_count,
+    uint16_t channels,
+    mc_pattern_cell *out_cells
+);
+
+// Reads the first instrument name at offset (right after the last pattern)
+// into out_header. Returns 0 when instruments are declared but the first
+// instrument header does not fit.
+int mc_xm_read_first_instrument(const uint8_t *data, size_t size, size_t offset, mc_module_header *out_header);
 
 #endif
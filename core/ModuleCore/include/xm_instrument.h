@@ -0,0 +1,109 @@
+#ifndef MC_XM_INSTRUMENT_H
+#define MC_XM_INSTRUMENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "xm_sample.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    MC_XM_KEYMAP_SIZE = 96,
+    MC_XM_MAX_ENVELOPE_POINTS = 12,
+    MC_XM_ENVELOPE_ON = 0x01,
+    MC_XM_ENVELOPE_SUSTAIN = 0x02,
+    MC_XM_ENVELOPE_LOOP = 0x04,
+};
+
+typedef struct {
+    uint16_t tick;
+    uint16_t value;
+} mc_xm_envelope_point;
+
+// Envelope fields as stored in the instrument header. Point indices are raw;
+// callers validate them against point_count.
+typedef struct {
+    mc_xm_envelope_point points[MC_XM_MAX_ENVELOPE_POINTS];
+    uint8_t point_count;
+    uint8_t sustain_point;
+    uint8_t loop_start_point;
+    uint8_t loop_end_point;
+    uint8_t flags;
+} mc_xm_envelope;
+
+// A sample header plus the location of the header and of its delta-encoded
+// body in the module buffer that was parsed. data_in_bounds is 0 when the
+// file ends early.
+typedef struct {
+    mc_xm_sample_header header;
+    size_t header_offset;
+    size_t data_offset;
+    int data_in_bounds;
+} mc_xm_sample_info;
+
+// Keymap, envelope, vibrato and fadeout fields are zero when the instrument
+// header is too short to contain them. Samples for this instrument are
+// table->samples[first_sample ... first_sample + sample_count - 1].
+// header_offset and header_size locate the instrument header in the parsed
+// buffer.
+typedef struct {
+    size_t header_offset;
+    uint32_t header_size;
+    char name[23];
+    uint8_t type;
+    uint16_t sample_count;
+    uint32_t first_sample;
+    int has_keymap;
+    uint8_t keymap[MC_XM_KEYMAP_SIZE];
+    int has_envelopes;
+    mc_xm_envelope volume_envelope;
+    mc_xm_envelope panning_envelope;
+    uint8_t vibrato_type;
+    uint8_t vibrato_sweep;
+    uint8_t vibrato_depth;
+    uint8_t vibrato_rate;
+    uint16_t fadeout;
+} mc_xm_instrument;
+
+typedef struct {
+    uint16_t instrument_count;
+    mc_xm_instrument *instruments;
+    uint32_t sample_count;
+    mc_xm_sample_info *samples;
+    char warning[128];
+} mc_xm_instrument_table;
+
+// A borrowed view of one sample body. It points into the module buffer and is
+// valid only while that buffer is alive.
+typedef struct {
+    const uint8_t *data;
+    size_t length_bytes;
+} mc_xm_sample_view;
+
+// Parses every instrument and sample header of a whole XM file buffer. Parsing
+// stops at the first instrument that does not fit in the buffer; the instruments
+// before it are kept and a warning is set. Returns 0 for non-XM input or when
+// out of memory. Release the table with mc_xm_instrument_table_free.
+int mc_xm_parse_instruments(const uint8_t *data, size_t size, mc_xm_instrument_table *out_table);
+void mc_xm_instrument_table_free(mc_xm_instrument_table *table);
+
+// Byte offset of the first instrument header, after the module header and all
+// patterns. Returns 0 when the header or a pattern is malformed.
+int mc_xm_instrument_data_offset(const uint8_t *data, size_t size, size_t *out_offset);
+
+int mc_xm_sample_view_at(
+    const mc_xm_instrument_table *table,
+    const uint8_t *data,
+    size_t size,
+    uint32_t sample_index,
+    mc_xm_sample_view *out_view
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
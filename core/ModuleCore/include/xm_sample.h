@@ -0,0 +1,65 @@
+#ifndef MC_XM_SAMPLE_H
+#define MC_XM_SAMPLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    MC_XM_SAMPLE_HEADER_SIZE = 40,
+    MC_XM_SAMPLE_TYPE_16BIT = 0x10,
+    MC_XM_SAMPLE_LOOP_TYPE_MASK = 0x03,
+};
+
+// One 40-byte XM sample header. Lengths and loop points are stored in bytes,
+// exactly as in the file; the frame helpers below convert them for 16-bit data.
+typedef struct {
+    uint32_t length_bytes;
+    uint32_t loop_start_bytes;
+    uint32_t loop_length_bytes;
+    uint8_t volume;
+    int8_t finetune;
+    uint8_t type;
+    uint8_t panning;
+    int8_t relative_note;
+    char name[23];
+} mc_xm_sample_header;
+
+int mc_xm_parse_sample_header(const uint8_t *data, size_t size, mc_xm_sample_header *out_header);
+
+int mc_xm_sample_is_16bit(const mc_xm_sample_header *header);
+uint8_t mc_xm_sample_loop_type(const mc_xm_sample_header *header);
+uint32_t mc_xm_sample_frame_count(const mc_xm_sample_header *header);
+
+// Loop bounds in frames, clamped to the sample length. The loop length is zero
+// when the header has no loop type.
+uint32_t mc_xm_sample_loop_start_frame(const mc_xm_sample_header *header);
+uint32_t mc_xm_sample_loop_length_frames(const mc_xm_sample_header *header);
+
+// Delta decoders for XM sample bodies. src holds count deltas: bytes for 8-bit
+// data, little-endian words for 16-bit data. The running sum wraps like the
+// original tracker. Float variants scale by 1/128 and 1/32768.
+void mc_xm_delta_decode_8(const uint8_t *src, size_t count, int8_t *dst);
+void mc_xm_delta_decode_16(const uint8_t *src, size_t count, int16_t *dst);
+void mc_xm_delta_decode_8_to_float(const uint8_t *src, size_t count, float *dst);
+void mc_xm_delta_decode_16_to_float(const uint8_t *src, size_t count, float *dst);
+
+// Decodes one sample body into mono Float32, the format MixerCore voices copy.
+// body_size must cover header->length_bytes and dst must hold
+// mc_xm_sample_frame_count(header) frames. Returns 1 on success.
+int mc_xm_decode_sample_float(
+    const mc_xm_sample_header *header,
+    const uint8_t *body,
+    size_t body_size,
+    float *dst,
+    size_t dst_frame_capacity
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
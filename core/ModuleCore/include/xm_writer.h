@@ -0,0 +1,41 @@
+#ifndef MC_XM_WRITER_H
+#define MC_XM_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "module_handle.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    // A cell with all five fields is stored raw in five bytes unless its note
+    // has bit 7 set, which needs a packing byte in front.
+    MC_XM_MAX_PACKED_CELL_BYTES = 6,
+    MC_XM_MAX_PACKED_PATTERN_SIZE = 0xFFFF,
+};
+
+// Packs cell_count cells the way FastTracker 2 does. out must hold
+// cell_count * MC_XM_MAX_PACKED_CELL_BYTES bytes. Returns the packed size,
+// which is 0 when every cell is empty: such patterns are stored without
+// packed data.
+size_t mc_xm_pack_pattern(const mc_pattern_cell *cells, size_t cell_count, uint8_t *out);
+
+// Saves an XM handle to path. Only dirty patterns are re-packed and only
+// dirty instrument and sample headers are rewritten; every other byte range,
+// including all sample bodies and any data the parser does not understand,
+// is copied unchanged from the handle's source bytes in a few large writes.
+// The file is written to a new, uniquely named temp file next to path (with
+// path's permission bits when it exists) and renamed over it, so path may be
+// the file the handle was opened from. The handle keeps reading the original
+// bytes, so its edits stay dirty; reopen the saved file for a new baseline.
+// Returns 0 and fills error on failure, leaving path untouched.
+int mc_module_write_xm(mc_module *module, const char *path, char *error, size_t error_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -52,6 +52,24 @@ static uint32_t read_be_u16_words_as_bytes(const uint8_t *p) {
     return (uint32_t)(((uint16_t)p[0] << 8) | p[1]) * 2u;
 }
 
+// Finetune-0 periods from the ProTracker octaves 0-4 (C-0 = 1712), in
+// descending order. Index 0 is XM note C-2.
+static const uint16_t mod_note_periods[60] = {
+    1712, 1616, 1524, 1440, 1356, 1280, 1208, 1140, 1076, 1016, 960, 907,
+    856, 808, 762, 720, 678, 640, 604, 570, 538, 508, 480, 453,
+    428, 404, 381, 360, 339, 320, 302, 285, 269, 254, 240, 226,
+    214, 202, 190, 180, 170, 160, 151, 143, 135, 127, 120, 113,
+    107, 101, 95, 90, 85, 80, 75, 71, 67, 63, 60, 56,
+};
+
+enum {
+    MOD_FIRST_TABLE_NOTE = 25,
+};
+
+static uint16_t read_be_u16(const uint8_t *p) {
+    return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
 static int8_t mod_finetune_from_nibble(uint8_t v) {
     v &= 0x0F;
     if (v >= 8) {
@@ -60,14 +78,20 @@ static int8_t mod_finetune_from_nibble(uint8_t v) {
     return (int8_t)v;
 }
 
-int mc_parse_mod_header_bytes(const uint8_t *data, size_t size, mc_module_info *out_info) {
-    const size_t mod_header_size = 1084;
+int mc_mod_parse_header(
+    const uint8_t *data,
+    size_t size,
+    mc_module_header *out_header,
+    const uint8_t **out_orders,
+    uint16_t *out_order_count
+) {
+    const size_t mod_header_size = MC_MOD_HEADER_SIZE;
     const uint8_t *sig;
     uint8_t max_pattern = 0;
     size_t entries;
     size_t i;
 
-    if (data == NULL || out_info == NULL) {
+    if (data == NULL || out_header == NULL || out_orders == NULL || out_order_count == NULL) {
         return 0;
     }
     if (size < mod_header_size) {
@@ -79,30 +103,24 @@ int mc_parse_mod_header_bytes(const uint8_t *data, size_t size, mc_module_info *
         return 0;
     }
 
-    memset(out_info, 0, sizeof(*out_info));
-    out_info->type = MC_MODULE_TYPE_MOD;
-    out_info->ok = 1;
-    copy_trimmed(out_info->title, sizeof(out_info->title), data, 20);
-    out_info->channels = channels_from_sig(sig);
-    if (out_info->channels == 0) {
-        out_info->channels = 4;
-        snprintf(out_info->warning, sizeof(out_info->warning), "unknown MOD signature, defaulting to 4 channels");
-    }
-    out_info->instruments = 31;
-    out_info->song_length = data[950];
-    out_info->restart_position = data[951];
-    out_info->order_table_length = out_info->song_length;
-    if (out_info->order_table_length == 0 || out_info->order_table_length > 128) {
-        out_info->order_table_length = 128;
+    memset(out_header, 0, sizeof(*out_header));
+    out_header->type = MC_MODULE_TYPE_MOD;
+    copy_trimmed(out_header->title, sizeof(out_header->title), data, 20);
+    out_header->channels = channels_from_sig(sig);
+    if (out_header->channels == 0) {
+        out_header->channels = 4;
+        snprintf(out_header->warning, sizeof(out_header->warning), "unknown MOD signature, defaulting to 4 channels");
     }
-    memcpy(out_info->order_table, data + 952, out_info->order_table_length);
+    out_header->instruments = 31;
+    out_header->song_length = data[950];
+    out_header->restart_position = data[951];
 
-    copy_trimmed(out_info->first_mod_sample.name, sizeof(out_info->first_mod_sample.name), data + 20, 22);
-    out_info->first_mod_sample.length_bytes = read_be_u16_words_as_bytes(data + 42);
-    out_info->first_mod_sample.finetune = mod_finetune_from_nibble(data[44]);
-    out_info->first_mod_sample.volume = data[45];
+    copy_trimmed(out_header->first_mod_sample.name, sizeof(out_header->first_mod_sample.name), data + 20, 22);
+    out_header->first_mod_sample.length_bytes = read_be_u16_words_as_bytes(data + 42);
+    out_header->first_mod_sample.finetune = mod_finetune_from_nibble(data[44]);
+    out_header->first_mod_sample.volume = data[45];
 
-    entries = out_info->song_length;
+    entries = out_header->song_length;
     if (entries == 0 || entries > 128) {
         entries = 128;
     }
@@ -112,7 +130,82 @@ int mc_parse_mod_header_bytes(const uint8_t *data, size_t size, mc_module_info *
             max_pattern = pattern;
         }
     }
-    out_info->patterns = entries > 0 ? (uint16_t)(max_pattern + 1) : 0;
+    out_header->patterns = entries > 0 ? (uint16_t)(max_pattern + 1) : 0;
+    *out_orders = data + 952;
+    *out_order_count = (uint16_t)entries;
 
     return 1;
 }
+
+int mc_mod_sample_name(const uint8_t *data, size_t size, uint16_t index, char *out_name, size_t out_size) {
+    if (data == NULL || out_name == NULL || out_size == 0 || size < MC_MOD_HEADER_SIZE || index >= MC_MOD_SAMPLE_COUNT) {
+        return 0;
+    }
+    copy_trimmed(out_name, out_size, data + 20 + (size_t)index * 30u, 22);
+    return 1;
+}
+
+int mc_mod_parse_sample_header(const uint8_t *data, size_t size, uint16_t index, mc_mod_sample_header *out_header) {
+    const uint8_t *p;
+
+    if (data == NULL || out_header == NULL || size < MC_MOD_HEADER_SIZE || index >= MC_MOD_SAMPLE_COUNT) {
+        return 0;
+    }
+    p = data + 20 + (size_t)index * 30u;
+    memset(out_header, 0, sizeof(*out_header));
+    copy_trimmed(out_header->name, sizeof(out_header->name), p, 22);
+    out_header->length_bytes = read_be_u16_words_as_bytes(p + 22);
+    out_header->finetune = mod_finetune_from_nibble(p[24]);
+    out_header->volume = p[25] > 64 ? 64 : p[25];
+    out_header->loop_start_bytes = read_be_u16_words_as_bytes(p + 26);
+    out_header->loop_length_bytes = read_be_u16_words_as_bytes(p + 28);
+    return 1;
+}
+
+size_t mc_mod_pattern_size(uint16_t channels) {
+    return (size_t)MC_MOD_ROWS_PER_PATTERN * channels * MC_MOD_CELL_BYTES;
+}
+
+uint8_t mc_mod_period_to_note(uint16_t period) {
+    size_t low = 0;
+    size_t high = sizeof(mod_note_periods) / sizeof(mod_note_periods[0]) - 1u;
+
+    if (period == 0) {
+        return 0;
+    }
+    if (period >= mod_note_periods[low]) {
+        return MOD_FIRST_TABLE_NOTE;
+    }
+    if (period <= mod_note_periods[high]) {
+        return (uint8_t)(MOD_FIRST_TABLE_NOTE + high);
+    }
+    // Find the neighbours with mod_note_periods[low] > period >= [high].
+    while (high - low > 1u) {
+        size_t middle = (low + high) / 2u;
+        if (mod_note_periods[middle] > period) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    if ((uint32_t)mod_note_periods[low] - period < (uint32_t)period - mod_note_periods[high]) {
+        return (uint8_t)(MOD_FIRST_TABLE_NOTE + low);
+    }
+    return (uint8_t)(MOD_FIRST_TABLE_NOTE + high);
+}
+
+void mc_mod_decode_pattern(const uint8_t *data, uint16_t channels, mc_pattern_cell *out_cells) {
+    size_t cell_count = (size_t)MC_MOD_ROWS_PER_PATTERN * channels;
+    size_t i;
+
+    for (i = 0; i < cell_count; i++) {
+        const uint8_t *p = data + i * MC_MOD_CELL_BYTES;
+        mc_pattern_cell *cell = &out_cells[i];
+
+        cell->note = mc_mod_period_to_note((uint16_t)(read_be_u16(p) & 0x0FFF));
+        cell->instrument = (uint8_t)((p[0] & 0xF0) | (p[2] >> 4));
+        cell->volume = 0;
+        cell->effect_type = (uint8_t)(p[2] & 0x0F);
+        cell->effect_param = p[3];
+    }
+}
@@ -0,0 +1,158 @@
+#include "module_bytes_io.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+enum {
+    BYTES_TEMP_OPEN_ATTEMPTS = 64,
+};
+
+void mc_bytes_set_error(char *error, size_t error_size, const char *message, int err) {
+    if (error == NULL || error_size == 0) {
+        return;
+    }
+    if (err != 0) {
+        snprintf(error, error_size, "%s: %s", message, strerror(err));
+    } else {
+        snprintf(error, error_size, "%s", message);
+    }
+}
+
+void mc_bytes_put(mc_byte_writer *writer, const void *bytes, size_t count) {
+    if (writer->failed) {
+        return;
+    }
+    if (writer->capacity - writer->size < count) {
+        size_t capacity = writer->capacity > 0 ? writer->capacity : 4096u;
+        uint8_t *grown;
+        while (capacity - writer->size < count) {
+            capacity *= 2u;
+        }
+        grown = (uint8_t *)realloc(writer->data, capacity);
+        if (grown == NULL) {
+            writer->failed = 1;
+            return;
+        }
+        writer->data = grown;
+        writer->capacity = capacity;
+    }
+    memcpy(writer->data + writer->size, bytes, count);
+    writer->size += count;
+}
+
+void mc_bytes_put_uint(mc_byte_writer *writer, uint64_t value, size_t width) {
+    uint8_t bytes[8];
+    size_t i;
+
+    for (i = 0; i < width; i++) {
+        bytes[i] = (uint8_t)(value >> (8u * i));
+    }
+    mc_bytes_put(writer, bytes, width);
+}
+
+void mc_bytes_put_string(mc_byte_writer *writer, const char *s, size_t length_width, size_t max_length) {
+    size_t length = strnlen(s, max_length);
+
+    mc_bytes_put_uint(writer, length, length_width);
+    mc_bytes_put(writer, s, length);
+}
+
+const uint8_t *mc_bytes_take(mc_byte_reader *reader, size_t count) {
+    const uint8_t *p;
+
+    if (reader->failed || reader->size - reader->offset < count) {
+        reader->failed = 1;
+        return NULL;
+    }
+    p = reader->data + reader->offset;
+    reader->offset += count;
+    return p;
+}
+
+uint64_t mc_bytes_take_uint(mc_byte_reader *reader, size_t width) {
+    const uint8_t *p = mc_bytes_take(reader, width);
+    uint64_t value = 0;
+    size_t i;
+
+    if (p == NULL) {
+        return 0;
+    }
+    for (i = 0; i < width; i++) {
+        value |= (uint64_t)p[i] << (8u * i);
+    }
+    return value;
+}
+
+void mc_bytes_take_string(mc_byte_reader *reader, char *dst, size_t dst_size) {
+    size_t length = (size_t)mc_bytes_take_uint(reader, 1);
+    const uint8_t *p = mc_bytes_take(reader, length);
+
+    dst[0] = '\0';
+    if (p == NULL || length >= dst_size) {
+        reader->failed = 1;
+        return;
+    }
+    memcpy(dst, p, length);
+    dst[length] = '\0';
+}
+
+int mc_bytes_open_temp_file(const char *path, char **out_temp_path, char *error, size_t error_size) {
+    size_t temp_path_size = strlen(path) + sizeof(".save-4294967295-4294967295");
+    char *temp_path = (char *)malloc(temp_path_size);
+    struct timespec now;
+    struct stat st;
+    unsigned int seed;
+    int attempt;
+    int fd = -1;
+
+    *out_temp_path = NULL;
+    if (temp_path == NULL) {
+        mc_bytes_set_error(error, error_size, "out of memory", 0);
+        return -1;
+    }
+    clock_gettime(CLOCK_REALTIME, &now);
+    seed = (unsigned int)now.tv_nsec ^ ((unsigned int)now.tv_sec << 16);
+    for (attempt = 0; attempt < BYTES_TEMP_OPEN_ATTEMPTS; attempt++) {
+        snprintf(temp_path, temp_path_size, "%s.save-%u-%u",
+            path, (unsigned int)getpid(), seed + (unsigned int)attempt * 2654435761u);
+        fd = open(temp_path, O_WRONLY | O_CREAT | O_EXCL, 0666);
+        if (fd >= 0 || errno != EEXIST) {
+            break;
+        }
+    }
+    if (fd < 0) {
+        mc_bytes_set_error(error, error_size, "open failed", errno);
+        free(temp_path);
+        return -1;
+    }
+    if (stat(path, &st) == 0 && fchmod(fd, st.st_mode & 07777) != 0) {
+        mc_bytes_set_error(error, error_size, "chmod failed", errno);
+        close(fd);
+        unlink(temp_path);
+        free(temp_path);
+        return -1;
+    }
+    *out_temp_path = temp_path;
+    return fd;
+}
+
+int mc_bytes_write_all(int fd, const uint8_t *data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno;
+        }
+        data += n;
+        size -= (size_t)n;
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+#ifndef MC_MODULE_BYTES_IO_H
+#define MC_MODULE_BYTES_IO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Little-endian serialization shared by the module index and snapshot
+// formats, and the temp-file-and-rename output of the writers. Internal to
+// ModuleCore.
+
+// Growable output buffer. The first failed allocation sets failed and every
+// later put is ignored, so a writer is checked once after the last put.
+typedef struct {
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+    int failed;
+} mc_byte_writer;
+
+// Cursor over a byte range. Reading past the end sets failed and every later
+// take returns nothing.
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+    size_t offset;
+    int failed;
+} mc_byte_reader;
+
+// Writes "message" or "message: strerror(err)" for a non-zero err.
+void mc_bytes_set_error(char *error, size_t error_size, const char *message, int err);
+
+void mc_bytes_put(mc_byte_writer *writer, const void *bytes, size_t count);
+// Writes the low width bytes (at most 8) of value.
+void mc_bytes_put_uint(mc_byte_writer *writer, uint64_t value, size_t width);
+// Writes at most max_length bytes of s after their count as a length_width
+// byte integer.
+void mc_bytes_put_string(mc_byte_writer *writer, const char *s, size_t length_width, size_t max_length);
+
+// Returns the next count bytes, or NULL when fewer remain.
+const uint8_t *mc_bytes_take(mc_byte_reader *reader, size_t count);
+uint64_t mc_bytes_take_uint(mc_byte_reader *reader, size_t width);
+// Reads a u8-length-prefixed string into dst, failing when it does not fit
+// with its terminator.
+void mc_bytes_take_string(mc_byte_reader *reader, char *dst, size_t dst_size);
+
+// Creates a new, uniquely named file next to path for writing and returns
+// its descriptor, or -1 with error filled. O_EXCL never reuses or follows an
+// existing file, so stale temp files, symlinks and concurrent saves are left
+// alone. When path exists the temp file takes its permission bits, so the
+// rename keeps them; otherwise the usual umask applies. The caller renames
+// *out_temp_path over path, or unlinks it, and frees it.
+int mc_bytes_open_temp_file(const char *path, char **out_temp_path, char *error, size_t error_size);
+// Returns 0 or the errno of the failed write.
+int mc_bytes_write_all(int fd, const uint8_t *data, size_t size);
+
+#endif
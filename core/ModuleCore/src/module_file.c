@@ -0,0 +1,186 @@
+#include "module_file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static void set_error(char *error, size_t error_size, const char *message, int err) {
+    if (error == NULL || error_size == 0) {
+        return;
+    }
+    if (err != 0) {
+        snprintf(error, error_size, "%s: %s", message, strerror(err));
+    } else {
+        snprintf(error, error_size, "%s", message);
+    }
+}
+
+static int read_all(int fd, size_t size_hint, uint8_t **out_data, size_t *out_size) {
+    size_t capacity = size_hint > 0 ? size_hint : 65536u;
+    size_t size = 0;
+    uint8_t *data = (uint8_t *)malloc(capacity);
+
+    if (data == NULL) {
+        return ENOMEM;
+    }
+    for (;;) {
+        ssize_t n;
+        if (size == capacity) {
+            uint8_t *grown;
+            if (capacity > SIZE_MAX / 2u) {
+                free(data);
+                return EFBIG;
+            }
+            grown = (uint8_t *)realloc(data, capacity * 2u);
+            if (grown == NULL) {
+                free(data);
+                return ENOMEM;
+            }
+            data = grown;
+            capacity *= 2u;
+        }
+        n = read(fd, data + size, capacity - size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            free(data);
+            return errno;
+        }
+        if (n == 0) {
+            break;
+        }
+        size += (size_t)n;
+    }
+    *out_data = data;
+    *out_size = size;
+    return 0;
+}
+
+int mc_file_bytes_open(const char *path, mc_file_bytes *out_bytes, char *error, size_t error_size) {
+    struct stat st;
+    uint8_t *buffer = NULL;
+    size_t size = 0;
+    int fd;
+    int err;
+
+    if (out_bytes == NULL) {
+        return 0;
+    }
+    memset(out_bytes, 0, sizeof(*out_bytes));
+    if (path == NULL || path[0] == '\0') {
+        set_error(error, error_size, "invalid path", 0);
+        return 0;
+    }
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        set_error(error, error_size, "open failed", errno);
+        return 0;
+    }
+    if (fstat(fd, &st) != 0) {
+        set_error(error, error_size, "stat failed", errno);
+        close(fd);
+        return 0;
+    }
+    if (S_ISDIR(st.st_mode)) {
+        set_error(error, error_size, "open failed", EISDIR);
+        close(fd);
+        return 0;
+    }
+
+    if (S_ISREG(st.st_mode) && st.st_size > 0 && (uint64_t)st.st_size <= (uint64_t)SIZE_MAX) {
+        void *mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            close(fd);
+            out_bytes->data = (const uint8_t *)mapping;
+            out_bytes->size = (size_t)st.st_size;
+            out_bytes->mapped = 1;
+            return 1;
+        }
+    }
+
+    err = read_all(fd, S_ISREG(st.st_mode) && st.st_size > 0 ? (size_t)st.st_size : 0u, &buffer, &size);
+    close(fd);
+    if (err != 0) {
+        set_error(error, error_size, "read failed", err);
+        return 0;
+    }
+    out_bytes->data = buffer;
+    out_bytes->size = size;
+    out_bytes->mapped = 0;
+    return 1;
+}
+
+int mc_file_read_prefix(
+    const char *path,
+    uint8_t *buffer,
+    size_t capacity,
+    size_t *out_size,
+    uint64_t *out_file_size,
+    char *error,
+    size_t error_size
+) {
+    struct stat st;
+    size_t size = 0;
+    int fd;
+
+    if (buffer == NULL || out_size == NULL || out_file_size == NULL) {
+        return 0;
+    }
+    if (path == NULL || path[0] == '\0') {
+        set_error(error, error_size, "invalid path", 0);
+        return 0;
+    }
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        set_error(error, error_size, "open failed", errno);
+        return 0;
+    }
+    if (fstat(fd, &st) != 0) {
+        set_error(error, error_size, "stat failed", errno);
+        close(fd);
+        return 0;
+    }
+    if (S_ISDIR(st.st_mode)) {
+        set_error(error, error_size, "open failed", EISDIR);
+        close(fd);
+        return 0;
+    }
+    while (size < capacity) {
+        ssize_t n = read(fd, buffer + size, capacity - size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            set_error(error, error_size, "read failed", errno);
+            close(fd);
+            return 0;
+        }
+        if (n == 0) {
+            break;
+        }
+        size += (size_t)n;
+    }
+    close(fd);
+    *out_size = size;
+    *out_file_size = S_ISREG(st.st_mode) ? (uint64_t)st.st_size : (uint64_t)size;
+    return 1;
+}
+
+void mc_file_bytes_close(mc_file_bytes *bytes) {
+    if (bytes == NULL) {
+        return;
+    }
+    if (bytes->mapped) {
+        munmap((void *)bytes->data, bytes->size);
+    } else {
+        free((void *)bytes->data);
+    }
+    memset(bytes, 0, sizeof(*bytes));
+}
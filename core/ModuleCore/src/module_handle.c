@@ -0,0 +1,817 @@
+#include "module_handle.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "mod_header.h"
+#include "module_file.h"
+#include "xm_header.h"
+
+typedef enum {
+    MC_PATTERN_UNDECODED = 0,
+    MC_PATTERN_DECODED,
+    MC_PATTERN_INVALID,
+} mc_pattern_state;
+
+typedef struct {
+    uint16_t row_count;
+    uint16_t packed_size;
+    size_t data_offset;
+    mc_pattern_state state;
+    int dirty;
+    uint32_t last_use;
+    mc_pattern_cell *cells;
+} mc_module_pattern;
+
+struct mc_module {
+    mc_file_bytes bytes;
+    mc_module_header header;
+    const uint8_t *orders;
+    uint16_t order_count;
+    uint16_t pattern_count;
+    mc_module_pattern *patterns;
+    uint32_t flags;
+    uint16_t pattern_cache_capacity;
+    uint16_t resident_pattern_count;
+    uint32_t pattern_use_clock;
+    int has_xm_instruments;
+    mc_xm_instrument_table xm_instruments;
+    int has_mod_samples;
+    mc_mod_sample_header mod_samples[MC_MOD_SAMPLE_COUNT];
+    size_t mod_sample_offsets[MC_MOD_SAMPLE_COUNT];
+    uint8_t *instrument_dirty;
+    mc_module_info *info;
+};
+
+enum {
+    MC_LOAD_OK = 0,
+    MC_LOAD_INVALID,
+    MC_LOAD_NO_MEMORY,
+};
+
+enum {
+    // Thread startup costs about as much as decoding this many packed bytes,
+    // so the internal pool gives each thread at least this much work.
+    MC_PARALLEL_DECODE_MIN_BYTES_PER_THREAD = 32 * 1024,
+};
+
+static void set_error(char *error, size_t error_size, const char *message) {
+    if (error != NULL && error_size > 0) {
+        snprintf(error, error_size, "%s", message);
+    }
+}
+
+static void free_patterns(mc_module *module) {
+    uint16_t i;
+
+    for (i = 0; i < module->pattern_count; i++) {
+        free(module->patterns[i].cells);
+    }
+    free(module->patterns);
+    module->patterns = NULL;
+    module->pattern_count = 0;
+    module->resident_pattern_count = 0;
+}
+
+static void evict_least_recent_pattern(mc_module *module) {
+    mc_module_pattern *oldest = NULL;
+    uint16_t i;
+
+    for (i = 0; i < module->pattern_count; i++) {
+        mc_module_pattern *pattern = &module->patterns[i];
+        if (pattern->cells != NULL && !pattern->dirty && (oldest == NULL || pattern->last_use < oldest->last_use)) {
+            oldest = pattern;
+        }
+    }
+    if (oldest != NULL) {
+        free(oldest->cells);
+        oldest->cells = NULL;
+        oldest->state = MC_PATTERN_UNDECODED;
+        module->resident_pattern_count--;
+    }
+}
+
+// Every cell takes at least one packed byte, which bounds the grid
+// allocation by the file size.
+static int pattern_needs_grid(const mc_module *module, const mc_module_pattern *pattern) {
+    size_t cell_count = (size_t)pattern->row_count * module->header.channels;
+
+    return pattern->packed_size > 0 && cell_count > 0 && cell_count <= pattern->packed_size;
+}
+
+// Decodes one undecoded pattern into its own grid. Only the pattern itself is
+// written, so different patterns can be decoded on different threads; the
+// cache bookkeeping is left to the caller.
+static int decode_pattern_grid(const mc_module *module, mc_module_pattern *pattern) {
+    size_t cell_count = (size_t)pattern->row_count * module->header.channels;
+
+    if (pattern->state == MC_PATTERN_DECODED) {
+        return MC_LOAD_OK;
+    }
+    if (pattern->state == MC_PATTERN_INVALID) {
+        return MC_LOAD_INVALID;
+    }
+    if (cell_count == 0 && pattern->packed_size > 0) {
+        pattern->state = MC_PATTERN_INVALID;
+        return MC_LOAD_INVALID;
+    }
+    if (pattern->packed_size == 0 || cell_count == 0) {
+        pattern->state = MC_PATTERN_DECODED;
+        return MC_LOAD_OK;
+    }
+    if (!pattern_needs_grid(module, pattern)) {
+        pattern->state = MC_PATTERN_INVALID;
+        return MC_LOAD_INVALID;
+    }
+
+    pattern->cells = (mc_pattern_cell *)malloc(cell_count * sizeof(*pattern->cells));
+    if (pattern->cells == NULL) {
+        return MC_LOAD_NO_MEMORY;
+    }
+    if (module->header.type == MC_MODULE_TYPE_MOD) {
+        mc_mod_decode_pattern(module->bytes.data + pattern->data_offset, module->header.channels, pattern->cells);
+    } else if (!mc_xm_decode_pattern(
+            module->bytes.data + pattern->data_offset,
+            pattern->packed_size,
+            pattern->row_count,
+            module->header.channels,
+            pattern->cells)) {
+        free(pattern->cells);
+        pattern->cells = NULL;
+        pattern->state = MC_PATTERN_INVALID;
+        return MC_LOAD_INVALID;
+    }
+    pattern->state = MC_PATTERN_DECODED;
+    return MC_LOAD_OK;
+}
+
+static int decode_pattern(mc_module *module, uint16_t index) {
+    mc_module_pattern *pattern = &module->patterns[index];
+    int was_resident = pattern->cells != NULL;
+    int status;
+
+    if (pattern->state == MC_PATTERN_UNDECODED && pattern_needs_grid(module, pattern) &&
+        (module->flags & MC_MODULE_OPEN_EAGER_PATTERNS) == 0 &&
+        module->resident_pattern_count >= module->pattern_cache_capacity) {
+        evict_least_recent_pattern(module);
+    }
+    status = decode_pattern_grid(module, pattern);
+    if (status == MC_LOAD_OK) {
+        if (pattern->cells != NULL && !was_resident) {
+            module->resident_pattern_count++;
+        }
+        pattern->last_use = ++module->pattern_use_clock;
+    }
+    return status;
+}
+
+typedef struct {
+    size_t count;
+    mc_pattern_task task;
+    void *task_context;
+    atomic_size_t next;
+} pool_work;
+
+static void *run_pool_work(void *arg) {
+    pool_work *work = (pool_work *)arg;
+
+    for (;;) {
+        size_t index = atomic_fetch_add(&work->next, 1);
+        if (index >= work->count) {
+            break;
+        }
+        work->task(work->task_context, index);
+    }
+    return NULL;
+}
+
+// The internal executor: context points at the thread count. The calling
+// thread takes part, and a thread that cannot be started just leaves more
+// work for the others.
+static void pool_parallel_for(void *context, size_t count, mc_pattern_task task, void *task_context) {
+    size_t thread_count = *(const size_t *)context;
+    pthread_t threads[MC_MODULE_MAX_DECODE_THREADS];
+    size_t started = 0;
+    size_t i;
+    pool_work work;
+
+    work.count = count;
+    work.task = task;
+    work.task_context = task_context;
+    atomic_init(&work.next, 0);
+    while (started + 1u < thread_count && started + 1u < count) {
+        if (pthread_create(&threads[started], NULL, run_pool_work, &work) != 0) {
+            break;
+        }
+        started++;
+    }
+    run_pool_work(&work);
+    for (i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+static size_t pool_thread_count(uint16_t requested, size_t packed_bytes) {
+    size_t count = requested;
+    size_t useful = packed_bytes / MC_PARALLEL_DECODE_MIN_BYTES_PER_THREAD;
+
+    if (count == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        count = online > 0 ? (size_t)online : 1u;
+    }
+    if (count > useful) {
+        count = useful;
+    }
+    if (count > MC_MODULE_MAX_DECODE_THREADS) {
+        count = MC_MODULE_MAX_DECODE_THREADS;
+    }
+    return count > 0 ? count : 1u;
+}
+
+typedef struct {
+    mc_module *module;
+    const uint16_t *indices;
+    int *status;
+} pattern_batch;
+
+static void decode_pattern_task(void *task_context, size_t index) {
+    pattern_batch *batch = (pattern_batch *)task_context;
+    uint16_t pattern = batch->indices[index];
+
+    batch->status[pattern] = decode_pattern_grid(batch->module, &batch->module->patterns[pattern]);
+}
+
+// Decodes all patterns and pins them resident. On failure *out_failed is the
+// lowest failing pattern and the status is the one decode_pattern reports for
+// it, so callers cannot tell this from a serial loop.
+static int decode_all_patterns(
+    mc_module *module,
+    uint16_t thread_count,
+    const mc_pattern_executor *executor,
+    uint16_t *out_failed
+) {
+    pattern_batch batch;
+    uint16_t *indices;
+    size_t pending = 0;
+    size_t packed_bytes = 0;
+    uint16_t i;
+
+    module->flags |= MC_MODULE_OPEN_EAGER_PATTERNS;
+    if (module->pattern_count == 0) {
+        return MC_LOAD_OK;
+    }
+    indices = (uint16_t *)malloc(module->pattern_count * sizeof(*indices));
+    batch.status = (int *)malloc(module->pattern_count * sizeof(*batch.status));
+    if (indices == NULL || batch.status == NULL) {
+        free(indices);
+        free(batch.status);
+        for (i = 0; i < module->pattern_count; i++) {
+            int status = decode_pattern(module, i);
+            if (status != MC_LOAD_OK) {
+                *out_failed = i;
+                return status;
+            }
+        }
+        return MC_LOAD_OK;
+    }
+
+    for (i = 0; i < module->pattern_count; i++) {
+        mc_module_pattern *pattern = &module->patterns[i];
+        if (pattern->state == MC_PATTERN_UNDECODED) {
+            indices[pending++] = i;
+            packed_bytes += pattern->packed_size;
+        } else {
+            batch.status[i] = decode_pattern_grid(module, pattern);
+        }
+    }
+    batch.module = module;
+    batch.indices = indices;
+    if (pending > 0) {
+        if (executor != NULL && executor->parallel_for != NULL) {
+            executor->parallel_for(executor->context, pending, decode_pattern_task, &batch);
+        } else {
+            size_t threads = pool_thread_count(thread_count, packed_bytes);
+            pool_parallel_for(&threads, pending, decode_pattern_task, &batch);
+        }
+    }
+    free(indices);
+
+    module->resident_pattern_count = 0;
+    for (i = 0; i < module->pattern_count; i++) {
+        mc_module_pattern *pattern = &module->patterns[i];
+        if (pattern->cells != NULL) {
+            pattern->last_use = ++module->pattern_use_clock;
+            module->resident_pattern_count++;
+        }
+    }
+    for (i = 0; i < module->pattern_count; i++) {
+        if (batch.status[i] != MC_LOAD_OK) {
+            int status = batch.status[i];
+            free(batch.status);
+            *out_failed = i;
+            return status;
+        }
+    }
+    free(batch.status);
+    return MC_LOAD_OK;
+}
+
+static int decode_patterns_for_open(mc_module *module, const mc_module_open_options *options) {
+    uint16_t i;
+
+    if ((module->flags & MC_MODULE_OPEN_PARALLEL_PATTERNS) != 0) {
+        uint16_t failed;
+        int status = decode_all_patterns(module, options->decode_threads, options->executor, &failed);
+        if (status != MC_LOAD_OK) {
+            return status;
+        }
+    } else if ((module->flags & MC_MODULE_OPEN_EAGER_PATTERNS) != 0) {
+        for (i = 0; i < module->pattern_count; i++) {
+            int status = decode_pattern(module, i);
+            if (status != MC_LOAD_OK) {
+                return status;
+            }
+        }
+    }
+    return MC_LOAD_OK;
+}
+
+static int load_xm(mc_module *module, const mc_module_open_options *options) {
+    const uint8_t *data = module->bytes.data;
+    size_t size = module->bytes.size;
+    size_t offset;
+    uint16_t i;
+    int status;
+
+    if (!mc_xm_parse_header(data, size, &module->header, &module->orders, &module->order_count, &offset)) {
+        return MC_LOAD_INVALID;
+    }
+    if (module->header.patterns > 0) {
+        module->patterns = (mc_module_pattern *)calloc(module->header.patterns, sizeof(*module->patterns));
+        if (module->patterns == NULL) {
+            return MC_LOAD_NO_MEMORY;
+        }
+    }
+
+    // Index pass: only pattern headers are read here.
+    for (i = 0; i < module->header.patterns; i++) {
+        mc_module_pattern *pattern = &module->patterns[i];
+        mc_xm_pattern_span span;
+
+        module->pattern_count = (uint16_t)(i + 1u);
+        if (!mc_xm_next_pattern(data, size, &offset, &span)) {
+            return MC_LOAD_INVALID;
+        }
+        pattern->row_count = span.row_count;
+        pattern->packed_size = span.packed_size;
+        pattern->data_offset = span.data_offset;
+    }
+
+    if (!mc_xm_read_first_instrument(data, size, offset, &module->header)) {
+        return MC_LOAD_INVALID;
+    }
+    status = decode_patterns_for_open(module, options);
+    if (status != MC_LOAD_OK) {
+        return status;
+    }
+    // A malformed instrument section leaves the header and patterns usable
+    // but exposes no instruments.
+    module->has_xm_instruments = mc_xm_parse_instruments(data, size, &module->xm_instruments);
+    return MC_LOAD_OK;
+}
+
+// Sample bodies follow the pattern data in header order. A file cut off
+// before the end of its pattern data keeps the header-only view with no
+// patterns; cut-off sample bodies are clamped by mc_module_mod_sample_view.
+static int load_mod(mc_module *module, const mc_module_open_options *options) {
+    const uint8_t *data = module->bytes.data;
+    size_t size = module->bytes.size;
+    size_t pattern_size;
+    size_t offset;
+    uint16_t i;
+
+    if (!mc_mod_parse_header(data, size, &module->header, &module->orders, &module->order_count)) {
+        return MC_LOAD_INVALID;
+    }
+    pattern_size = mc_mod_pattern_size(module->header.channels);
+    offset = MC_MOD_HEADER_SIZE + (size_t)module->header.patterns * pattern_size;
+    for (i = 0; i < MC_MOD_SAMPLE_COUNT; i++) {
+        mc_mod_parse_sample_header(data, size, i, &module->mod_samples[i]);
+        module->mod_sample_offsets[i] = offset;
+        offset += module->mod_samples[i].length_bytes;
+    }
+    module->has_mod_samples = 1;
+    if (module->header.patterns == 0 || pattern_size > 0xFFFFu ||
+        MC_MOD_HEADER_SIZE + (size_t)module->header.patterns * pattern_size > size) {
+        return MC_LOAD_OK;
+    }
+
+    module->patterns = (mc_module_pattern *)calloc(module->header.patterns, sizeof(*module->patterns));
+    if (module->patterns == NULL) {
+        return MC_LOAD_NO_MEMORY;
+    }
+    module->pattern_count = module->header.patterns;
+    for (i = 0; i < module->pattern_count; i++) {
+        module->patterns[i].row_count = MC_MOD_ROWS_PER_PATTERN;
+        module->patterns[i].packed_size = (uint16_t)pattern_size;
+        module->patterns[i].data_offset = MC_MOD_HEADER_SIZE + (size_t)i * pattern_size;
+    }
+    return decode_patterns_for_open(module, options);
+}
+
+
+mc_module *mc_module_open(const char *path, char *error, size_t error_size) {
+    return mc_module_open_with_options(path, NULL, error, error_size);
+}
+
+mc_module *mc_module_open_with_options(
+    const char *path,
+    const mc_module_open_options *options,
+    char *error,
+    size_t error_size
+) {
+    mc_module *module;
+    int status;
+
+    if (error != NULL && error_size > 0) {
+        error[0] = '\0';
+    }
+    module = (mc_module *)calloc(1, sizeof(*module));
+    if (module == NULL) {
+        set_error(error, error_size, "out of memory");
+        return NULL;
+    }
+    module->pattern_cache_capacity = MC_MODULE_DEFAULT_PATTERN_CACHE;
+    if (options != NULL) {
+        module->flags = options->flags;
+        if (options->pattern_cache_capacity > 0) {
+            module->pattern_cache_capacity = options->pattern_cache_capacity;
+        }
+    }
+    if (!mc_file_bytes_open(path, &module->bytes, error, error_size)) {
+        free(module);
+        return NULL;
+    }
+
+    switch (mc_identify_module(module->bytes.data, module->bytes.size)) {
+    case MC_MODULE_TYPE_XM:
+        status = load_xm(module, options);
+        break;
+    case MC_MODULE_TYPE_MOD:
+        status = load_mod(module, options);
+        break;
+    case MC_MODULE_TYPE_UNKNOWN:
+    default:
+        status = MC_LOAD_INVALID;
+        break;
+    }
+    if (status == MC_LOAD_OK) {
+        return module;
+    }
+
+    set_error(error, error_size, status == MC_LOAD_NO_MEMORY ? "out of memory" : "unsupported or invalid module header");
+    mc_module_close(module);
+    return NULL;
+}
+
+void mc_module_close(mc_module *module) {
+    if (module == NULL) {
+        return;
+    }
+    free(module->info);
+    free(module->instrument_dirty);
+    free_patterns(module);
+    mc_xm_instrument_table_free(&module->xm_instruments);
+    mc_file_bytes_close(&module->bytes);
+    free(module);
+}
+
+const mc_module_header *mc_module_get_header(const mc_module *module) {
+    return module == NULL ? NULL : &module->header;
+}
+
+const uint8_t *mc_module_order_table(const mc_module *module, uint16_t *out_count) {
+    if (out_count != NULL) {
+        *out_count = module == NULL ? 0 : module->order_count;
+    }
+    return module == NULL ? NULL : module->orders;
+}
+
+uint16_t mc_module_pattern_count(const mc_module *module) {
+    return module == NULL ? 0 : module->pattern_count;
+}
+
+uint16_t mc_module_pattern_rows(const mc_module *module, uint16_t pattern) {
+    if (module == NULL || pattern >= module->pattern_count) {
+        return 0;
+    }
+    return module->patterns[pattern].row_count;
+}
+
+uint16_t mc_module_pattern_packed_size(const mc_module *module, uint16_t pattern) {
+    if (module == NULL || pattern >= module->pattern_count) {
+        return 0;
+    }
+    return module->patterns[pattern].packed_size;
+}
+
+int mc_module_load_pattern(mc_module *module, uint16_t pattern, const mc_pattern_cell **out_cells) {
+    if (out_cells != NULL) {
+        *out_cells = NULL;
+    }
+    if (module == NULL || pattern >= module->pattern_count) {
+        return 0;
+    }
+    if (decode_pattern(module, pattern) != MC_LOAD_OK) {
+        return 0;
+    }
+    if (out_cells != NULL) {
+        *out_cells = module->patterns[pattern].cells;
+    }
+    return 1;
+}
+
+int mc_module_decode_patterns(
+    mc_module *module,
+    uint16_t thread_count,
+    const mc_pattern_executor *executor,
+    uint16_t *out_failed_pattern
+) {
+    uint16_t failed = 0;
+
+    if (out_failed_pattern != NULL) {
+        *out_failed_pattern = 0;
+    }
+    if (module == NULL) {
+        return 0;
+    }
+    if (decode_all_patterns(module, thread_count, executor, &failed) != MC_LOAD_OK) {
+        if (out_failed_pattern != NULL) {
+            *out_failed_pattern = failed;
+        }
+        return 0;
+    }
+    return 1;
+}
+
+const mc_pattern_cell *mc_module_pattern_cells(mc_module *module, uint16_t pattern) {
+    const mc_pattern_cell *cells;
+
+    return mc_module_load_pattern(module, pattern, &cells) ? cells : NULL;
+}
+
+mc_pattern_cell mc_module_pattern_cell(mc_module *module, uint16_t pattern, uint16_t row, uint16_t channel) {
+    mc_pattern_cell empty;
+    const mc_pattern_cell *cells;
+
+    memset(&empty, 0, sizeof(empty));
+    if (module == NULL || pattern >= module->pattern_count || channel >= module->header.channels ||
+        row >= module->patterns[pattern].row_count) {
+        return empty;
+    }
+    if (!mc_module_load_pattern(module, pattern, &cells) || cells == NULL) {
+        return empty;
+    }
+    return cells[(size_t)row * module->header.channels + channel];
+}
+
+mc_pattern_cell *mc_module_edit_pattern(mc_module *module, uint16_t index) {
+    mc_module_pattern *pattern;
+    size_t cell_count;
+
+    if (module == NULL || module->header.type != MC_MODULE_TYPE_XM || index >= module->pattern_count) {
+        return NULL;
+    }
+    pattern = &module->patterns[index];
+    cell_count = (size_t)pattern->row_count * module->header.channels;
+    if (cell_count == 0 || decode_pattern(module, index) != MC_LOAD_OK) {
+        return NULL;
+    }
+    if (pattern->cells == NULL) {
+        pattern->cells = (mc_pattern_cell *)calloc(cell_count, sizeof(*pattern->cells));
+        if (pattern->cells == NULL) {
+            return NULL;
+        }
+        module->resident_pattern_count++;
+    }
+    pattern->dirty = 1;
+    free(module->info);
+    module->info = NULL;
+    return pattern->cells;
+}
+
+static int mark_instrument_dirty(mc_module *module, uint16_t instrument) {
+    if (module->instrument_dirty == NULL) {
+        module->instrument_dirty = (uint8_t *)calloc(module->xm_instruments.instrument_count, 1);
+        if (module->instrument_dirty == NULL) {
+            return 0;
+        }
+    }
+    module->instrument_dirty[instrument] = 1;
+    free(module->info);
+    module->info = NULL;
+    return 1;
+}
+
+mc_xm_instrument *mc_module_edit_xm_instrument(mc_module *module, uint16_t instrument) {
+    if (module == NULL || !module->has_xm_instruments || instrument >= module->xm_instruments.instrument_count) {
+        return NULL;
+    }
+    if (!mark_instrument_dirty(module, instrument)) {
+        return NULL;
+    }
+    return &module->xm_instruments.instruments[instrument];
+}
+
+mc_xm_sample_header *mc_module_edit_xm_sample(mc_module *module, uint32_t sample_index) {
+    const mc_xm_instrument_table *table;
+    uint16_t i;
+
+    if (module == NULL || !module->has_xm_instruments) {
+        return NULL;
+    }
+    table = &module->xm_instruments;
+    for (i = 0; i < table->instrument_count; i++) {
+        const mc_xm_instrument *instrument = &table->instruments[i];
+        if (sample_index >= instrument->first_sample &&
+            sample_index - instrument->first_sample < instrument->sample_count) {
+            if (!mark_instrument_dirty(module, i)) {
+                return NULL;
+            }
+            return &table->samples[sample_index].header;
+        }
+    }
+    return NULL;
+}
+
+int mc_module_pattern_is_dirty(const mc_module *module, uint16_t pattern) {
+    return module != NULL && pattern < module->pattern_count && module->patterns[pattern].dirty;
+}
+
+int mc_module_xm_instrument_is_dirty(const mc_module *module, uint16_t instrument) {
+    return module != NULL && module->instrument_dirty != NULL &&
+        instrument < module->xm_instruments.instrument_count && module->instrument_dirty[instrument];
+}
+
+static int fill_info(mc_module *module, mc_module_info *info) {
+    const mc_module_header *header = &module->header;
+    uint16_t i;
+
+    memset(info, 0, sizeof(*info));
+    info->type = header->type;
+    info->ok = 1;
+    memcpy(info->warning, header->warning, sizeof(info->warning));
+    memcpy(info->title, header->title, sizeof(info->title));
+    memcpy(info->first_instrument_name, header->first_instrument_name, sizeof(info->first_instrument_name));
+    info->version_major = header->version_major;
+    info->version_minor = header->version_minor;
+    info->channels = header->channels;
+    info->patterns = header->patterns;
+    info->instruments = header->instruments;
+    info->xm_flags = header->xm_flags;
+    info->song_length = header->song_length;
+    info->restart_position = header->restart_position;
+    info->default_tempo = header->default_tempo;
+    info->default_bpm = header->default_bpm;
+    info->first_mod_sample = header->first_mod_sample;
+
+    info->order_table_length = module->order_count < MC_MAX_ORDER_ENTRIES ? module->order_count : MC_MAX_ORDER_ENTRIES;
+    if (info->order_table_length > 0) {
+        memcpy(info->order_table, module->orders, info->order_table_length);
+    }
+
+    info->pattern_row_count_count =
+        module->pattern_count < MC_MAX_PATTERN_ROW_COUNTS ? module->pattern_count : MC_MAX_PATTERN_ROW_COUNTS;
+    info->pattern_packed_size_count = info->pattern_row_count_count;
+    for (i = 0; i < info->pattern_row_count_count; i++) {
+        info->pattern_row_counts[i] = module->patterns[i].row_count;
+        info->pattern_packed_sizes[i] = module->patterns[i].packed_size;
+    }
+
+    for (i = 0; i < module->pattern_count; i++) {
+        const mc_module_pattern *pattern = &module->patterns[i];
+        size_t cell_count = (size_t)pattern->row_count * header->channels;
+        size_t c;
+
+        if (decode_pattern(module, i) != MC_LOAD_OK) {
+            return 0;
+        }
+        if (pattern->cells == NULL) {
+            continue;
+        }
+        for (c = 0; c < cell_count; c++) {
+            const mc_pattern_cell *cell = &pattern->cells[c];
+            mc_xm_event *event;
+
+            if (cell->note == 0 && cell->instrument == 0 && cell->volume == 0 &&
+                cell->effect_type == 0 && cell->effect_param == 0) {
+                continue;
+            }
+            if (info->xm_event_count >= MC_MAX_XM_EVENTS) {
+                if (info->warning[0] == '\0') {
+                    snprintf(
+                        info->warning,
+                        sizeof(info->warning),
+                        "xm events truncated at %u entries",
+                        (unsigned)MC_MAX_XM_EVENTS
+                    );
+                }
+                return 1;
+            }
+            event = &info->xm_events[info->xm_event_count++];
+            event->pattern = i;
+            event->row = (uint16_t)(c / header->channels);
+            event->channel = (uint16_t)(c % header->channels);
+            event->note = cell->note;
+            event->instrument = cell->instrument;
+            event->volume = cell->volume;
+            event->effect_type = cell->effect_type;
+            event->effect_param = cell->effect_param;
+        }
+    }
+    return 1;
+}
+
+const mc_module_info *mc_module_get_info(mc_module *module) {
+    if (module == NULL) {
+        return NULL;
+    }
+    if (module->info == NULL) {
+        module->info = (mc_module_info *)malloc(sizeof(*module->info));
+        if (module->info == NULL) {
+            return NULL;
+        }
+        if (!fill_info(module, module->info)) {
+            free(module->info);
+            module->info = NULL;
+            return NULL;
+        }
+    }
+    return module->info;
+}
+
+const uint8_t *mc_module_bytes(const mc_module *module, size_t *out_size) {
+    if (module == NULL) {
+        if (out_size != NULL) {
+            *out_size = 0;
+        }
+        return NULL;
+    }
+    if (out_size != NULL) {
+        *out_size = module->bytes.size;
+    }
+    return module->bytes.data;
+}
+
+int mc_module_is_mapped(const mc_module *module) {
+    return module != NULL && module->bytes.mapped;
+}
+
+const mc_xm_instrument_table *mc_module_xm_instruments(const mc_module *module) {
+    if (module == NULL || !module->has_xm_instruments) {
+        return NULL;
+    }
+    return &module->xm_instruments;
+}
+
+int mc_module_xm_sample_view(const mc_module *module, uint32_t sample_index, mc_xm_sample_view *out_view) {
+    if (module == NULL || !module->has_xm_instruments) {
+        return 0;
+    }
+    return mc_xm_sample_view_at(&module->xm_instruments, module->bytes.data, module->bytes.size, sample_index, out_view);
+}
+
+const mc_mod_sample_header *mc_module_mod_samples(const mc_module *module, uint16_t *out_count) {
+    if (out_count != NULL) {
+        *out_count = module != NULL && module->has_mod_samples ? MC_MOD_SAMPLE_COUNT : 0;
+    }
+    return module != NULL && module->has_mod_samples ? module->mod_samples : NULL;
+}
+
+int mc_module_mod_sample_view(const mc_module *module, uint16_t sample, mc_mod_sample_view *out_view) {
+    size_t offset;
+    size_t length;
+
+    if (out_view != NULL) {
+        out_view->data = NULL;
+        out_view->length_bytes = 0;
+    }
+    if (module == NULL || out_view == NULL || !module->has_mod_samples || sample >= MC_MOD_SAMPLE_COUNT) {
+        return 0;
+    }
+    offset = module->mod_sample_offsets[sample];
+    length = module->mod_samples[sample].length_bytes;
+    if (offset >= module->bytes.size) {
+        return length == 0;
+    }
+    if (length > module->bytes.size - offset) {
+        length = module->bytes.size - offset;
+    }
+    out_view->data = (const int8_t *)(module->bytes.data + offset);
+    out_view->length_bytes = length;
+    return 1;
+}
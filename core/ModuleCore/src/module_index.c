@@ -0,0 +1,579 @@
+#include "module_index.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mod_header.h"
+#include "module_bytes_io.h"
+#include "module_file.h"
+#include "module_song_walk.h"
+
+// File layout, little-endian: the magic, u32 version, u32 entry count, then
+// per entry: u16 path length + path, u64 size, i64 mtime seconds, u32 mtime
+// nanoseconds, u64 content hash, u8 ok, u8 type, u8 title length + title,
+// u16 channels, patterns, instruments and song length, u32 duration in ms,
+// u16 order count + orders, u16 name count + (u8 length + name) per name.
+static const char index_magic[8] = { 'V', 'T', 'X', 'I', 'N', 'D', 'E', 'X' };
+
+enum {
+    // 2: durations apply pattern loop, pattern delay and out-of-range breaks.
+    INDEX_VERSION = 2,
+    // Same cap as VTX_C_PLAYER_TIMELINE_MAX_ROWS: nested pattern loops in a
+    // damaged module can multiply into an effectively endless song.
+    INDEX_MAX_ESTIMATE_ROWS = 1 << 22,
+    // Per old entry during an update: moved into the new table, or
+    // superseded by a re-parsed entry for the same path.
+    INDEX_REUSED = 1,
+    INDEX_REPLACED = 2,
+};
+
+static uint64_t read_le_u64(const uint8_t *p) {
+    return (uint64_t)p[0] |
+        ((uint64_t)p[1] << 8) |
+        ((uint64_t)p[2] << 16) |
+        ((uint64_t)p[3] << 24) |
+        ((uint64_t)p[4] << 32) |
+        ((uint64_t)p[5] << 40) |
+        ((uint64_t)p[6] << 48) |
+        ((uint64_t)p[7] << 56);
+}
+
+static void free_entry(mc_index_entry *entry) {
+    free(entry->path);
+    free(entry->instrument_names);
+    memset(entry, 0, sizeof(*entry));
+}
+
+static int compare_entries(const void *a, const void *b) {
+    return strcmp(((const mc_index_entry *)a)->path, ((const mc_index_entry *)b)->path);
+}
+
+static int compare_path_pointers(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+static mc_index_entry *find_entry(const mc_module_index *index, const char *path) {
+    size_t low = 0;
+    size_t high = index->count;
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2u;
+        int order = strcmp(index->entries[middle].path, path);
+        if (order == 0) {
+            return &index->entries[middle];
+        }
+        if (order < 0) {
+            low = middle + 1u;
+        } else {
+            high = middle;
+        }
+    }
+    return NULL;
+}
+
+static int64_t stat_mtime_sec(const struct stat *st) {
+#if defined(__APPLE__)
+    return (int64_t)st->st_mtimespec.tv_sec;
+#else
+    return (int64_t)st->st_mtim.tv_sec;
+#endif
+}
+
+static uint32_t stat_mtime_nsec(const struct stat *st) {
+#if defined(__APPLE__)
+    return (uint32_t)st->st_mtimespec.tv_nsec;
+#else
+    return (uint32_t)st->st_mtim.tv_nsec;
+#endif
+}
+
+static uint64_t rotate_left(uint64_t value, unsigned bits) {
+    return (value << bits) | (value >> (64u - bits));
+}
+
+uint64_t mc_index_content_hash(const uint8_t *data, size_t size) {
+    const uint64_t k1 = 0x9E3779B97F4A7C15ull;
+    const uint64_t k2 = 0xC2B2AE3D27D4EB4Full;
+    uint64_t h = 0x243F6A8885A308D3ull ^ ((uint64_t)size * k2);
+    uint64_t tail = 0;
+    size_t i = 0;
+
+    for (; i + 8u <= size; i += 8u) {
+        h ^= read_le_u64(data + i) * k1;
+        h = rotate_left(h, 31) * k2;
+    }
+    for (; i < size; i++) {
+        tail |= (uint64_t)data[i] << (8u * (i & 7u));
+    }
+    h ^= tail * k1;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+uint32_t mc_index_estimate_duration_ms(mc_module *module) {
+    mc_song_walk *walk;
+    uint16_t loop_order;
+    uint16_t loop_row;
+    uint32_t rows = 0;
+    double seconds = 0.0;
+
+    walk = (mc_song_walk *)malloc(sizeof(*walk));
+    if (walk == NULL) {
+        return 0;
+    }
+    if (!mc_song_walk_begin(walk, module, 0)) {
+        free(walk);
+        return 0;
+    }
+    do {
+        uint32_t ticks = mc_song_walk_process_row(walk);
+        seconds += (double)ticks * 2.5 / (double)walk->bpm;
+    } while (++rows < INDEX_MAX_ESTIMATE_ROWS && mc_song_walk_advance(walk, &loop_order, &loop_row));
+    free(walk);
+    return seconds * 1000.0 + 0.5 < (double)UINT32_MAX ? (uint32_t)(seconds * 1000.0 + 0.5) : UINT32_MAX;
+}
+
+// A NULL module leaves the entry marked as not a module.
+static int fill_entry(mc_index_entry *entry, mc_module *module) {
+    const mc_module_header *header;
+    const uint8_t *orders;
+    const uint8_t *data;
+    size_t size = 0;
+    uint16_t i;
+
+    if (module == NULL) {
+        return 1;
+    }
+    header = mc_module_get_header(module);
+    data = mc_module_bytes(module, &size);
+    entry->ok = 1;
+    entry->type = header->type;
+    memcpy(entry->title, header->title, sizeof(entry->title));
+    entry->channels = header->channels;
+    entry->patterns = header->patterns;
+    entry->instruments = header->instruments;
+    entry->song_length = header->song_length;
+    orders = mc_module_order_table(module, &entry->order_count);
+    if (entry->order_count > MC_MAX_ORDER_ENTRIES) {
+        entry->order_count = MC_MAX_ORDER_ENTRIES;
+    }
+    if (entry->order_count > 0) {
+        memcpy(entry->orders, orders, entry->order_count);
+    }
+
+    if (header->type == MC_MODULE_TYPE_XM) {
+        const mc_xm_instrument_table *table = mc_module_xm_instruments(module);
+        entry->instrument_name_count = table != NULL ? table->instrument_count : 0;
+    } else {
+        entry->instrument_name_count = header->instruments;
+    }
+    if (entry->instrument_name_count > 0) {
+        entry->instrument_names = (char (*)[MC_INDEX_NAME_SIZE])calloc(entry->instrument_name_count,
+            sizeof(*entry->instrument_names));
+        if (entry->instrument_names == NULL) {
+            return 0;
+        }
+    }
+    for (i = 0; i < entry->instrument_name_count; i++) {
+        if (header->type == MC_MODULE_TYPE_XM) {
+            memcpy(entry->instrument_names[i], mc_module_xm_instruments(module)->instruments[i].name,
+                MC_INDEX_NAME_SIZE);
+        } else {
+            mc_mod_sample_name(data, size, i, entry->instrument_names[i], MC_INDEX_NAME_SIZE);
+        }
+    }
+    entry->duration_ms = mc_index_estimate_duration_ms(module);
+    return 1;
+}
+
+int mc_index_update(
+    mc_module_index *index,
+    const char *const *paths,
+    size_t path_count,
+    mc_index_update_stats *out_stats
+) {
+    mc_index_update_stats stats;
+    mc_index_entry *next;
+    const char **sorted;
+    uint8_t *reused;
+    uint8_t *fresh;
+    size_t count = 0;
+    size_t i;
+
+    if (index == NULL || (paths == NULL && path_count > 0)) {
+        return 0;
+    }
+    memset(&stats, 0, sizeof(stats));
+    next = (mc_index_entry *)calloc(path_count + 1u, sizeof(*next));
+    sorted = (const char **)malloc((path_count + 1u) * sizeof(*sorted));
+    reused = (uint8_t *)calloc(index->count + 1u, 1);
+    fresh = (uint8_t *)calloc(path_count + 1u, 1);
+    if (next == NULL || sorted == NULL || reused == NULL || fresh == NULL) {
+        free(next);
+        free(sorted);
+        free(reused);
+        free(fresh);
+        return 0;
+    }
+    if (path_count > 0) {
+        memcpy(sorted, paths, path_count * sizeof(*sorted));
+        qsort(sorted, path_count, sizeof(*sorted), compare_path_pointers);
+    }
+
+    for (i = 0; i < path_count; i++) {
+        const char *path = sorted[i];
+        mc_index_entry *old;
+        mc_index_entry *entry = &next[count];
+        mc_module *module;
+        mc_file_bytes bytes = { NULL, 0, 0 };
+        const uint8_t *data;
+        size_t size = 0;
+        struct stat st;
+        uint64_t hash;
+
+        if ((i > 0 && strcmp(path, sorted[i - 1]) == 0) || stat(path, &st) != 0 || !S_ISREG(st.st_mode)) {
+            continue;
+        }
+        old = find_entry(index, path);
+        if (old != NULL && old->size == (uint64_t)st.st_size &&
+            old->mtime_sec == stat_mtime_sec(&st) && old->mtime_nsec == stat_mtime_nsec(&st)) {
+            *entry = *old;
+            reused[old - index->entries] = INDEX_REUSED;
+            count++;
+            stats.unchanged++;
+            continue;
+        }
+
+        // The module's own mapping is hashed; only a file that does not
+        // open as a module is read on its own.
+        module = mc_module_open(path, NULL, 0);
+        if (module != NULL) {
+            data = mc_module_bytes(module, &size);
+        } else if (mc_file_bytes_open(path, &bytes, NULL, 0)) {
+            data = bytes.data;
+            size = bytes.size;
+        } else {
+            continue;
+        }
+        hash = mc_index_content_hash(data, size);
+        if (old != NULL && old->size == (uint64_t)size && old->content_hash == hash) {
+            *entry = *old;
+            reused[old - index->entries] = INDEX_REUSED;
+            stats.rehashed++;
+        } else {
+            if (old != NULL) {
+                reused[old - index->entries] = INDEX_REPLACED;
+            }
+            entry->path = (char *)malloc(strlen(path) + 1u);
+            fresh[count] = 1;
+            if (entry->path == NULL || !fill_entry(entry, module)) {
+                mc_module_close(module);
+                mc_file_bytes_close(&bytes);
+                count++;
+                goto out_of_memory;
+            }
+            strcpy(entry->path, path);
+            entry->size = (uint64_t)size;
+            entry->content_hash = hash;
+            stats.parsed++;
+        }
+        entry->mtime_sec = stat_mtime_sec(&st);
+        entry->mtime_nsec = stat_mtime_nsec(&st);
+        mc_module_close(module);
+        mc_file_bytes_close(&bytes);
+        count++;
+    }
+
+    for (i = 0; i < index->count; i++) {
+        if (reused[i] != INDEX_REUSED) {
+            free_entry(&index->entries[i]);
+        }
+        if (reused[i] == 0) {
+            stats.removed++;
+        }
+    }
+    free(index->entries);
+    index->entries = next;
+    index->count = count;
+    free(sorted);
+    free(reused);
+    free(fresh);
+    if (out_stats != NULL) {
+        *out_stats = stats;
+    }
+    return 1;
+
+out_of_memory:
+    for (i = 0; i < count; i++) {
+        if (fresh[i]) {
+            free_entry(&next[i]);
+        }
+    }
+    free(next);
+    free(sorted);
+    free(reused);
+    free(fresh);
+    return 0;
+}
+
+static int contains_ignoring_case(const char *haystack, const char *needle) {
+    size_t needle_length = strlen(needle);
+    const char *start;
+
+    for (start = haystack; *start; start++) {
+        size_t i;
+        for (i = 0; i < needle_length && start[i]; i++) {
+            char a = start[i];
+            char b = needle[i];
+            if (a >= 'A' && a <= 'Z') {
+                a = (char)(a - 'A' + 'a');
+            }
+            if (b >= 'A' && b <= 'Z') {
+                b = (char)(b - 'A' + 'a');
+            }
+            if (a != b) {
+                break;
+            }
+        }
+        if (i == needle_length) {
+            return 1;
+        }
+    }
+    return needle_length == 0;
+}
+
+size_t mc_index_find(const mc_module_index *index, const char *needle, uint32_t fields, size_t start) {
+    size_t i;
+
+    if (index == NULL || needle == NULL) {
+        return index == NULL ? 0 : index->count;
+    }
+    for (i = start; i < index->count; i++) {
+        const mc_index_entry *entry = &index->entries[i];
+        uint16_t n;
+
+        if (!entry->ok) {
+            continue;
+        }
+        if ((fields & MC_INDEX_MATCH_TITLE) != 0 && contains_ignoring_case(entry->title, needle)) {
+            return i;
+        }
+        for (n = 0; (fields & MC_INDEX_MATCH_INSTRUMENT) != 0 && n < entry->instrument_name_count; n++) {
+            if (contains_ignoring_case(entry->instrument_names[n], needle)) {
+                return i;
+            }
+        }
+    }
+    return index->count;
+}
+
+int mc_index_save(const mc_module_index *index, const char *path, char *error, size_t error_size) {
+    mc_byte_writer writer = { NULL, 0, 0, 0 };
+    char *temp_path;
+    size_t i;
+    int fd;
+    int err;
+    int ok;
+
+    if (index == NULL || path == NULL || path[0] == '\0') {
+        mc_bytes_set_error(error, error_size, "invalid path", 0);
+        return 0;
+    }
+    mc_bytes_put(&writer, index_magic, sizeof(index_magic));
+    mc_bytes_put_uint(&writer, INDEX_VERSION, 4);
+    mc_bytes_put_uint(&writer, index->count, 4);
+    for (i = 0; i < index->count; i++) {
+        const mc_index_entry *entry = &index->entries[i];
+        uint16_t n;
+
+        mc_bytes_put_string(&writer, entry->path, 2, 0xFFFF);
+        mc_bytes_put_uint(&writer, entry->size, 8);
+        mc_bytes_put_uint(&writer, (uint64_t)entry->mtime_sec, 8);
+        mc_bytes_put_uint(&writer, entry->mtime_nsec, 4);
+        mc_bytes_put_uint(&writer, entry->content_hash, 8);
+        mc_bytes_put_uint(&writer, entry->ok ? 1u : 0u, 1);
+        mc_bytes_put_uint(&writer, (uint64_t)entry->type, 1);
+        mc_bytes_put_string(&writer, entry->title, 1, sizeof(entry->title) - 1u);
+        mc_bytes_put_uint(&writer, entry->channels, 2);
+        mc_bytes_put_uint(&writer, entry->patterns, 2);
+        mc_bytes_put_uint(&writer, entry->instruments, 2);
+        mc_bytes_put_uint(&writer, entry->song_length, 2);
+        mc_bytes_put_uint(&writer, entry->duration_ms, 4);
+        mc_bytes_put_uint(&writer, entry->order_count, 2);
+        mc_bytes_put(&writer, entry->orders, entry->order_count);
+        mc_bytes_put_uint(&writer, entry->instrument_name_count, 2);
+        for (n = 0; n < entry->instrument_name_count; n++) {
+            mc_bytes_put_string(&writer, entry->instrument_names[n], 1, MC_INDEX_NAME_SIZE - 1u);
+        }
+    }
+    if (writer.failed) {
+        free(writer.data);
+        mc_bytes_set_error(error, error_size, "out of memory", 0);
+        return 0;
+    }
+
+    fd = mc_bytes_open_temp_file(path, &temp_path, error, error_size);
+    if (fd < 0) {
+        free(writer.data);
+        return 0;
+    }
+    err = mc_bytes_write_all(fd, writer.data, writer.size);
+    if (err == 0 && fsync(fd) != 0) {
+        err = errno;
+    }
+    if (close(fd) != 0 && err == 0) {
+        err = errno;
+    }
+    ok = err == 0;
+    if (!ok) {
+        mc_bytes_set_error(error, error_size, "write failed", err);
+    } else if (rename(temp_path, path) != 0) {
+        mc_bytes_set_error(error, error_size, "rename failed", errno);
+        ok = 0;
+    }
+    if (!ok) {
+        unlink(temp_path);
+    }
+    free(temp_path);
+    free(writer.data);
+    return ok;
+}
+
+int mc_index_load(const char *path, mc_module_index *out_index, char *error, size_t error_size) {
+    mc_file_bytes bytes;
+    mc_byte_reader reader;
+    struct stat st;
+    uint32_t version;
+    uint32_t count;
+    uint32_t i;
+
+    if (out_index == NULL) {
+        return 0;
+    }
+    memset(out_index, 0, sizeof(*out_index));
+    if (path != NULL && stat(path, &st) != 0 && errno == ENOENT) {
+        return 1;
+    }
+    if (!mc_file_bytes_open(path, &bytes, error, error_size)) {
+        return 0;
+    }
+    reader.data = bytes.data;
+    reader.size = bytes.size;
+    reader.offset = 0;
+    reader.failed = 0;
+    if (bytes.size < sizeof(index_magic) + 8u || memcmp(bytes.data, index_magic, sizeof(index_magic)) != 0) {
+        mc_file_bytes_close(&bytes);
+        mc_bytes_set_error(error, error_size, "not a module index", 0);
+        return 0;
+    }
+    mc_bytes_take(&reader, sizeof(index_magic));
+    version = (uint32_t)mc_bytes_take_uint(&reader, 4);
+    // Entries of an older version may carry stale metadata; the next update
+    // re-parses every file.
+    if (version < INDEX_VERSION) {
+        mc_file_bytes_close(&bytes);
+        return 1;
+    }
+    if (version != INDEX_VERSION) {
+        mc_file_bytes_close(&bytes);
+        mc_bytes_set_error(error, error_size, "unsupported index version", 0);
+        return 0;
+    }
+    count = (uint32_t)mc_bytes_take_uint(&reader, 4);
+    // Every entry takes well over 32 bytes, which bounds the allocation by
+    // the file size.
+    if (count > bytes.size / 32u) {
+        mc_file_bytes_close(&bytes);
+        mc_bytes_set_error(error, error_size, "index truncated", 0);
+        return 0;
+    }
+    out_index->entries = (mc_index_entry *)calloc(count + 1u, sizeof(*out_index->entries));
+    if (out_index->entries == NULL) {
+        mc_file_bytes_close(&bytes);
+        mc_bytes_set_error(error, error_size, "out of memory", 0);
+        return 0;
+    }
+
+    for (i = 0; i < count && !reader.failed; i++) {
+        mc_index_entry *entry = &out_index->entries[i];
+        size_t path_length = (size_t)mc_bytes_take_uint(&reader, 2);
+        const uint8_t *path_bytes = mc_bytes_take(&reader, path_length);
+        const uint8_t *orders;
+        uint16_t n;
+
+        out_index->count = i + 1u;
+        entry->path = (char *)malloc(path_length + 1u);
+        if (path_bytes == NULL || entry->path == NULL) {
+            reader.failed = 1;
+            break;
+        }
+        memcpy(entry->path, path_bytes, path_length);
+        entry->path[path_length] = '\0';
+        entry->size = mc_bytes_take_uint(&reader, 8);
+        entry->mtime_sec = (int64_t)mc_bytes_take_uint(&reader, 8);
+        entry->mtime_nsec = (uint32_t)mc_bytes_take_uint(&reader, 4);
+        entry->content_hash = mc_bytes_take_uint(&reader, 8);
+        entry->ok = mc_bytes_take_uint(&reader, 1) != 0;
+        entry->type = (mc_module_type)mc_bytes_take_uint(&reader, 1);
+        mc_bytes_take_string(&reader, entry->title, sizeof(entry->title));
+        entry->channels = (uint16_t)mc_bytes_take_uint(&reader, 2);
+        entry->patterns = (uint16_t)mc_bytes_take_uint(&reader, 2);
+        entry->instruments = (uint16_t)mc_bytes_take_uint(&reader, 2);
+        entry->song_length = (uint16_t)mc_bytes_take_uint(&reader, 2);
+        entry->duration_ms = (uint32_t)mc_bytes_take_uint(&reader, 4);
+        entry->order_count = (uint16_t)mc_bytes_take_uint(&reader, 2);
+        if (entry->order_count > MC_MAX_ORDER_ENTRIES) {
+            reader.failed = 1;
+            break;
+        }
+        orders = mc_bytes_take(&reader, entry->order_count);
+        if (orders != NULL && entry->order_count > 0) {
+            memcpy(entry->orders, orders, entry->order_count);
+        }
+        entry->instrument_name_count = (uint16_t)mc_bytes_take_uint(&reader, 2);
+        if (entry->instrument_name_count > 0 && !reader.failed) {
+            entry->instrument_names = (char (*)[MC_INDEX_NAME_SIZE])calloc(entry->instrument_name_count,
+                sizeof(*entry->instrument_names));
+            if (entry->instrument_names == NULL) {
+                reader.failed = 1;
+                break;
+            }
+        }
+        for (n = 0; n < entry->instrument_name_count && !reader.failed; n++) {
+            mc_bytes_take_string(&reader, entry->instrument_names[n], MC_INDEX_NAME_SIZE);
+        }
+    }
+    mc_file_bytes_close(&bytes);
+    if (reader.failed) {
+        mc_index_free(out_index);
+        mc_bytes_set_error(error, error_size, "index truncated", 0);
+        return 0;
+    }
+    // Saved indexes are sorted; re-sort in case the file was produced
+    // elsewhere so lookups stay valid.
+    if (out_index->count > 1u) {
+        qsort(out_index->entries, out_index->count, sizeof(*out_index->entries), compare_entries);
+    }
+    return 1;
+}
+
+void mc_index_free(mc_module_index *index) {
+    size_t i;
+
+    if (index == NULL) {
+        return;
+    }
+    for (i = 0; i < index->count; i++) {
+        free_entry(&index->entries[i]);
+    }
+    free(index->entries);
+    memset(index, 0, sizeof(*index));
+}
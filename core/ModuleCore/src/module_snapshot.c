@@ -0,0 +1,500 @@
+#include "module_snapshot.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "module_bytes_io.h"
+
+// Layout, little-endian: the magic, u32 version, then the header (u8 type,
+// u8-length-prefixed warning, title and first instrument name, ten u16
+// fields, the first MOD sample as name, u32 length, i8 finetune, u8 volume),
+// u16 order count + orders, u16 pattern count, and per pattern u16 rows,
+// u16 packed size, u32 cell count and the non-empty cells in row-major
+// order. Each cell is a varint count of empty cells skipped since the
+// previous one, a mask of its non-zero fields (bit 0 note .. bit 4 effect
+// parameter) and those fields.
+static const char snapshot_magic[8] = { 'V', 'T', 'X', 'D', 'U', 'M', 'P', 0 };
+
+enum {
+    // Smallest encoded cell: a one-byte gap and a mask.
+    SNAPSHOT_MIN_CELL_BYTES = 2,
+    SNAPSHOT_DESCRIPTION_SIZE = 256,
+};
+
+typedef struct {
+    mc_snapshot_difference_fn report;
+    void *context;
+    size_t count;
+} diff_state;
+
+static void put_varint(mc_byte_writer *writer, size_t value) {
+    uint8_t bytes[10];
+    size_t count = 0;
+
+    do {
+        bytes[count] = (uint8_t)(value & 0x7Fu);
+        value >>= 7;
+        if (value != 0) {
+            bytes[count] |= 0x80u;
+        }
+        count++;
+    } while (value != 0);
+    mc_bytes_put(writer, bytes, count);
+}
+
+static size_t take_varint(mc_byte_reader *reader) {
+    size_t value = 0;
+    unsigned shift = 0;
+
+    for (;;) {
+        const uint8_t *p = mc_bytes_take(reader, 1);
+        if (p == NULL || shift >= 8u * sizeof(size_t)) {
+            reader->failed = 1;
+            return 0;
+        }
+        value |= (size_t)(*p & 0x7Fu) << shift;
+        if ((*p & 0x80u) == 0) {
+            return value;
+        }
+        shift += 7;
+    }
+}
+
+static int cell_is_empty(const mc_pattern_cell *cell) {
+    return cell->note == 0 && cell->instrument == 0 && cell->volume == 0 && cell->effect_type == 0 &&
+        cell->effect_param == 0;
+}
+
+int mc_snapshot_capture(mc_module *module, mc_module_snapshot *out_snapshot, char *error, size_t error_size) {
+    const mc_module_header *header = mc_module_get_header(module);
+    const uint8_t *orders;
+    size_t event_capacity = 0;
+    uint16_t p;
+
+    if (out_snapshot == NULL) {
+        return 0;
+    }
+    memset(out_snapshot, 0, sizeof(*out_snapshot));
+    if (header == NULL) {
+        mc_bytes_set_error(error, error_size, "invalid module", 0);
+        return 0;
+    }
+    out_snapshot->header = *header;
+    orders = mc_module_order_table(module, &out_snapshot->order_count);
+    out_snapshot->pattern_count = mc_module_pattern_count(module);
+    out_snapshot->orders = (uint8_t *)malloc((size_t)out_snapshot->order_count + 1u);
+    out_snapshot->patterns =
+        (mc_snapshot_pattern *)calloc((size_t)out_snapshot->pattern_count + 1u, sizeof(*out_snapshot->patterns));
+    if (out_snapshot->orders == NULL || out_snapshot->patterns == NULL) {
+        mc_snapshot_free(out_snapshot);
+        mc_bytes_set_error(error, error_size, "out of memory", 0);
+        return 0;
+    }
+    if (out_snapshot->order_count > 0) {
+        memcpy(out_snapshot->orders, orders, out_snapshot->order_count);
+    }
+
+    for (p = 0; p < out_snapshot->pattern_count; p++) {
+        mc_snapshot_pattern *pattern = &out_snapshot->patterns[p];
+        const mc_pattern_cell *cells;
+        size_t cell_count;
+        size_t c;
+
+        pattern->row_count = mc_module_pattern_rows(module, p);
+        pattern->packed_size = mc_module_pattern_packed_size(module, p);
+        pattern->first_event = out_snapshot->event_count;
+        if (!mc_module_load_pattern(module, p, &cells)) {
+            char message[64];
+            snprintf(message, sizeof(message), "invalid pattern data in pattern %u", (unsigned)p);
+            mc_snapshot_free(out_snapshot);
+            mc_bytes_set_error(error, error_size, message, 0);
+            return 0;
+        }
+        cell_count = cells != NULL ? (size_t)pattern->row_count * header->channels : 0u;
+        for (c = 0; c < cell_count; c++) {
+            mc_xm_event *event;
+
+            if (cell_is_empty(&cells[c])) {
+                continue;
+            }
+            if (out_snapshot->event_count == event_capacity) {
+                mc_xm_event *grown;
+                event_capacity = event_capacity > 0 ? event_capacity * 2u : 1024u;
+                grown = (mc_xm_event *)realloc(out_snapshot->events, event_capacity * sizeof(*grown));
+                if (grown == NULL) {
+                    mc_snapshot_free(out_snapshot);
+                    mc_bytes_set_error(error, error_size, "out of memory", 0);
+                    return 0;
+                }
+                out_snapshot->events = grown;
+            }
+            event = &out_snapshot->events[out_snapshot->event_count++];
+            event->pattern = p;
+            event->row = (uint16_t)(c / header->channels);
+            event->channel = (uint16_t)(c % header->channels);
+            event->note = cells[c].note;
+            event->instrument = cells[c].instrument;
+            event->volume = cells[c].volume;
+            event->effect_type = cells[c].effect_type;
+            event->effect_param = cells[c].effect_param;
+        }
+        pattern->event_count = out_snapshot->event_count - pattern->first_event;
+    }
+    return 1;
+}
+
+int mc_snapshot_encode(const mc_module_snapshot *snapshot, uint8_t **out_data, size_t *out_size) {
+    const mc_module_header *header;
+    mc_byte_writer writer = { NULL, 0, 0, 0 };
+    uint16_t p;
+
+    if (snapshot == NULL || out_data == NULL || out_size == NULL) {
+        return 0;
+    }
+    header = &snapshot->header;
+    mc_bytes_put(&writer, snapshot_magic, sizeof(snapshot_magic));
+    mc_bytes_put_uint(&writer, MC_SNAPSHOT_VERSION, 4);
+    mc_bytes_put_uint(&writer, (uint32_t)header->type, 1);
+    mc_bytes_put_string(&writer, header->warning, 1, sizeof(header->warning) - 1u);
+    mc_bytes_put_string(&writer, header->title, 1, sizeof(header->title) - 1u);
+    mc_bytes_put_string(&writer, header->first_instrument_name, 1, sizeof(header->first_instrument_name) - 1u);
+    mc_bytes_put_uint(&writer, header->version_major, 2);
+    mc_bytes_put_uint(&writer, header->version_minor, 2);
+    mc_bytes_put_uint(&writer, header->channels, 2);
+    mc_bytes_put_uint(&writer, header->patterns, 2);
+    mc_bytes_put_uint(&writer, header->instruments, 2);
+    mc_bytes_put_uint(&writer, header->xm_flags, 2);
+    mc_bytes_put_uint(&writer, header->song_length, 2);
+    mc_bytes_put_uint(&writer, header->restart_position, 2);
+    mc_bytes_put_uint(&writer, header->default_tempo, 2);
+    mc_bytes_put_uint(&writer, header->default_bpm, 2);
+    mc_bytes_put_string(&writer, header->first_mod_sample.name, 1, sizeof(header->first_mod_sample.name) - 1u);
+    mc_bytes_put_uint(&writer, header->first_mod_sample.length_bytes, 4);
+    mc_bytes_put_uint(&writer, (uint8_t)header->first_mod_sample.finetune, 1);
+    mc_bytes_put_uint(&writer, header->first_mod_sample.volume, 1);
+
+    mc_bytes_put_uint(&writer, snapshot->order_count, 2);
+    mc_bytes_put(&writer, snapshot->orders, snapshot->order_count);
+    mc_bytes_put_uint(&writer, snapshot->pattern_count, 2);
+    for (p = 0; p < snapshot->pattern_count; p++) {
+        const mc_snapshot_pattern *pattern = &snapshot->patterns[p];
+        size_t next_index = 0;
+        size_t e;
+
+        mc_bytes_put_uint(&writer, pattern->row_count, 2);
+        mc_bytes_put_uint(&writer, pattern->packed_size, 2);
+        mc_bytes_put_uint(&writer, (uint32_t)pattern->event_count, 4);
+        for (e = 0; e < pattern->event_count; e++) {
+            const mc_xm_event *event = &snapshot->events[pattern->first_event + e];
+            size_t index = (size_t)event->row * header->channels + event->channel;
+            uint8_t fields[5];
+            uint8_t mask = 0;
+            uint8_t bytes[6];
+            size_t count = 1;
+            size_t f;
+
+            fields[0] = event->note;
+            fields[1] = event->instrument;
+            fields[2] = event->volume;
+            fields[3] = event->effect_type;
+            fields[4] = event->effect_param;
+            for (f = 0; f < 5; f++) {
+                if (fields[f] != 0) {
+                    mask |= (uint8_t)(1u << f);
+                    bytes[count++] = fields[f];
+                }
+            }
+            bytes[0] = mask;
+            put_varint(&writer, index - next_index);
+            mc_bytes_put(&writer, bytes, count);
+            next_index = index + 1u;
+        }
+    }
+    if (writer.failed) {
+        free(writer.data);
+        return 0;
+    }
+    *out_data = writer.data;
+    *out_size = writer.size;
+    return 1;
+}
+
+int mc_snapshot_is_encoded(const uint8_t *data, size_t size) {
+    return data != NULL && size >= sizeof(snapshot_magic) + 4u &&
+        memcmp(data, snapshot_magic, sizeof(snapshot_magic)) == 0;
+}
+
+int mc_snapshot_decode(
+    const uint8_t *data,
+    size_t size,
+    mc_module_snapshot *out_snapshot,
+    char *error,
+    size_t error_size
+) {
+    mc_byte_reader reader;
+    mc_module_header *header;
+    const uint8_t *orders;
+    uint16_t p;
+
+    if (out_snapshot == NULL) {
+        return 0;
+    }
+    memset(out_snapshot, 0, sizeof(*out_snapshot));
+    if (!mc_snapshot_is_encoded(data, size)) {
+        mc_bytes_set_error(error, error_size, "not a module snapshot", 0);
+        return 0;
+    }
+    reader.data = data;
+    reader.size = size;
+    reader.offset = sizeof(snapshot_magic);
+    reader.failed = 0;
+    if (mc_bytes_take_uint(&reader, 4) != MC_SNAPSHOT_VERSION) {
+        mc_bytes_set_error(error, error_size, "unsupported snapshot version", 0);
+        return 0;
+    }
+
+    header = &out_snapshot->header;
+    header->type = (mc_module_type)mc_bytes_take_uint(&reader, 1);
+    mc_bytes_take_string(&reader, header->warning, sizeof(header->warning));
+    mc_bytes_take_string(&reader, header->title, sizeof(header->title));
+    mc_bytes_take_string(&reader, header->first_instrument_name, sizeof(header->first_instrument_name));
+    header->version_major = (uint16_t)mc_bytes_take_uint(&reader, 2);
+    header->version_minor = (uint16_t)mc_bytes_take_uint(&reader, 2);
+    header->channels = (uint16_t)mc_bytes_take_uint(&reader, 2);
+    header->patterns = (uint16_t)mc_bytes_take_uint(&reader, 2);
+    header->instruments = (uint16_t)mc_bytes_take_uint(&reader, 2);
+    header->xm_flags = (uint16_t)mc_bytes_take_uint(&reader, 2);
+    header->song_length = (uint16_t)mc_bytes_take_uint(&reader, 2);
+    header->restart_position = (uint16_t)mc_bytes_take_uint(&reader, 2);
+    header->default_tempo = (uint16_t)mc_bytes_take_uint(&reader, 2);
+    header->default_bpm = (uint16_t)mc_bytes_take_uint(&reader, 2);
+    mc_bytes_take_string(&reader, header->first_mod_sample.name, sizeof(header->first_mod_sample.name));
+    header->first_mod_sample.length_bytes = mc_bytes_take_uint(&reader, 4);
+    header->first_mod_sample.finetune = (int8_t)(uint8_t)mc_bytes_take_uint(&reader, 1);
+    header->first_mod_sample.volume = (uint8_t)mc_bytes_take_uint(&reader, 1);
+
+    out_snapshot->order_count = (uint16_t)mc_bytes_take_uint(&reader, 2);
+    orders = mc_bytes_take(&reader, out_snapshot->order_count);
+    out_snapshot->pattern_count = (uint16_t)mc_bytes_take_uint(&reader, 2);
+    if (reader.failed) {
+        mc_bytes_set_error(error, error_size, "snapshot truncated", 0);
+        return 0;
+    }
+    out_snapshot->orders = (uint8_t *)malloc((size_t)out_snapshot->order_count + 1u);
+    out_snapshot->patterns =
+        (mc_snapshot_pattern *)calloc((size_t)out_snapshot->pattern_count + 1u, sizeof(*out_snapshot->patterns));
+    // Every cell takes at least SNAPSHOT_MIN_CELL_BYTES, which bounds the
+    // event table by the buffer size.
+    out_snapshot->events = (mc_xm_event *)malloc(((size - reader.offset) / SNAPSHOT_MIN_CELL_BYTES + 1u) *
+        sizeof(*out_snapshot->events));
+    if (out_snapshot->orders == NULL || out_snapshot->patterns == NULL || out_snapshot->events == NULL) {
+        mc_snapshot_free(out_snapshot);
+        mc_bytes_set_error(error, error_size, "out of memory", 0);
+        return 0;
+    }
+    if (out_snapshot->order_count > 0) {
+        memcpy(out_snapshot->orders, orders, out_snapshot->order_count);
+    }
+
+    for (p = 0; p < out_snapshot->pattern_count && !reader.failed; p++) {
+        mc_snapshot_pattern *pattern = &out_snapshot->patterns[p];
+        size_t cell_count;
+        size_t next_index;
+        uint32_t count;
+        uint32_t e;
+
+        pattern->row_count = (uint16_t)mc_bytes_take_uint(&reader, 2);
+        pattern->packed_size = (uint16_t)mc_bytes_take_uint(&reader, 2);
+        count = mc_bytes_take_uint(&reader, 4);
+        if (count > (size - reader.offset) / SNAPSHOT_MIN_CELL_BYTES) {
+            reader.failed = 1;
+            break;
+        }
+        pattern->first_event = out_snapshot->event_count;
+        pattern->event_count = count;
+        cell_count = (size_t)pattern->row_count * header->channels;
+        next_index = 0;
+        for (e = 0; e < count && !reader.failed; e++) {
+            mc_xm_event *event = &out_snapshot->events[out_snapshot->event_count++];
+            size_t gap = take_varint(&reader);
+            uint8_t fields[5] = { 0, 0, 0, 0, 0 };
+            uint8_t mask = (uint8_t)mc_bytes_take_uint(&reader, 1);
+            size_t f;
+
+            // Gaps keep cells in row-major order, which the diff relies on.
+            if (next_index >= cell_count || gap >= cell_count - next_index || mask == 0 || mask > 0x1F) {
+                reader.failed = 1;
+                break;
+            }
+            next_index += gap;
+            for (f = 0; f < 5; f++) {
+                if ((mask & (1u << f)) != 0) {
+                    fields[f] = (uint8_t)mc_bytes_take_uint(&reader, 1);
+                }
+            }
+            event->pattern = p;
+            event->row = (uint16_t)(next_index / header->channels);
+            event->channel = (uint16_t)(next_index % header->channels);
+            event->note = fields[0];
+            event->instrument = fields[1];
+            event->volume = fields[2];
+            event->effect_type = fields[3];
+            event->effect_param = fields[4];
+            next_index++;
+        }
+    }
+    if (reader.failed || reader.offset != size) {
+        mc_snapshot_free(out_snapshot);
+        mc_bytes_set_error(error, error_size, reader.failed ? "snapshot truncated" : "trailing bytes after snapshot", 0);
+        return 0;
+    }
+    return 1;
+}
+
+void mc_snapshot_free(mc_module_snapshot *snapshot) {
+    if (snapshot == NULL) {
+        return;
+    }
+    free(snapshot->orders);
+    free(snapshot->patterns);
+    free(snapshot->events);
+    memset(snapshot, 0, sizeof(*snapshot));
+}
+
+static void differ(diff_state *state, const char *format, ...) {
+    char description[SNAPSHOT_DESCRIPTION_SIZE];
+    va_list args;
+
+    state->count++;
+    if (state->report == NULL) {
+        return;
+    }
+    va_start(args, format);
+    vsnprintf(description, sizeof(description), format, args);
+    va_end(args);
+    state->report(state->context, description);
+}
+
+static void compare_uint(diff_state *state, const char *name, long a, long b) {
+    if (a != b) {
+        differ(state, "%s: %ld != %ld", name, a, b);
+    }
+}
+
+static void compare_string(diff_state *state, const char *name, const char *a, const char *b) {
+    if (strcmp(a, b) != 0) {
+        differ(state, "%s: \"%s\" != \"%s\"", name, a, b);
+    }
+}
+
+static void format_cell(char *out, size_t out_size, const mc_xm_event *event) {
+    if (event == NULL) {
+        snprintf(out, out_size, "empty");
+        return;
+    }
+    snprintf(out, out_size, "note %u instrument %u volume %u effect %X%02X", event->note, event->instrument,
+        event->volume, event->effect_type, event->effect_param);
+}
+
+static int same_cell(const mc_xm_event *a, const mc_xm_event *b) {
+    return a->note == b->note && a->instrument == b->instrument && a->volume == b->volume &&
+        a->effect_type == b->effect_type && a->effect_param == b->effect_param;
+}
+
+static void compare_cells(diff_state *state, const mc_xm_event *a, const mc_xm_event *b) {
+    const mc_xm_event *at = a != NULL ? a : b;
+    char left[64];
+    char right[64];
+
+    if (a != NULL && b != NULL && same_cell(a, b)) {
+        return;
+    }
+    format_cell(left, sizeof(left), a);
+    format_cell(right, sizeof(right), b);
+    differ(state, "pattern %u row %u channel %u: %s != %s", at->pattern, at->row, at->channel, left, right);
+}
+
+static void compare_pattern(
+    diff_state *state,
+    const mc_module_snapshot *a,
+    const mc_module_snapshot *b,
+    uint16_t index
+) {
+    const mc_snapshot_pattern *pa = &a->patterns[index];
+    const mc_snapshot_pattern *pb = &b->patterns[index];
+    const mc_xm_event *ea = a->events + pa->first_event;
+    const mc_xm_event *eb = b->events + pb->first_event;
+    size_t i = 0;
+    size_t j = 0;
+    char name[64];
+
+    snprintf(name, sizeof(name), "pattern %u rows", index);
+    compare_uint(state, name, pa->row_count, pb->row_count);
+    snprintf(name, sizeof(name), "pattern %u packed_size", index);
+    compare_uint(state, name, pa->packed_size, pb->packed_size);
+    while (i < pa->event_count || j < pb->event_count) {
+        long key_a = i < pa->event_count ? (long)ea[i].row * 65536L + ea[i].channel : -1;
+        long key_b = j < pb->event_count ? (long)eb[j].row * 65536L + eb[j].channel : -1;
+
+        if (key_b < 0 || (key_a >= 0 && key_a < key_b)) {
+            compare_cells(state, &ea[i++], NULL);
+        } else if (key_a < 0 || key_b < key_a) {
+            compare_cells(state, NULL, &eb[j++]);
+        } else {
+            compare_cells(state, &ea[i++], &eb[j++]);
+        }
+    }
+}
+
+size_t mc_snapshot_diff(
+    const mc_module_snapshot *a,
+    const mc_module_snapshot *b,
+    mc_snapshot_difference_fn report,
+    void *context
+) {
+    const mc_module_header *ha = &a->header;
+    const mc_module_header *hb = &b->header;
+    diff_state state;
+    uint16_t count;
+    uint16_t i;
+
+    state.report = report;
+    state.context = context;
+    state.count = 0;
+    compare_string(&state, "type", mc_module_type_name(ha->type), mc_module_type_name(hb->type));
+    compare_string(&state, "title", ha->title, hb->title);
+    compare_string(&state, "warning", ha->warning, hb->warning);
+    compare_string(&state, "first_instrument_name", ha->first_instrument_name, hb->first_instrument_name);
+    compare_uint(&state, "version_major", ha->version_major, hb->version_major);
+    compare_uint(&state, "version_minor", ha->version_minor, hb->version_minor);
+    compare_uint(&state, "channels", ha->channels, hb->channels);
+    compare_uint(&state, "patterns", ha->patterns, hb->patterns);
+    compare_uint(&state, "instruments", ha->instruments, hb->instruments);
+    compare_uint(&state, "xm_flags", ha->xm_flags, hb->xm_flags);
+    compare_uint(&state, "song_length", ha->song_length, hb->song_length);
+    compare_uint(&state, "restart_position", ha->restart_position, hb->restart_position);
+    compare_uint(&state, "default_tempo", ha->default_tempo, hb->default_tempo);
+    compare_uint(&state, "default_bpm", ha->default_bpm, hb->default_bpm);
+    compare_string(&state, "first_mod_sample.name", ha->first_mod_sample.name, hb->first_mod_sample.name);
+    compare_uint(&state, "first_mod_sample.length_bytes", ha->first_mod_sample.length_bytes,
+        hb->first_mod_sample.length_bytes);
+    compare_uint(&state, "first_mod_sample.finetune", ha->first_mod_sample.finetune, hb->first_mod_sample.finetune);
+    compare_uint(&state, "first_mod_sample.volume", ha->first_mod_sample.volume, hb->first_mod_sample.volume);
+
+    compare_uint(&state, "order_table_length", a->order_count, b->order_count);
+    count = a->order_count < b->order_count ? a->order_count : b->order_count;
+    for (i = 0; i < count; i++) {
+        if (a->orders[i] != b->orders[i]) {
+            differ(&state, "order_table[%u]: %u != %u", i, a->orders[i], b->orders[i]);
+        }
+    }
+
+    compare_uint(&state, "pattern_count", a->pattern_count, b->pattern_count);
+    count = a->pattern_count < b->pattern_count ? a->pattern_count : b->pattern_count;
+    for (i = 0; i < count; i++) {
+        compare_pattern(&state, a, b, i);
+    }
+    return state.count;
+}
@@ -0,0 +1,152 @@
+#include "module_song_walk.h"
+
+#include <string.h>
+
+enum {
+    SONG_WALK_EFFECT_POSITION_JUMP = 0x0B,
+    SONG_WALK_EFFECT_PATTERN_BREAK = 0x0D,
+    SONG_WALK_EFFECT_EXTENDED = 0x0E,
+    SONG_WALK_EFFECT_SET_SPEED = 0x0F,
+    SONG_WALK_EXTENDED_PATTERN_LOOP = 0x6,
+    SONG_WALK_EXTENDED_PATTERN_DELAY = 0xE,
+};
+
+static uint16_t song_walk_pattern_rows(mc_module *module, uint16_t pattern) {
+    uint16_t row_count = mc_module_pattern_rows(module, pattern);
+
+    if (pattern >= mc_module_pattern_count(module) || row_count == 0u) {
+        return MC_SONG_WALK_EMPTY_PATTERN_ROWS;
+    }
+    return row_count;
+}
+
+static void song_walk_enter(mc_song_walk *walk, uint16_t order) {
+    walk->visited_orders[order] = 1u;
+    walk->order = order;
+    walk->pattern = walk->orders[order];
+    walk->row_count = song_walk_pattern_rows(walk->module, walk->pattern);
+    walk->cells = NULL;
+    if (walk->pattern < mc_module_pattern_count(walk->module) &&
+        mc_module_pattern_rows(walk->module, walk->pattern) > 0u &&
+        !mc_module_load_pattern(walk->module, walk->pattern, &walk->cells)) {
+        walk->cells = NULL;
+    }
+}
+
+int mc_song_walk_begin(mc_song_walk *walk, mc_module *module, uint16_t start_order) {
+    const mc_module_header *header = mc_module_get_header(module);
+    uint16_t order_count = 0u;
+
+    memset(walk, 0, sizeof(*walk));
+    if (header == NULL) {
+        return 0;
+    }
+    walk->module = module;
+    walk->orders = mc_module_order_table(module, &order_count);
+    if (order_count > MC_MAX_ORDER_ENTRIES) {
+        order_count = MC_MAX_ORDER_ENTRIES;
+    }
+    walk->song_length = header->song_length < order_count ? header->song_length : order_count;
+    if (walk->orders == NULL || walk->song_length == 0u || start_order >= walk->song_length) {
+        return 0;
+    }
+    walk->restart_order = header->restart_position < walk->song_length ? header->restart_position : 0u;
+    walk->pattern_channel_count = header->channels;
+    walk->channel_count = header->channels < MC_SONG_WALK_MAX_CHANNELS
+        ? header->channels
+        : (uint16_t)MC_SONG_WALK_MAX_CHANNELS;
+    walk->speed = header->default_tempo > 0u ? header->default_tempo : MC_SONG_WALK_DEFAULT_SPEED;
+    walk->bpm = header->default_bpm > 0u ? header->default_bpm : MC_SONG_WALK_DEFAULT_BPM;
+    song_walk_enter(walk, start_order);
+    return 1;
+}
+
+uint32_t mc_song_walk_process_row(mc_song_walk *walk) {
+    uint16_t channel;
+
+    walk->pattern_delay = 0u;
+    for (channel = 0u; walk->cells != NULL && channel < walk->channel_count; channel++) {
+        const mc_pattern_cell *cell = &walk->cells[(size_t)walk->row * walk->pattern_channel_count + channel];
+        uint8_t param = cell->effect_param;
+
+        switch (cell->effect_type) {
+        case SONG_WALK_EFFECT_POSITION_JUMP:
+            walk->jump_pending = 1;
+            walk->jump_order = param;
+            if (!walk->break_pending) {
+                walk->break_row = 0u;
+            }
+            break;
+        case SONG_WALK_EFFECT_PATTERN_BREAK:
+            walk->break_pending = 1;
+            walk->break_row = (uint16_t)((param >> 4) * 10u + (param & 0x0Fu));
+            break;
+        case SONG_WALK_EFFECT_EXTENDED:
+            if ((param >> 4) == SONG_WALK_EXTENDED_PATTERN_LOOP) {
+                uint8_t count = param & 0x0Fu;
+                if (count == 0u) {
+                    walk->channel_loop_rows[channel] = walk->row;
+                } else if (walk->channel_loop_counts[channel] == 0u) {
+                    walk->channel_loop_counts[channel] = count;
+                    walk->loop_pending = 1;
+                    walk->loop_row = walk->channel_loop_rows[channel];
+                } else if (--walk->channel_loop_counts[channel] > 0u) {
+                    walk->loop_pending = 1;
+                    walk->loop_row = walk->channel_loop_rows[channel];
+                }
+            } else if ((param >> 4) == SONG_WALK_EXTENDED_PATTERN_DELAY) {
+                walk->pattern_delay = param & 0x0Fu;
+            }
+            break;
+        case SONG_WALK_EFFECT_SET_SPEED:
+            if (param == 0u) {
+                break;
+            }
+            if (param < 0x20u) {
+                walk->speed = param;
+            } else {
+                walk->bpm = param;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return (uint32_t)walk->speed * (1u + walk->pattern_delay);
+}
+
+int mc_song_walk_advance(mc_song_walk *walk, uint16_t *loop_order, uint16_t *loop_row) {
+    uint16_t next_row = (uint16_t)(walk->row + 1u);
+    int change_order = 0;
+    uint16_t next_order = walk->order;
+
+    if (walk->loop_pending) {
+        next_row = walk->loop_row;
+    } else if (walk->jump_pending || walk->break_pending) {
+        next_order = walk->jump_pending ? walk->jump_order : (uint16_t)(walk->order + 1u);
+        next_row = walk->break_pending ? walk->break_row : 0u;
+        change_order = 1;
+    } else if (next_row >= walk->row_count) {
+        next_order = (uint16_t)(walk->order + 1u);
+        next_row = 0u;
+        change_order = 1;
+    }
+    walk->loop_pending = 0;
+    walk->jump_pending = 0;
+    walk->break_pending = 0;
+
+    if (change_order) {
+        uint16_t target = next_order < walk->song_length ? next_order : walk->restart_order;
+        int outside_range = walk->range_count > 0u &&
+            (target < walk->range_start || target - walk->range_start >= walk->range_count);
+        if ((!walk->loop && (next_order >= walk->song_length || walk->visited_orders[target])) || outside_range) {
+            uint16_t row_count = song_walk_pattern_rows(walk->module, walk->orders[target]);
+            *loop_order = target;
+            *loop_row = next_row < row_count ? next_row : 0u;
+            return 0;
+        }
+        song_walk_enter(walk, target);
+    }
+    walk->row = next_row < walk->row_count ? next_row : 0u;
+    return 1;
+}
@@ -1,11 +1,12 @@
 #include "module_types.h"
 
-#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "mod_header.h"
+#include "module_file.h"
+#include "module_handle.h"
 #include "xm_header.h"
 
 static mc_module_info mc_error(const char *message) {
@@ -32,63 +33,102 @@ const char *mc_module_type_name(mc_module_type type) {
 }
 
 mc_module_info mc_parse_file(const char *path) {
-    FILE *f;
-    long file_size;
-    uint8_t *data;
-    size_t bytes_read;
+    mc_module_open_options options;
+    mc_module *module;
+    const mc_module_info *summary;
     mc_module_info info;
+    char error[128];
 
-    if (path == NULL || path[0] == '\0') {
-        return mc_error("invalid path");
+    // Eager decoding keeps the old contract: an XM file with malformed
+    // pattern data is rejected rather than reported with missing events.
+    memset(&options, 0, sizeof(options));
+    options.flags = MC_MODULE_OPEN_EAGER_PATTERNS;
+    module = mc_module_open_with_options(path, &options, error, sizeof(error));
+    if (module == NULL) {
+        return mc_error(error);
     }
-
-    f = fopen(path, "rb");
-    if (f == NULL) {
-        char msg[128];
-        snprintf(msg, sizeof(msg), "open failed: %s", strerror(errno));
-        return mc_error(msg);
+    summary = mc_module_get_info(module);
+    if (summary == NULL) {
+        mc_module_close(module);
+        return mc_error("out of memory");
     }
+    info = *summary;
+    mc_module_close(module);
+    return info;
+}
+
+mc_module_type mc_identify_module(const uint8_t *data, size_t size) {
+    size_t i;
 
-    if (fseek(f, 0, SEEK_END) != 0) {
-        fclose(f);
-        return mc_error("seek failed");
+    if (data == NULL) {
+        return MC_MODULE_TYPE_UNKNOWN;
     }
-    file_size = ftell(f);
-    if (file_size < 0) {
-        fclose(f);
-        return mc_error("tell failed");
+    if (size >= 38 && memcmp(data, "Extended Module: ", 17) == 0 && data[37] == 0x1A) {
+        return MC_MODULE_TYPE_XM;
     }
-    if (fseek(f, 0, SEEK_SET) != 0) {
-        fclose(f);
-        return mc_error("seek failed");
+    if (size < 1084) {
+        return MC_MODULE_TYPE_UNKNOWN;
     }
-
-    data = (uint8_t *)malloc((size_t)file_size);
-    if (data == NULL && file_size > 0) {
-        fclose(f);
-        return mc_error("out of memory");
+    for (i = 1080; i < 1084; i++) {
+        if (data[i] < 32 || data[i] > 126) {
+            return MC_MODULE_TYPE_UNKNOWN;
+        }
     }
+    return MC_MODULE_TYPE_MOD;
+}
 
-    bytes_read = file_size > 0 ? fread(data, 1, (size_t)file_size, f) : 0;
-    fclose(f);
+mc_module_probe mc_probe_file(const char *path) {
+    mc_module_probe probe;
+    uint8_t prefix[MC_PROBE_BYTES];
+    uint8_t *data = prefix;
+    size_t size = 0;
+    const uint8_t *orders;
+    uint16_t order_count;
+    size_t pattern_offset;
+    int parsed = 0;
 
-    if ((size_t)file_size != bytes_read) {
-        free(data);
-        return mc_error("read failed");
+    memset(&probe, 0, sizeof(probe));
+    if (!mc_file_read_prefix(path, prefix, sizeof(prefix), &size, &probe.file_size, probe.error,
+            sizeof(probe.error))) {
+        return probe;
     }
 
-    if (mc_parse_xm_header_bytes(data, (size_t)file_size, &info)) {
-        free(data);
-        info.error[0] = '\0';
-        return info;
+    switch (mc_identify_module(prefix, size)) {
+    case MC_MODULE_TYPE_XM:
+        // The order table is the tail of the declared header; only a
+        // non-standard header size needs a second, larger read.
+        if (size >= 64) {
+            uint64_t needed = 60u + ((uint64_t)prefix[60] | ((uint64_t)prefix[61] << 8) |
+                ((uint64_t)prefix[62] << 16) | ((uint64_t)prefix[63] << 24));
+            if (needed > size && needed <= probe.file_size && needed <= (uint64_t)SIZE_MAX) {
+                data = (uint8_t *)malloc((size_t)needed);
+                if (data == NULL) {
+                    snprintf(probe.error, sizeof(probe.error), "out of memory");
+                    return probe;
+                }
+                if (!mc_file_read_prefix(path, data, (size_t)needed, &size, &probe.file_size, probe.error,
+                        sizeof(probe.error))) {
+                    free(data);
+                    return probe;
+                }
+            }
+        }
+        parsed = mc_xm_parse_header(data, size, &probe.header, &orders, &order_count, &pattern_offset);
+        break;
+    case MC_MODULE_TYPE_MOD:
+        parsed = mc_mod_parse_header(data, size, &probe.header, &orders, &order_count);
+        break;
+    case MC_MODULE_TYPE_UNKNOWN:
+    default:
+        break;
     }
-
-    if (mc_parse_mod_header_bytes(data, (size_t)file_size, &info)) {
+    if (data != prefix) {
         free(data);
-        info.error[0] = '\0';
-        return info;
     }
-
-    free(data);
-    return mc_error("unsupported or invalid module header");
+    if (!parsed) {
+        snprintf(probe.error, sizeof(probe.error), "unsupported or invalid module header");
+        return probe;
+    }
+    probe.ok = 1;
+    return probe;
 }
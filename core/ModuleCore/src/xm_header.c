@@ -26,78 +26,94 @@ static void copy_trimmed(char *dst, size_t dst_size, const uint8_t *src, size_t
     dst[count] = '\0';
 }
 
-static int decode_xm_event(
-    const uint8_t *data,
-    size_t size,
-    size_t *offset,
-    uint8_t *note,
-    uint8_t *instrument,
-    uint8_t *volume,
-    uint8_t *effect_type,
-    uint8_t *effect_param
-) {
-    uint8_t b;
-    size_t o;
-
-    if (offset == NULL || data == NULL || *offset >= size) {
-        return 0;
-    }
+// A cell is either a packing byte (bit 7 set, bits 0-4 select note,
+// instrument, volume, effect type and effect param) followed by the selected
+// fields, or five raw field bytes. Raw cells behave like a packing byte with
+// all five flags and no packing byte, so both forms share one layout table
+// keyed on the five flag bits.
+enum {
+    XM_CELL_FIELDS = 5,
+    XM_CELL_MAX_BYTES = 6,
+};
 
-    o = *offset;
-    b = data[o++];
+// field[i] is the byte offset of field i after the packing byte; mask[i] is 0
+// for absent fields so the (in-bounds) byte read there is discarded.
+typedef struct {
+    uint8_t length;
+    uint8_t field[XM_CELL_FIELDS];
+    uint8_t mask[XM_CELL_FIELDS];
+} xm_cell_layout;
 
-    *note = 0;
-    *instrument = 0;
-    *volume = 0;
-    *effect_type = 0;
-    *effect_param = 0;
+static const xm_cell_layout xm_cell_layouts[32] = {
+    { 0, { 0, 0, 0, 0, 0 }, { 0x00, 0x00, 0x00, 0x00, 0x00 } },
+    { 1, { 0, 0, 0, 0, 0 }, { 0xFF, 0x00, 0x00, 0x00, 0x00 } },
+    { 1, { 0, 0, 0, 0, 0 }, { 0x00, 0xFF, 0x00, 0x00, 0x00 } },
+    { 2, { 0, 1, 0, 0, 0 }, { 0xFF, 0xFF, 0x00, 0x00, 0x00 } },
+    { 1, { 0, 0, 0, 0, 0 }, { 0x00, 0x00, 0xFF, 0x00, 0x00 } },
+    { 2, { 0, 0, 1, 0, 0 }, { 0xFF, 0x00, 0xFF, 0x00, 0x00 } },
+    { 2, { 0, 0, 1, 0, 0 }, { 0x00, 0xFF, 0xFF, 0x00, 0x00 } },
+    { 3, { 0, 1, 2, 0, 0 }, { 0xFF, 0xFF, 0xFF, 0x00, 0x00 } },
+    { 1, { 0, 0, 0, 0, 0 }, { 0x00, 0x00, 0x00, 0xFF, 0x00 } },
+    { 2, { 0, 0, 0, 1, 0 }, { 0xFF, 0x00, 0x00, 0xFF, 0x00 } },
+    { 2, { 0, 0, 0, 1, 0 }, { 0x00, 0xFF, 0x00, 0xFF, 0x00 } },
+    { 3, { 0, 1, 0, 2, 0 }, { 0xFF, 0xFF, 0x00, 0xFF, 0x00 } },
+    { 2, { 0, 0, 0, 1, 0 }, { 0x00, 0x00, 0xFF, 0xFF, 0x00 } },
+    { 3, { 0, 0, 1, 2, 0 }, { 0xFF, 0x00, 0xFF, 0xFF, 0x00 } },
+    { 3, { 0, 0, 1, 2, 0 }, { 0x00, 0xFF, 0xFF, 0xFF, 0x00 } },
+    { 4, { 0, 1, 2, 3, 0 }, { 0xFF, 0xFF, 0xFF, 0xFF, 0x00 } },
+    { 1, { 0, 0, 0, 0, 0 }, { 0x00, 0x00, 0x00, 0x00, 0xFF } },
+    { 2, { 0, 0, 0, 0, 1 }, { 0xFF, 0x00, 0x00, 0x00, 0xFF } },
+    { 2, { 0, 0, 0, 0, 1 }, { 0x00, 0xFF, 0x00, 0x00, 0xFF } },
+    { 3, { 0, 1, 0, 0, 2 }, { 0xFF, 0xFF, 0x00, 0x00, 0xFF } },
+    { 2, { 0, 0, 0, 0, 1 }, { 0x00, 0x00, 0xFF, 0x00, 0xFF } },
+    { 3, { 0, 0, 1, 0, 2 }, { 0xFF, 0x00, 0xFF, 0x00, 0xFF } },
+    { 3, { 0, 0, 1, 0, 2 }, { 0x00, 0xFF, 0xFF, 0x00, 0xFF } },
+    { 4, { 0, 1, 2, 0, 3 }, { 0xFF, 0xFF, 0xFF, 0x00, 0xFF } },
+    { 2, { 0, 0, 0, 0, 1 }, { 0x00, 0x00, 0x00, 0xFF, 0xFF } },
+    { 3, { 0, 0, 0, 1, 2 }, { 0xFF, 0x00, 0x00, 0xFF, 0xFF } },
+    { 3, { 0, 0, 0, 1, 2 }, { 0x00, 0xFF, 0x00, 0xFF, 0xFF } },
+    { 4, { 0, 1, 0, 2, 3 }, { 0xFF, 0xFF, 0x00, 0xFF, 0xFF } },
+    { 3, { 0, 0, 0, 1, 2 }, { 0x00, 0x00, 0xFF, 0xFF, 0xFF } },
+    { 4, { 0, 0, 1, 2, 3 }, { 0xFF, 0x00, 0xFF, 0xFF, 0xFF } },
+    { 4, { 0, 0, 1, 2, 3 }, { 0x00, 0xFF, 0xFF, 0xFF, 0xFF } },
+    { 5, { 0, 1, 2, 3, 4 }, { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF } },
+};
 
-    if (b & 0x80) {
-        if ((b & 0x01) != 0) {
-            if (o >= size) { return 0; }
-            *note = data[o++];
-        }
-        if ((b & 0x02) != 0) {
-            if (o >= size) { return 0; }
-            *instrument = data[o++];
-        }
-        if ((b & 0x04) != 0) {
-            if (o >= size) { return 0; }
-            *volume = data[o++];
-        }
-        if ((b & 0x08) != 0) {
-            if (o >= size) { return 0; }
-            *effect_type = data[o++];
-        }
-        if ((b & 0x10) != 0) {
-            if (o >= size) { return 0; }
-            *effect_param = data[o++];
-        }
-    } else {
-        if (o + 4 > size) {
-            return 0;
-        }
-        *note = b;
-        *instrument = data[o++];
-        *volume = data[o++];
-        *effect_type = data[o++];
-        *effect_param = data[o++];
-    }
+// Decodes one cell from p. At least XM_CELL_MAX_BYTES bytes must be readable;
+// the return value is the number of bytes the cell actually uses.
+static inline size_t unpack_cell(const uint8_t *p, mc_pattern_cell *cell) {
+    size_t packed = (size_t)(p[0] >> 7);
+    const xm_cell_layout *layout = &xm_cell_layouts[packed ? (p[0] & 0x1F) : 0x1F];
+    const uint8_t *src = p + packed;
+    mc_pattern_cell decoded;
 
-    *offset = o;
-    return 1;
+    // Built in a local so the byte stores cannot alias the table and source
+    // reads, which would force the compiler to reload them per field.
+    decoded.note = (uint8_t)(src[layout->field[0]] & layout->mask[0]);
+    decoded.instrument = (uint8_t)(src[layout->field[1]] & layout->mask[1]);
+    decoded.volume = (uint8_t)(src[layout->field[2]] & layout->mask[2]);
+    decoded.effect_type = (uint8_t)(src[layout->field[3]] & layout->mask[3]);
+    decoded.effect_param = (uint8_t)(src[layout->field[4]] & layout->mask[4]);
+    *cell = decoded;
+    return packed + layout->length;
 }
 
-int mc_parse_xm_header_bytes(const uint8_t *data, size_t size, mc_module_info *out_info) {
+int mc_xm_parse_header(
+    const uint8_t *data,
+    size_t size,
+    mc_module_header *out_header,
+    const uint8_t **out_orders,
+    uint16_t *out_order_count,
+    size_t *out_pattern_offset
+) {
     const size_t min_header = 80;
-    const uint8_t *ptr;
-    size_t remaining;
-    uint16_t i;
     uint32_t header_size;
     size_t total_header;
     uint16_t version;
+    size_t order_capacity;
 
-    if (data == NULL || out_info == NULL) {
+    if (data == NULL || out_header == NULL || out_orders == NULL || out_order_count == NULL ||
+        out_pattern_offset == NULL) {
         return 0;
     }
     if (size < min_header) {
@@ -119,147 +135,138 @@ int mc_parse_xm_header_bytes(const uint8_t *data, size_t size, mc_module_info *o
         return 0;
     }
 
-    memset(out_info, 0, sizeof(*out_info));
-    out_info->type = MC_MODULE_TYPE_XM;
-    out_info->ok = 1;
-    copy_trimmed(out_info->title, sizeof(out_info->title), data + 17, 20);
+    memset(out_header, 0, sizeof(*out_header));
+    out_header->type = MC_MODULE_TYPE_XM;
+    copy_trimmed(out_header->title, sizeof(out_header->title), data + 17, 20);
 
     version = read_le_u16(data + 58);
-    out_info->version_major = (uint16_t)((version >> 8) & 0xFF);
-    out_info->version_minor = (uint16_t)(version & 0xFF);
-    out_info->song_length = read_le_u16(data + 64);
-    out_info->restart_position = read_le_u16(data + 66);
-    out_info->channels = read_le_u16(data + 68);
-    out_info->patterns = read_le_u16(data + 70);
-    out_info->instruments = read_le_u16(data + 72);
-    out_info->xm_flags = read_le_u16(data + 74);
-    out_info->default_tempo = read_le_u16(data + 76);
-    out_info->default_bpm = read_le_u16(data + 78);
+    out_header->version_major = (uint16_t)((version >> 8) & 0xFF);
+    out_header->version_minor = (uint16_t)(version & 0xFF);
+    out_header->song_length = read_le_u16(data + 64);
+    out_header->restart_position = read_le_u16(data + 66);
+    out_header->channels = read_le_u16(data + 68);
+    out_header->patterns = read_le_u16(data + 70);
+    out_header->instruments = read_le_u16(data + 72);
+    out_header->xm_flags = read_le_u16(data + 74);
+    out_header->default_tempo = read_le_u16(data + 76);
+    out_header->default_bpm = read_le_u16(data + 78);
 
-    out_info->order_table_length = out_info->song_length;
-    if (out_info->order_table_length > MC_MAX_ORDER_ENTRIES) {
-        out_info->order_table_length = MC_MAX_ORDER_ENTRIES;
-    }
-    memcpy(out_info->order_table, data + 80, out_info->order_table_length);
+    // The order table is the tail of the declared header, normally 256 bytes.
+    order_capacity = total_header - min_header;
+    *out_orders = data + min_header;
+    *out_order_count = out_header->song_length < order_capacity ? out_header->song_length : (uint16_t)order_capacity;
+    *out_pattern_offset = total_header;
+    return 1;
+}
 
-    ptr = data + total_header;
-    remaining = size - total_header;
+int mc_xm_next_pattern(const uint8_t *data, size_t size, size_t *offset, mc_xm_pattern_span *out_span) {
+    uint32_t pat_header_len;
+    size_t remaining;
 
-    out_info->pattern_row_count_count = out_info->patterns;
-    if (out_info->pattern_row_count_count > MC_MAX_PATTERN_ROW_COUNTS) {
-        out_info->pattern_row_count_count = MC_MAX_PATTERN_ROW_COUNTS;
+    if (data == NULL || offset == NULL || out_span == NULL || *offset > size) {
+        return 0;
+    }
+    remaining = size - *offset;
+    if (remaining < 9) {
+        return 0;
+    }
+    pat_header_len = read_le_u32(data + *offset);
+    if (pat_header_len < 9 || remaining < pat_header_len) {
+        return 0;
+    }
+    out_span->row_count = read_le_u16(data + *offset + 5);
+    out_span->packed_size = read_le_u16(data + *offset + 7);
+    if (remaining < (size_t)pat_header_len + (size_t)out_span->packed_size) {
+        return 0;
     }
+    out_span->data_offset = *offset + pat_header_len;
+    *offset = out_span->data_offset + out_span->packed_size;
+    return 1;
+}
 
-    for (i = 0; i < out_info->patterns; i++) {
-        uint32_t pat_header_len;
-        uint16_t row_count;
-        uint16_t packed_size;
-        const uint8_t *pat_data;
-        size_t pat_offset = 0;
-        uint16_t row;
-        uint16_t ch;
+int mc_xm_decode_pattern(
+    const uint8_t *packed,
+    size_t packed_size,
+    uint16_t row_count,
+    uint16_t channels,
+    mc_pattern_cell *out_cells
+) {
+    size_t cell_count = (size_t)row_count * channels;
+    size_t row_budget = (size_t)channels * XM_CELL_MAX_BYTES;
+    size_t offset = 0;
+    uint16_t row;
 
-        if (remaining < 9) {
-            return 0;
-        }
-        pat_header_len = read_le_u32(ptr + 0);
-        if (pat_header_len < 9 || remaining < pat_header_len) {
-            return 0;
-        }
-        row_count = read_le_u16(ptr + 5);
-        packed_size = read_le_u16(ptr + 7);
-        if (i < out_info->pattern_row_count_count) {
-            out_info->pattern_row_counts[i] = row_count;
-        }
-        if (i < MC_MAX_PATTERN_ROW_COUNTS) {
-            out_info->pattern_packed_size_count = i + 1;
-            out_info->pattern_packed_sizes[i] = packed_size;
-        }
-        if (remaining < (size_t)pat_header_len + (size_t)packed_size) {
-            return 0;
+    if (cell_count > 0 && out_cells == NULL) {
+        return 0;
+    }
+    if (packed_size == 0) {
+        if (cell_count > 0) {
+            memset(out_cells, 0, cell_count * sizeof(*out_cells));
         }
+        return 1;
+    }
+    // Every cell takes at least one packed byte.
+    if (cell_count > packed_size) {
+        return 0;
+    }
 
-        pat_data = ptr + pat_header_len;
-        for (row = 0; row < row_count; row++) {
-            for (ch = 0; ch < out_info->channels; ch++) {
-                uint8_t note;
-                uint8_t instrument;
-                uint8_t volume;
-                uint8_t effect_type;
-                uint8_t effect_param;
-
-                if (packed_size > 0) {
-                    if (!decode_xm_event(
-                            pat_data,
-                            packed_size,
-                            &pat_offset,
-                            &note,
-                            &instrument,
-                            &volume,
-                            &effect_type,
-                            &effect_param)) {
-                        return 0;
-                    }
-                } else {
-                    note = 0;
-                    instrument = 0;
-                    volume = 0;
-                    effect_type = 0;
-                    effect_param = 0;
-                }
+    for (row = 0; row < row_count; row++) {
+        mc_pattern_cell *cells = out_cells + (size_t)row * channels;
+        uint16_t ch;
 
-                if (note != 0 || instrument != 0 || volume != 0 || effect_type != 0 || effect_param != 0) {
-                    if (out_info->xm_event_count < MC_MAX_XM_EVENTS) {
-                    mc_xm_event *event = &out_info->xm_events[out_info->xm_event_count];
-                    event->pattern = i;
-                    event->row = row;
-                    event->channel = ch;
-                    event->note = note;
-                    event->instrument = instrument;
-                    event->volume = volume;
-                    event->effect_type = effect_type;
-                    event->effect_param = effect_param;
-                    out_info->xm_event_count++;
-                    } else if (out_info->warning[0] == '\0') {
-                        snprintf(
-                            out_info->warning,
-                            sizeof(out_info->warning),
-                            "xm events truncated at %u entries",
-                            (unsigned)MC_MAX_XM_EVENTS
-                        );
-                    }
+        if (packed_size - offset >= row_budget) {
+            // The whole row fits even if every cell uses six bytes, so cells
+            // are unpacked without further bounds checks.
+            for (ch = 0; ch < channels; ch++) {
+                // Empty cells dominate real patterns; taking them on a
+                // predictable branch keeps the offset chain short.
+                if (packed[offset] == 0x80) {
+                    memset(&cells[ch], 0, sizeof(cells[ch]));
+                    offset++;
+                    continue;
                 }
+                offset += unpack_cell(packed + offset, &cells[ch]);
             }
+            continue;
         }
-        if (pat_offset != packed_size) {
-            return 0;
-        }
-
-        ptr += pat_header_len + packed_size;
-        remaining -= pat_header_len + packed_size;
-    }
+        for (ch = 0; ch < channels; ch++) {
+            uint8_t tail[XM_CELL_MAX_BYTES] = { 0 };
+            size_t available = packed_size - offset;
+            size_t used;
 
-    if (out_info->instruments > 0) {
-        uint32_t inst_header_size;
-        uint16_t num_samples;
-
-        if (remaining < 29) {
-            return 0;
-        }
-        inst_header_size = read_le_u32(ptr + 0);
-        if (inst_header_size < 29 || remaining < inst_header_size) {
-            return 0;
+            if (available == 0) {
+                return 0;
+            }
+            memcpy(tail, packed + offset, available < sizeof(tail) ? available : sizeof(tail));
+            used = unpack_cell(tail, &cells[ch]);
+            if (used > available) {
+                return 0;
+            }
+            offset += used;
         }
-        copy_trimmed(out_info->first_instrument_name, sizeof(out_info->first_instrument_name), ptr + 4, 22);
-        num_samples = read_le_u16(ptr + 27);
+    }
+    return offset == packed_size;
+}
 
-        ptr += inst_header_size;
-        remaining -= inst_header_size;
+int mc_xm_read_first_instrument(const uint8_t *data, size_t size, size_t offset, mc_module_header *out_header) {
+    uint32_t inst_header_size;
+    size_t remaining;
 
-        if (num_samples > 0) {
-            /* For now, instrument name only (best effort). Sample/instrument bodies are not parsed yet. */
-        }
+    if (data == NULL || out_header == NULL || offset > size) {
+        return 0;
     }
-
+    if (out_header->instruments == 0) {
+        return 1;
+    }
+    remaining = size - offset;
+    if (remaining < 29) {
+        return 0;
+    }
+    inst_header_size = read_le_u32(data + offset);
+    if (inst_header_size < 29 || remaining < inst_header_size) {
+        return 0;
+    }
+    // Only the first name is kept here; see mc_xm_parse_instruments for full instruments.
+    copy_trimmed(out_header->first_instrument_name, sizeof(out_header->first_instrument_name), data + offset + 4, 22);
     return 1;
 }
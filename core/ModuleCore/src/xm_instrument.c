@@ -0,0 +1,271 @@
+#include "xm_instrument.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    XM_MODULE_HEADER_MIN = 80,
+    XM_PATTERN_HEADER_MIN = 9,
+    XM_INSTRUMENT_HEADER_MIN = 29,
+    XM_INSTRUMENT_SAMPLE_HEADER_SIZE_END = 33,
+    XM_INSTRUMENT_KEYMAP_END = 33 + MC_XM_KEYMAP_SIZE,
+    XM_INSTRUMENT_VOLUME_POINTS = 129,
+    XM_INSTRUMENT_PANNING_POINTS = 177,
+    XM_INSTRUMENT_ENVELOPE_END = 241,
+};
+
+static uint16_t read_le_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+static uint32_t read_le_u32(const uint8_t *p) {
+    return (uint32_t)p[0] |
+        ((uint32_t)p[1] << 8) |
+        ((uint32_t)p[2] << 16) |
+        ((uint32_t)p[3] << 24);
+}
+
+static void copy_trimmed(char *dst, size_t dst_size, const uint8_t *src, size_t src_size) {
+    size_t count = src_size;
+    while (count > 0 && (src[count - 1] == 0 || src[count - 1] == ' ')) {
+        count--;
+    }
+    if (count >= dst_size) {
+        count = dst_size - 1;
+    }
+    memcpy(dst, src, count);
+    dst[count] = '\0';
+}
+
+static void read_envelope(
+    const uint8_t *instrument,
+    size_t points_offset,
+    uint8_t point_count,
+    uint8_t sustain_point,
+    uint8_t loop_start_point,
+    uint8_t loop_end_point,
+    uint8_t flags,
+    mc_xm_envelope *out_envelope
+) {
+    uint8_t i;
+
+    out_envelope->point_count = point_count > MC_XM_MAX_ENVELOPE_POINTS ? MC_XM_MAX_ENVELOPE_POINTS : point_count;
+    for (i = 0; i < out_envelope->point_count; i++) {
+        out_envelope->points[i].tick = read_le_u16(instrument + points_offset + (size_t)i * 4u);
+        out_envelope->points[i].value = read_le_u16(instrument + points_offset + (size_t)i * 4u + 2u);
+    }
+    out_envelope->sustain_point = sustain_point;
+    out_envelope->loop_start_point = loop_start_point;
+    out_envelope->loop_end_point = loop_end_point;
+    out_envelope->flags = flags;
+}
+
+static int reserve_samples(mc_xm_instrument_table *table, uint32_t *capacity, uint32_t needed) {
+    mc_xm_sample_info *grown;
+    uint32_t next = *capacity == 0u ? 64u : *capacity;
+
+    if (needed <= *capacity) {
+        return 1;
+    }
+    while (next < needed) {
+        next *= 2u;
+    }
+    grown = (mc_xm_sample_info *)realloc(table->samples, (size_t)next * sizeof(*grown));
+    if (grown == NULL) {
+        return 0;
+    }
+    table->samples = grown;
+    *capacity = next;
+    return 1;
+}
+
+int mc_xm_instrument_data_offset(const uint8_t *data, size_t size, size_t *out_offset) {
+    uint32_t header_size;
+    size_t offset;
+    uint16_t pattern_count;
+    uint16_t i;
+
+    if (data == NULL || out_offset == NULL || size < XM_MODULE_HEADER_MIN) {
+        return 0;
+    }
+    if (memcmp(data, "Extended Module: ", 17) != 0 || data[37] != 0x1A) {
+        return 0;
+    }
+    header_size = read_le_u32(data + 60);
+    if (header_size < 20 || size - 60u < (size_t)header_size) {
+        return 0;
+    }
+    offset = 60u + (size_t)header_size;
+    pattern_count = read_le_u16(data + 70);
+    for (i = 0; i < pattern_count; i++) {
+        uint32_t pattern_header_size;
+        uint16_t packed_size;
+
+        if (size - offset < XM_PATTERN_HEADER_MIN) {
+            return 0;
+        }
+        pattern_header_size = read_le_u32(data + offset);
+        packed_size = read_le_u16(data + offset + 7);
+        if (pattern_header_size < XM_PATTERN_HEADER_MIN ||
+            size - offset < (size_t)pattern_header_size + (size_t)packed_size) {
+            return 0;
+        }
+        offset += (size_t)pattern_header_size + (size_t)packed_size;
+    }
+    *out_offset = offset;
+    return 1;
+}
+
+int mc_xm_parse_instruments(const uint8_t *data, size_t size, mc_xm_instrument_table *out_table) {
+    size_t offset;
+    uint16_t declared_instruments;
+    uint32_t sample_capacity = 0u;
+    uint16_t i;
+
+    if (out_table == NULL) {
+        return 0;
+    }
+    memset(out_table, 0, sizeof(*out_table));
+    if (!mc_xm_instrument_data_offset(data, size, &offset)) {
+        return 0;
+    }
+    declared_instruments = read_le_u16(data + 72);
+    if (declared_instruments == 0) {
+        return 1;
+    }
+    out_table->instruments = (mc_xm_instrument *)calloc(declared_instruments, sizeof(mc_xm_instrument));
+    if (out_table->instruments == NULL) {
+        return 0;
+    }
+
+    for (i = 0; i < declared_instruments; i++) {
+        const uint8_t *base;
+        mc_xm_instrument *instrument = &out_table->instruments[i];
+        uint32_t header_size;
+        uint32_t sample_header_size;
+        size_t sample_header_offset;
+        size_t sample_data_offset;
+        uint16_t sample_count;
+        uint16_t s;
+
+        if (size - offset < XM_INSTRUMENT_HEADER_MIN) {
+            break;
+        }
+        base = data + offset;
+        header_size = read_le_u32(base);
+        if (header_size < XM_INSTRUMENT_HEADER_MIN || size - offset < (size_t)header_size) {
+            break;
+        }
+        sample_count = read_le_u16(base + 27);
+        instrument->header_offset = offset;
+        instrument->header_size = header_size;
+        copy_trimmed(instrument->name, sizeof(instrument->name), base + 4, 22);
+        instrument->type = base[26];
+        instrument->first_sample = out_table->sample_count;
+        if (sample_count == 0) {
+            out_table->instrument_count = (uint16_t)(i + 1u);
+            offset += header_size;
+            continue;
+        }
+        if (size - offset < XM_INSTRUMENT_SAMPLE_HEADER_SIZE_END) {
+            break;
+        }
+
+        if (header_size >= XM_INSTRUMENT_KEYMAP_END) {
+            instrument->has_keymap = 1;
+            memcpy(instrument->keymap, base + 33, MC_XM_KEYMAP_SIZE);
+        }
+        if (header_size >= XM_INSTRUMENT_ENVELOPE_END) {
+            instrument->has_envelopes = 1;
+            read_envelope(base, XM_INSTRUMENT_VOLUME_POINTS, base[225], base[227], base[228], base[229], base[233],
+                &instrument->volume_envelope);
+            read_envelope(base, XM_INSTRUMENT_PANNING_POINTS, base[226], base[230], base[231], base[232], base[234],
+                &instrument->panning_envelope);
+            instrument->vibrato_type = base[235];
+            instrument->vibrato_sweep = base[236];
+            instrument->vibrato_depth = base[237];
+            instrument->vibrato_rate = base[238];
+            instrument->fadeout = read_le_u16(base + 239);
+        }
+
+        sample_header_size = read_le_u32(base + 29);
+        if (sample_header_size < MC_XM_SAMPLE_HEADER_SIZE) {
+            sample_header_size = MC_XM_SAMPLE_HEADER_SIZE;
+        }
+        sample_header_offset = offset + header_size;
+        if ((size - sample_header_offset) / sample_header_size < sample_count) {
+            break;
+        }
+        sample_data_offset = sample_header_offset + (size_t)sample_header_size * sample_count;
+        if (!reserve_samples(out_table, &sample_capacity, out_table->sample_count + sample_count)) {
+            mc_xm_instrument_table_free(out_table);
+            return 0;
+        }
+
+        for (s = 0; s < sample_count; s++) {
+            mc_xm_sample_info *sample = &out_table->samples[out_table->sample_count + s];
+            memset(sample, 0, sizeof(*sample));
+            mc_xm_parse_sample_header(
+                data + sample_header_offset + (size_t)s * sample_header_size,
+                MC_XM_SAMPLE_HEADER_SIZE,
+                &sample->header
+            );
+            sample->header_offset = sample_header_offset + (size_t)s * sample_header_size;
+            sample->data_offset = sample_data_offset;
+            sample->data_in_bounds = sample_data_offset <= size &&
+                size - sample_data_offset >= (size_t)sample->header.length_bytes;
+            sample_data_offset += sample->header.length_bytes;
+        }
+        instrument->sample_count = sample_count;
+        out_table->sample_count += sample_count;
+        out_table->instrument_count = (uint16_t)(i + 1u);
+        offset = sample_data_offset;
+        if (offset > size) {
+            break;
+        }
+    }
+
+    if (out_table->instrument_count < declared_instruments) {
+        snprintf(
+            out_table->warning,
+            sizeof(out_table->warning),
+            "instrument data truncated after %u of %u instruments",
+            (unsigned)out_table->instrument_count,
+            (unsigned)declared_instruments
+        );
+    }
+    return 1;
+}
+
+void mc_xm_instrument_table_free(mc_xm_instrument_table *table) {
+    if (table == NULL) {
+        return;
+    }
+    free(table->instruments);
+    free(table->samples);
+    memset(table, 0, sizeof(*table));
+}
+
+int mc_xm_sample_view_at(
+    const mc_xm_instrument_table *table,
+    const uint8_t *data,
+    size_t size,
+    uint32_t sample_index,
+    mc_xm_sample_view *out_view
+) {
+    const mc_xm_sample_info *sample;
+
+    if (table == NULL || data == NULL || out_view == NULL || sample_index >= table->sample_count) {
+        return 0;
+    }
+    sample = &table->samples[sample_index];
+    if (!sample->data_in_bounds ||
+        sample->data_offset > size ||
+        size - sample->data_offset < (size_t)sample->header.length_bytes) {
+        return 0;
+    }
+    out_view->data = data + sample->data_offset;
+    out_view->length_bytes = sample->header.length_bytes;
+    return 1;
+}
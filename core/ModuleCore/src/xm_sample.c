@@ -0,0 +1,251 @@
+#include "xm_sample.h"
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define MC_XM_DELTA_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MC_XM_DELTA_NEON 1
+#endif
+
+// Float conversion decodes through a small integer buffer so the delta pass and
+// the int-to-float pass both stay in L1 and vectorize independently.
+#define MC_XM_DECODE_CHUNK 512u
+
+static uint16_t read_le_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+static uint32_t read_le_u32(const uint8_t *p) {
+    return (uint32_t)p[0] |
+        ((uint32_t)p[1] << 8) |
+        ((uint32_t)p[2] << 16) |
+        ((uint32_t)p[3] << 24);
+}
+
+static void copy_trimmed(char *dst, size_t dst_size, const uint8_t *src, size_t src_size) {
+    size_t count = src_size;
+    while (count > 0 && (src[count - 1] == 0 || src[count - 1] == ' ')) {
+        count--;
+    }
+    if (count >= dst_size) {
+        count = dst_size - 1;
+    }
+    memcpy(dst, src, count);
+    dst[count] = '\0';
+}
+
+// Running sum of count byte deltas starting from acc. Lanes are summed with a
+// log-step in-register prefix sum, then offset by the previous block's last
+// value. All arithmetic wraps modulo 2^8, matching scalar int8 accumulation.
+static uint8_t prefix_sum_8(const uint8_t *src, size_t count, uint8_t acc, uint8_t *dst) {
+    size_t i = 0;
+
+#if defined(MC_XM_DELTA_SSE2)
+    __m128i carry = _mm_set1_epi8((char)acc);
+    for (; i + 16u <= count; i += 16u) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(const void *)(src + i));
+        x = _mm_add_epi8(x, _mm_slli_si128(x, 1));
+        x = _mm_add_epi8(x, _mm_slli_si128(x, 2));
+        x = _mm_add_epi8(x, _mm_slli_si128(x, 4));
+        x = _mm_add_epi8(x, _mm_slli_si128(x, 8));
+        x = _mm_add_epi8(x, carry);
+        _mm_storeu_si128((__m128i *)(void *)(dst + i), x);
+        acc = (uint8_t)((unsigned)_mm_extract_epi16(x, 7) >> 8);
+        carry = _mm_set1_epi8((char)acc);
+    }
+#elif defined(MC_XM_DELTA_NEON)
+    uint8x16_t zero = vdupq_n_u8(0);
+    uint8x16_t carry = vdupq_n_u8(acc);
+    for (; i + 16u <= count; i += 16u) {
+        uint8x16_t x = vld1q_u8(src + i);
+        x = vaddq_u8(x, vextq_u8(zero, x, 15));
+        x = vaddq_u8(x, vextq_u8(zero, x, 14));
+        x = vaddq_u8(x, vextq_u8(zero, x, 12));
+        x = vaddq_u8(x, vextq_u8(zero, x, 8));
+        x = vaddq_u8(x, carry);
+        vst1q_u8(dst + i, x);
+        acc = vgetq_lane_u8(x, 15);
+        carry = vdupq_n_u8(acc);
+    }
+#endif
+    for (; i < count; i++) {
+        acc = (uint8_t)(acc + src[i]);
+        dst[i] = acc;
+    }
+    return acc;
+}
+
+// 16-bit variant of prefix_sum_8. src holds little-endian words and may be
+// unaligned; both vector paths assume a little-endian host.
+static uint16_t prefix_sum_16(const uint8_t *src, size_t count, uint16_t acc, uint16_t *dst) {
+    size_t i = 0;
+
+#if defined(MC_XM_DELTA_SSE2)
+    __m128i carry = _mm_set1_epi16((short)acc);
+    for (; i + 8u <= count; i += 8u) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(const void *)(src + (i * 2u)));
+        x = _mm_add_epi16(x, _mm_slli_si128(x, 2));
+        x = _mm_add_epi16(x, _mm_slli_si128(x, 4));
+        x = _mm_add_epi16(x, _mm_slli_si128(x, 8));
+        x = _mm_add_epi16(x, carry);
+        _mm_storeu_si128((__m128i *)(void *)(dst + i), x);
+        acc = (uint16_t)_mm_extract_epi16(x, 7);
+        carry = _mm_set1_epi16((short)acc);
+    }
+#elif defined(MC_XM_DELTA_NEON)
+    uint16x8_t zero = vdupq_n_u16(0);
+    uint16x8_t carry = vdupq_n_u16(acc);
+    for (; i + 8u <= count; i += 8u) {
+        uint16x8_t x = vreinterpretq_u16_u8(vld1q_u8(src + (i * 2u)));
+        x = vaddq_u16(x, vextq_u16(zero, x, 7));
+        x = vaddq_u16(x, vextq_u16(zero, x, 6));
+        x = vaddq_u16(x, vextq_u16(zero, x, 4));
+        x = vaddq_u16(x, carry);
+        vst1q_u16(dst + i, x);
+        acc = vgetq_lane_u16(x, 7);
+        carry = vdupq_n_u16(acc);
+    }
+#endif
+    for (; i < count; i++) {
+        acc = (uint16_t)(acc + read_le_u16(src + (i * 2u)));
+        dst[i] = acc;
+    }
+    return acc;
+}
+
+int mc_xm_parse_sample_header(const uint8_t *data, size_t size, mc_xm_sample_header *out_header) {
+    if (data == NULL || out_header == NULL || size < MC_XM_SAMPLE_HEADER_SIZE) {
+        return 0;
+    }
+    memset(out_header, 0, sizeof(*out_header));
+    out_header->length_bytes = read_le_u32(data);
+    out_header->loop_start_bytes = read_le_u32(data + 4);
+    out_header->loop_length_bytes = read_le_u32(data + 8);
+    out_header->volume = data[12];
+    out_header->finetune = (int8_t)data[13];
+    out_header->type = data[14];
+    out_header->panning = data[15];
+    out_header->relative_note = (int8_t)data[16];
+    copy_trimmed(out_header->name, sizeof(out_header->name), data + 18, 22);
+    return 1;
+}
+
+int mc_xm_sample_is_16bit(const mc_xm_sample_header *header) {
+    return header != NULL && (header->type & MC_XM_SAMPLE_TYPE_16BIT) != 0;
+}
+
+uint8_t mc_xm_sample_loop_type(const mc_xm_sample_header *header) {
+    return header == NULL ? 0u : (uint8_t)(header->type & MC_XM_SAMPLE_LOOP_TYPE_MASK);
+}
+
+uint32_t mc_xm_sample_frame_count(const mc_xm_sample_header *header) {
+    if (header == NULL) {
+        return 0u;
+    }
+    return mc_xm_sample_is_16bit(header) ? header->length_bytes / 2u : header->length_bytes;
+}
+
+uint32_t mc_xm_sample_loop_start_frame(const mc_xm_sample_header *header) {
+    uint32_t frame_count = mc_xm_sample_frame_count(header);
+    uint32_t start;
+
+    if (header == NULL) {
+        return 0u;
+    }
+    start = mc_xm_sample_is_16bit(header) ? header->loop_start_bytes / 2u : header->loop_start_bytes;
+    return start < frame_count ? start : frame_count;
+}
+
+uint32_t mc_xm_sample_loop_length_frames(const mc_xm_sample_header *header) {
+    uint32_t frame_count = mc_xm_sample_frame_count(header);
+    uint32_t start = mc_xm_sample_loop_start_frame(header);
+    uint32_t length;
+
+    if (header == NULL || mc_xm_sample_loop_type(header) == 0u) {
+        return 0u;
+    }
+    length = mc_xm_sample_is_16bit(header) ? header->loop_length_bytes / 2u : header->loop_length_bytes;
+    return length < frame_count - start ? length : frame_count - start;
+}
+
+void mc_xm_delta_decode_8(const uint8_t *src, size_t count, int8_t *dst) {
+    if (src == NULL || dst == NULL) {
+        return;
+    }
+    prefix_sum_8(src, count, 0u, (uint8_t *)dst);
+}
+
+void mc_xm_delta_decode_16(const uint8_t *src, size_t count, int16_t *dst) {
+    if (src == NULL || dst == NULL) {
+        return;
+    }
+    prefix_sum_16(src, count, 0u, (uint16_t *)dst);
+}
+
+void mc_xm_delta_decode_8_to_float(const uint8_t *src, size_t count, float *dst) {
+    int8_t chunk[MC_XM_DECODE_CHUNK];
+    uint8_t acc = 0u;
+    size_t done = 0;
+
+    if (src == NULL || dst == NULL) {
+        return;
+    }
+    while (done < count) {
+        size_t n = count - done < MC_XM_DECODE_CHUNK ? count - done : MC_XM_DECODE_CHUNK;
+        size_t i;
+        acc = prefix_sum_8(src + done, n, acc, (uint8_t *)chunk);
+        for (i = 0; i < n; i++) {
+            dst[done + i] = (float)chunk[i] * (1.0f / 128.0f);
+        }
+        done += n;
+    }
+}
+
+void mc_xm_delta_decode_16_to_float(const uint8_t *src, size_t count, float *dst) {
+    int16_t chunk[MC_XM_DECODE_CHUNK];
+    uint16_t acc = 0u;
+    size_t done = 0;
+
+    if (src == NULL || dst == NULL) {
+        return;
+    }
+    while (done < count) {
+        size_t n = count - done < MC_XM_DECODE_CHUNK ? count - done : MC_XM_DECODE_CHUNK;
+        size_t i;
+        acc = prefix_sum_16(src + (done * 2u), n, acc, (uint16_t *)chunk);
+        for (i = 0; i < n; i++) {
+            dst[done + i] = (float)chunk[i] * (1.0f / 32768.0f);
+        }
+        done += n;
+    }
+}
+
+int mc_xm_decode_sample_float(
+    const mc_xm_sample_header *header,
+    const uint8_t *body,
+    size_t body_size,
+    float *dst,
+    size_t dst_frame_capacity
+) {
+    uint32_t frame_count;
+
+    if (header == NULL || (body == NULL && header->length_bytes > 0u)) {
+        return 0;
+    }
+    if ((size_t)header->length_bytes > body_size) {
+        return 0;
+    }
+    frame_count = mc_xm_sample_frame_count(header);
+    if (frame_count > dst_frame_capacity || (dst == NULL && frame_count > 0u)) {
+        return 0;
+    }
+    if (mc_xm_sample_is_16bit(header)) {
+        mc_xm_delta_decode_16_to_float(body, frame_count, dst);
+    } else {
+        mc_xm_delta_decode_8_to_float(body, frame_count, dst);
+    }
+    return 1;
+}
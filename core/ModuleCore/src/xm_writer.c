@@ -0,0 +1,395 @@
+#include "xm_writer.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "module_bytes_io.h"
+#include "xm_header.h"
+
+enum {
+    XM_PATTERN_PACKED_SIZE_OFFSET = 7,
+    XM_INSTRUMENT_NAME_SIZE = 22,
+    XM_INSTRUMENT_KEYMAP_END = 33 + MC_XM_KEYMAP_SIZE,
+    XM_INSTRUMENT_VOLUME_POINTS = 129,
+    XM_INSTRUMENT_PANNING_POINTS = 177,
+    XM_INSTRUMENT_ENVELOPE_END = 241,
+    XM_SAMPLE_NAME_OFFSET = 18,
+};
+
+// Output that coalesces consecutive source ranges into one write().
+typedef struct {
+    int fd;
+    const uint8_t *source;
+    size_t pending_start;
+    size_t pending_end;
+    int err;
+} xm_output;
+
+static void set_error(char *error, size_t error_size, const char *message, int err) {
+    if (error == NULL || error_size == 0) {
+        return;
+    }
+    if (err != 0) {
+        snprintf(error, error_size, "%s: %s", message, strerror(err));
+    } else {
+        snprintf(error, error_size, "%s", message);
+    }
+}
+
+static uint16_t read_le_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+static uint32_t read_le_u32(const uint8_t *p) {
+    return (uint32_t)p[0] |
+        ((uint32_t)p[1] << 8) |
+        ((uint32_t)p[2] << 16) |
+        ((uint32_t)p[3] << 24);
+}
+
+static void write_le_u16(uint8_t *p, uint16_t value) {
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static void write_le_u32(uint8_t *p, uint32_t value) {
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)((value >> 8) & 0xFF);
+    p[2] = (uint8_t)((value >> 16) & 0xFF);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+// Names are parsed with trailing spaces and NULs trimmed, so an unchanged
+// name keeps its original padding bytes.
+static void write_name(uint8_t *dst, size_t dst_size, const char *name) {
+    size_t stored = dst_size;
+    size_t length = strnlen(name, dst_size);
+
+    while (stored > 0 && (dst[stored - 1] == 0 || dst[stored - 1] == ' ')) {
+        stored--;
+    }
+    if (stored == length && memcmp(dst, name, length) == 0) {
+        return;
+    }
+    memset(dst, 0, dst_size);
+    memcpy(dst, name, length);
+}
+
+static void flush_source(xm_output *out) {
+    if (out->err == 0 && out->pending_end > out->pending_start) {
+        out->err = mc_bytes_write_all(out->fd, out->source + out->pending_start, out->pending_end - out->pending_start);
+    }
+    out->pending_start = out->pending_end;
+}
+
+static void emit_source(xm_output *out, size_t start, size_t end) {
+    if (start >= end) {
+        return;
+    }
+    if (start == out->pending_end && out->pending_end > out->pending_start) {
+        out->pending_end = end;
+        return;
+    }
+    flush_source(out);
+    out->pending_start = start;
+    out->pending_end = end;
+}
+
+static void emit_bytes(xm_output *out, const uint8_t *data, size_t size) {
+    flush_source(out);
+    if (out->err == 0 && size > 0) {
+        out->err = mc_bytes_write_all(out->fd, data, size);
+    }
+}
+
+static void write_envelope(uint8_t *base, size_t points_offset, size_t count_offset, const mc_xm_envelope *envelope) {
+    uint8_t stored_count = base[count_offset];
+    uint8_t i;
+
+    for (i = 0; i < envelope->point_count && i < MC_XM_MAX_ENVELOPE_POINTS; i++) {
+        write_le_u16(base + points_offset + (size_t)i * 4u, envelope->points[i].tick);
+        write_le_u16(base + points_offset + (size_t)i * 4u + 2u, envelope->points[i].value);
+    }
+    // The parser clamps oversized counts; keep the stored byte unless the
+    // count was actually edited.
+    if (envelope->point_count !=
+        (stored_count > MC_XM_MAX_ENVELOPE_POINTS ? MC_XM_MAX_ENVELOPE_POINTS : stored_count)) {
+        base[count_offset] = envelope->point_count;
+    }
+}
+
+// Rewrites the known fields of an instrument header prefix in place.
+static void patch_instrument(uint8_t *base, size_t length, const mc_xm_instrument *instrument) {
+    write_name(base + 4, XM_INSTRUMENT_NAME_SIZE, instrument->name);
+    base[26] = instrument->type;
+    if (length >= XM_INSTRUMENT_KEYMAP_END) {
+        memcpy(base + 33, instrument->keymap, MC_XM_KEYMAP_SIZE);
+    }
+    if (length >= XM_INSTRUMENT_ENVELOPE_END) {
+        const mc_xm_envelope *volume = &instrument->volume_envelope;
+        const mc_xm_envelope *panning = &instrument->panning_envelope;
+
+        write_envelope(base, XM_INSTRUMENT_VOLUME_POINTS, 225, volume);
+        write_envelope(base, XM_INSTRUMENT_PANNING_POINTS, 226, panning);
+        base[227] = volume->sustain_point;
+        base[228] = volume->loop_start_point;
+        base[229] = volume->loop_end_point;
+        base[230] = panning->sustain_point;
+        base[231] = panning->loop_start_point;
+        base[232] = panning->loop_end_point;
+        base[233] = volume->flags;
+        base[234] = panning->flags;
+        base[235] = instrument->vibrato_type;
+        base[236] = instrument->vibrato_sweep;
+        base[237] = instrument->vibrato_depth;
+        base[238] = instrument->vibrato_rate;
+        write_le_u16(base + 239, instrument->fadeout);
+    }
+}
+
+static void patch_sample_header(uint8_t *base, const mc_xm_sample_header *header) {
+    write_le_u32(base + 4, header->loop_start_bytes);
+    write_le_u32(base + 8, header->loop_length_bytes);
+    base[12] = header->volume;
+    base[13] = (uint8_t)header->finetune;
+    base[14] = header->type;
+    base[15] = header->panning;
+    base[16] = (uint8_t)header->relative_note;
+    write_name(base + XM_SAMPLE_NAME_OFFSET, MC_XM_SAMPLE_HEADER_SIZE - XM_SAMPLE_NAME_OFFSET, header->name);
+}
+
+size_t mc_xm_pack_pattern(const mc_pattern_cell *cells, size_t cell_count, uint8_t *out) {
+    size_t size = 0;
+    int empty = 1;
+    size_t i;
+
+    for (i = 0; i < cell_count; i++) {
+        const mc_pattern_cell *cell = &cells[i];
+        uint8_t flags = (uint8_t)(
+            (cell->note != 0 ? 0x01 : 0) |
+            (cell->instrument != 0 ? 0x02 : 0) |
+            (cell->volume != 0 ? 0x04 : 0) |
+            (cell->effect_type != 0 ? 0x08 : 0) |
+            (cell->effect_param != 0 ? 0x10 : 0));
+
+        if (flags != 0) {
+            empty = 0;
+        }
+        if (flags == 0x1F && cell->note < 0x80) {
+            out[size++] = cell->note;
+            out[size++] = cell->instrument;
+            out[size++] = cell->volume;
+            out[size++] = cell->effect_type;
+            out[size++] = cell->effect_param;
+            continue;
+        }
+        out[size++] = (uint8_t)(0x80 | flags);
+        if ((flags & 0x01) != 0) {
+            out[size++] = cell->note;
+        }
+        if ((flags & 0x02) != 0) {
+            out[size++] = cell->instrument;
+        }
+        if ((flags & 0x04) != 0) {
+            out[size++] = cell->volume;
+        }
+        if ((flags & 0x08) != 0) {
+            out[size++] = cell->effect_type;
+        }
+        if ((flags & 0x10) != 0) {
+            out[size++] = cell->effect_param;
+        }
+    }
+    return empty ? 0 : size;
+}
+
+static int write_patterns(
+    mc_module *module,
+    const uint8_t *data,
+    size_t size,
+    size_t *offset,
+    xm_output *out,
+    char *error,
+    size_t error_size
+) {
+    uint16_t channels = mc_module_get_header(module)->channels;
+    uint16_t pattern_count = mc_module_pattern_count(module);
+    uint8_t *packed = NULL;
+    size_t capacity = 0;
+    uint16_t i;
+
+    for (i = 0; i < pattern_count; i++) {
+        size_t cell_count = (size_t)mc_module_pattern_rows(module, i) * channels;
+        if (mc_module_pattern_is_dirty(module, i) && cell_count > capacity) {
+            capacity = cell_count;
+        }
+    }
+    if (capacity > 0) {
+        packed = (uint8_t *)malloc(capacity * MC_XM_MAX_PACKED_CELL_BYTES);
+        if (packed == NULL) {
+            set_error(error, error_size, "out of memory", 0);
+            return 0;
+        }
+    }
+
+    for (i = 0; i < pattern_count && out->err == 0; i++) {
+        size_t header_start = *offset;
+        mc_xm_pattern_span span;
+        const mc_pattern_cell *cells;
+        size_t packed_size;
+        uint8_t size_field[2];
+
+        if (!mc_xm_next_pattern(data, size, offset, &span)) {
+            free(packed);
+            set_error(error, error_size, "unsupported or invalid module header", 0);
+            return 0;
+        }
+        if (!mc_module_pattern_is_dirty(module, i)) {
+            emit_source(out, header_start, *offset);
+            continue;
+        }
+
+        cells = mc_module_pattern_cells(module, i);
+        packed_size = cells == NULL ? 0 : mc_xm_pack_pattern(cells, (size_t)span.row_count * channels, packed);
+        if (packed_size > MC_XM_MAX_PACKED_PATTERN_SIZE) {
+            char message[64];
+            free(packed);
+            snprintf(message, sizeof(message), "pattern %u packs to more than 65535 bytes", (unsigned)i);
+            set_error(error, error_size, message, 0);
+            return 0;
+        }
+        // Extra pattern header bytes past the packed size are kept as-is.
+        write_le_u16(size_field, (uint16_t)packed_size);
+        emit_source(out, header_start, header_start + XM_PATTERN_PACKED_SIZE_OFFSET);
+        emit_bytes(out, size_field, sizeof(size_field));
+        emit_source(out, header_start + XM_PATTERN_PACKED_SIZE_OFFSET + 2u, span.data_offset);
+        emit_bytes(out, packed, packed_size);
+    }
+    free(packed);
+    return 1;
+}
+
+static int write_instruments(
+    mc_module *module,
+    const uint8_t *data,
+    size_t *cursor,
+    xm_output *out,
+    char *error,
+    size_t error_size
+) {
+    const mc_xm_instrument_table *table = mc_module_xm_instruments(module);
+    char message[64];
+    uint16_t i;
+
+    if (table == NULL) {
+        return 1;
+    }
+    for (i = 0; i < table->instrument_count && out->err == 0; i++) {
+        const mc_xm_instrument *instrument = &table->instruments[i];
+        uint8_t header[XM_INSTRUMENT_ENVELOPE_END];
+        size_t length = instrument->header_size < sizeof(header) ? instrument->header_size : sizeof(header);
+        uint16_t s;
+
+        if (!mc_module_xm_instrument_is_dirty(module, i)) {
+            continue;
+        }
+        if (read_le_u16(data + instrument->header_offset + 27) != instrument->sample_count) {
+            snprintf(message, sizeof(message), "instrument %u sample count cannot change", (unsigned)i);
+            set_error(error, error_size, message, 0);
+            return 0;
+        }
+        memcpy(header, data + instrument->header_offset, length);
+        patch_instrument(header, length, instrument);
+        emit_source(out, *cursor, instrument->header_offset);
+        emit_bytes(out, header, length);
+        *cursor = instrument->header_offset + length;
+
+        for (s = 0; s < instrument->sample_count; s++) {
+            const mc_xm_sample_info *sample = &table->samples[instrument->first_sample + s];
+            uint8_t sample_header[MC_XM_SAMPLE_HEADER_SIZE];
+
+            memcpy(sample_header, data + sample->header_offset, sizeof(sample_header));
+            if (read_le_u32(sample_header) != sample->header.length_bytes) {
+                snprintf(message, sizeof(message), "sample %u length cannot change",
+                    (unsigned)(instrument->first_sample + s));
+                set_error(error, error_size, message, 0);
+                return 0;
+            }
+            patch_sample_header(sample_header, &sample->header);
+            emit_source(out, *cursor, sample->header_offset);
+            emit_bytes(out, sample_header, sizeof(sample_header));
+            *cursor = sample->header_offset + sizeof(sample_header);
+        }
+    }
+    return 1;
+}
+
+int mc_module_write_xm(mc_module *module, const char *path, char *error, size_t error_size) {
+    const mc_module_header *header = mc_module_get_header(module);
+    mc_module_header parsed;
+    const uint8_t *data;
+    const uint8_t *orders;
+    uint16_t order_count;
+    size_t size;
+    size_t offset;
+    size_t cursor;
+    char *temp_path;
+    xm_output out;
+    int ok;
+
+    if (error != NULL && error_size > 0) {
+        error[0] = '\0';
+    }
+    if (header == NULL || header->type != MC_MODULE_TYPE_XM) {
+        set_error(error, error_size, "not an XM module", 0);
+        return 0;
+    }
+    if (path == NULL || path[0] == '\0') {
+        set_error(error, error_size, "invalid path", 0);
+        return 0;
+    }
+    data = mc_module_bytes(module, &size);
+    if (!mc_xm_parse_header(data, size, &parsed, &orders, &order_count, &offset)) {
+        set_error(error, error_size, "unsupported or invalid module header", 0);
+        return 0;
+    }
+
+    memset(&out, 0, sizeof(out));
+    out.source = data;
+    out.fd = mc_bytes_open_temp_file(path, &temp_path, error, error_size);
+    if (out.fd < 0) {
+        return 0;
+    }
+
+    emit_source(&out, 0, offset);
+    ok = write_patterns(module, data, size, &offset, &out, error, error_size);
+    cursor = offset;
+    ok = ok && write_instruments(module, data, &cursor, &out, error, error_size);
+    if (ok) {
+        emit_source(&out, cursor, size);
+        flush_source(&out);
+        if (out.err == 0 && fsync(out.fd) != 0) {
+            out.err = errno;
+        }
+        if (out.err != 0) {
+            set_error(error, error_size, "write failed", out.err);
+            ok = 0;
+        }
+    }
+    if (close(out.fd) != 0 && ok) {
+        set_error(error, error_size, "write failed", errno);
+        ok = 0;
+    }
+    if (ok && rename(temp_path, path) != 0) {
+        set_error(error, error_size, "rename failed", errno);
+        ok = 0;
+    }
+    if (!ok) {
+        unlink(temp_path);
+    }
+    free(temp_path);
+    return ok;
+}
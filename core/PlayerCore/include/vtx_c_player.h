@@ -0,0 +1,114 @@
+#ifndef VTX_C_PLAYER_H
+#define VTX_C_PLAYER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "module_handle.h"
+#include "vtx_c_mixer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VTX_C_PLAYER_MAX_CHANNELS 32u
+
+typedef enum {
+    VTX_C_PLAYER_STATUS_OK = 0,
+    VTX_C_PLAYER_STATUS_INVALID_ARGUMENT = 1,
+    VTX_C_PLAYER_STATUS_OUT_OF_MEMORY = 2,
+    VTX_C_PLAYER_STATUS_UNSUPPORTED_MODULE = 3,
+    VTX_C_PLAYER_STATUS_MIXER_ERROR = 4,
+} VTXCPlayerStatus;
+
+typedef struct {
+    double sample_rate;
+    uint32_t channel_count;
+    uint16_t start_order;
+    // When nonzero the song also ends as soon as playback would leave orders
+    // start_order ... start_order + order_count - 1.
+    uint16_t order_count;
+    // 0 ends the song after the last order, or when a jump or break reaches an
+    // order that already played. Nonzero wraps to the restart position and
+    // plays forever.
+    int loop_song;
+    // Pyramid levels built for each sample when the player creates its own
+    // bank (see vtx_c_player_sample_bank_build_pyramids); 0 builds none.
+    uint32_t sample_pyramid_levels;
+} VTXCPlayerConfig;
+
+// Song position of the tick being rendered.
+typedef struct {
+    uint16_t order;
+    uint16_t pattern;
+    uint16_t row;
+    uint16_t tick;
+    uint16_t speed;
+    uint16_t bpm;
+    uint8_t global_volume;
+    uint64_t frame;
+    int ended;
+} VTXCPlayerPosition;
+
+// Every sample of a module decoded once to Float32, with the instrument data
+// the player needs. A bank is read-only after creation and may be shared by
+// any number of players, including players on other threads. It must outlive
+// them.
+typedef struct VTXCPlayerSampleBank VTXCPlayerSampleBank;
+
+// Advances a module tick by tick: speed and BPM, per-channel effect memory,
+// pattern breaks, position jumps and pattern loops. Each tick's note starts
+// and volume, panning and pitch changes go straight to an owned MixerCore
+// state as shared-sample voices tagged with their channel index.
+typedef struct VTXCPlayer VTXCPlayer;
+
+VTXCPlayerConfig vtx_c_player_default_config(void);
+
+VTXCPlayerStatus vtx_c_player_sample_bank_create(mc_module *module, VTXCPlayerSampleBank **out_bank);
+void vtx_c_player_sample_bank_free(VTXCPlayerSampleBank *bank);
+// Rebuilds every sample's pyramid with up to level_count levels (0 removes
+// them), using the sample's loop. Voices then read decimated data on high
+// notes and fast slides up. Call it before the bank is shared, since a bank is
+// read-only while players use it. Pyramid memory counts toward byte_count.
+VTXCPlayerStatus vtx_c_player_sample_bank_build_pyramids(VTXCPlayerSampleBank *bank, uint32_t level_count);
+uint32_t vtx_c_player_sample_bank_sample_count(const VTXCPlayerSampleBank *bank);
+size_t vtx_c_player_sample_bank_byte_count(const VTXCPlayerSampleBank *bank);
+
+// Creates a player at config.start_order. module must stay open while the
+// player is alive. Every pattern is decoded here with mc_module_decode_patterns
+// and stays resident, so other readers of the handle cannot evict the grid the
+// player is playing; like that call, this must not run concurrently with other
+// calls on the handle. When bank is NULL the player builds and owns one.
+VTXCPlayerStatus vtx_c_player_create(
+    mc_module *module,
+    const VTXCPlayerSampleBank *bank,
+    VTXCPlayerConfig config,
+    VTXCPlayer **out_player
+);
+void vtx_c_player_free(VTXCPlayer *player);
+
+// Renders up to frame_count interleaved frames. Fewer frames are rendered
+// only when the song ends; out_rendered_count reports how many were written.
+VTXCPlayerStatus vtx_c_player_render(
+    VTXCPlayer *player,
+    float *output_interleaved_float32,
+    uint32_t frame_count,
+    uint32_t *out_rendered_count
+);
+
+int vtx_c_player_has_ended(const VTXCPlayer *player);
+VTXCPlayerPosition vtx_c_player_position(const VTXCPlayer *player);
+
+// Notes dropped because every mixer voice slot was in use.
+uint64_t vtx_c_player_dropped_note_count(const VTXCPlayer *player);
+
+// The player's mixer. Callers may select a render engine, attach a trace
+// ring or read counters;
+// adding or stopping voices directly desynchronizes the player.
+VTXCMixerState *vtx_c_player_mixer(VTXCPlayer *player);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
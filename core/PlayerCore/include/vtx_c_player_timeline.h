@@ -0,0 +1,77 @@
+#ifndef VTX_C_PLAYER_TIMELINE_H
+#define VTX_C_PLAYER_TIMELINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "module_handle.h"
+#include "vtx_c_player.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Nested pattern loops in a damaged module can multiply into an effectively
+// endless song; the walk stops after this many played rows.
+#define VTX_C_PLAYER_TIMELINE_MAX_ROWS (1u << 22)
+
+typedef struct {
+    uint64_t start_frame;
+    uint16_t order;
+    uint16_t pattern;
+    uint16_t row;
+    uint16_t speed;
+    uint16_t bpm;
+} VTXCPlayerTimelineRow;
+
+// Frame timing of one pass through a song, as a VTXCPlayer with loop_song
+// off would render it at the same sample rate.
+typedef struct {
+    double sample_rate;
+    uint64_t total_frames;
+    // Where a looping player continues after the last frame: the restart
+    // position, or the target of the jump or break that revisits an order.
+    // loop_frame is that row's first start frame; has_loop_frame is 0 when
+    // the row never played in this pass.
+    uint16_t loop_order;
+    uint16_t loop_row;
+    int has_loop_frame;
+    uint64_t loop_frame;
+    // 1 when the walk stopped at VTX_C_PLAYER_TIMELINE_MAX_ROWS.
+    int truncated;
+    // Played rows in playback order, so start frames ascend. A row repeated
+    // by a pattern loop appears once per pass.
+    size_t row_count;
+    VTXCPlayerTimelineRow *rows;
+    // Indices into rows sorted by order, row, then start frame.
+    uint32_t *rows_by_position;
+} VTXCPlayerTimeline;
+
+// Walks the order list with mc_song_walk (module_song_walk.h), applying only
+// the control effects: speed and BPM, position jump, pattern break, pattern
+// loop and pattern delay. Nothing is mixed and no samples are decoded.
+VTXCPlayerStatus vtx_c_player_timeline_build(
+    mc_module *module,
+    double sample_rate,
+    uint16_t start_order,
+    VTXCPlayerTimeline *out_timeline
+);
+void vtx_c_player_timeline_free(VTXCPlayerTimeline *timeline);
+
+// Row playing at frame, by binary search. NULL at or past total_frames.
+const VTXCPlayerTimelineRow *vtx_c_player_timeline_row_at_frame(const VTXCPlayerTimeline *timeline, uint64_t frame);
+
+// First frame at which order and row start playing, by binary search.
+// Returns 0 when that row is not played.
+int vtx_c_player_timeline_frame_of(
+    const VTXCPlayerTimeline *timeline,
+    uint16_t order,
+    uint16_t row,
+    uint64_t *out_frame
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
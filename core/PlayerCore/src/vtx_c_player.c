@@ -0,0 +1,1387 @@
+#include "vtx_c_player.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mod_header.h"
+#include "module_song_walk.h"
+#include "xm_instrument.h"
+#include "xm_sample.h"
+
+#define VTX_C_PLAYER_MAX_NOTE 96u
+#define VTX_C_PLAYER_KEY_OFF_NOTE 97u
+#define VTX_C_PLAYER_MAX_VOLUME 64
+#define VTX_C_PLAYER_MAX_PAN 255
+#define VTX_C_PLAYER_CENTER_PAN 128
+#define VTX_C_PLAYER_FADEOUT_MAX 65536
+#define VTX_C_PLAYER_SAMPLE_OFFSET_FRAMES 256u
+
+// Periods are in FT2 units for both frequency modes: linear periods step 64
+// per semitone with C-4 at 4608, Amiga periods are four times the ProTracker
+// value so that C-4 is 1712. C-4 plays a sample at 8363 Hz.
+#define VTX_C_PLAYER_C4_FREQUENCY 8363.0
+#define VTX_C_PLAYER_LINEAR_PERIOD_BASE 7680
+#define VTX_C_PLAYER_LINEAR_C4_PERIOD 4608.0
+#define VTX_C_PLAYER_LINEAR_PERIOD_PER_SEMITONE 64
+#define VTX_C_PLAYER_AMIGA_C4_PERIOD 1712.0
+#define VTX_C_PLAYER_MIN_PERIOD 1
+#define VTX_C_PLAYER_MAX_PERIOD 32000
+#define VTX_C_PLAYER_MOD_MIN_PERIOD (113 * 4)
+#define VTX_C_PLAYER_MOD_MAX_PERIOD (856 * 4)
+
+// MOD channels alternate left/right/right/left at half separation.
+#define VTX_C_PLAYER_MOD_LEFT_PAN 0x40
+#define VTX_C_PLAYER_MOD_RIGHT_PAN 0xC0
+
+enum {
+    VTX_C_PLAYER_EFFECT_ARPEGGIO = 0x00,
+    VTX_C_PLAYER_EFFECT_PORTA_UP = 0x01,
+    VTX_C_PLAYER_EFFECT_PORTA_DOWN = 0x02,
+    VTX_C_PLAYER_EFFECT_TONE_PORTA = 0x03,
+    VTX_C_PLAYER_EFFECT_VIBRATO = 0x04,
+    VTX_C_PLAYER_EFFECT_TONE_PORTA_VOLUME_SLIDE = 0x05,
+    VTX_C_PLAYER_EFFECT_VIBRATO_VOLUME_SLIDE = 0x06,
+    VTX_C_PLAYER_EFFECT_TREMOLO = 0x07,
+    VTX_C_PLAYER_EFFECT_SET_PAN = 0x08,
+    VTX_C_PLAYER_EFFECT_SAMPLE_OFFSET = 0x09,
+    VTX_C_PLAYER_EFFECT_VOLUME_SLIDE = 0x0A,
+    VTX_C_PLAYER_EFFECT_POSITION_JUMP = 0x0B,
+    VTX_C_PLAYER_EFFECT_SET_VOLUME = 0x0C,
+    VTX_C_PLAYER_EFFECT_PATTERN_BREAK = 0x0D,
+    VTX_C_PLAYER_EFFECT_EXTENDED = 0x0E,
+    VTX_C_PLAYER_EFFECT_SET_SPEED = 0x0F,
+    VTX_C_PLAYER_EFFECT_SET_GLOBAL_VOLUME = 0x10,
+    VTX_C_PLAYER_EFFECT_GLOBAL_VOLUME_SLIDE = 0x11,
+    VTX_C_PLAYER_EFFECT_KEY_OFF = 0x14,
+    VTX_C_PLAYER_EFFECT_SET_ENVELOPE_POSITION = 0x15,
+    VTX_C_PLAYER_EFFECT_PAN_SLIDE = 0x19,
+    VTX_C_PLAYER_EFFECT_MULTI_RETRIGGER = 0x1B,
+    VTX_C_PLAYER_EFFECT_EXTRA_FINE_PORTA = 0x21,
+};
+
+enum {
+    VTX_C_PLAYER_EXTENDED_FINE_PORTA_UP = 0x1,
+    VTX_C_PLAYER_EXTENDED_FINE_PORTA_DOWN = 0x2,
+    VTX_C_PLAYER_EXTENDED_VIBRATO_WAVEFORM = 0x4,
+    VTX_C_PLAYER_EXTENDED_PATTERN_LOOP = 0x6,
+    VTX_C_PLAYER_EXTENDED_TREMOLO_WAVEFORM = 0x7,
+    VTX_C_PLAYER_EXTENDED_RETRIGGER = 0x9,
+    VTX_C_PLAYER_EXTENDED_FINE_VOLUME_UP = 0xA,
+    VTX_C_PLAYER_EXTENDED_FINE_VOLUME_DOWN = 0xB,
+    VTX_C_PLAYER_EXTENDED_NOTE_CUT = 0xC,
+    VTX_C_PLAYER_EXTENDED_NOTE_DELAY = 0xD,
+    VTX_C_PLAYER_EXTENDED_PATTERN_DELAY = 0xE,
+};
+
+typedef struct {
+    float *pcm;
+    VTXCMixerSamplePyramid *pyramid;
+    VTXCMixerSharedSample shared;
+    uint8_t volume;
+    int8_t finetune;
+    int8_t relative_note;
+    uint8_t panning;
+    VTXCMixerLoopMode loop_mode;
+    uint32_t loop_start_frame;
+    uint32_t loop_end_frame;
+} VTXCPlayerSample;
+
+typedef struct {
+    uint32_t first_sample;
+    uint16_t sample_count;
+    int has_keymap;
+    uint8_t keymap[MC_XM_KEYMAP_SIZE];
+    int has_volume_envelope;
+    int has_panning_envelope;
+    mc_xm_envelope volume_envelope;
+    mc_xm_envelope panning_envelope;
+    uint16_t fadeout;
+} VTXCPlayerInstrument;
+
+struct VTXCPlayerSampleBank {
+    uint16_t instrument_count;
+    VTXCPlayerInstrument *instruments;
+    uint32_t sample_count;
+    VTXCPlayerSample *samples;
+    size_t byte_count;
+};
+
+typedef struct {
+    mc_pattern_cell cell;
+    const VTXCPlayerInstrument *instrument;
+    const VTXCPlayerSample *sample;
+    uint8_t instrument_number;
+    int32_t period;
+    int32_t target_period;
+    int32_t volume;
+    int32_t pan;
+    int32_t default_pan;
+    int32_t period_offset;
+    int32_t volume_offset;
+
+    uint8_t porta_up_speed;
+    uint8_t porta_down_speed;
+    uint8_t fine_porta_up_speed;
+    uint8_t fine_porta_down_speed;
+    uint8_t extra_fine_porta_up_speed;
+    uint8_t extra_fine_porta_down_speed;
+    uint8_t tone_porta_speed;
+    uint8_t vibrato_speed;
+    uint8_t vibrato_depth;
+    uint8_t vibrato_position;
+    uint8_t vibrato_waveform;
+    uint8_t tremolo_speed;
+    uint8_t tremolo_depth;
+    uint8_t tremolo_position;
+    uint8_t tremolo_waveform;
+    uint8_t volume_slide;
+    uint8_t fine_volume_up;
+    uint8_t fine_volume_down;
+    uint8_t global_volume_slide;
+    uint8_t pan_slide;
+    uint8_t sample_offset;
+    uint8_t multi_retrigger;
+    uint8_t retrigger_counter;
+
+    int key_on;
+    uint16_t volume_envelope_tick;
+    uint16_t panning_envelope_tick;
+    int32_t fadeout;
+
+    int trigger_pending;
+    uint32_t trigger_frame;
+    int cut_immediately;
+    int has_voice;
+    uint32_t voice;
+    float sent_gain;
+    float sent_pan;
+    double sent_step;
+} VTXCPlayerChannel;
+
+struct VTXCPlayer {
+    mc_module *module;
+    const VTXCPlayerSampleBank *bank;
+    VTXCPlayerSampleBank *owned_bank;
+    VTXCPlayerConfig config;
+    int linear_frequency;
+    int is_mod;
+    uint16_t channel_count;
+
+    // Order, row, speed, BPM and the row-control effects (jump, break,
+    // pattern loop and delay), shared with the timeline and index walks.
+    mc_song_walk walk;
+    uint16_t tick;
+    int32_t global_volume;
+    // Repeats of the current row still to play for its pattern delay.
+    uint8_t pattern_delay;
+    int repeating_row;
+
+    double tick_frame_remainder;
+    uint32_t frames_left_in_tick;
+    int ended;
+    uint64_t dropped_note_count;
+    VTXCPlayerPosition position;
+    VTXCPlayerChannel channels[VTX_C_PLAYER_MAX_CHANNELS];
+    VTXCMixerState mixer;
+};
+
+static const uint8_t vtx_c_player_sine_table[32] = {
+    0, 24, 49, 74, 97, 120, 141, 161, 180, 197, 212, 224, 235, 244, 250, 253,
+    255, 253, 250, 244, 235, 224, 212, 197, 180, 161, 141, 120, 97, 74, 49, 24,
+};
+
+static int32_t vtx_c_player_clamp(int32_t value, int32_t minimum, int32_t maximum) {
+    if (value < minimum) {
+        return minimum;
+    }
+    if (value > maximum) {
+        return maximum;
+    }
+    return value;
+}
+
+static void vtx_c_player_sanitize_loop(VTXCPlayerSample *sample, uint8_t loop_type, uint32_t start, uint32_t length) {
+    uint32_t frame_count = sample->shared.frame_count;
+
+    sample->loop_mode = VTX_C_MIXER_LOOP_NONE;
+    sample->loop_start_frame = 0u;
+    sample->loop_end_frame = 0u;
+    if (loop_type == 0u || length == 0u || start >= frame_count) {
+        return;
+    }
+    if (length > frame_count - start) {
+        length = frame_count - start;
+    }
+    sample->loop_mode = loop_type == 2u ? VTX_C_MIXER_LOOP_PING_PONG : VTX_C_MIXER_LOOP_FORWARD;
+    sample->loop_start_frame = start;
+    sample->loop_end_frame = start + length;
+}
+
+static int vtx_c_player_bank_load_xm(VTXCPlayerSampleBank *bank, mc_module *module) {
+    const mc_xm_instrument_table *table = mc_module_xm_instruments(module);
+    uint32_t sample_index;
+    uint16_t instrument_index;
+
+    if (table == NULL) {
+        return 1;
+    }
+    bank->instruments = (VTXCPlayerInstrument *)calloc(
+        table->instrument_count > 0u ? table->instrument_count : 1u,
+        sizeof(*bank->instruments)
+    );
+    bank->samples = (VTXCPlayerSample *)calloc(table->sample_count > 0u ? table->sample_count : 1u, sizeof(*bank->samples));
+    if (bank->instruments == NULL || bank->samples == NULL) {
+        return 0;
+    }
+    bank->instrument_count = table->instrument_count;
+    bank->sample_count = table->sample_count;
+
+    for (instrument_index = 0u; instrument_index < table->instrument_count; instrument_index++) {
+        const mc_xm_instrument *source = &table->instruments[instrument_index];
+        VTXCPlayerInstrument *instrument = &bank->instruments[instrument_index];
+
+        instrument->first_sample = source->first_sample;
+        instrument->sample_count = source->sample_count;
+        instrument->has_keymap = source->has_keymap;
+        memcpy(instrument->keymap, source->keymap, sizeof(instrument->keymap));
+        instrument->volume_envelope = source->volume_envelope;
+        instrument->panning_envelope = source->panning_envelope;
+        if (instrument->volume_envelope.point_count > MC_XM_MAX_ENVELOPE_POINTS) {
+            instrument->volume_envelope.point_count = MC_XM_MAX_ENVELOPE_POINTS;
+        }
+        if (instrument->panning_envelope.point_count > MC_XM_MAX_ENVELOPE_POINTS) {
+            instrument->panning_envelope.point_count = MC_XM_MAX_ENVELOPE_POINTS;
+        }
+        instrument->has_volume_envelope = source->has_envelopes &&
+            (source->volume_envelope.flags & MC_XM_ENVELOPE_ON) != 0u &&
+            instrument->volume_envelope.point_count > 0u;
+        instrument->has_panning_envelope = source->has_envelopes &&
+            (source->panning_envelope.flags & MC_XM_ENVELOPE_ON) != 0u &&
+            instrument->panning_envelope.point_count > 0u;
+        instrument->fadeout = source->fadeout;
+    }
+
+    for (sample_index = 0u; sample_index < table->sample_count; sample_index++) {
+        const mc_xm_sample_header *header = &table->samples[sample_index].header;
+        VTXCPlayerSample *sample = &bank->samples[sample_index];
+        uint32_t frame_count = mc_xm_sample_frame_count(header);
+        mc_xm_sample_view view;
+
+        sample->volume = header->volume > VTX_C_PLAYER_MAX_VOLUME ? VTX_C_PLAYER_MAX_VOLUME : header->volume;
+        sample->finetune = header->finetune;
+        sample->relative_note = header->relative_note;
+        sample->panning = header->panning;
+        if (frame_count == 0u || !mc_module_xm_sample_view(module, sample_index, &view)) {
+            continue;
+        }
+        sample->pcm = (float *)malloc((size_t)frame_count * sizeof(float));
+        if (sample->pcm == NULL) {
+            return 0;
+        }
+        if (!mc_xm_decode_sample_float(header, view.data, view.length_bytes, sample->pcm, frame_count)) {
+            free(sample->pcm);
+            sample->pcm = NULL;
+            continue;
+        }
+        sample->shared.pcm = sample->pcm;
+        sample->shared.frame_count = frame_count;
+        bank->byte_count += (size_t)frame_count * sizeof(float);
+        vtx_c_player_sanitize_loop(
+            sample,
+            mc_xm_sample_loop_type(header),
+            mc_xm_sample_loop_start_frame(header),
+            mc_xm_sample_loop_length_frames(header)
+        );
+    }
+    return 1;
+}
+
+static int vtx_c_player_bank_load_mod(VTXCPlayerSampleBank *bank, mc_module *module) {
+    uint16_t count = 0u;
+    const mc_mod_sample_header *headers = mc_module_mod_samples(module, &count);
+    uint16_t sample_index;
+
+    if (headers == NULL || count == 0u) {
+        return 1;
+    }
+    bank->instruments = (VTXCPlayerInstrument *)calloc(count, sizeof(*bank->instruments));
+    bank->samples = (VTXCPlayerSample *)calloc(count, sizeof(*bank->samples));
+    if (bank->instruments == NULL || bank->samples == NULL) {
+        return 0;
+    }
+    bank->instrument_count = count;
+    bank->sample_count = count;
+
+    for (sample_index = 0u; sample_index < count; sample_index++) {
+        const mc_mod_sample_header *header = &headers[sample_index];
+        VTXCPlayerSample *sample = &bank->samples[sample_index];
+        mc_mod_sample_view view;
+        size_t frame;
+
+        bank->instruments[sample_index].first_sample = sample_index;
+        bank->instruments[sample_index].sample_count = 1u;
+        sample->volume = header->volume;
+        // MOD finetune is in eighths of a semitone, XM finetune in 128ths.
+        sample->finetune = (int8_t)(header->finetune * 16);
+        sample->panning = VTX_C_PLAYER_CENTER_PAN;
+        if (!mc_module_mod_sample_view(module, sample_index, &view) ||
+            view.length_bytes == 0u ||
+            view.length_bytes > UINT32_MAX) {
+            continue;
+        }
+        sample->pcm = (float *)malloc(view.length_bytes * sizeof(float));
+        if (sample->pcm == NULL) {
+            return 0;
+        }
+        for (frame = 0u; frame < view.length_bytes; frame++) {
+            sample->pcm[frame] = (float)view.data[frame] / 128.0f;
+        }
+        sample->shared.pcm = sample->pcm;
+        sample->shared.frame_count = (uint32_t)view.length_bytes;
+        bank->byte_count += view.length_bytes * sizeof(float);
+        // ProTracker treats a loop of one word or less as no loop.
+        vtx_c_player_sanitize_loop(
+            sample,
+            header->loop_length_bytes > 2u ? 1u : 0u,
+            header->loop_start_bytes,
+            header->loop_length_bytes
+        );
+    }
+    return 1;
+}
+
+VTXCPlayerConfig vtx_c_player_default_config(void) {
+    VTXCPlayerConfig config;
+
+    memset(&config, 0, sizeof(config));
+    config.sample_rate = VTX_C_MIXER_DEFAULT_SAMPLE_RATE;
+    config.channel_count = VTX_C_MIXER_DEFAULT_CHANNEL_COUNT;
+    return config;
+}
+
+VTXCPlayerStatus vtx_c_player_sample_bank_create(mc_module *module, VTXCPlayerSampleBank **out_bank) {
+    VTXCPlayerSampleBank *bank;
+    const mc_module_header *header;
+    int ok;
+
+    if (out_bank == NULL) {
+        return VTX_C_PLAYER_STATUS_INVALID_ARGUMENT;
+    }
+    *out_bank = NULL;
+    header = mc_module_get_header(module);
+    if (header == NULL) {
+        return VTX_C_PLAYER_STATUS_INVALID_ARGUMENT;
+    }
+    if (header->type != MC_MODULE_TYPE_XM && header->type != MC_MODULE_TYPE_MOD) {
+        return VTX_C_PLAYER_STATUS_UNSUPPORTED_MODULE;
+    }
+    bank = (VTXCPlayerSampleBank *)calloc(1u, sizeof(*bank));
+    if (bank == NULL) {
+        return VTX_C_PLAYER_STATUS_OUT_OF_MEMORY;
+    }
+    ok = header->type == MC_MODULE_TYPE_XM
+        ? vtx_c_player_bank_load_xm(bank, module)
+        : vtx_c_player_bank_load_mod(bank, module);
+    if (!ok) {
+        vtx_c_player_sample_bank_free(bank);
+        return VTX_C_PLAYER_STATUS_OUT_OF_MEMORY;
+    }
+    *out_bank = bank;
+    return VTX_C_PLAYER_STATUS_OK;
+}
+
+void vtx_c_player_sample_bank_free(VTXCPlayerSampleBank *bank) {
+    uint32_t sample_index;
+
+    if (bank == NULL) {
+        return;
+    }
+    for (sample_index = 0u; sample_index < bank->sample_count; sample_index++) {
+        vtx_c_mixer_sample_pyramid_free(bank->samples[sample_index].pyramid);
+        free(bank->samples[sample_index].pcm);
+    }
+    free(bank->samples);
+    free(bank->instruments);
+    free(bank);
+}
+
+VTXCPlayerStatus vtx_c_player_sample_bank_build_pyramids(VTXCPlayerSampleBank *bank, uint32_t level_count) {
+    uint32_t sample_index;
+
+    if (bank == NULL || level_count > VTX_C_MIXER_MAX_SAMPLE_PYRAMID_LEVELS) {
+        return VTX_C_PLAYER_STATUS_INVALID_ARGUMENT;
+    }
+    for (sample_index = 0u; sample_index < bank->sample_count; sample_index++) {
+        VTXCPlayerSample *sample = &bank->samples[sample_index];
+
+        if (sample->pyramid != NULL) {
+            bank->byte_count -= vtx_c_mixer_sample_pyramid_byte_count(sample->pyramid);
+            vtx_c_mixer_sample_pyramid_free(sample->pyramid);
+            sample->pyramid = NULL;
+            sample->shared.pyramid = NULL;
+        }
+        if (level_count == 0u || sample->shared.frame_count == 0u) {
+            continue;
+        }
+        if (vtx_c_mixer_sample_pyramid_create(
+                &sample->shared,
+                sample->loop_mode,
+                sample->loop_start_frame,
+                sample->loop_end_frame,
+                level_count,
+                &sample->pyramid) != VTX_C_MIXER_STATUS_OK) {
+            return VTX_C_PLAYER_STATUS_OUT_OF_MEMORY;
+        }
+        sample->shared.pyramid = sample->pyramid;
+        bank->byte_count += vtx_c_mixer_sample_pyramid_byte_count(sample->pyramid);
+    }
+    return VTX_C_PLAYER_STATUS_OK;
+}
+
+uint32_t vtx_c_player_sample_bank_sample_count(const VTXCPlayerSampleBank *bank) {
+    return bank == NULL ? 0u : bank->sample_count;
+}
+
+size_t vtx_c_player_sample_bank_byte_count(const VTXCPlayerSampleBank *bank) {
+    return bank == NULL ? 0u : bank->byte_count;
+}
+
+static int32_t vtx_c_player_note_period(const VTXCPlayer *player, uint8_t note, const VTXCPlayerSample *sample) {
+    int32_t relative_note = sample != NULL ? sample->relative_note : 0;
+    int32_t finetune = sample != NULL ? sample->finetune : 0;
+    int32_t zero_based_note = vtx_c_player_clamp((int32_t)note - 1 + relative_note, 0, VTX_C_PLAYER_MAX_NOTE - 1);
+    double period;
+
+    if (player->linear_frequency) {
+        return VTX_C_PLAYER_LINEAR_PERIOD_BASE - zero_based_note * VTX_C_PLAYER_LINEAR_PERIOD_PER_SEMITONE - finetune / 2;
+    }
+    period = VTX_C_PLAYER_AMIGA_C4_PERIOD * 16.0 * pow(2.0, -((double)zero_based_note + (double)finetune / 128.0) / 12.0);
+    return (int32_t)lround(period);
+}
+
+// Period a voice plays at. MOD notes from octaves 0 and 4 of the period table
+// lie outside the slide limits below and keep their pitch.
+static int32_t vtx_c_player_clamped_period(int32_t period) {
+    return vtx_c_player_clamp(period, VTX_C_PLAYER_MIN_PERIOD, VTX_C_PLAYER_MAX_PERIOD);
+}
+
+// Result of a portamento up or down or a fine slide. As in ProTracker, MOD
+// slides stop at periods 113 and 856.
+static int32_t vtx_c_player_slide_period(const VTXCPlayer *player, int32_t period) {
+    if (player->is_mod) {
+        return vtx_c_player_clamp(period, VTX_C_PLAYER_MOD_MIN_PERIOD, VTX_C_PLAYER_MOD_MAX_PERIOD);
+    }
+    return vtx_c_player_clamped_period(period);
+}
+
+static double vtx_c_player_period_frequency(const VTXCPlayer *player, int32_t period) {
+    if (period <= 0) {
+        return 0.0;
+    }
+    if (player->linear_frequency) {
+        return VTX_C_PLAYER_C4_FREQUENCY * pow(2.0, (VTX_C_PLAYER_LINEAR_C4_PERIOD - (double)period) / 768.0);
+    }
+    return VTX_C_PLAYER_C4_FREQUENCY * VTX_C_PLAYER_AMIGA_C4_PERIOD / (double)period;
+}
+
+static int32_t vtx_c_player_arpeggio_offset(const VTXCPlayer *player, int32_t period, uint8_t semitones) {
+    if (semitones == 0u) {
+        return 0;
+    }
+    if (player->linear_frequency) {
+        return -(int32_t)semitones * VTX_C_PLAYER_LINEAR_PERIOD_PER_SEMITONE;
+    }
+    return (int32_t)lround((double)period * pow(2.0, -(double)semitones / 12.0)) - period;
+}
+
+static int32_t vtx_c_player_waveform_value(uint8_t waveform, uint8_t position) {
+    uint8_t index = position & 31u;
+    int32_t value;
+
+    switch (waveform & 3u) {
+    case 1u:
+        value = (int32_t)index * 8;
+        if (position & 32u) {
+            value = 255 - value;
+        }
+        break;
+    case 2u:
+        value = 255;
+        break;
+    default:
+        value = vtx_c_player_sine_table[index];
+        break;
+    }
+    return (position & 32u) ? -value : value;
+}
+
+static const VTXCPlayerSample *vtx_c_player_select_sample(
+    const VTXCPlayer *player,
+    const VTXCPlayerInstrument *instrument,
+    uint8_t note
+) {
+    uint32_t slot = 0u;
+
+    if (instrument == NULL || instrument->sample_count == 0u) {
+        return NULL;
+    }
+    if (instrument->has_keymap && note >= 1u && note <= VTX_C_PLAYER_MAX_NOTE) {
+        slot = instrument->keymap[note - 1u];
+    }
+    if (slot >= instrument->sample_count || instrument->first_sample + slot >= player->bank->sample_count) {
+        return NULL;
+    }
+    return &player->bank->samples[instrument->first_sample + slot];
+}
+
+static void vtx_c_player_reset_envelopes(VTXCPlayerChannel *channel) {
+    channel->key_on = 1;
+    channel->volume_envelope_tick = 0u;
+    channel->panning_envelope_tick = 0u;
+    channel->fadeout = VTX_C_PLAYER_FADEOUT_MAX;
+}
+
+static void vtx_c_player_apply_sample_defaults(const VTXCPlayer *player, VTXCPlayerChannel *channel) {
+    if (channel->sample == NULL) {
+        return;
+    }
+    channel->volume = channel->sample->volume;
+    channel->pan = player->is_mod ? channel->default_pan : channel->sample->panning;
+}
+
+static void vtx_c_player_trigger(VTXCPlayerChannel *channel, uint32_t start_frame) {
+    if ((channel->vibrato_waveform & 4u) == 0u) {
+        channel->vibrato_position = 0u;
+    }
+    if ((channel->tremolo_waveform & 4u) == 0u) {
+        channel->tremolo_position = 0u;
+    }
+    channel->retrigger_counter = 0u;
+    vtx_c_player_reset_envelopes(channel);
+    channel->trigger_pending = channel->sample != NULL;
+    channel->trigger_frame = start_frame;
+}
+
+static void vtx_c_player_key_off(VTXCPlayerChannel *channel) {
+    channel->key_on = 0;
+    if (channel->instrument == NULL || !channel->instrument->has_volume_envelope) {
+        channel->volume = 0;
+    }
+}
+
+static int vtx_c_player_cell_has_tone_porta(const mc_pattern_cell *cell) {
+    return cell->effect_type == VTX_C_PLAYER_EFFECT_TONE_PORTA ||
+        cell->effect_type == VTX_C_PLAYER_EFFECT_TONE_PORTA_VOLUME_SLIDE ||
+        (cell->volume & 0xF0u) == 0xF0u;
+}
+
+// Note and instrument columns. Runs on tick 0, or on the EDx delay tick.
+static void vtx_c_player_process_note(VTXCPlayer *player, VTXCPlayerChannel *channel) {
+    const mc_pattern_cell *cell = &channel->cell;
+    const VTXCPlayerSample *sample;
+
+    if (cell->instrument != 0u) {
+        channel->instrument_number = cell->instrument;
+        channel->instrument = cell->instrument <= player->bank->instrument_count
+            ? &player->bank->instruments[cell->instrument - 1u]
+            : NULL;
+    }
+    if (cell->note == VTX_C_PLAYER_KEY_OFF_NOTE) {
+        vtx_c_player_key_off(channel);
+        return;
+    }
+    if (cell->note == 0u || cell->note > VTX_C_PLAYER_MAX_NOTE) {
+        if (cell->instrument != 0u) {
+            vtx_c_player_apply_sample_defaults(player, channel);
+            vtx_c_player_reset_envelopes(channel);
+        }
+        return;
+    }
+
+    sample = vtx_c_player_select_sample(player, channel->instrument, cell->note);
+    if (vtx_c_player_cell_has_tone_porta(cell) && channel->has_voice && channel->sample != NULL) {
+        channel->target_period = vtx_c_player_note_period(player, cell->note, sample != NULL ? sample : channel->sample);
+        if (cell->instrument != 0u) {
+            vtx_c_player_apply_sample_defaults(player, channel);
+            vtx_c_player_reset_envelopes(channel);
+        }
+        return;
+    }
+    if (sample == NULL || sample->shared.frame_count == 0u) {
+        channel->sample = NULL;
+        channel->volume = 0;
+        return;
+    }
+    channel->sample = sample;
+    channel->period = vtx_c_player_note_period(player, cell->note, sample);
+    channel->target_period = channel->period;
+    if (cell->instrument != 0u) {
+        vtx_c_player_apply_sample_defaults(player, channel);
+    }
+    vtx_c_player_trigger(
+        channel,
+        cell->effect_type == VTX_C_PLAYER_EFFECT_SAMPLE_OFFSET
+            ? (uint32_t)channel->sample_offset * VTX_C_PLAYER_SAMPLE_OFFSET_FRAMES
+            : 0u
+    );
+}
+
+static void vtx_c_player_volume_slide(int32_t *volume, uint8_t param) {
+    if (param & 0xF0u) {
+        *volume += param >> 4;
+    } else {
+        *volume -= param & 0x0Fu;
+    }
+    *volume = vtx_c_player_clamp(*volume, 0, VTX_C_PLAYER_MAX_VOLUME);
+}
+
+static void vtx_c_player_tone_porta(const VTXCPlayer *player, VTXCPlayerChannel *channel) {
+    int32_t speed = (int32_t)channel->tone_porta_speed * 4;
+
+    if (channel->period < channel->target_period) {
+        channel->period += speed;
+        if (channel->period > channel->target_period) {
+            channel->period = channel->target_period;
+        }
+    } else if (channel->period > channel->target_period) {
+        channel->period -= speed;
+        if (channel->period < channel->target_period) {
+            channel->period = channel->target_period;
+        }
+    }
+    channel->period = vtx_c_player_clamped_period(channel->period);
+}
+
+static void vtx_c_player_vibrato(VTXCPlayerChannel *channel) {
+    int32_t value = vtx_c_player_waveform_value(channel->vibrato_waveform, channel->vibrato_position);
+
+    channel->period_offset = (value * (int32_t)channel->vibrato_depth) / 32;
+    channel->vibrato_position = (uint8_t)((channel->vibrato_position + channel->vibrato_speed) & 63u);
+}
+
+static void vtx_c_player_tremolo(VTXCPlayerChannel *channel) {
+    int32_t value = vtx_c_player_waveform_value(channel->tremolo_waveform, channel->tremolo_position);
+
+    channel->volume_offset = (value * (int32_t)channel->tremolo_depth) / 64;
+    channel->tremolo_position = (uint8_t)((channel->tremolo_position + channel->tremolo_speed) & 63u);
+}
+
+static void vtx_c_player_multi_retrigger_volume(VTXCPlayerChannel *channel) {
+    switch (channel->multi_retrigger >> 4) {
+    case 0x1: channel->volume -= 1; break;
+    case 0x2: channel->volume -= 2; break;
+    case 0x3: channel->volume -= 4; break;
+    case 0x4: channel->volume -= 8; break;
+    case 0x5: channel->volume -= 16; break;
+    case 0x6: channel->volume = channel->volume * 2 / 3; break;
+    case 0x7: channel->volume /= 2; break;
+    case 0x9: channel->volume += 1; break;
+    case 0xA: channel->volume += 2; break;
+    case 0xB: channel->volume += 4; break;
+    case 0xC: channel->volume += 8; break;
+    case 0xD: channel->volume += 16; break;
+    case 0xE: channel->volume = channel->volume * 3 / 2; break;
+    case 0xF: channel->volume *= 2; break;
+    default: break;
+    }
+    channel->volume = vtx_c_player_clamp(channel->volume, 0, VTX_C_PLAYER_MAX_VOLUME);
+}
+
+static void vtx_c_player_volume_column_tick0(VTXCPlayerChannel *channel) {
+    uint8_t volume = channel->cell.volume;
+    uint8_t value = volume & 0x0Fu;
+
+    if (volume >= 0x10u && volume <= 0x50u) {
+        channel->volume = volume - 0x10u;
+        return;
+    }
+    switch (volume & 0xF0u) {
+    case 0x80u:
+        channel->volume = vtx_c_player_clamp(channel->volume - value, 0, VTX_C_PLAYER_MAX_VOLUME);
+        break;
+    case 0x90u:
+        channel->volume = vtx_c_player_clamp(channel->volume + value, 0, VTX_C_PLAYER_MAX_VOLUME);
+        break;
+    case 0xA0u:
+        if (value != 0u) {
+            channel->vibrato_speed = value;
+        }
+        break;
+    case 0xB0u:
+        if (value != 0u) {
+            channel->vibrato_depth = value;
+        }
+        break;
+    case 0xC0u:
+        channel->pan = value << 4;
+        break;
+    case 0xF0u:
+        if (value != 0u) {
+            channel->tone_porta_speed = (uint8_t)(value << 4);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void vtx_c_player_volume_column_tick(const VTXCPlayer *player, VTXCPlayerChannel *channel) {
+    uint8_t value = channel->cell.volume & 0x0Fu;
+
+    switch (channel->cell.volume & 0xF0u) {
+    case 0x60u:
+        channel->volume = vtx_c_player_clamp(channel->volume - value, 0, VTX_C_PLAYER_MAX_VOLUME);
+        break;
+    case 0x70u:
+        channel->volume = vtx_c_player_clamp(channel->volume + value, 0, VTX_C_PLAYER_MAX_VOLUME);
+        break;
+    case 0xB0u:
+        vtx_c_player_vibrato(channel);
+        break;
+    case 0xD0u:
+        channel->pan = vtx_c_player_clamp(channel->pan - value, 0, VTX_C_PLAYER_MAX_PAN);
+        break;
+    case 0xE0u:
+        channel->pan = vtx_c_player_clamp(channel->pan + value, 0, VTX_C_PLAYER_MAX_PAN);
+        break;
+    case 0xF0u:
+        vtx_c_player_tone_porta(player, channel);
+        break;
+    default:
+        break;
+    }
+}
+
+static void vtx_c_player_extended_tick0(VTXCPlayer *player, VTXCPlayerChannel *channel, uint8_t command, uint8_t value) {
+    switch (command) {
+    case VTX_C_PLAYER_EXTENDED_FINE_PORTA_UP:
+        if (value != 0u) {
+            channel->fine_porta_up_speed = value;
+        }
+        channel->period = vtx_c_player_slide_period(player, channel->period - channel->fine_porta_up_speed * 4);
+        break;
+    case VTX_C_PLAYER_EXTENDED_FINE_PORTA_DOWN:
+        if (value != 0u) {
+            channel->fine_porta_down_speed = value;
+        }
+        channel->period = vtx_c_player_slide_period(player, channel->period + channel->fine_porta_down_speed * 4);
+        break;
+    case VTX_C_PLAYER_EXTENDED_VIBRATO_WAVEFORM:
+        channel->vibrato_waveform = value;
+        break;
+    case VTX_C_PLAYER_EXTENDED_TREMOLO_WAVEFORM:
+        channel->tremolo_waveform = value;
+        break;
+    case VTX_C_PLAYER_EXTENDED_FINE_VOLUME_UP:
+        if (value != 0u) {
+            channel->fine_volume_up = value;
+        }
+        channel->volume = vtx_c_player_clamp(channel->volume + channel->fine_volume_up, 0, VTX_C_PLAYER_MAX_VOLUME);
+        break;
+    case VTX_C_PLAYER_EXTENDED_FINE_VOLUME_DOWN:
+        if (value != 0u) {
+            channel->fine_volume_down = value;
+        }
+        channel->volume = vtx_c_player_clamp(channel->volume - channel->fine_volume_down, 0, VTX_C_PLAYER_MAX_VOLUME);
+        break;
+    case VTX_C_PLAYER_EXTENDED_NOTE_CUT:
+        if (value == 0u) {
+            channel->volume = 0;
+            channel->cut_immediately = 1;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void vtx_c_player_effect_tick0(VTXCPlayer *player, VTXCPlayerChannel *channel) {
+    uint8_t param = channel->cell.effect_param;
+
+    switch (channel->cell.effect_type) {
+    case VTX_C_PLAYER_EFFECT_PORTA_UP:
+        if (param != 0u) {
+            channel->porta_up_speed = param;
+        }
+        break;
+    case VTX_C_PLAYER_EFFECT_PORTA_DOWN:
+        if (param != 0u) {
+            channel->porta_down_speed = param;
+        }
+        break;
+    case VTX_C_PLAYER_EFFECT_TONE_PORTA:
+        if (param != 0u) {
+            channel->tone_porta_speed = param;
+        }
+        break;
+    case VTX_C_PLAYER_EFFECT_VIBRATO:
+        if (param & 0xF0u) {
+            channel->vibrato_speed = param >> 4;
+        }
+        if (param & 0x0Fu) {
+            channel->vibrato_depth = param & 0x0Fu;
+        }
+        break;
+    case VTX_C_PLAYER_EFFECT_TONE_PORTA_VOLUME_SLIDE:
+    case VTX_C_PLAYER_EFFECT_VIBRATO_VOLUME_SLIDE:
+    case VTX_C_PLAYER_EFFECT_VOLUME_SLIDE:
+        if (param != 0u) {
+            channel->volume_slide = param;
+        }
+        break;
+    case VTX_C_PLAYER_EFFECT_TREMOLO:
+        if (param & 0xF0u) {
+            channel->tremolo_speed = param >> 4;
+        }
+        if (param & 0x0Fu) {
+            channel->tremolo_depth = param & 0x0Fu;
+        }
+        break;
+    case VTX_C_PLAYER_EFFECT_SET_PAN:
+        channel->pan = param;
+        break;
+    case VTX_C_PLAYER_EFFECT_SET_VOLUME:
+        channel->volume = param > VTX_C_PLAYER_MAX_VOLUME ? VTX_C_PLAYER_MAX_VOLUME : param;
+        break;
+    case VTX_C_PLAYER_EFFECT_EXTENDED:
+        vtx_c_player_extended_tick0(player, channel, param >> 4, param & 0x0Fu);
+        break;
+    case VTX_C_PLAYER_EFFECT_SET_GLOBAL_VOLUME:
+        player->global_volume = param > VTX_C_PLAYER_MAX_VOLUME ? VTX_C_PLAYER_MAX_VOLUME : param;
+        break;
+    case VTX_C_PLAYER_EFFECT_GLOBAL_VOLUME_SLIDE:
+        if (param != 0u) {
+            channel->global_volume_slide = param;
+        }
+        break;
+    case VTX_C_PLAYER_EFFECT_KEY_OFF:
+        if (param == 0u) {
+            vtx_c_player_key_off(channel);
+        }
+        break;
+    case VTX_C_PLAYER_EFFECT_SET_ENVELOPE_POSITION:
+        channel->volume_envelope_tick = param;
+        break;
+    case VTX_C_PLAYER_EFFECT_PAN_SLIDE:
+        if (param != 0u) {
+            channel->pan_slide = param;
+        }
+        break;
+    case VTX_C_PLAYER_EFFECT_MULTI_RETRIGGER:
+        if (param != 0u) {
+            channel->multi_retrigger = param;
+        }
+        break;
+    case VTX_C_PLAYER_EFFECT_EXTRA_FINE_PORTA:
+        if ((param >> 4) == 1u) {
+            if (param & 0x0Fu) {
+                channel->extra_fine_porta_up_speed = param & 0x0Fu;
+            }
+            channel->period = vtx_c_player_slide_period(player, channel->period - channel->extra_fine_porta_up_speed);
+        } else if ((param >> 4) == 2u) {
+            if (param & 0x0Fu) {
+                channel->extra_fine_porta_down_speed = param & 0x0Fu;
+            }
+            channel->period = vtx_c_player_slide_period(player, channel->period + channel->extra_fine_porta_down_speed);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void vtx_c_player_effect_tick(VTXCPlayer *player, VTXCPlayerChannel *channel) {
+    uint8_t param = channel->cell.effect_param;
+    uint8_t command = param >> 4;
+    uint8_t value = param & 0x0Fu;
+
+    switch (channel->cell.effect_type) {
+    case VTX_C_PLAYER_EFFECT_ARPEGGIO:
+        if (param != 0u) {
+            uint8_t phase = (uint8_t)(player->tick % 3u);
+            uint8_t semitones = phase == 1u ? command : (phase == 2u ? value : 0u);
+            channel->period_offset = vtx_c_player_arpeggio_offset(player, channel->period, semitones);
+        }
+        break;
+    case VTX_C_PLAYER_EFFECT_PORTA_UP:
+        channel->period = vtx_c_player_slide_period(player, channel->period - channel->porta_up_speed * 4);
+        break;
+    case VTX_C_PLAYER_EFFECT_PORTA_DOWN:
+        channel->period = vtx_c_player_slide_period(player, channel->period + channel->porta_down_speed * 4);
+        break;
+    case VTX_C_PLAYER_EFFECT_TONE_PORTA:
+        vtx_c_player_tone_porta(player, channel);
+        break;
+    case VTX_C_PLAYER_EFFECT_VIBRATO:
+        vtx_c_player_vibrato(channel);
+        break;
+    case VTX_C_PLAYER_EFFECT_TONE_PORTA_VOLUME_SLIDE:
+        vtx_c_player_tone_porta(player, channel);
+        vtx_c_player_volume_slide(&channel->volume, channel->volume_slide);
+        break;
+    case VTX_C_PLAYER_EFFECT_VIBRATO_VOLUME_SLIDE:
+        vtx_c_player_vibrato(channel);
+        vtx_c_player_volume_slide(&channel->volume, channel->volume_slide);
+        break;
+    case VTX_C_PLAYER_EFFECT_TREMOLO:
+        vtx_c_player_tremolo(channel);
+        break;
+    case VTX_C_PLAYER_EFFECT_VOLUME_SLIDE:
+        vtx_c_player_volume_slide(&channel->volume, channel->volume_slide);
+        break;
+    case VTX_C_PLAYER_EFFECT_EXTENDED:
+        if (command == VTX_C_PLAYER_EXTENDED_RETRIGGER && value != 0u && player->tick % value == 0u) {
+            vtx_c_player_trigger(channel, 0u);
+        } else if (command == VTX_C_PLAYER_EXTENDED_NOTE_CUT && player->tick == value) {
+            channel->volume = 0;
+            channel->cut_immediately = 1;
+        } else if (command == VTX_C_PLAYER_EXTENDED_NOTE_DELAY && player->tick == value) {
+            vtx_c_player_process_note(player, channel);
+            vtx_c_player_volume_column_tick0(channel);
+        }
+        break;
+    case VTX_C_PLAYER_EFFECT_GLOBAL_VOLUME_SLIDE:
+        vtx_c_player_volume_slide(&player->global_volume, channel->global_volume_slide);
+        break;
+    case VTX_C_PLAYER_EFFECT_KEY_OFF:
+        if (player->tick == param) {
+            vtx_c_player_key_off(channel);
+        }
+        break;
+    case VTX_C_PLAYER_EFFECT_PAN_SLIDE:
+        if (channel->pan_slide & 0xF0u) {
+            channel->pan = vtx_c_player_clamp(channel->pan + (channel->pan_slide >> 4), 0, VTX_C_PLAYER_MAX_PAN);
+        } else {
+            channel->pan = vtx_c_player_clamp(channel->pan - (channel->pan_slide & 0x0Fu), 0, VTX_C_PLAYER_MAX_PAN);
+        }
+        break;
+    case VTX_C_PLAYER_EFFECT_MULTI_RETRIGGER:
+        if ((channel->multi_retrigger & 0x0Fu) != 0u &&
+            ++channel->retrigger_counter >= (channel->multi_retrigger & 0x0Fu)) {
+            vtx_c_player_multi_retrigger_volume(channel);
+            vtx_c_player_trigger(channel, 0u);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static int32_t vtx_c_player_envelope_value(const mc_xm_envelope *envelope, uint16_t tick) {
+    uint8_t point_index;
+
+    if (tick <= envelope->points[0].tick || envelope->point_count == 1u) {
+        return envelope->points[0].value;
+    }
+    for (point_index = 1u; point_index < envelope->point_count; point_index++) {
+        const mc_xm_envelope_point *left = &envelope->points[point_index - 1u];
+        const mc_xm_envelope_point *right = &envelope->points[point_index];
+        if (tick < right->tick) {
+            int32_t span = (int32_t)right->tick - (int32_t)left->tick;
+            if (span <= 0) {
+                return right->value;
+            }
+            return left->value + ((int32_t)right->value - (int32_t)left->value) * ((int32_t)tick - left->tick) / span;
+        }
+    }
+    return envelope->points[envelope->point_count - 1u].value;
+}
+
+static void vtx_c_player_advance_envelope(const mc_xm_envelope *envelope, int key_on, uint16_t *tick) {
+    if ((envelope->flags & MC_XM_ENVELOPE_SUSTAIN) &&
+        key_on &&
+        envelope->sustain_point < envelope->point_count &&
+        *tick == envelope->points[envelope->sustain_point].tick) {
+        return;
+    }
+    if (*tick < UINT16_MAX) {
+        (*tick)++;
+    }
+    if ((envelope->flags & MC_XM_ENVELOPE_LOOP) &&
+        envelope->loop_end_point < envelope->point_count &&
+        envelope->loop_start_point <= envelope->loop_end_point &&
+        *tick == envelope->points[envelope->loop_end_point].tick) {
+        *tick = envelope->points[envelope->loop_start_point].tick;
+    }
+}
+
+static void vtx_c_player_update_channel(VTXCPlayer *player, uint16_t channel_index) {
+    VTXCPlayerChannel *channel = &player->channels[channel_index];
+    const VTXCPlayerInstrument *instrument = channel->instrument;
+    VTXCMixerState *mixer = &player->mixer;
+    int32_t envelope_volume = VTX_C_PLAYER_MAX_VOLUME;
+    int32_t pan = channel->pan;
+    int32_t volume;
+    double frequency;
+    double step;
+    float gain;
+    float mixer_pan;
+
+    if (instrument != NULL && instrument->has_volume_envelope) {
+        envelope_volume = vtx_c_player_clamp(
+            vtx_c_player_envelope_value(&instrument->volume_envelope, channel->volume_envelope_tick),
+            0,
+            VTX_C_PLAYER_MAX_VOLUME
+        );
+        vtx_c_player_advance_envelope(&instrument->volume_envelope, channel->key_on, &channel->volume_envelope_tick);
+        if (!channel->key_on) {
+            channel->fadeout = vtx_c_player_clamp(channel->fadeout - instrument->fadeout, 0, VTX_C_PLAYER_FADEOUT_MAX);
+        }
+    }
+    if (instrument != NULL && instrument->has_panning_envelope) {
+        int32_t envelope_pan = vtx_c_player_clamp(
+            vtx_c_player_envelope_value(&instrument->panning_envelope, channel->panning_envelope_tick),
+            0,
+            64
+        );
+        int32_t distance = pan > VTX_C_PLAYER_CENTER_PAN ? pan - VTX_C_PLAYER_CENTER_PAN : VTX_C_PLAYER_CENTER_PAN - pan;
+        pan = vtx_c_player_clamp(pan + (envelope_pan - 32) * (VTX_C_PLAYER_CENTER_PAN - distance) / 32, 0, VTX_C_PLAYER_MAX_PAN);
+        vtx_c_player_advance_envelope(&instrument->panning_envelope, channel->key_on, &channel->panning_envelope_tick);
+    }
+
+    if (channel->sample == NULL || (!channel->has_voice && !channel->trigger_pending)) {
+        // A note on a missing or empty sample silences the channel, as in FT2.
+        if (channel->sample == NULL && channel->has_voice) {
+            vtx_c_mixer_ramp_down_voices_for_channel_tag(
+                mixer,
+                channel_index,
+                vtx_c_mixer_replacement_stop_ramp_frame_count(),
+                NULL
+            );
+            channel->has_voice = 0;
+        }
+        channel->trigger_pending = 0;
+        channel->cut_immediately = 0;
+        return;
+    }
+    volume = vtx_c_player_clamp(channel->volume + channel->volume_offset, 0, VTX_C_PLAYER_MAX_VOLUME);
+    gain = (float)((double)volume / 64.0 *
+        (double)envelope_volume / 64.0 *
+        (double)channel->fadeout / (double)VTX_C_PLAYER_FADEOUT_MAX *
+        (double)player->global_volume / 64.0);
+    mixer_pan = (float)pan / 127.5f - 1.0f;
+    frequency = vtx_c_player_period_frequency(
+        player,
+        vtx_c_player_clamped_period(channel->period + channel->period_offset)
+    );
+    step = frequency / mixer->config.sample_rate;
+    if (!(step > 0.0)) {
+        step = 1.0;
+    }
+
+    if (channel->trigger_pending) {
+        uint32_t voice = 0u;
+        VTXCMixerStatus status;
+
+        channel->trigger_pending = 0;
+        channel->has_voice = 0;
+        vtx_c_mixer_ramp_down_voices_for_channel_tag(
+            mixer,
+            channel_index,
+            vtx_c_mixer_replacement_stop_ramp_frame_count(),
+            NULL
+        );
+        status = vtx_c_mixer_add_scheduled_shared_sample_voice(
+            mixer,
+            &channel->sample->shared,
+            step,
+            channel->trigger_frame,
+            gain,
+            mixer_pan,
+            channel->sample->loop_mode,
+            channel->sample->loop_start_frame,
+            channel->sample->loop_end_frame,
+            vtx_c_mixer_current_frame(mixer),
+            &voice
+        );
+        if (status != VTX_C_MIXER_STATUS_OK) {
+            player->dropped_note_count++;
+        } else if (vtx_c_mixer_set_voice_channel_tag(mixer, voice, channel_index) == VTX_C_MIXER_STATUS_OK) {
+            channel->has_voice = 1;
+            channel->voice = voice;
+        }
+    } else if (gain != channel->sent_gain || mixer_pan != channel->sent_pan || step != channel->sent_step) {
+        uint64_t frame = vtx_c_mixer_current_frame(mixer);
+        if (channel->cut_immediately) {
+            vtx_c_mixer_schedule_voice_gain_pan_update_immediate(mixer, channel->voice, frame, 1, gain, 1, mixer_pan);
+            if (step != channel->sent_step) {
+                vtx_c_mixer_schedule_voice_sample_step_update(mixer, channel->voice, frame, step);
+            }
+        } else {
+            vtx_c_mixer_schedule_voice_gain_pan_sample_step_update(
+                mixer,
+                channel->voice,
+                frame,
+                1,
+                gain,
+                1,
+                mixer_pan,
+                step
+            );
+        }
+    }
+    channel->sent_gain = gain;
+    channel->sent_pan = mixer_pan;
+    channel->sent_step = step;
+    channel->cut_immediately = 0;
+}
+
+static void vtx_c_player_advance_row(VTXCPlayer *player) {
+    uint16_t loop_order;
+    uint16_t loop_row;
+
+    if (!mc_song_walk_advance(&player->walk, &loop_order, &loop_row)) {
+        player->ended = 1;
+    }
+}
+
+static void vtx_c_player_process_row(VTXCPlayer *player) {
+    const mc_song_walk *walk = &player->walk;
+    uint16_t channel_index;
+
+    // Speed, BPM, jumps, breaks, pattern loops and delays; the channel loop
+    // below handles every other effect.
+    mc_song_walk_process_row(&player->walk);
+    player->pattern_delay = walk->pattern_delay;
+    for (channel_index = 0u; channel_index < player->channel_count; channel_index++) {
+        VTXCPlayerChannel *channel = &player->channels[channel_index];
+        const mc_pattern_cell *cell = &channel->cell;
+
+        memset(&channel->cell, 0, sizeof(channel->cell));
+        if (walk->cells != NULL) {
+            channel->cell = walk->cells[(size_t)walk->row * walk->pattern_channel_count + channel_index];
+        }
+        channel->period_offset = 0;
+        channel->volume_offset = 0;
+        if (cell->effect_type == VTX_C_PLAYER_EFFECT_SAMPLE_OFFSET && cell->effect_param != 0u) {
+            channel->sample_offset = cell->effect_param;
+        }
+        if (!(cell->effect_type == VTX_C_PLAYER_EFFECT_EXTENDED &&
+              (cell->effect_param >> 4) == VTX_C_PLAYER_EXTENDED_NOTE_DELAY &&
+              (cell->effect_param & 0x0Fu) != 0u)) {
+            vtx_c_player_process_note(player, channel);
+            vtx_c_player_volume_column_tick0(channel);
+        }
+        vtx_c_player_effect_tick0(player, channel);
+    }
+}
+
+static void vtx_c_player_process_tick(VTXCPlayer *player) {
+    VTXCMixerState *mixer = &player->mixer;
+    uint16_t channel_index;
+    double exact_frames;
+
+    vtx_c_mixer_release_inactive_voices(mixer, NULL);
+    for (channel_index = 0u; channel_index < player->channel_count; channel_index++) {
+        VTXCPlayerChannel *channel = &player->channels[channel_index];
+        if (channel->has_voice && !vtx_c_mixer_voice_is_active(mixer, channel->voice)) {
+            channel->has_voice = 0;
+        }
+    }
+
+    if (player->tick == 0u) {
+        if (!player->repeating_row) {
+            vtx_c_player_process_row(player);
+        }
+    } else {
+        for (channel_index = 0u; channel_index < player->channel_count; channel_index++) {
+            VTXCPlayerChannel *channel = &player->channels[channel_index];
+            channel->period_offset = 0;
+            channel->volume_offset = 0;
+            vtx_c_player_volume_column_tick(player, channel);
+            vtx_c_player_effect_tick(player, channel);
+        }
+    }
+    for (channel_index = 0u; channel_index < player->channel_count; channel_index++) {
+        vtx_c_player_update_channel(player, channel_index);
+    }
+
+    player->position.order = player->walk.order;
+    player->position.pattern = player->walk.pattern;
+    player->position.row = player->walk.row;
+    player->position.tick = player->tick;
+    player->position.speed = player->walk.speed;
+    player->position.bpm = player->walk.bpm;
+    player->position.global_volume = (uint8_t)player->global_volume;
+    player->position.frame = vtx_c_mixer_current_frame(mixer);
+
+    exact_frames = mixer->config.sample_rate * 2.5 / (double)player->walk.bpm + player->tick_frame_remainder;
+    player->frames_left_in_tick = (uint32_t)floor(exact_frames);
+    player->tick_frame_remainder = exact_frames - (double)player->frames_left_in_tick;
+
+    player->tick++;
+    if (player->tick >= player->walk.speed) {
+        player->tick = 0u;
+        if (player->pattern_delay > 0u) {
+            player->pattern_delay--;
+            player->repeating_row = 1;
+        } else {
+            player->repeating_row = 0;
+            vtx_c_player_advance_row(player);
+        }
+    }
+}
+
+VTXCPlayerStatus vtx_c_player_create(
+    mc_module *module,
+    const VTXCPlayerSampleBank *bank,
+    VTXCPlayerConfig config,
+    VTXCPlayer **out_player
+) {
+    const mc_module_header *header;
+    VTXCPlayer *player;
+    VTXCMixerConfig mixer_config;
+    uint16_t channel_index;
+
+    if (out_player == NULL) {
+        return VTX_C_PLAYER_STATUS_INVALID_ARGUMENT;
+    }
+    *out_player = NULL;
+    header = mc_module_get_header(module);
+    if (header == NULL) {
+        return VTX_C_PLAYER_STATUS_INVALID_ARGUMENT;
+    }
+    if (header->type != MC_MODULE_TYPE_XM && header->type != MC_MODULE_TYPE_MOD) {
+        return VTX_C_PLAYER_STATUS_UNSUPPORTED_MODULE;
+    }
+    player = (VTXCPlayer *)calloc(1u, sizeof(*player));
+    if (player == NULL) {
+        return VTX_C_PLAYER_STATUS_OUT_OF_MEMORY;
+    }
+    player->module = module;
+    player->config = config;
+    if (!mc_song_walk_begin(&player->walk, module, config.start_order)) {
+        free(player);
+        return VTX_C_PLAYER_STATUS_INVALID_ARGUMENT;
+    }
+    // Pins every pattern grid until mc_module_close, so the walk's grid stays
+    // valid however many other patterns are read through the handle while the
+    // player is alive. A malformed pattern still plays as an empty one.
+    mc_module_decode_patterns(module, 0u, NULL, NULL);
+    if (bank == NULL) {
+        VTXCPlayerStatus status = vtx_c_player_sample_bank_create(module, &player->owned_bank);
+        if (status == VTX_C_PLAYER_STATUS_OK && config.sample_pyramid_levels > 0u) {
+            status = vtx_c_player_sample_bank_build_pyramids(player->owned_bank, config.sample_pyramid_levels);
+        }
+        if (status != VTX_C_PLAYER_STATUS_OK) {
+            vtx_c_player_sample_bank_free(player->owned_bank);
+            free(player);
+            return status;
+        }
+        bank = player->owned_bank;
+    }
+    player->bank = bank;
+
+    mixer_config.sample_rate = config.sample_rate;
+    mixer_config.channel_count = config.channel_count;
+    vtx_c_mixer_init(&player->mixer, mixer_config);
+    // The mixer sanitizes the rate and channel count; keep the effective values.
+    player->config.sample_rate = player->mixer.config.sample_rate;
+    player->config.channel_count = player->mixer.config.channel_count;
+
+    player->is_mod = header->type == MC_MODULE_TYPE_MOD;
+    player->linear_frequency = !player->is_mod && (header->xm_flags & 0x01u) != 0u;
+    player->channel_count = header->channels < VTX_C_PLAYER_MAX_CHANNELS
+        ? header->channels
+        : (uint16_t)VTX_C_PLAYER_MAX_CHANNELS;
+    player->global_volume = VTX_C_PLAYER_MAX_VOLUME;
+    for (channel_index = 0u; channel_index < player->channel_count; channel_index++) {
+        VTXCPlayerChannel *channel = &player->channels[channel_index];
+        uint16_t lane = channel_index & 3u;
+        if (player->is_mod) {
+            channel->default_pan = lane == 0u || lane == 3u ? VTX_C_PLAYER_MOD_LEFT_PAN : VTX_C_PLAYER_MOD_RIGHT_PAN;
+        } else {
+            channel->default_pan = VTX_C_PLAYER_CENTER_PAN;
+        }
+        channel->pan = channel->default_pan;
+        channel->fadeout = VTX_C_PLAYER_FADEOUT_MAX;
+    }
+    player->walk.loop = config.loop_song;
+    player->walk.range_start = config.start_order;
+    player->walk.range_count = config.order_count;
+    *out_player = player;
+    return VTX_C_PLAYER_STATUS_OK;
+}
+
+void vtx_c_player_free(VTXCPlayer *player) {
+    if (player == NULL) {
+        return;
+    }
+    vtx_c_mixer_clear_voices(&player->mixer);
+    vtx_c_player_sample_bank_free(player->owned_bank);
+    free(player);
+}
+
+VTXCPlayerStatus vtx_c_player_render(
+    VTXCPlayer *player,
+    float *output_interleaved_float32,
+    uint32_t frame_count,
+    uint32_t *out_rendered_count
+) {
+    uint32_t rendered = 0u;
+
+    if (out_rendered_count != NULL) {
+        *out_rendered_count = 0u;
+    }
+    if (player == NULL || (output_interleaved_float32 == NULL && frame_count > 0u)) {
+        return VTX_C_PLAYER_STATUS_INVALID_ARGUMENT;
+    }
+    while (rendered < frame_count) {
+        uint32_t chunk;
+
+        if (player->frames_left_in_tick == 0u) {
+            if (player->ended) {
+                break;
+            }
+            vtx_c_player_process_tick(player);
+            if (player->frames_left_in_tick == 0u) {
+                continue;
+            }
+        }
+        chunk = frame_count - rendered;
+        if (chunk > player->frames_left_in_tick) {
+            chunk = player->frames_left_in_tick;
+        }
+        if (vtx_c_mixer_render(
+                &player->mixer,
+                output_interleaved_float32 + (size_t)rendered * player->config.channel_count,
+                chunk
+            ) != VTX_C_MIXER_STATUS_OK) {
+            return VTX_C_PLAYER_STATUS_MIXER_ERROR;
+        }
+        player->frames_left_in_tick -= chunk;
+        rendered += chunk;
+    }
+    if (out_rendered_count != NULL) {
+        *out_rendered_count = rendered;
+    }
+    return VTX_C_PLAYER_STATUS_OK;
+}
+
+int vtx_c_player_has_ended(const VTXCPlayer *player) {
+    return player == NULL || (player->ended && player->frames_left_in_tick == 0u);
+}
+
+VTXCPlayerPosition vtx_c_player_position(const VTXCPlayer *player) {
+    VTXCPlayerPosition position;
+
+    if (player == NULL) {
+        memset(&position, 0, sizeof(position));
+        position.ended = 1;
+        return position;
+    }
+    position = player->position;
+    position.ended = vtx_c_player_has_ended(player);
+    return position;
+}
+
+uint64_t vtx_c_player_dropped_note_count(const VTXCPlayer *player) {
+    return player == NULL ? 0u : player->dropped_note_count;
+}
+
+VTXCMixerState *vtx_c_player_mixer(VTXCPlayer *player) {
+    return player == NULL ? NULL : &player->mixer;
+}
@@ -0,0 +1,213 @@
+#include "vtx_c_player_timeline.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "module_song_walk.h"
+
+#define VTX_C_PLAYER_TIMELINE_INITIAL_CAPACITY 256u
+
+static int vtx_c_player_timeline_compare_keys(const void *lhs, const void *rhs) {
+    uint64_t a = *(const uint64_t *)lhs;
+    uint64_t b = *(const uint64_t *)rhs;
+
+    return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+static int vtx_c_player_timeline_index_positions(VTXCPlayerTimeline *timeline) {
+    uint64_t *keys;
+    size_t index;
+
+    keys = (uint64_t *)malloc((timeline->row_count > 0u ? timeline->row_count : 1u) * sizeof(*keys));
+    timeline->rows_by_position = (uint32_t *)malloc(
+        (timeline->row_count > 0u ? timeline->row_count : 1u) * sizeof(*timeline->rows_by_position)
+    );
+    if (keys == NULL || timeline->rows_by_position == NULL) {
+        free(keys);
+        return 0;
+    }
+    // Row indices are below 2^22, so order, row and index pack into one key
+    // whose sort order is order, row, then start frame.
+    for (index = 0u; index < timeline->row_count; index++) {
+        keys[index] = ((uint64_t)timeline->rows[index].order << 48) |
+            ((uint64_t)timeline->rows[index].row << 32) |
+            (uint64_t)index;
+    }
+    qsort(keys, timeline->row_count, sizeof(*keys), vtx_c_player_timeline_compare_keys);
+    for (index = 0u; index < timeline->row_count; index++) {
+        timeline->rows_by_position[index] = (uint32_t)(keys[index] & 0xFFFFFFFFu);
+    }
+    free(keys);
+    return 1;
+}
+
+VTXCPlayerStatus vtx_c_player_timeline_build(
+    mc_module *module,
+    double sample_rate,
+    uint16_t start_order,
+    VTXCPlayerTimeline *out_timeline
+) {
+    const mc_module_header *header;
+    mc_song_walk *walk;
+    VTXCPlayerTimeline timeline;
+    size_t capacity = VTX_C_PLAYER_TIMELINE_INITIAL_CAPACITY;
+    double tick_frame_remainder = 0.0;
+    uint64_t frame = 0u;
+
+    if (out_timeline == NULL) {
+        return VTX_C_PLAYER_STATUS_INVALID_ARGUMENT;
+    }
+    memset(out_timeline, 0, sizeof(*out_timeline));
+    header = mc_module_get_header(module);
+    if (header == NULL) {
+        return VTX_C_PLAYER_STATUS_INVALID_ARGUMENT;
+    }
+    if (header->type != MC_MODULE_TYPE_XM && header->type != MC_MODULE_TYPE_MOD) {
+        return VTX_C_PLAYER_STATUS_UNSUPPORTED_MODULE;
+    }
+    walk = (mc_song_walk *)malloc(sizeof(*walk));
+    if (walk == NULL) {
+        return VTX_C_PLAYER_STATUS_OUT_OF_MEMORY;
+    }
+    if (!mc_song_walk_begin(walk, module, start_order)) {
+        free(walk);
+        return VTX_C_PLAYER_STATUS_INVALID_ARGUMENT;
+    }
+
+    memset(&timeline, 0, sizeof(timeline));
+    // Same sanitizing as the mixer the player owns.
+    timeline.sample_rate = isfinite(sample_rate) && sample_rate > 0.0 ? sample_rate : VTX_C_MIXER_DEFAULT_SAMPLE_RATE;
+    timeline.rows = (VTXCPlayerTimelineRow *)malloc(capacity * sizeof(*timeline.rows));
+    if (timeline.rows == NULL) {
+        free(walk);
+        return VTX_C_PLAYER_STATUS_OUT_OF_MEMORY;
+    }
+
+    for (;;) {
+        VTXCPlayerTimelineRow *entry;
+        uint32_t tick_count;
+        uint32_t tick;
+
+        if (timeline.row_count == VTX_C_PLAYER_TIMELINE_MAX_ROWS) {
+            timeline.truncated = 1;
+            break;
+        }
+        if (timeline.row_count == capacity) {
+            VTXCPlayerTimelineRow *grown = (VTXCPlayerTimelineRow *)realloc(
+                timeline.rows,
+                capacity * 2u * sizeof(*timeline.rows)
+            );
+            if (grown == NULL) {
+                free(timeline.rows);
+                free(walk);
+                return VTX_C_PLAYER_STATUS_OUT_OF_MEMORY;
+            }
+            timeline.rows = grown;
+            capacity *= 2u;
+        }
+
+        tick_count = mc_song_walk_process_row(walk);
+        entry = &timeline.rows[timeline.row_count++];
+        entry->start_frame = frame;
+        entry->order = walk->order;
+        entry->pattern = walk->pattern;
+        entry->row = walk->row;
+        entry->speed = walk->speed;
+        entry->bpm = walk->bpm;
+
+        // Tick lengths accumulate exactly as in vtx_c_player_process_tick.
+        for (tick = 0u; tick < tick_count; tick++) {
+            double exact_frames = timeline.sample_rate * 2.5 / (double)walk->bpm + tick_frame_remainder;
+            uint32_t tick_frames = (uint32_t)floor(exact_frames);
+            tick_frame_remainder = exact_frames - (double)tick_frames;
+            frame += tick_frames;
+        }
+
+        if (!mc_song_walk_advance(walk, &timeline.loop_order, &timeline.loop_row)) {
+            break;
+        }
+    }
+    free(walk);
+    timeline.total_frames = frame;
+
+    if (!vtx_c_player_timeline_index_positions(&timeline)) {
+        free(timeline.rows);
+        return VTX_C_PLAYER_STATUS_OUT_OF_MEMORY;
+    }
+    if (!timeline.truncated) {
+        timeline.has_loop_frame = vtx_c_player_timeline_frame_of(
+            &timeline,
+            timeline.loop_order,
+            timeline.loop_row,
+            &timeline.loop_frame
+        );
+    }
+    *out_timeline = timeline;
+    return VTX_C_PLAYER_STATUS_OK;
+}
+
+void vtx_c_player_timeline_free(VTXCPlayerTimeline *timeline) {
+    if (timeline == NULL) {
+        return;
+    }
+    free(timeline->rows);
+    free(timeline->rows_by_position);
+    memset(timeline, 0, sizeof(*timeline));
+}
+
+const VTXCPlayerTimelineRow *vtx_c_player_timeline_row_at_frame(const VTXCPlayerTimeline *timeline, uint64_t frame) {
+    size_t low = 0u;
+    size_t high;
+
+    if (timeline == NULL || timeline->row_count == 0u || frame >= timeline->total_frames) {
+        return NULL;
+    }
+    // Last row whose start frame is at or before frame.
+    high = timeline->row_count;
+    while (high - low > 1u) {
+        size_t middle = low + (high - low) / 2u;
+        if (timeline->rows[middle].start_frame <= frame) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return &timeline->rows[low];
+}
+
+int vtx_c_player_timeline_frame_of(
+    const VTXCPlayerTimeline *timeline,
+    uint16_t order,
+    uint16_t row,
+    uint64_t *out_frame
+) {
+    size_t low = 0u;
+    size_t high;
+
+    if (timeline == NULL || out_frame == NULL || timeline->rows_by_position == NULL) {
+        return 0;
+    }
+    // First entry not ordered before (order, row).
+    high = timeline->row_count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2u;
+        const VTXCPlayerTimelineRow *entry = &timeline->rows[timeline->rows_by_position[middle]];
+        if (entry->order < order || (entry->order == order && entry->row < row)) {
+            low = middle + 1u;
+        } else {
+            high = middle;
+        }
+    }
+    if (low == timeline->row_count) {
+        return 0;
+    }
+    {
+        const VTXCPlayerTimelineRow *entry = &timeline->rows[timeline->rows_by_position[low]];
+        if (entry->order != order || entry->row != row) {
+            return 0;
+        }
+        *out_frame = entry->start_frame;
+    }
+    return 1;
+}
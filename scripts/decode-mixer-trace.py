@@ -0,0 +1,298 @@
+#!/usr/bin/env python3
+"""Decode binary MixerCore event traces into JSONL records or a summary."""
+
+from __future__ import annotations
+
+import argparse
+import json
+import statistics
+import struct
+import sys
+from collections import Counter, defaultdict
+from pathlib import Path
+from typing import Any, Iterator
+
+
+FLOAT_DIGITS = 9
+MAGIC = b"VTXTRACE"
+HEADER = struct.Struct("<8sIIIIQ")
+RECORD = struct.Struct("<QHHIIIff")
+SUPPORTED_VERSION = 1
+NO_VALUE = 0xFFFFFFFF
+
+KIND_NAMES = {
+    1: "render_begin",
+    2: "render_end",
+    3: "voice_start",
+    4: "voice_stop",
+    5: "voice_steal",
+    6: "voice_end",
+    7: "key_off",
+    8: "event_apply",
+    9: "ramp",
+}
+FLAG_GAIN = 1 << 0
+FLAG_PAN = 1 << 1
+FLAG_STEP = 1 << 2
+FLAG_RAMPED = 1 << 3
+
+
+class TraceDecodeError(Exception):
+    """A user-facing mixer trace decode error."""
+
+
+def rounded(value: float) -> float:
+    return round(float(value), FLOAT_DIGITS)
+
+
+def load_trace(path: Path) -> tuple[dict[str, Any], bytes]:
+    if not path.exists():
+        raise TraceDecodeError(f"missing mixer trace: {path}")
+    if not path.is_file():
+        raise TraceDecodeError(f"mixer trace is not a file: {path}")
+    data = path.read_bytes()
+    if len(data) < HEADER.size:
+        raise TraceDecodeError(f"malformed mixer trace: {path}: truncated header")
+    magic, version, record_size, sample_rate, channel_count, dropped = HEADER.unpack_from(data)
+    if magic != MAGIC:
+        raise TraceDecodeError(f"malformed mixer trace: {path}: bad magic")
+    if version != SUPPORTED_VERSION or record_size != RECORD.size:
+        raise TraceDecodeError(
+            f"unsupported mixer trace: {path}: version {version}, record size {record_size}"
+        )
+    body = data[HEADER.size:]
+    if len(body) % RECORD.size != 0:
+        raise TraceDecodeError(f"malformed mixer trace: {path}: truncated record")
+    header = {
+        "version": version,
+        "sample_rate": sample_rate,
+        "channel_count": channel_count,
+        "dropped_records": dropped,
+        "records": len(body) // RECORD.size,
+    }
+    return header, body
+
+
+def decode_record(fields: tuple[Any, ...]) -> dict[str, Any]:
+    frame, kind, flags, voice, channel_tag, count, value_a, value_b = fields
+    name = KIND_NAMES.get(kind, f"unknown_{kind}")
+    record: dict[str, Any] = {
+        "frame": frame,
+        "kind": name,
+        "voice": None if voice == NO_VALUE else voice,
+        "channel_tag": None if channel_tag == NO_VALUE else channel_tag,
+    }
+    if name == "render_begin":
+        record["frames"] = count
+    elif name == "render_end":
+        record["peak"] = rounded(value_a)
+        record["rms"] = rounded(value_b)
+    elif name == "voice_start":
+        record["sample_frames"] = count
+        record["gain"] = rounded(value_a)
+        record["pan"] = rounded(value_b)
+    elif name == "voice_steal":
+        record["ramp_frames"] = count
+        record["gain"] = rounded(value_a)
+    elif name == "event_apply":
+        if flags & FLAG_STEP:
+            record["sample_step"] = rounded(value_a)
+        else:
+            if flags & FLAG_GAIN:
+                record["gain"] = rounded(value_a)
+            if flags & FLAG_PAN:
+                record["pan"] = rounded(value_b)
+            record["ramped"] = bool(flags & FLAG_RAMPED)
+    elif name == "ramp":
+        record["target"] = "pan" if flags & FLAG_PAN else "gain"
+        record["ramp_frames"] = count
+        record["start"] = rounded(value_a)
+        record["end"] = rounded(value_b)
+    return record
+
+
+def decode_records(body: bytes) -> Iterator[dict[str, Any]]:
+    """Yields records in frame order.
+
+    The mixer writes end and key-off records after the render that produced
+    them, so records between a render's begin and end are stably sorted by
+    frame. Everything else keeps the order it was written in.
+    """
+    pending: list[dict[str, Any]] = []
+    in_render = False
+    for fields in RECORD.iter_unpack(body):
+        record = decode_record(fields)
+        if record["kind"] == "render_begin":
+            yield from pending
+            pending = []
+            in_render = True
+            yield record
+        elif record["kind"] == "render_end" and in_render:
+            pending.sort(key=lambda item: item["frame"])
+            yield from pending
+            pending = []
+            in_render = False
+            yield record
+        elif in_render:
+            pending.append(record)
+        else:
+            yield record
+    yield from pending
+
+
+def build_summary(header: dict[str, Any], records: list[dict[str, Any]]) -> dict[str, Any]:
+    kind_counts = Counter(record["kind"] for record in records)
+    renders = [record for record in records if record["kind"] == "render_begin"]
+    render_ends = [record for record in records if record["kind"] == "render_end"]
+    starts: dict[int, int] = {}
+    lifetimes: list[int] = []
+    channels: dict[str, Counter[str]] = defaultdict(Counter)
+    active: set[int] = set()
+    max_active_voices = 0
+    ends_without_start = 0
+    render_gaps = 0
+    expected_frame: int | None = None
+
+    for record in records:
+        kind = record["kind"]
+        voice = record["voice"]
+        if record["channel_tag"] is not None:
+            channels[str(record["channel_tag"])][kind] += 1
+        if kind == "render_begin":
+            if expected_frame is not None and record["frame"] != expected_frame:
+                render_gaps += 1
+            expected_frame = record["frame"] + record["frames"]
+        elif kind == "voice_start":
+            starts[voice] = record["frame"]
+            active.add(voice)
+            max_active_voices = max(max_active_voices, len(active))
+        elif kind in ("voice_end", "voice_stop"):
+            start_frame = starts.pop(voice, None)
+            if start_frame is None:
+                ends_without_start += 1
+            else:
+                lifetimes.append(max(0, record["frame"] - start_frame))
+            active.discard(voice)
+
+    lifetime_summary = None
+    if lifetimes:
+        lifetime_summary = {
+            "min_frames": min(lifetimes),
+            "median_frames": rounded(statistics.median(lifetimes)),
+            "max_frames": max(lifetimes),
+        }
+    first_frame = renders[0]["frame"] if renders else None
+    last_frame = render_ends[-1]["frame"] if render_ends else None
+    sample_rate = header["sample_rate"]
+    return {
+        "header": header,
+        "kind_counts": dict(sorted(kind_counts.items())),
+        "render_calls": len(renders),
+        "rendered_frames": sum(record["frames"] for record in renders),
+        "first_frame": first_frame,
+        "last_frame": last_frame,
+        "seconds": (
+            rounded((last_frame - first_frame) / sample_rate)
+            if first_frame is not None and last_frame is not None and sample_rate > 0
+            else None
+        ),
+        "render_gaps": render_gaps,
+        "peak": max((record["peak"] for record in render_ends), default=0.0),
+        "max_active_voices": max_active_voices,
+        "voices_still_active": len(active),
+        "ends_without_start": ends_without_start,
+        "voice_lifetime": lifetime_summary,
+        "channels": {
+            tag: dict(sorted(counts.items()))
+            for tag, counts in sorted(channels.items(), key=lambda item: int(item[0]))
+        },
+    }
+
+
+def build_markdown(summary: dict[str, Any]) -> str:
+    header = summary["header"]
+    lines = [
+        "# Mixer Trace Summary",
+        "",
+        f"- Records: {header['records']} ({header['dropped_records']} dropped)",
+        f"- Sample rate: {header['sample_rate']} Hz, {header['channel_count']} channels",
+        f"- Render calls: {summary['render_calls']} covering {summary['rendered_frames']} frames",
+        f"- Render gaps: {summary['render_gaps']}",
+        f"- Peak: {summary['peak']}",
+        f"- Max active voices: {summary['max_active_voices']}",
+        f"- Voices still active: {summary['voices_still_active']}",
+        f"- Ends without a traced start: {summary['ends_without_start']}",
+    ]
+    lifetime = summary["voice_lifetime"]
+    if lifetime is not None:
+        lines.append(
+            f"- Voice lifetime frames: min {lifetime['min_frames']}, "
+            f"median {lifetime['median_frames']}, max {lifetime['max_frames']}"
+        )
+    lines += ["", "## Records", "", "| Kind | Count |", "| --- | ---: |"]
+    for kind, count in summary["kind_counts"].items():
+        lines.append(f"| {kind} | {count} |")
+    if summary["channels"]:
+        kinds = ["voice_start", "voice_steal", "voice_stop", "voice_end", "key_off", "event_apply"]
+        lines += [
+            "",
+            "## Channel Tags",
+            "",
+            "| Tag | " + " | ".join(kinds) + " |",
+            "| ---: | " + " | ".join("---:" for _ in kinds) + " |",
+        ]
+        for tag, counts in summary["channels"].items():
+            lines.append(f"| {tag} | " + " | ".join(str(counts.get(kind, 0)) for kind in kinds) + " |")
+    return "\n".join(lines) + "\n"
+
+
+def write_jsonl(path: str, records: list[dict[str, Any]]) -> None:
+    text = "".join(json.dumps(record, sort_keys=True) + "\n" for record in records)
+    if path == "-":
+        sys.stdout.write(text)
+        return
+    Path(path).parent.mkdir(parents=True, exist_ok=True)
+    Path(path).write_text(text, encoding="utf-8")
+
+
+def write_json(path: Path, summary: dict[str, Any]) -> None:
+    path.parent.mkdir(parents=True, exist_ok=True)
+    path.write_text(json.dumps(summary, indent=2, sort_keys=True) + "\n", encoding="utf-8")
+
+
+def parse_args(argv: list[str]) -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("trace", type=Path, help="Binary mixer trace, e.g. from vtx_render --trace")
+    parser.add_argument("--jsonl", help="Write decoded records as JSONL to this path, or - for stdout")
+    parser.add_argument("--json", dest="json_report", type=Path, help="Optional JSON summary output path")
+    parser.add_argument("--markdown", type=Path, help="Optional Markdown summary output path")
+    return parser.parse_args(argv)
+
+
+def main(argv: list[str]) -> int:
+    args = parse_args(argv)
+    try:
+        header, body = load_trace(args.trace)
+    except TraceDecodeError as error:
+        print(f"error: {error}", file=sys.stderr)
+        return 2
+
+    records = list(decode_records(body))
+    if args.jsonl:
+        write_jsonl(args.jsonl, records)
+    if not args.json_report and not args.markdown and args.jsonl:
+        return 0
+    summary = build_summary(header, records)
+    markdown = build_markdown(summary)
+    if args.json_report:
+        write_json(args.json_report, summary)
+    if args.markdown:
+        args.markdown.parent.mkdir(parents=True, exist_ok=True)
+        args.markdown.write_text(markdown, encoding="utf-8")
+    if not args.json_report and not args.markdown:
+        print(markdown, end="")
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main(sys.argv[1:]))
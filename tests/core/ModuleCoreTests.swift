@@ -1,6 +1,7 @@
 import Foundation
 import XCTest
 import ModuleCore
+import PlayerCore
 
 final class ModuleCoreTests: XCTestCase {
     func testParseSyntheticMODHeaderSelectedFields() throws {
@@ -54,6 +55,143 @@ final class ModuleCoreTests: XCTestCase {
         XCTAssertEqual(cString(info.first_instrument_name), "BASS")
     }
 
+    func testModuleHandleExposesDenseXMPatternGrids() throws {
+        guard let handle = mc_module_open(try fixturePath("minimal.xm"), nil, 0) else {
+            return XCTFail("mc_module_open failed")
+        }
+        defer { mc_module_close(handle) }
+
+        let header = try XCTUnwrap(mc_module_get_header(handle)).pointee
+        XCTAssertEqual(header.channels, 4)
+        XCTAssertEqual(cString(header.first_instrument_name), "BASS")
+        var orderCount: UInt16 = 0
+        let orders = try XCTUnwrap(mc_module_order_table(handle, &orderCount))
+        XCTAssertEqual(Array(UnsafeBufferPointer(start: orders, count: Int(orderCount))), [0, 1, 0])
+
+        XCTAssertEqual(mc_module_pattern_count(handle), 2)
+        XCTAssertEqual(mc_module_pattern_rows(handle, 1), 4)
+        XCTAssertEqual(mc_module_pattern_packed_size(handle, 1), 28)
+        let cells = try XCTUnwrap(mc_module_pattern_cells(handle, 1))
+        XCTAssertEqual(cells[1 * 4 + 2].note, 59)
+        XCTAssertEqual(cells[2 * 4 + 0].effect_type, 11)
+        XCTAssertEqual(cells[2 * 4 + 0].effect_param, 2)
+        XCTAssertEqual(cells[0 * 4 + 1].note, 0)
+        XCTAssertEqual(mc_module_pattern_cell(handle, 0, 3, 3).volume, 40)
+        XCTAssertEqual(mc_module_pattern_cell(handle, 0, 4, 0).note, 0)
+        XCTAssertNil(mc_module_pattern_cells(handle, 2))
+    }
+
+    func testLazyModuleHandleDecodesPatternsOnDemand() throws {
+        var bytes = try Data(contentsOf: URL(fileURLWithPath: try fixturePath("minimal.xm")))
+        // First packing byte of pattern 1: claim all five fields so the
+        // packed data no longer decodes to exactly its declared size.
+        bytes[383] = 0x9F
+        let tmpURL = URL(fileURLWithPath: NSTemporaryDirectory()).appendingPathComponent("mc_lazy.xm")
+        try bytes.write(to: tmpURL)
+        defer { try? FileManager.default.removeItem(at: tmpURL) }
+
+        XCTAssertEqual(mc_parse_file(tmpURL.path).ok, 0)
+        var options = mc_module_open_options()
+        options.flags = UInt32(MC_MODULE_OPEN_EAGER_PATTERNS)
+        XCTAssertNil(mc_module_open_with_options(tmpURL.path, &options, nil, 0))
+        options.flags = UInt32(MC_MODULE_OPEN_PARALLEL_PATTERNS)
+        options.decode_threads = 4
+        XCTAssertNil(mc_module_open_with_options(tmpURL.path, &options, nil, 0))
+
+        options = mc_module_open_options()
+        options.pattern_cache_capacity = 1
+        guard let handle = mc_module_open_with_options(tmpURL.path, &options, nil, 0) else {
+            return XCTFail("lazy open failed")
+        }
+        defer { mc_module_close(handle) }
+        XCTAssertEqual(mc_module_pattern_count(handle), 2)
+        XCTAssertEqual(mc_module_pattern_packed_size(handle, 1), 28)
+
+        var cells: UnsafePointer<mc_pattern_cell>?
+        XCTAssertEqual(mc_module_load_pattern(handle, 0, &cells), 1)
+        XCTAssertEqual(cells?[0].note, 48)
+        XCTAssertEqual(mc_module_load_pattern(handle, 1, &cells), 0)
+        XCTAssertNil(cells)
+        XCTAssertEqual(mc_module_pattern_cell(handle, 0, 3, 3).note, 55)
+        XCTAssertNil(mc_module_get_info(handle))
+
+        var failed: UInt16 = 0
+        XCTAssertEqual(mc_module_decode_patterns(handle, 4, nil, &failed), 0)
+        XCTAssertEqual(failed, 1)
+    }
+
+    func testParallelPatternDecodeMatchesSerialDecode() throws {
+        let path = try fixturePath("minimal.xm")
+        var options = mc_module_open_options()
+        options.flags = UInt32(MC_MODULE_OPEN_EAGER_PATTERNS)
+        guard let serial = mc_module_open_with_options(path, &options, nil, 0) else {
+            return XCTFail("serial open failed")
+        }
+        defer { mc_module_close(serial) }
+        options.flags = UInt32(MC_MODULE_OPEN_PARALLEL_PATTERNS)
+        options.decode_threads = 4
+        guard let parallel = mc_module_open_with_options(path, &options, nil, 0) else {
+            return XCTFail("parallel open failed")
+        }
+        defer { mc_module_close(parallel) }
+        guard let lazy = mc_module_open(path, nil, 0) else {
+            return XCTFail("lazy open failed")
+        }
+        defer { mc_module_close(lazy) }
+
+        // Runs the tasks backwards on the calling thread, standing in for a
+        // caller-owned pool that finishes patterns out of order.
+        var executor = mc_pattern_executor(
+            parallel_for: { _, count, task, taskContext in
+                for index in (0..<count).reversed() {
+                    task?(taskContext, index)
+                }
+            },
+            context: nil
+        )
+        var failed: UInt16 = 0
+        XCTAssertEqual(mc_module_decode_patterns(lazy, 0, &executor, &failed), 1)
+
+        for handle in [parallel, lazy] {
+            XCTAssertEqual(mc_module_pattern_count(handle), 2)
+            for pattern in 0..<UInt16(2) {
+                let byteCount = Int(mc_module_pattern_rows(serial, pattern)) * 4 * MemoryLayout<mc_pattern_cell>.stride
+                let expected = try XCTUnwrap(mc_module_pattern_cells(serial, pattern))
+                let actual = try XCTUnwrap(mc_module_pattern_cells(handle, pattern))
+                XCTAssertEqual(memcmp(expected, actual, byteCount), 0)
+            }
+        }
+    }
+
+    func testModuleHandleKeepsEventsPastTheSummaryCap() throws {
+        let channels = 40
+        let rows = 64
+        let packed = [UInt8](repeating: 0, count: rows * channels).flatMap { _ in [UInt8(0x81), 49] }
+
+        var bytes = Array("Extended Module: ".utf8) + [UInt8](repeating: 0, count: 20) + [0x1A]
+        bytes += [UInt8](repeating: 0, count: 20) + le16(0x0104)
+        bytes += le32(276) + le16(1) + le16(0) + le16(channels) + le16(1) + le16(0) + le16(1) + le16(6) + le16(125)
+        bytes += [UInt8](repeating: 0, count: 256)
+        bytes += le32(9) + [0] + le16(rows) + le16(packed.count) + packed
+
+        let tmpURL = URL(fileURLWithPath: NSTemporaryDirectory()).appendingPathComponent("mc_dense.xm")
+        try Data(bytes).write(to: tmpURL)
+        defer { try? FileManager.default.removeItem(at: tmpURL) }
+
+        let info = mc_parse_file(tmpURL.path)
+        XCTAssertEqual(info.ok, 1)
+        XCTAssertEqual(Int(info.xm_event_count), Int(MC_MAX_XM_EVENTS))
+        XCTAssertEqual(cString(info.warning), "xm events truncated at 2048 entries")
+
+        guard let handle = mc_module_open(tmpURL.path, nil, 0) else {
+            return XCTFail("mc_module_open failed")
+        }
+        defer { mc_module_close(handle) }
+        let cells = try XCTUnwrap(mc_module_pattern_cells(handle, 0))
+        let notes = UnsafeBufferPointer(start: cells, count: rows * channels).map(\.note)
+        XCTAssertEqual(notes, [UInt8](repeating: 49, count: rows * channels))
+    }
+
     func testGoldenSnapshotMOD() throws {
         let info = mc_parse_file(try fixturePath("minimal.mod"))
         XCTAssertEqual(normalize(snapshotJSON(info)), normalize(try goldenString("minimal.mod.json")))
@@ -98,6 +236,578 @@ final class ModuleCoreTests: XCTestCase {
         XCTAssertFalse(cString(info.error).isEmpty)
     }
 
+    func testMODPatternsAndSamplesDecodeIntoTheSharedGrid() throws {
+        var bytes = [UInt8](repeating: 0, count: 1084)
+        bytes.replaceSubrange(0..<8, with: Array("FULL MOD".utf8))
+        bytes.replaceSubrange(20..<24, with: Array("BASS".utf8))
+        bytes.replaceSubrange(42..<50, with: [0, 4, 0x0F, 70, 0, 1, 0, 2])
+        bytes[950] = 1
+        bytes[951] = 0x7F
+        bytes.replaceSubrange(1080..<1084, with: Array("M.K.".utf8))
+        var pattern = [UInt8](repeating: 0, count: 1024)
+        // Row 0: period 428 (ProTracker C-2), sample 1, effect C20.
+        pattern.replaceSubrange(0..<4, with: [0x01, 0xAC, 0x1C, 0x20])
+        // Row 5, channel 3: period 113 (B-3), sample 17, effect F7D.
+        pattern.replaceSubrange(92..<96, with: [0x10, 0x71, 0x1F, 0x7D])
+        bytes += pattern + [1, 2, 3, 4, 0xFF, 0xFE]
+
+        let tmpURL = URL(fileURLWithPath: NSTemporaryDirectory()).appendingPathComponent("mc_full.mod")
+        try Data(bytes).write(to: tmpURL)
+        defer { try? FileManager.default.removeItem(at: tmpURL) }
+        guard let module = mc_module_open(tmpURL.path, nil, 0) else {
+            return XCTFail("mc_module_open failed")
+        }
+        defer { mc_module_close(module) }
+
+        XCTAssertEqual(mc_module_pattern_count(module), 1)
+        XCTAssertEqual(mc_module_pattern_rows(module, 0), 64)
+        let first = mc_module_pattern_cell(module, 0, 0, 0)
+        XCTAssertEqual(first.note, 49)
+        XCTAssertEqual(first.instrument, 1)
+        XCTAssertEqual(first.effect_type, 0x0C)
+        XCTAssertEqual(first.effect_param, 0x20)
+        let last = mc_module_pattern_cell(module, 0, 5, 3)
+        XCTAssertEqual(last.note, 72)
+        XCTAssertEqual(last.instrument, 17)
+        XCTAssertEqual(mc_mod_period_to_note(430), 49)
+        XCTAssertNil(mc_module_edit_pattern(module, 0))
+
+        var count: UInt16 = 0
+        let samples = try XCTUnwrap(mc_module_mod_samples(module, &count))
+        XCTAssertEqual(count, 31)
+        XCTAssertEqual(cString(samples[0].name), "BASS")
+        XCTAssertEqual(samples[0].length_bytes, 8)
+        XCTAssertEqual(samples[0].finetune, -1)
+        XCTAssertEqual(samples[0].volume, 64)
+        XCTAssertEqual(samples[0].loop_length_bytes, 4)
+        var view = mc_mod_sample_view()
+        XCTAssertEqual(mc_module_mod_sample_view(module, 0, &view), 1)
+        XCTAssertEqual(view.length_bytes, 6)
+        XCTAssertEqual(Array(UnsafeBufferPointer(start: view.data, count: view.length_bytes)), [1, 2, 3, 4, -1, -2])
+    }
+
+    func testProbeReadsHeaderFieldsWithoutThePatternData() throws {
+        let xm = mc_probe_file(try fixturePath("minimal.xm"))
+        XCTAssertEqual(xm.ok, 1)
+        XCTAssertEqual(typeName(xm.header.type), "XM")
+        let parsed = mc_parse_file(try fixturePath("minimal.xm"))
+        XCTAssertEqual(cString(xm.header.title), cString(parsed.title))
+        XCTAssertEqual(xm.header.patterns, parsed.patterns)
+        XCTAssertEqual(xm.header.default_bpm, parsed.default_bpm)
+
+        let mod = mc_probe_file(try fixturePath("minimal.mod"))
+        XCTAssertEqual(mod.ok, 1)
+        XCTAssertEqual(typeName(mod.header.type), "MOD")
+        XCTAssertEqual(mod.header.channels, 4)
+        XCTAssertEqual(cString(mod.header.first_mod_sample.name), "KICK")
+
+        // Only the header is read, so truncated pattern data still probes.
+        let module = syntheticXMModule(sampleDeltas: [1, 2, 3])
+        let tmpURL = URL(fileURLWithPath: NSTemporaryDirectory()).appendingPathComponent("mc_probe.xm")
+        try Data(module.prefix(340)).write(to: tmpURL)
+        defer { try? FileManager.default.removeItem(at: tmpURL) }
+        let truncated = mc_probe_file(tmpURL.path)
+        XCTAssertEqual(truncated.ok, 1)
+        XCTAssertEqual(truncated.file_size, 340)
+        XCTAssertEqual(cString(truncated.header.title), "SYNTH")
+        XCTAssertNil(mc_module_open(tmpURL.path, nil, 0))
+
+        try Data([0x00, 0x01, 0x02]).write(to: tmpURL)
+        let rejected = mc_probe_file(tmpURL.path)
+        XCTAssertEqual(rejected.ok, 0)
+        XCTAssertEqual(cString(rejected.error), "unsupported or invalid module header")
+        XCTAssertEqual(mc_identify_module(Array(module.prefix(64)), 64), MC_MODULE_TYPE_XM)
+    }
+
+    func testParseXMSampleHeaderConvertsSixteenBitLengthsToFrames() {
+        var bytes = [UInt8](repeating: 0, count: Int(MC_XM_SAMPLE_HEADER_SIZE))
+        bytes[0] = 21
+        bytes[4] = 6
+        bytes[8] = 40
+        bytes[12] = 48
+        bytes[13] = 0xF0
+        bytes[14] = 0x11
+        bytes[16] = 0xFE
+        bytes.replaceSubrange(18..<22, with: Array("SNARE".utf8.prefix(4)))
+
+        var header = mc_xm_sample_header()
+        XCTAssertEqual(mc_xm_parse_sample_header(bytes, bytes.count, &header), 1)
+        XCTAssertEqual(mc_xm_parse_sample_header(bytes, bytes.count - 1, &header), 0)
+        XCTAssertEqual(header.volume, 48)
+        XCTAssertEqual(header.finetune, -16)
+        XCTAssertEqual(header.relative_note, -2)
+        XCTAssertEqual(cString(header.name), "SNAR")
+        XCTAssertEqual(mc_xm_sample_is_16bit(&header), 1)
+        XCTAssertEqual(mc_xm_sample_loop_type(&header), 1)
+        XCTAssertEqual(mc_xm_sample_frame_count(&header), 10)
+        XCTAssertEqual(mc_xm_sample_loop_start_frame(&header), 3)
+        XCTAssertEqual(mc_xm_sample_loop_length_frames(&header), 7)
+    }
+
+    func testXMDeltaDecodeMatchesScalarWrappingAccumulation() {
+        let deltas: [UInt8] = (0..<257).map { UInt8(truncatingIfNeeded: ($0 * 37) ^ ($0 >> 2)) }
+
+        var expected8 = [Float]()
+        var accumulator8 = Int8(0)
+        for delta in deltas {
+            accumulator8 = accumulator8 &+ Int8(bitPattern: delta)
+            expected8.append(Float(accumulator8) / 128.0)
+        }
+        var decoded8 = [Float](repeating: 0, count: deltas.count)
+        mc_xm_delta_decode_8_to_float(deltas, deltas.count, &decoded8)
+        XCTAssertEqual(decoded8, expected8)
+
+        let wordCount = deltas.count / 2
+        var expected16 = [Int16]()
+        var accumulator16 = Int16(0)
+        for index in 0..<wordCount {
+            let delta = Int16(bitPattern: UInt16(deltas[index * 2]) | (UInt16(deltas[index * 2 + 1]) << 8))
+            accumulator16 = accumulator16 &+ delta
+            expected16.append(accumulator16)
+        }
+        var decoded16 = [Int16](repeating: 0, count: wordCount)
+        mc_xm_delta_decode_16(deltas, wordCount, &decoded16)
+        XCTAssertEqual(decoded16, expected16)
+
+        var header = mc_xm_sample_header()
+        header.length_bytes = UInt32(deltas.count)
+        header.type = UInt8(MC_XM_SAMPLE_TYPE_16BIT)
+        var pcm = [Float](repeating: 0, count: wordCount)
+        XCTAssertEqual(mc_xm_decode_sample_float(&header, deltas, deltas.count, &pcm, pcm.count), 1)
+        XCTAssertEqual(pcm, expected16.map { Float($0) / 32768.0 })
+        XCTAssertEqual(mc_xm_decode_sample_float(&header, deltas, deltas.count - 1, &pcm, pcm.count), 0)
+    }
+
+    func testXMPatternDecodeMixesRawPackedAndEmptyCells() {
+        // Three rows of two channels; the last row is short enough to take the
+        // per-cell bounds-checked path.
+        let packed: [UInt8] = [
+            49, 1, 0x40, 0x0F, 0x06, 0x80,
+            0x83, 50, 2, 0x98, 0x0C, 0x20,
+            0x80, 0x9F, 51, 3, 0x30, 0x0A, 0x01,
+        ]
+        var cells = [mc_pattern_cell](repeating: mc_pattern_cell(), count: 6)
+        XCTAssertEqual(mc_xm_decode_pattern(packed, packed.count, 3, 2, &cells), 1)
+
+        let decoded = cells.map { [$0.note, $0.instrument, $0.volume, $0.effect_type, $0.effect_param] }
+        XCTAssertEqual(decoded, [
+            [49, 1, 0x40, 0x0F, 0x06], [0, 0, 0, 0, 0],
+            [50, 2, 0, 0, 0], [0, 0, 0, 0x0C, 0x20],
+            [0, 0, 0, 0, 0], [51, 3, 0x30, 0x0A, 0x01],
+        ])
+        XCTAssertEqual(mc_xm_decode_pattern(packed, packed.count - 1, 3, 2, &cells), 0)
+        XCTAssertEqual(mc_xm_decode_pattern(packed + [0x80], packed.count + 1, 3, 2, &cells), 0)
+    }
+
+    func testParseXMInstrumentsExposesKeymapEnvelopeAndSampleViews() {
+        let module = syntheticXMModule(sampleDeltas: [4, 4, 0xF8, 0x7F])
+        var table = mc_xm_instrument_table()
+        XCTAssertEqual(mc_xm_parse_instruments(module, module.count, &table), 1)
+        defer { mc_xm_instrument_table_free(&table) }
+
+        XCTAssertEqual(table.instrument_count, 1)
+        XCTAssertEqual(table.sample_count, 1)
+        XCTAssertEqual(cString(table.warning), "")
+        let instrument = table.instruments[0]
+        XCTAssertEqual(cString(instrument.name), "LEAD")
+        XCTAssertEqual(instrument.has_keymap, 1)
+        XCTAssertEqual(withUnsafeBytes(of: instrument.keymap) { $0[95] }, 0)
+        XCTAssertEqual(instrument.has_envelopes, 1)
+        XCTAssertEqual(instrument.volume_envelope.point_count, 2)
+        XCTAssertEqual(instrument.volume_envelope.points.1.tick, 16)
+        XCTAssertEqual(instrument.volume_envelope.points.1.value, 32)
+        XCTAssertEqual(instrument.volume_envelope.flags, UInt8(MC_XM_ENVELOPE_ON))
+        XCTAssertEqual(instrument.vibrato_depth, 5)
+        XCTAssertEqual(instrument.fadeout, 512)
+
+        let sample = table.samples[0]
+        XCTAssertEqual(sample.header.length_bytes, 4)
+        XCTAssertEqual(sample.data_offset, module.count - 4)
+        XCTAssertEqual(sample.data_in_bounds, 1)
+
+        var view = mc_xm_sample_view()
+        module.withUnsafeBufferPointer { bytes in
+            XCTAssertEqual(mc_xm_sample_view_at(&table, bytes.baseAddress, bytes.count, 0, &view), 1)
+            XCTAssertEqual(view.data, bytes.baseAddress.map { $0 + (bytes.count - 4) })
+        }
+        XCTAssertEqual(view.length_bytes, 4)
+
+        var truncated = mc_xm_instrument_table()
+        XCTAssertEqual(mc_xm_parse_instruments(module, module.count - 2, &truncated), 1)
+        defer { mc_xm_instrument_table_free(&truncated) }
+        XCTAssertEqual(truncated.instrument_count, 1)
+        XCTAssertEqual(truncated.samples[0].data_in_bounds, 0)
+    }
+
+    func testModuleHandleMapsFileAndServesSampleViewsFromIt() throws {
+        let module = syntheticXMModule(sampleDeltas: [4, 4, 0xF8, 0x7F])
+        let tmpURL = URL(fileURLWithPath: NSTemporaryDirectory()).appendingPathComponent("mc_handle.xm")
+        try Data(module).write(to: tmpURL)
+        defer { try? FileManager.default.removeItem(at: tmpURL) }
+
+        guard let handle = mc_module_open(tmpURL.path, nil, 0) else {
+            return XCTFail("mc_module_open failed")
+        }
+        defer { mc_module_close(handle) }
+
+        XCTAssertEqual(mc_module_is_mapped(handle), 1)
+        let header = try XCTUnwrap(mc_module_get_header(handle)).pointee
+        XCTAssertEqual(typeName(header.type), "XM")
+        XCTAssertEqual(cString(header.title), "SYNTH")
+
+        var size = 0
+        let bytes = try XCTUnwrap(mc_module_bytes(handle, &size))
+        XCTAssertEqual(size, module.count)
+        XCTAssertEqual(Array(UnsafeBufferPointer(start: bytes, count: size)), module)
+
+        let table = try XCTUnwrap(mc_module_xm_instruments(handle)).pointee
+        XCTAssertEqual(table.instrument_count, 1)
+        XCTAssertEqual(table.sample_count, 1)
+        var view = mc_xm_sample_view()
+        XCTAssertEqual(mc_module_xm_sample_view(handle, 0, &view), 1)
+        XCTAssertEqual(view.data, bytes + (size - 4))
+        XCTAssertEqual(view.length_bytes, 4)
+        XCTAssertEqual(mc_module_xm_sample_view(handle, 1, &view), 0)
+
+        var error = [CChar](repeating: 0, count: 128)
+        XCTAssertNil(mc_module_open(tmpURL.path + ".missing", &error, error.count))
+        XCTAssertTrue(String(cString: error).hasPrefix("open failed"))
+    }
+
+    func testXMWriterRepacksEditedPatternsAndCopiesTheRest() throws {
+        let module = syntheticXMModule(sampleDeltas: [4, 4, 0xF8, 0x7F])
+        let tmpURL = URL(fileURLWithPath: NSTemporaryDirectory()).appendingPathComponent("mc_writer.xm")
+        let savedURL = URL(fileURLWithPath: NSTemporaryDirectory()).appendingPathComponent("mc_writer_saved.xm")
+        try Data(module).write(to: tmpURL)
+        defer {
+            try? FileManager.default.removeItem(at: tmpURL)
+            try? FileManager.default.removeItem(at: savedURL)
+        }
+
+        guard let handle = mc_module_open(tmpURL.path, nil, 0) else {
+            return XCTFail("mc_module_open failed")
+        }
+        defer { mc_module_close(handle) }
+        var error = [CChar](repeating: 0, count: 128)
+        XCTAssertEqual(mc_module_write_xm(handle, savedURL.path, &error, error.count), 1, String(cString: error))
+        XCTAssertEqual([UInt8](try Data(contentsOf: savedURL)), module)
+
+        let cells = try XCTUnwrap(mc_module_edit_pattern(handle, 0))
+        cells[1] = mc_pattern_cell(note: 49, instrument: 1, volume: 0, effect_type: 0, effect_param: 0)
+        let instrument = try XCTUnwrap(mc_module_edit_xm_instrument(handle, 0))
+        withUnsafeMutableBytes(of: &instrument.pointee.name) { name in
+            name.copyBytes(from: Array("BASS".utf8) + [0])
+        }
+        try XCTUnwrap(mc_module_edit_xm_sample(handle, 0)).pointee.volume = 40
+        XCTAssertEqual(mc_module_pattern_is_dirty(handle, 0), 1)
+        XCTAssertEqual(mc_module_xm_instrument_is_dirty(handle, 0), 1)
+        XCTAssertEqual(mc_module_write_xm(handle, savedURL.path, &error, error.count), 1, String(cString: error))
+
+        let saved = [UInt8](try Data(contentsOf: savedURL))
+        XCTAssertEqual(saved.count, module.count + 4)
+        XCTAssertEqual(Array(saved.suffix(4)), [4, 4, 0xF8, 0x7F])
+        guard let reopened = mc_module_open(savedURL.path, nil, 0) else {
+            return XCTFail("reopen failed")
+        }
+        defer { mc_module_close(reopened) }
+        XCTAssertEqual(mc_module_pattern_packed_size(reopened, 0), 4)
+        XCTAssertEqual(mc_module_pattern_cell(reopened, 0, 0, 1).note, 49)
+        XCTAssertEqual(mc_module_pattern_cell(reopened, 0, 0, 0).note, 0)
+        let table = try XCTUnwrap(mc_module_xm_instruments(reopened)).pointee
+        XCTAssertEqual(cString(table.instruments[0].name), "BASS")
+        XCTAssertEqual(table.instruments[0].fadeout, 512)
+        XCTAssertEqual(table.samples[0].header.volume, 40)
+        XCTAssertEqual(cString(table.samples[0].header.name), "SAMPLE")
+
+        try XCTUnwrap(mc_module_edit_xm_sample(handle, 0)).pointee.length_bytes = 6
+        XCTAssertEqual(mc_module_write_xm(handle, savedURL.path, &error, error.count), 0)
+        XCTAssertEqual(String(cString: error), "sample 0 length cannot change")
+    }
+
+    func testSnapshotRoundTripsAndDiffsPatternCells() throws {
+        let tmpURL = URL(fileURLWithPath: NSTemporaryDirectory()).appendingPathComponent("mc_snapshot.xm")
+        try Data(syntheticXMModule(sampleDeltas: [1])).write(to: tmpURL)
+        defer { try? FileManager.default.removeItem(at: tmpURL) }
+        guard let module = mc_module_open(tmpURL.path, nil, 0) else {
+            return XCTFail("mc_module_open failed")
+        }
+        defer { mc_module_close(module) }
+        let cells = try XCTUnwrap(mc_module_edit_pattern(module, 0))
+        cells[1] = mc_pattern_cell(note: 49, instrument: 1, volume: 0x40, effect_type: 0x0C, effect_param: 0x20)
+
+        var original = mc_module_snapshot()
+        var error = [CChar](repeating: 0, count: 128)
+        XCTAssertEqual(mc_snapshot_capture(module, &original, &error, error.count), 1, String(cString: error))
+        defer { mc_snapshot_free(&original) }
+        XCTAssertEqual(original.event_count, 1)
+        XCTAssertEqual(original.events[0].channel, 1)
+
+        var data: UnsafeMutablePointer<UInt8>?
+        var size = 0
+        XCTAssertEqual(mc_snapshot_encode(&original, &data, &size), 1)
+        defer { free(data) }
+        XCTAssertEqual(mc_snapshot_is_encoded(data, size), 1)
+        var decoded = mc_module_snapshot()
+        XCTAssertEqual(mc_snapshot_decode(data, size, &decoded, &error, error.count), 1, String(cString: error))
+        defer { mc_snapshot_free(&decoded) }
+        XCTAssertEqual(mc_snapshot_diff(&original, &decoded, nil, nil), 0)
+        var truncated = mc_module_snapshot()
+        XCTAssertEqual(mc_snapshot_decode(data, size - 1, &truncated, &error, error.count), 0)
+        XCTAssertEqual(String(cString: error), "snapshot truncated")
+
+        cells[0].note = 1
+        cells[1].effect_param = 0x30
+        var edited = mc_module_snapshot()
+        XCTAssertEqual(mc_snapshot_capture(module, &edited, &error, error.count), 1)
+        defer { mc_snapshot_free(&edited) }
+        XCTAssertEqual(mc_snapshot_diff(&original, &edited, nil, nil), 2)
+    }
+
+    func testPlayerRendersSharedSampleVoicesUntilTheSongEnds() throws {
+        let tmpURL = URL(fileURLWithPath: NSTemporaryDirectory()).appendingPathComponent("vtx_player.xm")
+        try Data(syntheticXMModule(sampleDeltas: [0x40, 0, 0, 0x80])).write(to: tmpURL)
+        defer { try? FileManager.default.removeItem(at: tmpURL) }
+        guard let module = mc_module_open(tmpURL.path, nil, 0) else {
+            return XCTFail("mc_module_open failed")
+        }
+        defer { mc_module_close(module) }
+        let cells = try XCTUnwrap(mc_module_edit_pattern(module, 0))
+        cells[0] = mc_pattern_cell(note: 49, instrument: 1, volume: 0x50, effect_type: 0, effect_param: 0)
+
+        var bank: OpaquePointer?
+        XCTAssertEqual(vtx_c_player_sample_bank_create(module, &bank), VTX_C_PLAYER_STATUS_OK)
+        defer { vtx_c_player_sample_bank_free(bank) }
+        XCTAssertEqual(vtx_c_player_sample_bank_sample_count(bank), 1)
+        XCTAssertEqual(vtx_c_player_sample_bank_byte_count(bank), 4 * MemoryLayout<Float>.size)
+
+        var config = vtx_c_player_default_config()
+        config.sample_rate = 44_100
+        var player: OpaquePointer?
+        XCTAssertEqual(vtx_c_player_create(module, bank, config, &player), VTX_C_PLAYER_STATUS_OK)
+        defer { vtx_c_player_free(player) }
+
+        // One row at speed 6 and 125 BPM is six ticks of 882 frames.
+        var output = [Float](repeating: 0, count: 2 * 8192)
+        var rendered: UInt32 = 0
+        XCTAssertEqual(vtx_c_player_render(player, &output, 8192, &rendered), VTX_C_PLAYER_STATUS_OK)
+        XCTAssertEqual(rendered, 5292)
+        XCTAssertEqual(vtx_c_player_has_ended(player), 1)
+        XCTAssertGreaterThan(output[0], 0.4)
+        XCTAssertGreaterThan(output[1], 0.4)
+        XCTAssertEqual(vtx_c_mixer_sample_allocation_count(vtx_c_player_mixer(player)), 0)
+        XCTAssertEqual(vtx_c_player_dropped_note_count(player), 0)
+    }
+
+    func testPlayerSilencesTheChannelOnANoteWithoutASample() throws {
+        let tmpURL = URL(fileURLWithPath: NSTemporaryDirectory()).appendingPathComponent("vtx_player_silence.xm")
+        try Data(syntheticXMModule(sampleDeltas: [0x40, 0, 0, 0], rows: 2, forwardLoop: true)).write(to: tmpURL)
+        defer { try? FileManager.default.removeItem(at: tmpURL) }
+        guard let module = mc_module_open(tmpURL.path, nil, 0) else {
+            return XCTFail("mc_module_open failed")
+        }
+        defer { mc_module_close(module) }
+        // Channel 0 of the two: the looping sample would sound through both
+        // rows; instrument 2 does not exist.
+        let cells = try XCTUnwrap(mc_module_edit_pattern(module, 0))
+        cells[0 * 2 + 0] = mc_pattern_cell(note: 49, instrument: 1, volume: 0x50, effect_type: 0, effect_param: 0)
+        cells[1 * 2 + 0] = mc_pattern_cell(note: 49, instrument: 2, volume: 0x50, effect_type: 0, effect_param: 0)
+
+        var config = vtx_c_player_default_config()
+        config.sample_rate = 44_100
+        var player: OpaquePointer?
+        XCTAssertEqual(vtx_c_player_create(module, nil, config, &player), VTX_C_PLAYER_STATUS_OK)
+        defer { vtx_c_player_free(player) }
+        var output = [Float](repeating: 0, count: 2 * 16_384)
+        var rendered: UInt32 = 0
+        XCTAssertEqual(vtx_c_player_render(player, &output, 16_384, &rendered), VTX_C_PLAYER_STATUS_OK)
+        XCTAssertEqual(rendered, 2 * 5292)
+        XCTAssertGreaterThan(output[2 * 5000], 0.4)
+        let rampEnd = 5292 + Int(vtx_c_mixer_replacement_stop_ramp_frame_count())
+        XCTAssertEqual(output[(2 * rampEnd)..<(2 * Int(rendered))].map { abs($0) }.max(), 0)
+    }
+
+    func testPlayerKeepsTheOctaveOfMODNotesOutsideTheSlideLimits() throws {
+        // Period 1712 (C-0) lies below ProTracker's slide limit of 856 (C-1)
+        // and must still sound an octave lower.
+        func risingEdges(period: Int) throws -> Int {
+            var bytes = [UInt8](repeating: 0, count: 1084)
+            bytes.replaceSubrange(20..<24, with: Array("SQR ".utf8))
+            bytes.replaceSubrange(42..<50, with: [0, 4, 0, 64, 0, 0, 0, 4])
+            bytes[950] = 1
+            bytes[951] = 0x7F
+            bytes.replaceSubrange(1080..<1084, with: Array("M.K.".utf8))
+            var pattern = [UInt8](repeating: 0, count: 1024)
+            pattern.replaceSubrange(0..<4, with: [UInt8(period >> 8), UInt8(period & 0xFF), 0x10, 0])
+            bytes += pattern + [0x40, 0x40, 0x40, 0x40, 0xC0, 0xC0, 0xC0, 0xC0]
+
+            let tmpURL = URL(fileURLWithPath: NSTemporaryDirectory()).appendingPathComponent("vtx_player_octave.mod")
+            try Data(bytes).write(to: tmpURL)
+            defer { try? FileManager.default.removeItem(at: tmpURL) }
+            guard let module = mc_module_open(tmpURL.path, nil, 0) else {
+                XCTFail("mc_module_open failed")
+                return 0
+            }
+            defer { mc_module_close(module) }
+            var config = vtx_c_player_default_config()
+            config.sample_rate = 44_100
+            var player: OpaquePointer?
+            XCTAssertEqual(vtx_c_player_create(module, nil, config, &player), VTX_C_PLAYER_STATUS_OK)
+            defer { vtx_c_player_free(player) }
+            var output = [Float](repeating: 0, count: 2 * 4410)
+            var rendered: UInt32 = 0
+            XCTAssertEqual(vtx_c_player_render(player, &output, 4410, &rendered), VTX_C_PLAYER_STATUS_OK)
+            return (1..<Int(rendered)).filter { output[2 * $0 - 2] <= 0 && output[2 * $0] > 0 }.count
+        }
+
+        let octave0 = try risingEdges(period: 1712)
+        let octave1 = try risingEdges(period: 856)
+        XCTAssertGreaterThan(octave1, 40)
+        XCTAssertLessThanOrEqual(abs(2 * octave0 - octave1), 2)
+    }
+
+    func testPlayerTimelineMatchesRenderedFramesAndMapsBothWays() throws {
+        guard let module = mc_module_open(try fixturePath("minimal.xm"), nil, 0) else {
+            return XCTFail("mc_module_open failed")
+        }
+        defer { mc_module_close(module) }
+        var timeline = VTXCPlayerTimeline()
+        XCTAssertEqual(vtx_c_player_timeline_build(module, 48_000, 0, &timeline), VTX_C_PLAYER_STATUS_OK)
+        defer { vtx_c_player_timeline_free(&timeline) }
+        XCTAssertEqual(timeline.row_count, 11)
+        XCTAssertEqual(timeline.total_frames, 63_360)
+        XCTAssertEqual(timeline.loop_order, 1)
+        XCTAssertEqual(timeline.loop_row, 0)
+        XCTAssertEqual(timeline.has_loop_frame, 1)
+        XCTAssertEqual(timeline.loop_frame, 23_040)
+
+        let row = try XCTUnwrap(vtx_c_player_timeline_row_at_frame(&timeline, 30_000)).pointee
+        XCTAssertEqual(row.order, 1)
+        XCTAssertEqual(row.row, 1)
+        XCTAssertEqual(row.start_frame, 28_800)
+        XCTAssertNil(vtx_c_player_timeline_row_at_frame(&timeline, timeline.total_frames))
+        var frame: UInt64 = 0
+        XCTAssertEqual(vtx_c_player_timeline_frame_of(&timeline, 2, 3, &frame), 1)
+        XCTAssertEqual(frame, 57_600)
+        XCTAssertEqual(vtx_c_player_timeline_frame_of(&timeline, 1, 3, &frame), 0)
+
+        var config = vtx_c_player_default_config()
+        config.sample_rate = 48_000
+        var player: OpaquePointer?
+        XCTAssertEqual(vtx_c_player_create(module, nil, config, &player), VTX_C_PLAYER_STATUS_OK)
+        defer { vtx_c_player_free(player) }
+        var output = [Float](repeating: 0, count: 2 * 4096)
+        var rendered: UInt32 = 0
+        var total: UInt64 = 0
+        repeat {
+            XCTAssertEqual(vtx_c_player_render(player, &output, 4096, &rendered), VTX_C_PLAYER_STATUS_OK)
+            total += UInt64(rendered)
+        } while rendered == 4096
+        XCTAssertEqual(total, timeline.total_frames)
+
+        config.start_order = 1
+        config.order_count = 1
+        var rangePlayer: OpaquePointer?
+        XCTAssertEqual(vtx_c_player_create(module, nil, config, &rangePlayer), VTX_C_PLAYER_STATUS_OK)
+        defer { vtx_c_player_free(rangePlayer) }
+        total = 0
+        repeat {
+            XCTAssertEqual(vtx_c_player_render(rangePlayer, &output, 4096, &rendered), VTX_C_PLAYER_STATUS_OK)
+            total += UInt64(rendered)
+        } while rendered == 4096
+        XCTAssertEqual(total, 40_320 - 23_040)
+    }
+
+    func testIndexDurationEstimateMatchesPlayerTimeline() throws {
+        // (row, channel, effect, param) cells of each pattern, 2 channels.
+        let cases: [(name: String, orders: [UInt8], patterns: [(rows: Int, cells: [(Int, Int, UInt8, UInt8)])], ms: UInt32)] = [
+            // D40 targets a row past the end of the next pattern, which
+            // plays from row 0 up to its F03 and B02.
+            ("break", [0, 1, 2], [
+                (8, [(3, 1, 0x0D, 0x40)]),
+                (16, [(5, 0, 0x0F, 0x03), (9, 0, 0x0B, 0x02)]),
+                (4, [(2, 1, 0x0B, 0x00)]),
+            ], 1560),
+            ("delay", [0, 1], [
+                (8, [(2, 0, 0x0E, 0xE3), (5, 1, 0x0E, 0xE1), (5, 0, 0x0F, 0x40)]),
+                (4, [(1, 1, 0x0E, 0xE2)]),
+            ], 3304),
+            ("loop", [0, 1], [
+                (8, [(1, 0, 0x0E, 0x60), (3, 0, 0x0E, 0x62), (4, 1, 0x0E, 0x60), (6, 1, 0x0E, 0x61)]),
+                (4, [(0, 0, 0x0E, 0x60), (2, 0, 0x0E, 0x63), (3, 1, 0x0D, 0x70)]),
+            ], 3600),
+        ]
+        for testCase in cases {
+            let tmpURL = URL(fileURLWithPath: NSTemporaryDirectory()).appendingPathComponent("mc_duration_\(testCase.name).xm")
+            try Data(controlEffectXMModule(orders: testCase.orders, patterns: testCase.patterns)).write(to: tmpURL)
+            defer { try? FileManager.default.removeItem(at: tmpURL) }
+            guard let module = mc_module_open(tmpURL.path, nil, 0) else {
+                return XCTFail("mc_module_open failed")
+            }
+            defer { mc_module_close(module) }
+            var timeline = VTXCPlayerTimeline()
+            XCTAssertEqual(vtx_c_player_timeline_build(module, 48_000, 0, &timeline), VTX_C_PLAYER_STATUS_OK)
+            defer { vtx_c_player_timeline_free(&timeline) }
+            let estimate = mc_index_estimate_duration_ms(module)
+            XCTAssertEqual(estimate, testCase.ms, testCase.name)
+            XCTAssertEqual(Double(estimate), Double(timeline.total_frames) / 48.0, accuracy: 1, testCase.name)
+        }
+    }
+
+    func testModuleIndexReparsesOnlyChangedFiles() throws {
+        let dir = URL(fileURLWithPath: NSTemporaryDirectory()).appendingPathComponent("mc_index_test")
+        try? FileManager.default.removeItem(at: dir)
+        try FileManager.default.createDirectory(at: dir, withIntermediateDirectories: true)
+        defer { try? FileManager.default.removeItem(at: dir) }
+        let modURL = dir.appendingPathComponent("a.mod")
+        let xmURL = dir.appendingPathComponent("b.xm")
+        let indexPath = dir.appendingPathComponent("index.bin").path
+        try Data(contentsOf: URL(fileURLWithPath: try fixturePath("minimal.mod"))).write(to: modURL)
+        try Data(syntheticXMModule(sampleDeltas: [4, 4])).write(to: xmURL)
+
+        func update(_ index: inout mc_module_index) -> mc_index_update_stats {
+            let paths = [xmURL.path, modURL.path].map { UnsafePointer(strdup($0)) }
+            defer { paths.forEach { free(UnsafeMutablePointer(mutating: $0)) } }
+            var stats = mc_index_update_stats()
+            XCTAssertEqual(mc_index_update(&index, paths, paths.count, &stats), 1)
+            return stats
+        }
+
+        var index = mc_module_index()
+        var error = [CChar](repeating: 0, count: 128)
+        XCTAssertEqual(mc_index_load(indexPath, &index, &error, error.count), 1)
+        XCTAssertEqual(index.count, 0)
+        XCTAssertEqual(update(&index).parsed, 2)
+        XCTAssertEqual(mc_index_save(&index, indexPath, &error, error.count), 1, String(cString: error))
+        mc_index_free(&index)
+
+        XCTAssertEqual(mc_index_load(indexPath, &index, &error, error.count), 1, String(cString: error))
+        defer { mc_index_free(&index) }
+        XCTAssertEqual(index.count, 2)
+        let mod = index.entries[0]
+        XCTAssertEqual(String(cString: mod.path), modURL.path)
+        XCTAssertEqual(typeName(mod.type), "MOD")
+        XCTAssertEqual(cString(mod.title), "TEST MOD")
+        XCTAssertEqual(mod.order_count, 2)
+        XCTAssertEqual(mod.duration_ms, 15360)
+        XCTAssertEqual(cString(mod.instrument_names[0]), "KICK")
+        let xm = index.entries[1]
+        XCTAssertEqual(cString(xm.title), "SYNTH")
+        XCTAssertEqual(xm.instrument_name_count, 1)
+        XCTAssertEqual(xm.duration_ms, 120)
+        XCTAssertEqual(update(&index).unchanged, 2)
+
+        try FileManager.default.setAttributes([.modificationDate: Date(timeIntervalSinceNow: 60)], ofItemAtPath: modURL.path)
+        try Data(syntheticXMModule(sampleDeltas: [4, 4, 4])).write(to: xmURL)
+        let stats = update(&index)
+        XCTAssertEqual(stats.rehashed, 1)
+        XCTAssertEqual(stats.parsed, 1)
+        XCTAssertEqual(stats.removed, 0)
+
+        XCTAssertEqual(mc_index_find(&index, "kick", UInt32(MC_INDEX_MATCH_INSTRUMENT), 0), 0)
+        XCTAssertEqual(mc_index_find(&index, "lead", UInt32(MC_INDEX_MATCH_INSTRUMENT), 0), 1)
+        XCTAssertEqual(mc_index_find(&index, "lead", UInt32(MC_INDEX_MATCH_TITLE), 0), 2)
+    }
+
     private func fixturePath(_ name: String) throws -> String {
         guard let base = Bundle.module.resourceURL else {
             throw XCTSkip("Missing Bundle.module resource URL")
@@ -128,6 +838,44 @@ final class ModuleCoreTests: XCTestCase {
         return value
     }
 
+    /// One empty pattern and one instrument with a single 8-bit sample.
+    private func syntheticXMModule(sampleDeltas: [UInt8], rows: Int = 1, forwardLoop: Bool = false) -> [UInt8] {
+        var bytes = Array("Extended Module: ".utf8) + padded("SYNTH", 20) + [0x1A] + padded("", 20) + le16(0x0104)
+        bytes += le32(276) + le16(1) + le16(0) + le16(2) + le16(1) + le16(1) + le16(1) + le16(6) + le16(125)
+        bytes += [UInt8](repeating: 0, count: 256)
+        bytes += le32(9) + [0] + le16(rows) + le16(0)
+
+        var instrument = le32(263) + padded("LEAD", 22) + [0] + le16(1) + le32(40)
+        instrument += [UInt8](repeating: 0, count: 96)
+        instrument += le16(0) + le16(64) + le16(16) + le16(32) + [UInt8](repeating: 0, count: 40)
+        instrument += [UInt8](repeating: 0, count: 48)
+        instrument += [2, 0, 0, 0, 1, 0, 0, 0, UInt8(MC_XM_ENVELOPE_ON), 0, 0, 0, 5, 0]
+        instrument += le16(512) + [UInt8](repeating: 0, count: 22)
+        bytes += instrument
+
+        bytes += le32(sampleDeltas.count) + le32(0) + le32(forwardLoop ? sampleDeltas.count : 0)
+        bytes += [64, 0, forwardLoop ? 1 : 0, 128, 0, 0] + padded("SAMPLE", 22)
+        bytes += sampleDeltas
+        return bytes
+    }
+
+    // Two channels, no instruments, unpacked cells carrying only effects.
+    private func controlEffectXMModule(orders: [UInt8], patterns: [(rows: Int, cells: [(Int, Int, UInt8, UInt8)])]) -> [UInt8] {
+        var bytes = Array("Extended Module: ".utf8) + padded("CONTROL", 20) + [0x1A] + padded("", 20) + le16(0x0104)
+        bytes += le32(276) + le16(orders.count) + le16(0) + le16(2) + le16(patterns.count) + le16(0) + le16(1)
+        bytes += le16(6) + le16(125)
+        bytes += orders + [UInt8](repeating: 0, count: 256 - orders.count)
+        for pattern in patterns {
+            var data = [UInt8](repeating: 0, count: pattern.rows * 2 * 5)
+            for (row, channel, effect, param) in pattern.cells {
+                data[(row * 2 + channel) * 5 + 3] = effect
+                data[(row * 2 + channel) * 5 + 4] = param
+            }
+            bytes += le32(9) + [0] + le16(pattern.rows) + le16(data.count) + data
+        }
+        return bytes
+    }
+
     private func typeName(_ type: mc_module_type) -> String {
         String(cString: mc_module_type_name(type))
     }
@@ -290,3 +1038,11 @@ final class ModuleCoreTests: XCTestCase {
         return out
     }
 }
+
+// Little-endian fields and fixed-size, zero-padded text for the hand-built
+// module images above.
+private func le16(_ value: Int) -> [UInt8] { [UInt8(value & 0xFF), UInt8((value >> 8) & 0xFF)] }
+private func le32(_ value: Int) -> [UInt8] { le16(value & 0xFFFF) + le16(value >> 16) }
+private func padded(_ text: String, _ count: Int) -> [UInt8] {
+    Array((Array(text.utf8) + [UInt8](repeating: 0, count: count)).prefix(count))
+}
@@ -881,6 +881,101 @@ final class VTXRenderBoundedXMTests: XCTestCase {
         XCTAssertEqual(try Data(contentsOf: windowedOutputURL), try Data(contentsOf: defaultOutputURL))
     }
 
+    func testBatchManifestJobsMatchSingleRunOutput() throws {
+        let directory = try temporaryDirectory()
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let inputURL = try generatedPlayableXMPath(in: directory)
+        let jobArguments = [
+            ["--max-frames", "44100", "--diagnostics-json", "diagnostics.json"],
+            ["--rows", "1", "--sample-rate", "48000", "--auto-headroom"],
+            ["--until-song-end", "--tail-seconds", "0.25", "--window-rows", "64"],
+        ]
+        let manifest = jobArguments.enumerated().map { index, extra in
+            ["--input", inputURL.path, "--output", directory.appendingPathComponent("batch-\(index).wav").path, "--order", "0"]
+                + extra.map { $0.hasSuffix(".json") ? directory.appendingPathComponent("batch-\(index)-\($0)").path : $0 }
+        }
+        let manifestURL = directory.appendingPathComponent("jobs.json")
+        try JSONSerialization.data(withJSONObject: manifest).write(to: manifestURL)
+
+        let tool = BatchRenderTool(currentDirectory: repoRoot(), progressOutput: { _ in })
+        let jobs = try tool.loadManifest(fromPath: manifestURL.path)
+        let report = tool.run(jobs, workerCount: 3)
+
+        XCTAssertEqual(report.failedJobCount, 0)
+        XCTAssertEqual(report.moduleCount, 1)
+        XCTAssertEqual(report.workerCount, 3)
+        XCTAssertEqual(report.outcomes.map(\.index), [0, 1, 2])
+        XCTAssertEqual(
+            batchRenderSummaryLine(report),
+            "Batch render: 3 succeeded, 0 failed, 3 jobs over 1 modules on 3 workers."
+        )
+        for (index, job) in jobs.enumerated() {
+            let singleOutputURL = directory.appendingPathComponent("single-\(index).wav")
+            let singleDiagnosticsURL = directory.appendingPathComponent("single-\(index)-diagnostics.json")
+            let single = RenderToolArguments(
+                inputPath: job.inputPath,
+                outputPath: singleOutputURL.path,
+                diagnosticsJSONPath: job.diagnosticsJSONPath == nil ? nil : singleDiagnosticsURL.path,
+                order: job.order,
+                orderCount: job.orderCount,
+                rows: job.rows,
+                sampleRate: job.sampleRate,
+                maxFrames: job.maxFrames,
+                seconds: job.seconds,
+                untilSongEnd: job.untilSongEnd,
+                tailSeconds: job.tailSeconds,
+                windowRows: job.windowRows,
+                autoHeadroom: job.autoHeadroom
+            )
+            let result = try RenderTool(currentDirectory: repoRoot()).run(single)
+
+            XCTAssertEqual(try Data(contentsOf: URL(fileURLWithPath: job.outputPath)), try Data(contentsOf: singleOutputURL))
+            if let diagnosticsJSONPath = job.diagnosticsJSONPath {
+                XCTAssertEqual(
+                    try Data(contentsOf: URL(fileURLWithPath: diagnosticsJSONPath)),
+                    try Data(contentsOf: singleDiagnosticsURL)
+                )
+            }
+            XCTAssertEqual(
+                report.outcomes[index].summary,
+                renderToolSummary(arguments: job, result: result)
+                    .replacingOccurrences(of: singleOutputURL.path, with: job.outputPath)
+                    .replacingOccurrences(of: singleDiagnosticsURL.path, with: job.diagnosticsJSONPath ?? "")
+            )
+        }
+    }
+
+    func testBatchManifestRejectsBadJobsBeforeRendering() throws {
+        let directory = try temporaryDirectory()
+        defer { try? FileManager.default.removeItem(at: directory) }
+        let manifestURL = directory.appendingPathComponent("jobs.json")
+        let tool = BatchRenderTool(currentDirectory: repoRoot(), progressOutput: { _ in })
+        let sharedOutput = directory.appendingPathComponent("candidate.wav").path
+
+        try JSONSerialization.data(withJSONObject: [
+            ["--input", "/tmp/a.xm", "--output", sharedOutput, "--order", "0"],
+            ["--input", "/tmp/b.xm", "--output", sharedOutput, "--order", "1"],
+        ]).write(to: manifestURL)
+        XCTAssertThrowsError(try tool.loadManifest(fromPath: manifestURL.path)) { error in
+            XCTAssertEqual(error as? RenderToolError, .invalidManifest("Manifest jobs 1 and 2 both write \(sharedOutput)."))
+        }
+
+        try JSONSerialization.data(withJSONObject: [
+            ["--input", "/tmp/a.xm", "--output", sharedOutput],
+        ]).write(to: manifestURL)
+        XCTAssertThrowsError(try tool.loadManifest(fromPath: manifestURL.path)) { error in
+            XCTAssertEqual(error as? RenderToolError, .invalidManifest("Manifest job 1: Missing required argument: --order"))
+        }
+
+        XCTAssertEqual(
+            try BatchRenderToolArguments.parse(["--manifest", manifestURL.path, "--jobs", "4"]),
+            BatchRenderToolArguments(manifestPath: manifestURL.path, workerCount: 4)
+        )
+        XCTAssertThrowsError(try BatchRenderToolArguments.parse(["--manifest", manifestURL.path, "--order", "0"])) { error in
+            XCTAssertEqual(error as? RenderToolError, .unknownArgument("--order"))
+        }
+    }
+
     func testDefaultRunDoesNotEmitProgressStatusOutput() throws {
         let directory = try temporaryDirectory()
         defer { try? FileManager.default.removeItem(at: directory) }
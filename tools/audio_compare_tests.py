@@ -1,6 +1,7 @@
 import importlib.util
 import json
 import math
+import os
 import struct
 import subprocess
 import sys
@@ -17,6 +18,12 @@ DISCONTINUITY_SCRIPT_PATH = Path(__file__).resolve().parents[1] / "scripts" / "a
 RUNTIME_TRACE_SUMMARY_SCRIPT_PATH = (
     Path(__file__).resolve().parents[1] / "scripts" / "summarize-runtime-c-mixer-trace.py"
 )
+MIXER_TRACE_DECODE_SCRIPT_PATH = Path(__file__).resolve().parents[1] / "scripts" / "decode-mixer-trace.py"
+NATIVE_COMPARE_CANDIDATES = [
+    Path(os.environ["VTX_AUDIO_COMPARE"]) if os.environ.get("VTX_AUDIO_COMPARE") else None,
+    Path(__file__).resolve().parents[1] / ".build" / "debug" / "vtx_audio_compare",
+    Path(__file__).resolve().parents[1] / ".build" / "release" / "vtx_audio_compare",
+]
 
 
 def load_audio_compare_module():
@@ -46,9 +53,19 @@ def load_runtime_trace_summary_module():
     return module
 
 
+def load_mixer_trace_decode_module():
+    spec = importlib.util.spec_from_file_location("mixer_trace_decode", MIXER_TRACE_DECODE_SCRIPT_PATH)
+    module = importlib.util.module_from_spec(spec)
+    assert spec.loader is not None
+    sys.modules[spec.name] = module
+    spec.loader.exec_module(module)
+    return module
+
+
 audio_compare = load_audio_compare_module()
 audio_discontinuities = load_audio_discontinuities_module()
 runtime_trace_summary = load_runtime_trace_summary_module()
+mixer_trace_decode = load_mixer_trace_decode_module()
 
 
 def synthetic_comparison_json(start_frame=100, end_frame=150):
@@ -1218,6 +1235,124 @@ class AudioCompareTests(unittest.TestCase):
             self.assertIn("missing-reference.wav", result.stderr)
 
 
+def native_compare_path():
+    for path in NATIVE_COMPARE_CANDIDATES:
+        if path is not None and path.is_file():
+            return path
+    return None
+
+
+@unittest.skipIf(native_compare_path() is None, "vtx_audio_compare is not built; run swift build or set VTX_AUDIO_COMPARE")
+class NativeAudioCompareTests(unittest.TestCase):
+    def run_native(self, reference, candidate, *extra):
+        result = subprocess.run(
+            [str(native_compare_path()), "--reference", str(reference), "--candidate", str(candidate), *extra],
+            check=False,
+            capture_output=True,
+            text=True,
+        )
+        self.assertEqual(result.returncode, 0, result.stderr)
+        return result.stdout
+
+    def assert_matches_script(self, reference, candidate, **options):
+        extra = []
+        flags = {
+            "seconds": "--seconds",
+            "window_ms": "--window-ms",
+            "top_windows": "--top-windows",
+            "diff_threshold": "--diff-threshold",
+        }
+        for name, value in options.items():
+            extra.extend([flags[name], str(value)])
+        native_text = self.run_native(reference, candidate, *extra)
+        expected = audio_compare.build_comparison(reference, candidate, **options)
+        expected["tool"] = "tools/vtx_audio_compare"
+
+        self.assertEqual(native_text, json.dumps(expected, indent=2, sort_keys=True) + "\n")
+
+    def test_native_json_matches_script_for_localized_mismatch(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            reference = Path(tmpdir) / "reference.wav"
+            candidate = Path(tmpdir) / "candidate.wav"
+            frames = sine_frames(channels=2, seconds=0.5)
+            changed = list(frames)
+            for index in range(1000, 1400):
+                changed[index] = (frames[index][0] * 0.5, frames[index][1])
+            write_pcm16_wav(reference, channels=2, frames=frames)
+            write_pcm16_wav(candidate, channels=2, frames=changed)
+
+            self.assert_matches_script(reference, candidate, seconds=1.0, window_ms=10.0, top_windows=3)
+
+    def test_native_json_matches_script_for_length_and_format_mismatches(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            reference = Path(tmpdir) / "reference.wav"
+            shorter = Path(tmpdir) / "shorter.wav"
+            other_rate = Path(tmpdir) / "other-rate.wav"
+            write_pcm16_wav(reference, frames=sine_frames(seconds=0.25))
+            write_pcm16_wav(shorter, frames=sine_frames(seconds=0.2, amplitude=0.4))
+            write_pcm16_wav(other_rate, sample_rate=4000, frames=sine_frames(sample_rate=4000))
+
+            self.assert_matches_script(reference, shorter, seconds=0.1, diff_threshold=0.5)
+            self.assert_matches_script(reference, shorter)
+            self.assert_matches_script(reference, other_rate)
+
+    def test_native_alignment_finds_delayed_candidate(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            reference = Path(tmpdir) / "reference.wav"
+            candidate = Path(tmpdir) / "candidate.wav"
+            frames = [0.5 * math.sin(index * 0.05) * math.sin(index * 0.0031) for index in range(6000)]
+            write_pcm16_wav(reference, frames=frames)
+            write_pcm16_wav(candidate, frames=[0.0] * 25 + frames[:-25])
+
+            comparison = json.loads(self.run_native(reference, candidate, "--align-max-ms", "10"))
+            alignment = comparison["sample_comparison"]["alignment"]
+
+            self.assertEqual(alignment["max_lag_frames"], 80)
+            self.assertEqual(alignment["best_offset_frames"], 25)
+            self.assertGreater(alignment["correlation_at_best"], 0.99)
+            self.assertLess(alignment["correlation_at_zero"], alignment["correlation_at_best"])
+
+    def test_native_clicks_match_discontinuity_analysis(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            wav = Path(tmpdir) / "step.wav"
+            frames = [0.0] * 40 + [0.8] * 40 + [-0.5] * 40
+            write_pcm16_wav(wav, sample_rate=100, frames=frames)
+
+            comparison = json.loads(
+                self.run_native(wav, wav, "--clicks", "--click-threshold-pcm16", "12000", "--top-clicks", "2")
+            )
+            clicks = comparison["reference"]["clicks"]
+            analysis = audio_discontinuities.build_analysis(wav, top_count=2, threshold_pcm16=12000)
+
+            self.assertEqual(clicks["threshold_jump_count"], analysis["analysis"]["threshold_jump_count"])
+            self.assertEqual(
+                clicks["threshold_jump_counts_by_second"],
+                analysis["analysis"]["threshold_jump_counts_by_second"],
+            )
+            self.assertEqual(
+                [(jump["frame"], jump["jump_magnitude_pcm16"]) for jump in clicks["top_adjacent_sample_jumps"]],
+                [(jump["frame"], jump["jump_magnitude_pcm16"]) for jump in analysis["top_adjacent_sample_jumps"]],
+            )
+
+    def test_native_rejects_missing_file(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            result = subprocess.run(
+                [
+                    str(native_compare_path()),
+                    "--reference",
+                    str(Path(tmpdir) / "missing.wav"),
+                    "--candidate",
+                    str(Path(tmpdir) / "missing.wav"),
+                ],
+                check=False,
+                capture_output=True,
+                text=True,
+            )
+
+            self.assertEqual(result.returncode, 1)
+            self.assertIn("missing.wav", result.stderr)
+
+
 class AudioCorrelationTests(unittest.TestCase):
     def test_correlation_maps_synthetic_window_to_overlapping_adapter_event(self):
         with tempfile.TemporaryDirectory() as tmpdir:
@@ -2409,5 +2544,105 @@ class RuntimeCMixerTraceSummaryTests(unittest.TestCase):
         return path
 
 
+class MixerTraceDecodeTests(unittest.TestCase):
+    def test_records_inside_a_render_are_sorted_by_frame(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            trace_path = self.write_trace(
+                tmpdir,
+                [
+                    self.record(3, frame=10, voice=0, tag=4, count=100, a=1.0, b=0.0),
+                    self.record(1, frame=0, count=64),
+                    self.record(8, frame=40, voice=0, tag=4, flags=1 | 8, a=0.5),
+                    self.record(6, frame=50, voice=0, tag=4),
+                    self.record(7, frame=30, voice=0, tag=4),
+                    self.record(2, frame=64, a=0.5, b=0.25),
+                ],
+            )
+
+            header, body = mixer_trace_decode.load_trace(trace_path)
+            records = list(mixer_trace_decode.decode_records(body))
+
+            self.assertEqual(header["records"], 6)
+            self.assertEqual(
+                [record["kind"] for record in records],
+                ["voice_start", "render_begin", "key_off", "event_apply", "voice_end", "render_end"],
+            )
+            self.assertEqual(records[3], {
+                "channel_tag": 4,
+                "frame": 40,
+                "gain": 0.5,
+                "kind": "event_apply",
+                "ramped": True,
+                "voice": 0,
+            })
+            self.assertIsNone(records[1]["voice"])
+
+    def test_summary_counts_lifetimes_gaps_and_channel_tags(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            trace_path = self.write_trace(
+                tmpdir,
+                [
+                    self.record(1, frame=0, count=100),
+                    self.record(3, frame=0, voice=0, tag=1, count=10),
+                    self.record(3, frame=20, voice=1, tag=2, count=10),
+                    self.record(6, frame=80, voice=0, tag=1),
+                    self.record(2, frame=100, a=0.75),
+                    self.record(5, frame=100, voice=1, tag=2, count=32, a=1.0),
+                    self.record(1, frame=150, count=100),
+                    self.record(6, frame=182, voice=1, tag=2),
+                    self.record(2, frame=250, a=0.5),
+                ],
+                dropped=3,
+            )
+
+            header, body = mixer_trace_decode.load_trace(trace_path)
+            summary = mixer_trace_decode.build_summary(header, list(mixer_trace_decode.decode_records(body)))
+
+            self.assertEqual(summary["header"]["dropped_records"], 3)
+            self.assertEqual(summary["render_calls"], 2)
+            self.assertEqual(summary["rendered_frames"], 200)
+            self.assertEqual(summary["render_gaps"], 1)
+            self.assertEqual(summary["peak"], 0.75)
+            self.assertEqual(summary["max_active_voices"], 2)
+            self.assertEqual(summary["voices_still_active"], 0)
+            self.assertEqual(summary["voice_lifetime"], {"min_frames": 80, "median_frames": 121.0, "max_frames": 162})
+            self.assertEqual(summary["channels"]["2"], {"voice_end": 1, "voice_start": 1, "voice_steal": 1})
+
+    def test_cli_writes_jsonl_and_rejects_truncated_traces(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            trace_path = self.write_trace(tmpdir, [self.record(1, frame=0, count=8), self.record(2, frame=8)])
+            jsonl_path = Path(tmpdir) / "trace.jsonl"
+            result = subprocess.run(
+                [sys.executable, str(MIXER_TRACE_DECODE_SCRIPT_PATH), str(trace_path), "--jsonl", str(jsonl_path)],
+                check=False,
+                capture_output=True,
+                text=True,
+            )
+
+            self.assertEqual(result.returncode, 0, result.stderr)
+            lines = jsonl_path.read_text(encoding="utf-8").splitlines()
+            self.assertEqual([json.loads(line)["kind"] for line in lines], ["render_begin", "render_end"])
+
+            trace_path.write_bytes(trace_path.read_bytes()[:-1])
+            result = subprocess.run(
+                [sys.executable, str(MIXER_TRACE_DECODE_SCRIPT_PATH), str(trace_path)],
+                check=False,
+                capture_output=True,
+                text=True,
+            )
+
+            self.assertEqual(result.returncode, 2)
+            self.assertIn("truncated record", result.stderr)
+
+    def record(self, kind, frame=0, voice=0xFFFFFFFF, tag=0xFFFFFFFF, flags=0, count=0, a=0.0, b=0.0):
+        return struct.pack("<QHHIIIff", frame, kind, flags, voice, tag, count, a, b)
+
+    def write_trace(self, tmpdir, records, dropped=0):
+        path = Path(tmpdir) / "mixer.vtxtrace"
+        header = struct.pack("<8sIIIIQ", b"VTXTRACE", 1, 32, 44100, 2, dropped)
+        path.write_bytes(header + b"".join(records))
+        return path
+
+
 if __name__ == "__main__":
     unittest.main()
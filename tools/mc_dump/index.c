@@ -0,0 +1,90 @@
+#include "index.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "json_out.h"
+#include "module_index.h"
+
+static void print_entry(const mc_index_entry *entry) {
+    uint16_t i;
+
+    printf("{\"path\":");
+    mc_json_print_string(entry->path);
+    printf(",\"ok\":%s,\"size_bytes\":%llu,\"content_hash\":\"%016llx\"", entry->ok ? "true" : "false",
+        (unsigned long long)entry->size, (unsigned long long)entry->content_hash);
+    if (entry->ok) {
+        printf(",\"type\":");
+        mc_json_print_string(mc_module_type_name(entry->type));
+        printf(",\"title\":");
+        mc_json_print_string(entry->title);
+        printf(",\"channels\":%u,\"patterns\":%u,\"instruments\":%u,\"song_length\":%u,\"duration_ms\":%u",
+            entry->channels, entry->patterns, entry->instruments, entry->song_length, entry->duration_ms);
+        printf(",\"orders\":[");
+        for (i = 0; i < entry->order_count; i++) {
+            printf(i > 0 ? ",%u" : "%u", entry->orders[i]);
+        }
+        printf("],\"instrument_names\":[");
+        for (i = 0; i < entry->instrument_name_count; i++) {
+            if (i > 0) {
+                putchar(',');
+            }
+            mc_json_print_string(entry->instrument_names[i]);
+        }
+        putchar(']');
+    }
+    printf("}\n");
+}
+
+int mc_dump_index(const char *index_path, const char *scan_root, const mc_scan_options *options, const char *query) {
+    mc_module_index index;
+    char error[256];
+    size_t i;
+
+    if (!mc_index_load(index_path, &index, error, sizeof(error))) {
+        fprintf(stderr, "error: %s: %s\n", index_path, error);
+        return 1;
+    }
+
+    if (scan_root != NULL) {
+        mc_index_update_stats stats;
+        char **paths = NULL;
+        size_t path_count = 0;
+        int updated;
+
+        if (!mc_scan_collect_paths(scan_root, options, &paths, &path_count)) {
+            mc_index_free(&index);
+            return 1;
+        }
+        updated = mc_index_update(&index, (const char *const *)paths, path_count, &stats);
+        mc_scan_free_paths(paths, path_count);
+        if (!updated) {
+            fprintf(stderr, "error: out of memory\n");
+            mc_index_free(&index);
+            return 1;
+        }
+        if (!mc_index_save(&index, index_path, error, sizeof(error))) {
+            fprintf(stderr, "error: %s: %s\n", index_path, error);
+            mc_index_free(&index);
+            return 1;
+        }
+        printf("{\"index\":");
+        mc_json_print_string(index_path);
+        printf(",\"entries\":%zu,\"unchanged\":%zu,\"rehashed\":%zu,\"parsed\":%zu,\"removed\":%zu}\n",
+            index.count, stats.unchanged, stats.rehashed, stats.parsed, stats.removed);
+    }
+
+    if (query != NULL) {
+        i = mc_index_find(&index, query, MC_INDEX_MATCH_TITLE | MC_INDEX_MATCH_INSTRUMENT, 0);
+        while (i < index.count) {
+            print_entry(&index.entries[i]);
+            i = mc_index_find(&index, query, MC_INDEX_MATCH_TITLE | MC_INDEX_MATCH_INSTRUMENT, i + 1u);
+        }
+    } else if (scan_root == NULL) {
+        for (i = 0; i < index.count; i++) {
+            print_entry(&index.entries[i]);
+        }
+    }
+    mc_index_free(&index);
+    return 0;
+}
@@ -0,0 +1,13 @@
+#ifndef MC_DUMP_INDEX_H
+#define MC_DUMP_INDEX_H
+
+#include "scan.h"
+
+// Loads the index at index_path (a missing file is an empty index). With
+// scan_root the index is brought up to date with the selected files under it
+// and saved, and a stats record is printed. With query, entries whose title
+// or instrument names contain it are printed as NDJSON; with neither, every
+// entry is. Returns the process exit status.
+int mc_dump_index(const char *index_path, const char *scan_root, const mc_scan_options *options, const char *query);
+
+#endif
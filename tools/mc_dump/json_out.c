@@ -0,0 +1,46 @@
+#include "json_out.h"
+
+#include <stdio.h>
+
+void mc_json_write_string(const char *s, mc_json_write_fn write, void *context) {
+    const unsigned char *p = (const unsigned char *)s;
+
+    write(context, "\"", 1);
+    for (; *p; p++) {
+        switch (*p) {
+        case '\\':
+            write(context, "\\\\", 2);
+            break;
+        case '"':
+            write(context, "\\\"", 2);
+            break;
+        case '\n':
+            write(context, "\\n", 2);
+            break;
+        case '\r':
+            write(context, "\\r", 2);
+            break;
+        case '\t':
+            write(context, "\\t", 2);
+            break;
+        default:
+            if (*p < 32) {
+                char escape[7];
+                snprintf(escape, sizeof(escape), "\\u%04x", *p);
+                write(context, escape, 6);
+            } else {
+                write(context, (const char *)p, 1);
+            }
+            break;
+        }
+    }
+    write(context, "\"", 1);
+}
+
+static void write_stdout(void *context, const char *bytes, size_t length) {
+    fwrite(bytes, 1, length, stdout);
+}
+
+void mc_json_print_string(const char *s) {
+    mc_json_write_string(s, write_stdout, NULL);
+}
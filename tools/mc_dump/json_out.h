@@ -0,0 +1,15 @@
+#ifndef MC_DUMP_JSON_OUT_H
+#define MC_DUMP_JSON_OUT_H
+
+#include <stddef.h>
+
+typedef void (*mc_json_write_fn)(void *context, const char *bytes, size_t length);
+
+// Writes s as a quoted JSON string through write, escaping quotes,
+// backslashes and control characters.
+void mc_json_write_string(const char *s, mc_json_write_fn write, void *context);
+
+// mc_json_write_string to stdout.
+void mc_json_print_string(const char *s);
+
+#endif
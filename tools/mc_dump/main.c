@@ -3,39 +3,10 @@
 #include <string.h>
 
 #include "module_types.h"
-
-static void print_json_string(const char *s) {
-    const unsigned char *p = (const unsigned char *)s;
-    putchar('"');
-    while (*p) {
-        switch (*p) {
-        case '\\':
-            fputs("\\\\", stdout);
-            break;
-        case '"':
-            fputs("\\\"", stdout);
-            break;
-        case '\n':
-            fputs("\\n", stdout);
-            break;
-        case '\r':
-            fputs("\\r", stdout);
-            break;
-        case '\t':
-            fputs("\\t", stdout);
-            break;
-        default:
-            if (*p < 32) {
-                fprintf(stdout, "\\u%04x", *p);
-            } else {
-                putchar(*p);
-            }
-            break;
-        }
-        p++;
-    }
-    putchar('"');
-}
+#include "index.h"
+#include "json_out.h"
+#include "scan.h"
+#include "snapshot.h"
 
 static int should_include_event(const mc_xm_event *event, int include_patterns, int has_pattern_filter, unsigned pattern_filter) {
     if (!include_patterns) {
@@ -52,16 +23,16 @@ static void print_json(const mc_module_info *info, int include_patterns, int has
     printf("{\n");
     printf("  \"ok\": %s,\n", info->ok ? "true" : "false");
     printf("  \"type\": ");
-    print_json_string(mc_module_type_name(info->type));
+    mc_json_print_string(mc_module_type_name(info->type));
     printf(",\n");
     printf("  \"error\": ");
-    print_json_string(info->error);
+    mc_json_print_string(info->error);
     printf(",\n");
     printf("  \"warning\": ");
-    print_json_string(info->warning);
+    mc_json_print_string(info->warning);
     printf(",\n");
     printf("  \"title\": ");
-    print_json_string(info->title);
+    mc_json_print_string(info->title);
     printf(",\n");
     printf("  \"version\": { \"major\": %u, \"minor\": %u },\n", info->version_major, info->version_minor);
     printf("  \"channels\": %u,\n", info->channels);
@@ -121,11 +92,11 @@ static void print_json(const mc_module_info *info, int include_patterns, int has
         printf("],\n");
     }
     printf("  \"first_instrument_name\": ");
-    print_json_string(info->first_instrument_name);
+    mc_json_print_string(info->first_instrument_name);
     printf(",\n");
     printf("  \"first_mod_sample\": {\n");
     printf("    \"name\": ");
-    print_json_string(info->first_mod_sample.name);
+    mc_json_print_string(info->first_mod_sample.name);
     printf(",\n");
     printf("    \"length_bytes\": %u,\n", info->first_mod_sample.length_bytes);
     printf("    \"finetune\": %d,\n", info->first_mod_sample.finetune);
@@ -141,11 +112,29 @@ int main(int argc, char **argv) {
     int include_patterns = 0;
     int has_pattern_filter = 0;
     unsigned pattern_filter = 0;
+    const char *scan_root = NULL;
+    const char *index_path = NULL;
+    const char *query = NULL;
+    const char *diff_paths[2] = { NULL, NULL };
+    int binary = 0;
+    mc_scan_options scan_options;
+    int scan_only_option = 0;
     int i;
 
+    memset(&scan_options, 0, sizeof(scan_options));
+
     for (i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--json") == 0) {
             json = 1;
+        } else if (strcmp(argv[i], "--binary") == 0) {
+            binary = 1;
+        } else if (strcmp(argv[i], "--diff") == 0) {
+            if (i + 2 >= argc) {
+                fprintf(stderr, "error: --diff requires two module or snapshot paths\n");
+                return 2;
+            }
+            diff_paths[0] = argv[++i];
+            diff_paths[1] = argv[++i];
         } else if (strcmp(argv[i], "--include-patterns") == 0) {
             include_patterns = 1;
         } else if (strcmp(argv[i], "--pattern") == 0) {
@@ -163,6 +152,55 @@ int main(int argc, char **argv) {
             has_pattern_filter = 1;
             include_patterns = 1;
             pattern_filter = (unsigned)value;
+        } else if (strcmp(argv[i], "--scan") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "error: --scan requires a directory argument\n");
+                return 2;
+            }
+            scan_root = argv[++i];
+        } else if (strcmp(argv[i], "--index") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "error: --index requires an index file argument\n");
+                return 2;
+            }
+            index_path = argv[++i];
+        } else if (strcmp(argv[i], "--query") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "error: --query requires a text argument\n");
+                return 2;
+            }
+            query = argv[++i];
+        } else if (strcmp(argv[i], "--include") == 0 || strcmp(argv[i], "--exclude") == 0) {
+            int include = strcmp(argv[i], "--include") == 0;
+            size_t *count = include ? &scan_options.include_count : &scan_options.exclude_count;
+            if (i + 1 >= argc) {
+                fprintf(stderr, "error: %s requires a glob argument\n", argv[i]);
+                return 2;
+            }
+            if (*count >= MC_SCAN_MAX_GLOBS) {
+                fprintf(stderr, "error: too many %s globs (max %d)\n", argv[i], MC_SCAN_MAX_GLOBS);
+                return 2;
+            }
+            if (include) {
+                scan_options.include[(*count)++] = argv[++i];
+            } else {
+                scan_options.exclude[(*count)++] = argv[++i];
+            }
+            scan_only_option = 1;
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            char *end = NULL;
+            long value;
+            if (i + 1 >= argc) {
+                fprintf(stderr, "error: --threads requires an integer argument\n");
+                return 2;
+            }
+            value = strtol(argv[++i], &end, 10);
+            if (end == NULL || *end != '\0' || value < 0 || value > MC_SCAN_MAX_THREADS) {
+                fprintf(stderr, "error: invalid thread count '%s'\n", argv[i]);
+                return 2;
+            }
+            scan_options.thread_count = (unsigned)value;
+            scan_only_option = 1;
         } else if (argv[i][0] == '-') {
             fprintf(stderr, "error: unknown option '%s'\n", argv[i]);
             return 2;
@@ -174,11 +212,61 @@ int main(int argc, char **argv) {
         }
     }
 
+    if (diff_paths[0] != NULL) {
+        if (path != NULL || binary || json || include_patterns || scan_root != NULL || index_path != NULL) {
+            fprintf(stderr, "error: --diff does not combine with other options\n");
+            return 2;
+        }
+        return mc_dump_diff(diff_paths[0], diff_paths[1]);
+    }
+    if (binary && (json || include_patterns || scan_root != NULL || index_path != NULL)) {
+        fprintf(stderr, "error: --binary takes only a module file path\n");
+        return 2;
+    }
+    if (query != NULL && index_path == NULL) {
+        fprintf(stderr, "error: --query requires --index\n");
+        return 2;
+    }
+    if (index_path != NULL) {
+        if (path != NULL) {
+            fprintf(stderr, "error: --index does not take a module file path\n");
+            return 2;
+        }
+        if (scan_options.thread_count != 0) {
+            fprintf(stderr, "error: --threads is not supported with --index\n");
+            return 2;
+        }
+        if (scan_only_option && scan_root == NULL) {
+            fprintf(stderr, "error: --include and --exclude require --scan\n");
+            return 2;
+        }
+        return mc_dump_index(index_path, scan_root, &scan_options, query);
+    }
+    if (scan_root != NULL) {
+        if (path != NULL) {
+            fprintf(stderr, "error: --scan does not take a module file path\n");
+            return 2;
+        }
+        return mc_dump_scan(scan_root, &scan_options);
+    }
+    if (scan_only_option) {
+        fprintf(stderr, "error: --include, --exclude and --threads require --scan\n");
+        return 2;
+    }
     if (path == NULL) {
         fprintf(stderr, "usage: %s [--json] [--include-patterns|--pattern N] <module-file>\n", argv[0]);
+        fprintf(stderr, "       %s --binary <module-file> > snapshot\n", argv[0]);
+        fprintf(stderr, "       %s --diff <module-or-snapshot> <module-or-snapshot>\n", argv[0]);
+        fprintf(stderr, "       %s --scan <dir> [--include GLOB]... [--exclude GLOB]... [--threads N]\n", argv[0]);
+        fprintf(stderr, "       %s --index <file> [--scan <dir> [--include GLOB]... [--exclude GLOB]...] [--query TEXT]\n",
+            argv[0]);
         return 2;
     }
 
+    if (binary) {
+        return mc_dump_binary(path);
+    }
+
     info = mc_parse_file(path);
     if (!info.ok) {
         if (json) {
@@ -0,0 +1,336 @@
+#include "scan.h"
+
+#include <dirent.h>
+#include <fnmatch.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "json_out.h"
+#include "module_handle.h"
+
+enum {
+    SCAN_OUTPUT_FLUSH_SIZE = 64 * 1024,
+};
+
+typedef struct {
+    char *data;
+    size_t size;
+    size_t capacity;
+} text_buffer;
+
+typedef struct {
+    char **items;
+    size_t count;
+    size_t capacity;
+} path_list;
+
+// Records are emitted in path order: a finished record waits in records[]
+// until every record before it has been written.
+typedef struct {
+    const path_list *paths;
+    pthread_mutex_t lock;
+    size_t next_claim;
+    size_t next_emit;
+    text_buffer *records;
+    text_buffer output;
+} scan_state;
+
+static void *checked_realloc(void *pointer, size_t size) {
+    void *grown = realloc(pointer, size);
+    if (grown == NULL) {
+        fprintf(stderr, "error: out of memory\n");
+        exit(1);
+    }
+    return grown;
+}
+
+static void text_reserve(text_buffer *text, size_t extra) {
+    size_t needed = text->size + extra + 1u;
+    size_t capacity = text->capacity > 0 ? text->capacity : 256u;
+
+    if (needed <= text->capacity) {
+        return;
+    }
+    while (capacity < needed) {
+        capacity *= 2u;
+    }
+    text->data = (char *)checked_realloc(text->data, capacity);
+    text->capacity = capacity;
+}
+
+static void text_append(text_buffer *text, const char *s, size_t length) {
+    text_reserve(text, length);
+    memcpy(text->data + text->size, s, length);
+    text->size += length;
+    text->data[text->size] = '\0';
+}
+
+static void text_appendf(text_buffer *text, const char *format, ...) {
+    va_list args;
+    int length;
+
+    va_start(args, format);
+    length = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+    if (length <= 0) {
+        return;
+    }
+    text_reserve(text, (size_t)length);
+    va_start(args, format);
+    vsnprintf(text->data + text->size, (size_t)length + 1u, format, args);
+    va_end(args);
+    text->size += (size_t)length;
+}
+
+static void text_write(void *context, const char *bytes, size_t length) {
+    text_append((text_buffer *)context, bytes, length);
+}
+
+static void text_append_json_string(text_buffer *text, const char *s) {
+    mc_json_write_string(s, text_write, text);
+}
+
+static void path_list_push(path_list *paths, char *path) {
+    if (paths->count == paths->capacity) {
+        paths->capacity = paths->capacity > 0 ? paths->capacity * 2u : 256u;
+        paths->items = (char **)checked_realloc(paths->items, paths->capacity * sizeof(*paths->items));
+    }
+    paths->items[paths->count++] = path;
+}
+
+static int compare_paths(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static int glob_matches(const char *glob, const char *relative) {
+    const char *name = strrchr(relative, '/');
+
+    if (strchr(glob, '/') == NULL) {
+        return fnmatch(glob, name != NULL ? name + 1 : relative, 0) == 0;
+    }
+    return fnmatch(glob, relative, FNM_PATHNAME) == 0;
+}
+
+static int is_selected(const mc_scan_options *options, const char *relative) {
+    size_t i;
+    int included = options->include_count == 0;
+
+    for (i = 0; i < options->include_count && !included; i++) {
+        included = glob_matches(options->include[i], relative);
+    }
+    for (i = 0; i < options->exclude_count && included; i++) {
+        included = !glob_matches(options->exclude[i], relative);
+    }
+    return included;
+}
+
+static void walk(const char *dir, size_t root_length, const mc_scan_options *options, path_list *paths) {
+    DIR *handle = opendir(dir);
+    struct dirent *entry;
+
+    if (handle == NULL) {
+        fprintf(stderr, "warning: cannot open directory %s\n", dir);
+        return;
+    }
+    while ((entry = readdir(handle)) != NULL) {
+        struct stat st;
+        size_t length;
+        char *path;
+
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+        length = strlen(dir) + 1u + strlen(entry->d_name);
+        path = (char *)checked_realloc(NULL, length + 1u);
+        snprintf(path, length + 1u, "%s/%s", dir, entry->d_name);
+        if (lstat(path, &st) != 0) {
+            free(path);
+            continue;
+        }
+        if (S_ISDIR(st.st_mode)) {
+            walk(path, root_length, options, paths);
+            free(path);
+        } else if (S_ISREG(st.st_mode) && is_selected(options, path + root_length + 1u)) {
+            path_list_push(paths, path);
+        } else {
+            free(path);
+        }
+    }
+    closedir(handle);
+}
+
+static double elapsed_us(const struct timespec *start) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) * 1e6 + (double)(now.tv_nsec - start->tv_nsec) / 1e3;
+}
+
+static void format_record(text_buffer *record, const char *path) {
+    char error[128];
+    struct timespec start;
+    const mc_module_header *header;
+    mc_module *module;
+    size_t size = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    module = mc_module_open(path, error, sizeof(error));
+    text_append(record, "{\"path\":", 8);
+    text_append_json_string(record, path);
+    if (module == NULL) {
+        text_append(record, ",\"ok\":false,\"error\":", 20);
+        text_append_json_string(record, error);
+        text_appendf(record, ",\"elapsed_us\":%.1f}\n", elapsed_us(&start));
+        return;
+    }
+
+    header = mc_module_get_header(module);
+    mc_module_bytes(module, &size);
+    text_append(record, ",\"ok\":true,\"type\":", 18);
+    text_append_json_string(record, mc_module_type_name(header->type));
+    text_append(record, ",\"title\":", 9);
+    text_append_json_string(record, header->title);
+    text_append(record, ",\"warning\":", 11);
+    text_append_json_string(record, header->warning);
+    text_appendf(record,
+        ",\"version\":{\"major\":%u,\"minor\":%u},\"channels\":%u,\"patterns\":%u,\"instruments\":%u,"
+        "\"song_length\":%u,\"restart_position\":%u,\"default_tempo\":%u,\"default_bpm\":%u,\"size_bytes\":%zu",
+        header->version_major, header->version_minor, header->channels, header->patterns, header->instruments,
+        header->song_length, header->restart_position, header->default_tempo, header->default_bpm, size);
+    mc_module_close(module);
+    text_appendf(record, ",\"elapsed_us\":%.1f}\n", elapsed_us(&start));
+}
+
+static void flush_output(scan_state *state) {
+    if (state->output.size > 0) {
+        fwrite(state->output.data, 1, state->output.size, stdout);
+        state->output.size = 0;
+    }
+}
+
+static void *scan_worker(void *arg) {
+    scan_state *state = (scan_state *)arg;
+
+    for (;;) {
+        text_buffer record = { NULL, 0, 0 };
+        size_t index;
+
+        pthread_mutex_lock(&state->lock);
+        index = state->next_claim++;
+        pthread_mutex_unlock(&state->lock);
+        if (index >= state->paths->count) {
+            break;
+        }
+        format_record(&record, state->paths->items[index]);
+
+        pthread_mutex_lock(&state->lock);
+        state->records[index] = record;
+        while (state->next_emit < state->paths->count && state->records[state->next_emit].data != NULL) {
+            text_buffer *ready = &state->records[state->next_emit];
+            text_append(&state->output, ready->data, ready->size);
+            free(ready->data);
+            ready->data = NULL;
+            state->next_emit++;
+        }
+        if (state->output.size >= SCAN_OUTPUT_FLUSH_SIZE) {
+            flush_output(state);
+        }
+        pthread_mutex_unlock(&state->lock);
+    }
+    return NULL;
+}
+
+int mc_scan_collect_paths(const char *root, const mc_scan_options *options, char ***out_paths, size_t *out_count) {
+    path_list paths = { NULL, 0, 0 };
+    struct stat st;
+    char *base;
+    size_t base_length;
+
+    if (stat(root, &st) != 0) {
+        fprintf(stderr, "error: cannot scan %s\n", root);
+        return 0;
+    }
+    base_length = strlen(root);
+    while (base_length > 1u && root[base_length - 1u] == '/') {
+        base_length--;
+    }
+    base = (char *)checked_realloc(NULL, base_length + 1u);
+    memcpy(base, root, base_length);
+    base[base_length] = '\0';
+    if (S_ISDIR(st.st_mode)) {
+        walk(base, base_length, options, &paths);
+        free(base);
+    } else {
+        path_list_push(&paths, base);
+    }
+    if (paths.count > 1u) {
+        qsort(paths.items, paths.count, sizeof(*paths.items), compare_paths);
+    }
+    *out_paths = paths.items;
+    *out_count = paths.count;
+    return 1;
+}
+
+void mc_scan_free_paths(char **paths, size_t count) {
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        free(paths[i]);
+    }
+    free(paths);
+}
+
+int mc_dump_scan(const char *root, const mc_scan_options *options) {
+    pthread_t threads[MC_SCAN_MAX_THREADS];
+    path_list paths = { NULL, 0, 0 };
+    scan_state state;
+    size_t thread_count = options->thread_count;
+    size_t started = 0;
+    size_t i;
+
+    if (!mc_scan_collect_paths(root, options, &paths.items, &paths.count)) {
+        return 1;
+    }
+
+    if (thread_count == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = online > 0 ? (size_t)online : 1u;
+    }
+    if (thread_count > MC_SCAN_MAX_THREADS) {
+        thread_count = MC_SCAN_MAX_THREADS;
+    }
+    memset(&state, 0, sizeof(state));
+    state.paths = &paths;
+    state.records = (text_buffer *)calloc(paths.count > 0 ? paths.count : 1u, sizeof(*state.records));
+    if (state.records == NULL) {
+        fprintf(stderr, "error: out of memory\n");
+        return 1;
+    }
+    pthread_mutex_init(&state.lock, NULL);
+    // The calling thread is one of the workers.
+    while (started + 1u < thread_count && started + 1u < paths.count) {
+        if (pthread_create(&threads[started], NULL, scan_worker, &state) != 0) {
+            break;
+        }
+        started++;
+    }
+    scan_worker(&state);
+    for (i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    flush_output(&state);
+    fflush(stdout);
+
+    pthread_mutex_destroy(&state.lock);
+    free(state.output.data);
+    free(state.records);
+    mc_scan_free_paths(paths.items, paths.count);
+    return 0;
+}
@@ -0,0 +1,33 @@
+#ifndef MC_DUMP_SCAN_H
+#define MC_DUMP_SCAN_H
+
+#include <stddef.h>
+
+enum {
+    MC_SCAN_MAX_GLOBS = 32,
+    MC_SCAN_MAX_THREADS = 256,
+};
+
+// Globs without a '/' match the file name; others match the path relative to
+// the scan root. With no include globs every regular file is scanned.
+typedef struct {
+    const char *include[MC_SCAN_MAX_GLOBS];
+    size_t include_count;
+    const char *exclude[MC_SCAN_MAX_GLOBS];
+    size_t exclude_count;
+    // 0 means one per online CPU.
+    unsigned thread_count;
+} mc_scan_options;
+
+// Collects the selected regular files under root (or root itself when it is
+// a file) in path order. Returns 0 after printing an error when root cannot
+// be read.
+int mc_scan_collect_paths(const char *root, const mc_scan_options *options, char ***out_paths, size_t *out_count);
+void mc_scan_free_paths(char **paths, size_t count);
+
+// Walks root (not following symlinks), opens every selected file with a lazy
+// module handle on a worker pool and writes one NDJSON record per file to
+// stdout, in path order. Returns the process exit status.
+int mc_dump_scan(const char *root, const mc_scan_options *options);
+
+#endif
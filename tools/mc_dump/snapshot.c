@@ -0,0 +1,113 @@
+#include "snapshot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "module_file.h"
+#include "module_handle.h"
+#include "module_snapshot.h"
+
+enum {
+    DIFF_REPORT_LIMIT = 100,
+};
+
+typedef struct {
+    size_t printed;
+} diff_output;
+
+// Eager decoding rejects malformed pattern data, as mc_parse_file does.
+static int capture_module(const char *path, mc_module_snapshot *snapshot, char *error, size_t error_size) {
+    mc_module_open_options options;
+    mc_module *module;
+    int ok;
+
+    memset(&options, 0, sizeof(options));
+    options.flags = MC_MODULE_OPEN_EAGER_PATTERNS;
+    module = mc_module_open_with_options(path, &options, error, error_size);
+    if (module == NULL) {
+        return 0;
+    }
+    ok = mc_snapshot_capture(module, snapshot, error, error_size);
+    mc_module_close(module);
+    return ok;
+}
+
+static int load_side(const char *path, mc_module_snapshot *snapshot, char *error, size_t error_size) {
+    mc_file_bytes bytes;
+    int ok;
+
+    if (!mc_file_bytes_open(path, &bytes, error, error_size)) {
+        return 0;
+    }
+    if (!mc_snapshot_is_encoded(bytes.data, bytes.size)) {
+        mc_file_bytes_close(&bytes);
+        return capture_module(path, snapshot, error, error_size);
+    }
+    ok = mc_snapshot_decode(bytes.data, bytes.size, snapshot, error, error_size);
+    mc_file_bytes_close(&bytes);
+    return ok;
+}
+
+static void print_difference(void *context, const char *description) {
+    diff_output *output = (diff_output *)context;
+
+    if (output->printed < DIFF_REPORT_LIMIT) {
+        printf("%s\n", description);
+    }
+    output->printed++;
+}
+
+int mc_dump_binary(const char *path) {
+    mc_module_snapshot snapshot;
+    uint8_t *data = NULL;
+    size_t size = 0;
+    char error[128];
+    int written;
+
+    if (!capture_module(path, &snapshot, error, sizeof(error))) {
+        fprintf(stderr, "error: %s\n", error[0] ? error : "unknown error");
+        return 1;
+    }
+    if (!mc_snapshot_encode(&snapshot, &data, &size)) {
+        mc_snapshot_free(&snapshot);
+        fprintf(stderr, "error: out of memory\n");
+        return 1;
+    }
+    mc_snapshot_free(&snapshot);
+    written = fwrite(data, 1, size, stdout) == size && fflush(stdout) == 0;
+    free(data);
+    if (!written) {
+        fprintf(stderr, "error: write failed\n");
+        return 1;
+    }
+    return 0;
+}
+
+int mc_dump_diff(const char *left_path, const char *right_path) {
+    mc_module_snapshot left;
+    mc_module_snapshot right;
+    diff_output output = { 0 };
+    char error[128];
+    size_t count;
+
+    if (!load_side(left_path, &left, error, sizeof(error))) {
+        fprintf(stderr, "error: %s: %s\n", left_path, error[0] ? error : "unknown error");
+        return 2;
+    }
+    if (!load_side(right_path, &right, error, sizeof(error))) {
+        fprintf(stderr, "error: %s: %s\n", right_path, error[0] ? error : "unknown error");
+        mc_snapshot_free(&left);
+        return 2;
+    }
+    count = mc_snapshot_diff(&left, &right, print_difference, &output);
+    if (count > DIFF_REPORT_LIMIT) {
+        printf("... %zu more\n", count - DIFF_REPORT_LIMIT);
+    }
+    if (count > 0) {
+        printf("%zu difference%s\n", count, count == 1 ? "" : "s");
+    }
+    mc_snapshot_free(&left);
+    mc_snapshot_free(&right);
+    return count > 0 ? 1 : 0;
+}
@@ -0,0 +1,13 @@
+#ifndef MC_DUMP_SNAPSHOT_H
+#define MC_DUMP_SNAPSHOT_H
+
+// Writes the binary snapshot (module_snapshot.h) of path to stdout. Returns
+// the process exit status.
+int mc_dump_binary(const char *path);
+
+// Compares two modules or saved snapshots, in any combination, and prints
+// each difference. Returns 0 when they match, 1 when they differ and 2 when
+// either side cannot be loaded.
+int mc_dump_diff(const char *left_path, const char *right_path);
+
+#endif
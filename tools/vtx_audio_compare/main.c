@@ -0,0 +1,1627 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Products are accumulated exactly as scripts/audio-compare.py does, one
+// rounding per operation, so the rounded JSON matches it digit for digit.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
+
+#define COMPARE_DEFAULT_SECONDS 30.0
+#define COMPARE_DEFAULT_DIFF_THRESHOLD 1.0e-4
+#define COMPARE_DEFAULT_NEAR_SILENCE_THRESHOLD 1.0e-5
+#define COMPARE_DEFAULT_WINDOW_MS 100.0
+#define COMPARE_DEFAULT_TOP_WINDOWS 5u
+#define COMPARE_DEFAULT_CLICK_THRESHOLD_PCM16 12000u
+#define COMPARE_DEFAULT_TOP_CLICKS 50u
+#define COMPARE_MAX_ALIGN_MS 1000.0
+#define COMPARE_CHUNK_FRAMES 4096u
+#define COMPARE_JSON_MAX_DEPTH 16
+
+typedef struct {
+    const char *reference_path;
+    const char *candidate_path;
+    const char *json_path;
+    double seconds;
+    double diff_threshold;
+    double near_silence_threshold;
+    double window_ms;
+    uint32_t top_windows;
+    double align_max_ms;
+    int clicks;
+    uint32_t click_threshold_pcm16;
+    uint32_t top_clicks;
+} compare_options;
+
+typedef struct {
+    FILE *file;
+    const char *path;
+    uint32_t sample_rate;
+    uint32_t channel_count;
+    uint32_t sample_width;
+    int is_float;
+    uint64_t frame_count;
+    uint64_t frames_remaining;
+    uint8_t *raw;
+} compare_wav;
+
+typedef struct {
+    uint32_t channel_count;
+    double near_silence_threshold;
+    double clipping_threshold;
+    uint64_t frames;
+    uint64_t sample_count;
+    double square_sum;
+    double peak;
+    double *channel_square_sum;
+    double *channel_peak;
+    uint64_t clipping_count;
+    uint64_t near_silence_count;
+} compare_stats;
+
+typedef struct {
+    uint64_t start_frame;
+    uint64_t end_frame;
+    double rms_difference;
+    double max_abs_difference;
+} compare_window;
+
+// Difference metrics over the frames both files share. Windows are closed as
+// the stream passes them and only the worst top_limit are kept.
+typedef struct {
+    uint32_t channel_count;
+    double diff_threshold;
+    uint64_t frames;
+    uint64_t sample_count;
+    int has_first_difference;
+    uint64_t first_difference_sample;
+    double dot;
+    double reference_square_sum;
+    double candidate_square_sum;
+    double diff_square_sum;
+    double max_abs_difference;
+    double *channel_diff_square_sum;
+    uint64_t window_frames;
+    uint64_t window_start;
+    uint64_t window_filled;
+    double window_square_sum;
+    double window_max_abs;
+    uint32_t top_limit;
+    size_t top_count;
+    size_t top_capacity;
+    compare_window *top;
+} compare_pair;
+
+typedef struct {
+    uint64_t frame;
+    uint32_t channel;
+    int32_t magnitude_pcm16;
+    double magnitude_normalized;
+    int32_t before_pcm16;
+    int32_t after_pcm16;
+    double before_normalized;
+    double after_normalized;
+} compare_jump;
+
+// Adjacent-sample jump scan, as scripts/analyze-audio-discontinuities.py
+// does it, over the analyzed span of one file.
+typedef struct {
+    uint32_t channel_count;
+    uint32_t sample_rate;
+    uint32_t threshold_pcm16;
+    uint32_t top_limit;
+    uint64_t frames;
+    int32_t *previous_pcm16;
+    double *previous_normalized;
+    uint64_t *count_by_channel;
+    uint64_t total;
+    uint64_t *count_by_second;
+    size_t second_capacity;
+    compare_jump *heap;
+    size_t heap_count;
+} compare_clicks;
+
+// Streaming cross-correlation of the mono mixes for lags in -max_lag...max_lag.
+// Reference blocks of block_frames are correlated against the candidate span
+// that extends max_lag past both ends, by overlap-save FFT, and the per-lag
+// sums are accumulated over the whole stream.
+typedef struct {
+    uint32_t max_lag;
+    uint32_t fft_size;
+    uint32_t block_frames;
+    uint32_t sample_rate;
+    double *reference;
+    uint64_t reference_base;
+    size_t reference_length;
+    size_t reference_capacity;
+    double *candidate;
+    uint64_t candidate_base;
+    size_t candidate_length;
+    size_t candidate_capacity;
+    uint64_t reference_read;
+    uint64_t candidate_read;
+    int reference_ended;
+    int candidate_ended;
+    uint64_t block_start;
+    double reference_energy;
+    double candidate_energy;
+    double *correlation;
+    double *x_re;
+    double *x_im;
+    double *y_re;
+    double *y_im;
+    double *cos_table;
+    double *sin_table;
+    double *mono;
+} compare_align;
+
+typedef struct {
+    FILE *out;
+    int depth;
+    int has_items[COMPARE_JSON_MAX_DEPTH];
+} compare_json;
+
+static void print_usage(const char *argv0) {
+    fprintf(stderr,
+        "usage: %s --reference PATH --candidate PATH [options]\n"
+        "  --reference PATH              reference PCM WAV\n"
+        "  --candidate PATH              candidate PCM WAV\n"
+        "  --json PATH                   write the JSON report here (default: stdout)\n"
+        "  --seconds X                   seconds to compare from the start (default %g)\n"
+        "  --diff-threshold X            first-difference threshold (default %g)\n"
+        "  --near-silence-threshold X    near-silence threshold (default %g)\n"
+        "  --window-ms X                 worst-window size in ms (default %g)\n"
+        "  --top-windows N               worst windows to report (default %u)\n"
+        "  --align-max-ms X              search the best alignment offset within +/-X ms (max %g)\n"
+        "  --clicks                      report adjacent-sample jumps for both files\n"
+        "  --click-threshold-pcm16 N     jump threshold in PCM16 steps (default %u)\n"
+        "  --top-clicks N                largest jumps to report per file (default %u)\n",
+        argv0,
+        COMPARE_DEFAULT_SECONDS,
+        COMPARE_DEFAULT_DIFF_THRESHOLD,
+        COMPARE_DEFAULT_NEAR_SILENCE_THRESHOLD,
+        COMPARE_DEFAULT_WINDOW_MS,
+        COMPARE_DEFAULT_TOP_WINDOWS,
+        COMPARE_MAX_ALIGN_MS,
+        COMPARE_DEFAULT_CLICK_THRESHOLD_PCM16,
+        COMPARE_DEFAULT_TOP_CLICKS);
+}
+
+static int parse_u32(const char *text, uint32_t minimum, uint32_t maximum, uint32_t *out) {
+    char *end = NULL;
+    unsigned long value = strtoul(text, &end, 10);
+    if (end == NULL || *end != '\0' || text[0] == '-' || value < minimum || value > maximum) {
+        return 0;
+    }
+    *out = (uint32_t)value;
+    return 1;
+}
+
+static int parse_double(const char *text, double minimum, double maximum, double *out) {
+    char *end = NULL;
+    double value = strtod(text, &end);
+    if (end == NULL || *end != '\0' || !isfinite(value) || value < minimum || value > maximum) {
+        return 0;
+    }
+    *out = value;
+    return 1;
+}
+
+// Python's round(value, 9): correctly rounded, ties to even.
+static double compare_round(double value) {
+    char text[512];
+
+    if (!isfinite(value)) {
+        return value;
+    }
+    snprintf(text, sizeof(text), "%.9f", value);
+    return strtod(text, NULL);
+}
+
+static double compare_dbfs(double value) {
+    return 20.0 * log10(value);
+}
+
+// --- WAV input -------------------------------------------------------------
+
+static uint32_t compare_le32(const uint8_t *bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static uint16_t compare_le16(const uint8_t *bytes) {
+    return (uint16_t)(bytes[0] | (bytes[1] << 8));
+}
+
+// Accepts what Python's wave module reads (PCM, 1-4 byte samples), plus
+// 32-bit float and WAVE_FORMAT_EXTENSIBLE so PlayerCore f32 renders compare
+// directly. Sizes come from the header, as in wave.
+static int compare_wav_open(compare_wav *wav, const char *path, char *error, size_t error_size) {
+    uint8_t header[12];
+    uint8_t chunk[8];
+    uint8_t fmt[40];
+    int has_fmt = 0;
+    uint32_t format_tag = 0;
+    uint32_t bits = 0;
+
+    memset(wav, 0, sizeof(*wav));
+    wav->path = path;
+    wav->file = fopen(path, "rb");
+    if (wav->file == NULL) {
+        snprintf(error, error_size, "cannot open file");
+        return 0;
+    }
+    if (fread(header, 1, sizeof(header), wav->file) != sizeof(header) || memcmp(header, "RIFF", 4) != 0) {
+        snprintf(error, error_size, "file does not start with RIFF id");
+        return 0;
+    }
+    if (memcmp(header + 8, "WAVE", 4) != 0) {
+        snprintf(error, error_size, "not a WAVE file");
+        return 0;
+    }
+    for (;;) {
+        uint32_t size;
+
+        if (fread(chunk, 1, sizeof(chunk), wav->file) != sizeof(chunk)) {
+            snprintf(error, error_size, "fmt chunk and/or data chunk missing");
+            return 0;
+        }
+        size = compare_le32(chunk + 4);
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            size_t wanted = size < sizeof(fmt) ? size : sizeof(fmt);
+            memset(fmt, 0, sizeof(fmt));
+            if (size < 14u || fread(fmt, 1, wanted, wav->file) != wanted) {
+                snprintf(error, error_size, "truncated fmt chunk");
+                return 0;
+            }
+            if (fseek(wav->file, (long)(size - wanted + (size & 1u)), SEEK_CUR) != 0) {
+                snprintf(error, error_size, "truncated fmt chunk");
+                return 0;
+            }
+            format_tag = compare_le16(fmt);
+            wav->channel_count = compare_le16(fmt + 2);
+            wav->sample_rate = compare_le32(fmt + 4);
+            bits = size >= 16u ? compare_le16(fmt + 14) : 0u;
+            if (format_tag == 0xFFFEu && size >= 26u) {
+                format_tag = compare_le16(fmt + 24);
+            }
+            has_fmt = 1;
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (!has_fmt) {
+                snprintf(error, error_size, "data chunk before fmt chunk");
+                return 0;
+            }
+            if (format_tag == 3u && bits == 32u) {
+                wav->is_float = 1;
+            } else if (format_tag != 1u) {
+                snprintf(error, error_size, "unknown format: %u", format_tag);
+                return 0;
+            }
+            wav->sample_width = (bits + 7u) / 8u;
+            if (wav->channel_count == 0u) {
+                snprintf(error, error_size, "channel count must be greater than zero");
+                return 0;
+            }
+            if (wav->sample_rate == 0u) {
+                snprintf(error, error_size, "sample rate must be greater than zero");
+                return 0;
+            }
+            if (wav->sample_width < 1u || wav->sample_width > 4u) {
+                snprintf(error, error_size, "unsupported sample width: %u bytes", wav->sample_width);
+                return 0;
+            }
+            wav->frame_count = size / ((uint64_t)wav->channel_count * wav->sample_width);
+            break;
+        } else if (fseek(wav->file, (long)size + (long)(size & 1u), SEEK_CUR) != 0) {
+            snprintf(error, error_size, "fmt chunk and/or data chunk missing");
+            return 0;
+        }
+    }
+    wav->raw = (uint8_t *)malloc((size_t)COMPARE_CHUNK_FRAMES * wav->channel_count * wav->sample_width);
+    if (wav->raw == NULL) {
+        snprintf(error, error_size, "out of memory");
+        return 0;
+    }
+    return 1;
+}
+
+static void compare_wav_close(compare_wav *wav) {
+    if (wav->file != NULL) {
+        fclose(wav->file);
+    }
+    free(wav->raw);
+}
+
+// Decodes up to COMPARE_CHUNK_FRAMES whole frames to -1...1 doubles the way
+// wave + audio-compare.py scale them. Returns the frame count; 0 at the end.
+static uint32_t compare_wav_read(compare_wav *wav, double *out) {
+    size_t frame_bytes = (size_t)wav->channel_count * wav->sample_width;
+    size_t wanted = COMPARE_CHUNK_FRAMES;
+    size_t frames;
+    size_t sample_count;
+    size_t index;
+
+    if (wav->frames_remaining < wanted) {
+        wanted = (size_t)wav->frames_remaining;
+    }
+    if (wanted == 0u) {
+        return 0u;
+    }
+    frames = fread(wav->raw, frame_bytes, wanted, wav->file);
+    wav->frames_remaining = frames < wanted ? 0u : wav->frames_remaining - frames;
+    sample_count = frames * wav->channel_count;
+    switch (wav->sample_width) {
+    case 1u:
+        for (index = 0; index < sample_count; index++) {
+            out[index] = ((int)wav->raw[index] - 128) / 128.0;
+        }
+        break;
+    case 2u:
+        for (index = 0; index < sample_count; index++) {
+            int16_t value = (int16_t)compare_le16(wav->raw + index * 2u);
+            out[index] = value / 32768.0;
+        }
+        break;
+    case 3u:
+        for (index = 0; index < sample_count; index++) {
+            const uint8_t *bytes = wav->raw + index * 3u;
+            int32_t value = (int32_t)((uint32_t)bytes[0] << 8 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 24) >> 8;
+            out[index] = value / 8388608.0;
+        }
+        break;
+    default:
+        for (index = 0; index < sample_count; index++) {
+            uint32_t bits = compare_le32(wav->raw + index * 4u);
+            if (wav->is_float) {
+                float value;
+                memcpy(&value, &bits, sizeof(value));
+                out[index] = (double)value;
+            } else {
+                out[index] = (int32_t)bits / 2147483648.0;
+            }
+        }
+        break;
+    }
+    return (uint32_t)frames;
+}
+
+// --- Per-file levels -------------------------------------------------------
+
+static int compare_stats_init(compare_stats *stats, const compare_wav *wav, double near_silence_threshold) {
+    memset(stats, 0, sizeof(*stats));
+    stats->channel_count = wav->channel_count;
+    stats->near_silence_threshold = near_silence_threshold;
+    stats->clipping_threshold = 1.0 - (1.0 / (double)(1ull << (wav->sample_width * 8u - 1u)));
+    stats->channel_square_sum = (double *)calloc(wav->channel_count, sizeof(double));
+    stats->channel_peak = (double *)calloc(wav->channel_count, sizeof(double));
+    return stats->channel_square_sum != NULL && stats->channel_peak != NULL;
+}
+
+static void compare_stats_free(compare_stats *stats) {
+    free(stats->channel_square_sum);
+    free(stats->channel_peak);
+}
+
+static void compare_stats_add(compare_stats *stats, const double *samples, uint32_t frames) {
+    uint32_t channels = stats->channel_count;
+    uint32_t frame;
+    uint32_t channel;
+
+    for (frame = 0; frame < frames; frame++) {
+        for (channel = 0; channel < channels; channel++) {
+            double sample = samples[(size_t)frame * channels + channel];
+            double square = sample * sample;
+            double magnitude = fabs(sample);
+
+            stats->square_sum += square;
+            stats->channel_square_sum[channel] += square;
+            if (magnitude > stats->peak) {
+                stats->peak = magnitude;
+            }
+            if (magnitude > stats->channel_peak[channel]) {
+                stats->channel_peak[channel] = magnitude;
+            }
+            stats->near_silence_count += magnitude <= stats->near_silence_threshold;
+            stats->clipping_count += magnitude >= stats->clipping_threshold;
+        }
+    }
+    stats->frames += frames;
+    stats->sample_count += (uint64_t)frames * channels;
+}
+
+static double compare_stats_rms(const compare_stats *stats) {
+    return stats->sample_count > 0u ? sqrt(stats->square_sum / (double)stats->sample_count) : 0.0;
+}
+
+static double compare_stats_channel_rms(const compare_stats *stats, uint32_t channel) {
+    return stats->frames > 0u ? sqrt(stats->channel_square_sum[channel] / (double)stats->frames) : 0.0;
+}
+
+// --- Reference/candidate differences ---------------------------------------
+
+static int compare_pair_init(compare_pair *pair, uint32_t channels, uint32_t sample_rate, const compare_options *options) {
+    memset(pair, 0, sizeof(*pair));
+    pair->channel_count = channels;
+    pair->diff_threshold = options->diff_threshold;
+    pair->window_frames = (uint64_t)(sample_rate * options->window_ms / 1000.0);
+    if (pair->window_frames == 0u) {
+        pair->window_frames = 1u;
+    }
+    pair->top_limit = options->top_windows;
+    pair->channel_diff_square_sum = (double *)calloc(channels, sizeof(double));
+    return pair->channel_diff_square_sum != NULL;
+}
+
+static void compare_pair_free(compare_pair *pair) {
+    free(pair->channel_diff_square_sum);
+    free(pair->top);
+}
+
+// Ranked like audio-compare.py: by rounded RMS difference, descending, then by
+// start frame. Windows arrive in start order, so a new window goes after every
+// kept window with an equal or larger rounded RMS.
+static int compare_pair_close_window(compare_pair *pair) {
+    compare_window window;
+    size_t position;
+
+    if (pair->window_filled == 0u) {
+        return 1;
+    }
+    window.start_frame = pair->window_start;
+    window.end_frame = pair->window_start + pair->window_filled;
+    window.rms_difference = compare_round(sqrt(pair->window_square_sum / (double)(pair->window_filled * pair->channel_count)));
+    window.max_abs_difference = pair->window_max_abs;
+    pair->window_start = window.end_frame;
+    pair->window_filled = 0u;
+    pair->window_square_sum = 0.0;
+    pair->window_max_abs = 0.0;
+
+    if (pair->top_limit == 0u) {
+        return 1;
+    }
+    position = pair->top_count;
+    while (position > 0u && pair->top[position - 1u].rms_difference < window.rms_difference) {
+        position--;
+    }
+    if (position >= pair->top_limit) {
+        return 1;
+    }
+    if (pair->top_count == pair->top_capacity && pair->top_count < pair->top_limit) {
+        size_t capacity = pair->top_capacity == 0u ? 16u : pair->top_capacity * 2u;
+        compare_window *grown;
+        if (capacity > pair->top_limit) {
+            capacity = pair->top_limit;
+        }
+        grown = (compare_window *)realloc(pair->top, capacity * sizeof(*grown));
+        if (grown == NULL) {
+            return 0;
+        }
+        pair->top = grown;
+        pair->top_capacity = capacity;
+    }
+    if (pair->top_count < pair->top_limit) {
+        pair->top_count++;
+    }
+    memmove(pair->top + position + 1u, pair->top + position, (pair->top_count - 1u - position) * sizeof(*pair->top));
+    pair->top[position] = window;
+    return 1;
+}
+
+static int compare_pair_add(compare_pair *pair, const double *reference, const double *candidate, uint32_t frames) {
+    uint32_t channels = pair->channel_count;
+    uint32_t frame;
+    uint32_t channel;
+
+    for (frame = 0; frame < frames; frame++) {
+        for (channel = 0; channel < channels; channel++) {
+            size_t index = (size_t)frame * channels + channel;
+            double ref = reference[index];
+            double cand = candidate[index];
+            double product = ref * cand;
+            double ref_square = ref * ref;
+            double cand_square = cand * cand;
+            double diff = cand - ref;
+            double diff_square = diff * diff;
+            double magnitude = fabs(diff);
+
+            if (!pair->has_first_difference && magnitude > pair->diff_threshold) {
+                pair->has_first_difference = 1;
+                pair->first_difference_sample = pair->sample_count + index;
+            }
+            pair->dot += product;
+            pair->reference_square_sum += ref_square;
+            pair->candidate_square_sum += cand_square;
+            pair->diff_square_sum += diff_square;
+            pair->channel_diff_square_sum[channel] += diff_square;
+            pair->window_square_sum += diff_square;
+            if (magnitude > pair->max_abs_difference) {
+                pair->max_abs_difference = magnitude;
+            }
+            if (magnitude > pair->window_max_abs) {
+                pair->window_max_abs = magnitude;
+            }
+        }
+        pair->window_filled++;
+        if (pair->window_filled == pair->window_frames && !compare_pair_close_window(pair)) {
+            return 0;
+        }
+    }
+    pair->frames += frames;
+    pair->sample_count += (uint64_t)frames * channels;
+    return 1;
+}
+
+// --- Adjacent-sample jumps -------------------------------------------------
+
+static int compare_clicks_init(compare_clicks *clicks, const compare_wav *wav, const compare_options *options) {
+    memset(clicks, 0, sizeof(*clicks));
+    clicks->channel_count = wav->channel_count;
+    clicks->sample_rate = wav->sample_rate;
+    clicks->threshold_pcm16 = options->click_threshold_pcm16;
+    clicks->top_limit = options->top_clicks;
+    clicks->previous_pcm16 = (int32_t *)calloc(wav->channel_count, sizeof(int32_t));
+    clicks->previous_normalized = (double *)calloc(wav->channel_count, sizeof(double));
+    clicks->count_by_channel = (uint64_t *)calloc(wav->channel_count, sizeof(uint64_t));
+    clicks->heap = (compare_jump *)malloc(((size_t)options->top_clicks + 1u) * sizeof(compare_jump));
+    return clicks->previous_pcm16 != NULL && clicks->previous_normalized != NULL &&
+        clicks->count_by_channel != NULL && clicks->heap != NULL;
+}
+
+static void compare_clicks_free(compare_clicks *clicks) {
+    free(clicks->previous_pcm16);
+    free(clicks->previous_normalized);
+    free(clicks->count_by_channel);
+    free(clicks->count_by_second);
+    free(clicks->heap);
+}
+
+// Heap order is the discontinuity script's key: magnitude, then earlier frame,
+// then lower channel ranks higher. The root is the weakest kept jump.
+static int compare_jump_weaker(const compare_jump *a, const compare_jump *b) {
+    if (a->magnitude_pcm16 != b->magnitude_pcm16) {
+        return a->magnitude_pcm16 < b->magnitude_pcm16;
+    }
+    if (a->frame != b->frame) {
+        return a->frame > b->frame;
+    }
+    return a->channel > b->channel;
+}
+
+static void compare_heap_sift_down(compare_jump *heap, size_t count, size_t index) {
+    for (;;) {
+        size_t weakest = index;
+        size_t left = index * 2u + 1u;
+        size_t right = left + 1u;
+        compare_jump swap;
+
+        if (left < count && compare_jump_weaker(&heap[left], &heap[weakest])) {
+            weakest = left;
+        }
+        if (right < count && compare_jump_weaker(&heap[right], &heap[weakest])) {
+            weakest = right;
+        }
+        if (weakest == index) {
+            return;
+        }
+        swap = heap[index];
+        heap[index] = heap[weakest];
+        heap[weakest] = swap;
+        index = weakest;
+    }
+}
+
+static void compare_clicks_keep(compare_clicks *clicks, const compare_jump *jump) {
+    size_t index;
+
+    if (clicks->heap_count < clicks->top_limit) {
+        index = clicks->heap_count++;
+        clicks->heap[index] = *jump;
+        while (index > 0u) {
+            size_t parent = (index - 1u) / 2u;
+            compare_jump swap;
+            if (!compare_jump_weaker(&clicks->heap[index], &clicks->heap[parent])) {
+                break;
+            }
+            swap = clicks->heap[index];
+            clicks->heap[index] = clicks->heap[parent];
+            clicks->heap[parent] = swap;
+            index = parent;
+        }
+    } else if (compare_jump_weaker(&clicks->heap[0], jump)) {
+        clicks->heap[0] = *jump;
+        compare_heap_sift_down(clicks->heap, clicks->heap_count, 0u);
+    }
+}
+
+static int compare_clicks_add(compare_clicks *clicks, const double *samples, uint32_t frames) {
+    uint32_t channels = clicks->channel_count;
+    uint32_t frame;
+    uint32_t channel;
+
+    for (frame = 0; frame < frames; frame++) {
+        uint64_t frame_index = clicks->frames + frame;
+        for (channel = 0; channel < channels; channel++) {
+            double normalized = samples[(size_t)frame * channels + channel];
+            double scaled = rint(normalized * 32768.0);
+            int32_t pcm16 = !isfinite(normalized) ? 0 : scaled > 32767.0 ? 32767 : scaled < -32768.0 ? -32768 : (int32_t)scaled;
+
+            if (frame_index > 0u) {
+                compare_jump jump;
+                jump.frame = frame_index;
+                jump.channel = channel;
+                jump.magnitude_pcm16 = abs(pcm16 - clicks->previous_pcm16[channel]);
+                jump.magnitude_normalized = fabs(normalized - clicks->previous_normalized[channel]);
+                jump.before_pcm16 = clicks->previous_pcm16[channel];
+                jump.after_pcm16 = pcm16;
+                jump.before_normalized = clicks->previous_normalized[channel];
+                jump.after_normalized = normalized;
+                if (jump.magnitude_pcm16 > (int32_t)clicks->threshold_pcm16) {
+                    size_t second = (size_t)((double)frame_index / clicks->sample_rate);
+                    if (second >= clicks->second_capacity) {
+                        size_t capacity = clicks->second_capacity == 0u ? 64u : clicks->second_capacity;
+                        uint64_t *grown;
+                        while (capacity <= second) {
+                            capacity *= 2u;
+                        }
+                        grown = (uint64_t *)realloc(clicks->count_by_second, capacity * sizeof(*grown));
+                        if (grown == NULL) {
+                            return 0;
+                        }
+                        memset(grown + clicks->second_capacity, 0, (capacity - clicks->second_capacity) * sizeof(*grown));
+                        clicks->count_by_second = grown;
+                        clicks->second_capacity = capacity;
+                    }
+                    clicks->count_by_channel[channel]++;
+                    clicks->count_by_second[second]++;
+                    clicks->total++;
+                }
+                if (clicks->top_limit > 0u) {
+                    compare_clicks_keep(clicks, &jump);
+                }
+            }
+            clicks->previous_pcm16[channel] = pcm16;
+            clicks->previous_normalized[channel] = normalized;
+        }
+    }
+    clicks->frames += frames;
+    return 1;
+}
+
+static int compare_jump_rank_order(const void *a, const void *b) {
+    const compare_jump *left = (const compare_jump *)a;
+    const compare_jump *right = (const compare_jump *)b;
+    if (compare_jump_weaker(right, left)) {
+        return -1;
+    }
+    return compare_jump_weaker(left, right) ? 1 : 0;
+}
+
+// --- FFT alignment ---------------------------------------------------------
+
+static void compare_fft(double *re, double *im, uint32_t n, const double *cos_table, const double *sin_table, int inverse) {
+    uint32_t i;
+    uint32_t j = 0;
+    uint32_t length;
+
+    for (i = 1; i < n; i++) {
+        uint32_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            double swap = re[i];
+            re[i] = re[j];
+            re[j] = swap;
+            swap = im[i];
+            im[i] = im[j];
+            im[j] = swap;
+        }
+    }
+    for (length = 2; length <= n; length <<= 1) {
+        uint32_t half = length >> 1;
+        uint32_t step = n / length;
+        uint32_t start;
+        for (start = 0; start < n; start += length) {
+            uint32_t k;
+            for (k = 0; k < half; k++) {
+                double w_re = cos_table[k * step];
+                double w_im = inverse ? sin_table[k * step] : -sin_table[k * step];
+                uint32_t a = start + k;
+                uint32_t b = a + half;
+                double t_re = re[b] * w_re - im[b] * w_im;
+                double t_im = re[b] * w_im + im[b] * w_re;
+                re[b] = re[a] - t_re;
+                im[b] = im[a] - t_im;
+                re[a] += t_re;
+                im[a] += t_im;
+            }
+        }
+    }
+}
+
+static int compare_align_init(compare_align *align, uint32_t sample_rate, double max_ms) {
+    uint32_t span;
+    uint32_t index;
+
+    memset(align, 0, sizeof(*align));
+    align->sample_rate = sample_rate;
+    align->max_lag = (uint32_t)(sample_rate * max_ms / 1000.0);
+    span = 2u * align->max_lag + 1u;
+    align->fft_size = 4096u;
+    while (align->fft_size < 4u * span) {
+        align->fft_size <<= 1;
+    }
+    align->block_frames = align->fft_size - 2u * align->max_lag;
+    align->reference_capacity = (size_t)align->block_frames + align->max_lag + COMPARE_CHUNK_FRAMES;
+    align->candidate_capacity = (size_t)align->block_frames + 2u * align->max_lag + COMPARE_CHUNK_FRAMES;
+    align->reference = (double *)malloc(align->reference_capacity * sizeof(double));
+    align->candidate = (double *)malloc(align->candidate_capacity * sizeof(double));
+    align->correlation = (double *)calloc(span, sizeof(double));
+    align->x_re = (double *)malloc((size_t)align->fft_size * sizeof(double));
+    align->x_im = (double *)malloc((size_t)align->fft_size * sizeof(double));
+    align->y_re = (double *)malloc((size_t)align->fft_size * sizeof(double));
+    align->y_im = (double *)malloc((size_t)align->fft_size * sizeof(double));
+    align->cos_table = (double *)malloc((size_t)(align->fft_size / 2u) * sizeof(double));
+    align->sin_table = (double *)malloc((size_t)(align->fft_size / 2u) * sizeof(double));
+    align->mono = (double *)malloc((size_t)COMPARE_CHUNK_FRAMES * sizeof(double));
+    if (align->reference == NULL || align->candidate == NULL || align->correlation == NULL ||
+        align->x_re == NULL || align->x_im == NULL || align->y_re == NULL || align->y_im == NULL ||
+        align->cos_table == NULL || align->sin_table == NULL || align->mono == NULL) {
+        return 0;
+    }
+    for (index = 0; index < align->fft_size / 2u; index++) {
+        double angle = 2.0 * M_PI * index / align->fft_size;
+        align->cos_table[index] = cos(angle);
+        align->sin_table[index] = sin(angle);
+    }
+    return 1;
+}
+
+static void compare_align_free(compare_align *align) {
+    free(align->reference);
+    free(align->candidate);
+    free(align->correlation);
+    free(align->x_re);
+    free(align->x_im);
+    free(align->y_re);
+    free(align->y_im);
+    free(align->cos_table);
+    free(align->sin_table);
+    free(align->mono);
+}
+
+static void compare_align_block(compare_align *align) {
+    uint64_t block_end = align->block_start + align->block_frames;
+    uint64_t reference_end = block_end < align->reference_read ? block_end : align->reference_read;
+    uint32_t n = align->fft_size;
+    uint32_t span = 2u * align->max_lag + 1u;
+    uint32_t index;
+
+    memset(align->x_re, 0, (size_t)n * sizeof(double));
+    memset(align->x_im, 0, (size_t)n * sizeof(double));
+    memset(align->y_re, 0, (size_t)n * sizeof(double));
+    memset(align->y_im, 0, (size_t)n * sizeof(double));
+    for (index = 0; index < reference_end - align->block_start; index++) {
+        align->x_re[index] = align->reference[align->block_start - align->reference_base + index];
+    }
+    for (index = 0; index < align->block_frames + 2u * align->max_lag; index++) {
+        int64_t frame = (int64_t)align->block_start - (int64_t)align->max_lag + index;
+        if (frame >= (int64_t)align->candidate_base &&
+            frame < (int64_t)(align->candidate_base + align->candidate_length)) {
+            align->y_re[index] = align->candidate[frame - (int64_t)align->candidate_base];
+        }
+    }
+    compare_fft(align->x_re, align->x_im, n, align->cos_table, align->sin_table, 0);
+    compare_fft(align->y_re, align->y_im, n, align->cos_table, align->sin_table, 0);
+    for (index = 0; index < n; index++) {
+        double re = align->x_re[index] * align->y_re[index] + align->x_im[index] * align->y_im[index];
+        double im = align->x_re[index] * align->y_im[index] - align->x_im[index] * align->y_re[index];
+        align->y_re[index] = re;
+        align->y_im[index] = im;
+    }
+    compare_fft(align->y_re, align->y_im, n, align->cos_table, align->sin_table, 1);
+    for (index = 0; index < span; index++) {
+        align->correlation[index] += align->y_re[index] / n;
+    }
+}
+
+static void compare_align_process(compare_align *align) {
+    for (;;) {
+        uint64_t block_end = align->block_start + align->block_frames;
+        uint64_t reference_end;
+        uint64_t keep_from;
+        size_t drop;
+
+        if (align->reference_ended && align->block_start >= align->reference_read) {
+            return;
+        }
+        if (!align->reference_ended && align->reference_read < block_end) {
+            return;
+        }
+        reference_end = block_end < align->reference_read ? block_end : align->reference_read;
+        if (!align->candidate_ended && align->candidate_read < reference_end + align->max_lag) {
+            return;
+        }
+        compare_align_block(align);
+        align->block_start = block_end;
+
+        keep_from = align->block_start;
+        if (keep_from > align->reference_base) {
+            drop = (size_t)(keep_from - align->reference_base);
+            if (drop > align->reference_length) {
+                drop = align->reference_length;
+            }
+            memmove(align->reference, align->reference + drop, (align->reference_length - drop) * sizeof(double));
+            align->reference_length -= drop;
+            align->reference_base += drop;
+        }
+        keep_from = align->block_start > align->max_lag ? align->block_start - align->max_lag : 0u;
+        if (keep_from > align->candidate_base) {
+            drop = (size_t)(keep_from - align->candidate_base);
+            if (drop > align->candidate_length) {
+                drop = align->candidate_length;
+            }
+            memmove(align->candidate, align->candidate + drop, (align->candidate_length - drop) * sizeof(double));
+            align->candidate_length -= drop;
+            align->candidate_base += drop;
+        }
+    }
+}
+
+static void compare_align_push(compare_align *align, const double *samples, uint32_t frames, uint32_t channels, int reference) {
+    uint32_t frame;
+    uint32_t channel;
+
+    for (frame = 0; frame < frames; frame++) {
+        double sum = 0.0;
+        double mono;
+        double square;
+        for (channel = 0; channel < channels; channel++) {
+            sum += samples[(size_t)frame * channels + channel];
+        }
+        mono = sum / channels;
+        square = mono * mono;
+        align->mono[frame] = mono;
+        if (reference) {
+            align->reference_energy += square;
+        } else {
+            align->candidate_energy += square;
+        }
+    }
+    if (reference) {
+        memcpy(align->reference + align->reference_length, align->mono, (size_t)frames * sizeof(double));
+        align->reference_length += frames;
+        align->reference_read += frames;
+        return;
+    }
+    for (frame = 0; frame < frames; frame++) {
+        uint64_t index = align->candidate_read + frame;
+        // Past the reference end only max_lag frames can still matter.
+        if (align->reference_ended && index >= align->reference_read + align->max_lag) {
+            break;
+        }
+        if (align->candidate_length < align->candidate_capacity) {
+            align->candidate[align->candidate_length++] = align->mono[frame];
+        }
+    }
+    align->candidate_read += frames;
+}
+
+// --- JSON ------------------------------------------------------------------
+// Mirrors json.dumps(indent=2, sort_keys=True): callers emit keys in sorted
+// order and floats print as Python's shortest round-trip repr.
+
+static void compare_format_float(double value, char *out, size_t size) {
+    char text[40];
+    char digits[20];
+    int digit_count = 0;
+    int precision;
+    int exponent;
+    int decimal_point;
+    const char *cursor;
+    size_t used = 0;
+
+    if (isnan(value)) {
+        snprintf(out, size, "NaN");
+        return;
+    }
+    if (isinf(value)) {
+        snprintf(out, size, value < 0.0 ? "-Infinity" : "Infinity");
+        return;
+    }
+    if (value == 0.0) {
+        snprintf(out, size, signbit(value) ? "-0.0" : "0.0");
+        return;
+    }
+    for (precision = 1; precision < 17; precision++) {
+        snprintf(text, sizeof(text), "%.*e", precision - 1, value);
+        if (strtod(text, NULL) == value) {
+            break;
+        }
+    }
+    snprintf(text, sizeof(text), "%.*e", precision - 1, value);
+    cursor = text;
+    if (*cursor == '-') {
+        out[used++] = '-';
+        cursor++;
+    }
+    for (; *cursor != 'e'; cursor++) {
+        if (*cursor != '.') {
+            digits[digit_count++] = *cursor;
+        }
+    }
+    while (digit_count > 1 && digits[digit_count - 1] == '0') {
+        digit_count--;
+    }
+    exponent = atoi(cursor + 1);
+    decimal_point = exponent + 1;
+    if (decimal_point <= -4 || decimal_point > 16) {
+        out[used++] = digits[0];
+        if (digit_count > 1) {
+            out[used++] = '.';
+            memcpy(out + used, digits + 1, (size_t)digit_count - 1u);
+            used += (size_t)digit_count - 1u;
+        }
+        snprintf(out + used, size - used, "e%c%02d", exponent < 0 ? '-' : '+', abs(exponent));
+        return;
+    }
+    if (decimal_point <= 0) {
+        out[used++] = '0';
+        out[used++] = '.';
+        for (; decimal_point < 0; decimal_point++) {
+            out[used++] = '0';
+        }
+        memcpy(out + used, digits, (size_t)digit_count);
+        used += (size_t)digit_count;
+    } else if (decimal_point < digit_count) {
+        memcpy(out + used, digits, (size_t)decimal_point);
+        used += (size_t)decimal_point;
+        out[used++] = '.';
+        memcpy(out + used, digits + decimal_point, (size_t)(digit_count - decimal_point));
+        used += (size_t)(digit_count - decimal_point);
+    } else {
+        memcpy(out + used, digits, (size_t)digit_count);
+        used += (size_t)digit_count;
+        for (; decimal_point > digit_count; decimal_point--) {
+            out[used++] = '0';
+        }
+        out[used++] = '.';
+        out[used++] = '0';
+    }
+    out[used] = '\0';
+}
+
+static void compare_json_code_unit(FILE *out, uint32_t unit) {
+    fprintf(out, "\\u%04x", unit);
+}
+
+// ensure_ascii escaping. Bytes that are not valid UTF-8 become lone
+// surrogates, as Python's surrogateescape file names do.
+static void compare_json_write_string(FILE *out, const char *text) {
+    const unsigned char *cursor = (const unsigned char *)text;
+
+    fputc('"', out);
+    while (*cursor != '\0') {
+        unsigned char byte = *cursor;
+        uint32_t code_point;
+        int length;
+        int index;
+
+        if (byte < 0x80u) {
+            switch (byte) {
+            case '"': fputs("\\\"", out); break;
+            case '\\': fputs("\\\\", out); break;
+            case '\n': fputs("\\n", out); break;
+            case '\r': fputs("\\r", out); break;
+            case '\t': fputs("\\t", out); break;
+            case '\b': fputs("\\b", out); break;
+            case '\f': fputs("\\f", out); break;
+            default:
+                if (byte < 0x20u) {
+                    compare_json_code_unit(out, byte);
+                } else {
+                    fputc(byte, out);
+                }
+                break;
+            }
+            cursor++;
+            continue;
+        }
+        length = byte >= 0xF0u && byte <= 0xF4u ? 4 : byte >= 0xE0u ? 3 : byte >= 0xC2u ? 2 : 0;
+        code_point = length == 4 ? byte & 0x07u : length == 3 ? byte & 0x0Fu : byte & 0x1Fu;
+        for (index = 1; index < length; index++) {
+            if ((cursor[index] & 0xC0u) != 0x80u) {
+                length = 0;
+                break;
+            }
+            code_point = (code_point << 6) | (cursor[index] & 0x3Fu);
+        }
+        if ((length == 3 && (code_point < 0x800u || (code_point >= 0xD800u && code_point <= 0xDFFFu))) ||
+            (length == 4 && (code_point < 0x10000u || code_point > 0x10FFFFu))) {
+            length = 0;
+        }
+        if (length == 0) {
+            compare_json_code_unit(out, 0xDC00u + byte);
+            cursor++;
+            continue;
+        }
+        if (code_point >= 0x10000u) {
+            code_point -= 0x10000u;
+            compare_json_code_unit(out, 0xD800u + (code_point >> 10));
+            compare_json_code_unit(out, 0xDC00u + (code_point & 0x3FFu));
+        } else {
+            compare_json_code_unit(out, code_point);
+        }
+        cursor += length;
+    }
+    fputc('"', out);
+}
+
+static void compare_json_prefix(compare_json *json, const char *key) {
+    int indent;
+
+    if (json->depth > 0) {
+        fputs(json->has_items[json->depth] ? ",\n" : "\n", json->out);
+        json->has_items[json->depth] = 1;
+        for (indent = 0; indent < json->depth; indent++) {
+            fputs("  ", json->out);
+        }
+    }
+    if (key != NULL) {
+        compare_json_write_string(json->out, key);
+        fputs(": ", json->out);
+    }
+}
+
+static void compare_json_begin(compare_json *json, const char *key, char open) {
+    compare_json_prefix(json, key);
+    fputc(open, json->out);
+    json->depth++;
+    json->has_items[json->depth] = 0;
+}
+
+static void compare_json_end(compare_json *json, char close) {
+    int indent;
+    int had_items = json->has_items[json->depth];
+
+    json->depth--;
+    if (had_items) {
+        fputc('\n', json->out);
+        for (indent = 0; indent < json->depth; indent++) {
+            fputs("  ", json->out);
+        }
+    }
+    fputc(close, json->out);
+}
+
+static void compare_json_int(compare_json *json, const char *key, int64_t value) {
+    compare_json_prefix(json, key);
+    fprintf(json->out, "%lld", (long long)value);
+}
+
+static void compare_json_float(compare_json *json, const char *key, double value) {
+    char text[64];
+    compare_json_prefix(json, key);
+    compare_format_float(compare_round(value), text, sizeof(text));
+    fputs(text, json->out);
+}
+
+static void compare_json_null(compare_json *json, const char *key) {
+    compare_json_prefix(json, key);
+    fputs("null", json->out);
+}
+
+static void compare_json_optional_float(compare_json *json, const char *key, int has_value, double value) {
+    if (has_value) {
+        compare_json_float(json, key, value);
+    } else {
+        compare_json_null(json, key);
+    }
+}
+
+static void compare_json_bool(compare_json *json, const char *key, int value) {
+    compare_json_prefix(json, key);
+    fputs(value ? "true" : "false", json->out);
+}
+
+static void compare_json_string(compare_json *json, const char *key, const char *value) {
+    compare_json_prefix(json, key);
+    compare_json_write_string(json->out, value);
+}
+
+// Path.name: the last component, ignoring trailing slashes.
+static void compare_json_path_name(compare_json *json, const char *key, const char *path) {
+    size_t end = strlen(path);
+    size_t start;
+    char *name;
+
+    while (end > 1u && path[end - 1u] == '/') {
+        end--;
+    }
+    start = end;
+    while (start > 0u && path[start - 1u] != '/') {
+        start--;
+    }
+    name = (char *)malloc(end - start + 1u);
+    if (name == NULL) {
+        compare_json_string(json, key, "");
+        return;
+    }
+    memcpy(name, path + start, end - start);
+    name[end - start] = '\0';
+    if (strcmp(name, ".") == 0 || strcmp(name, "/") == 0) {
+        name[0] = '\0';
+    }
+    compare_json_string(json, key, name);
+    free(name);
+}
+
+static void compare_json_wav_info(compare_json *json, const compare_wav *wav) {
+    compare_json_begin(json, "info", '{');
+    compare_json_int(json, "channel_count", wav->channel_count);
+    compare_json_float(json, "duration_seconds", (double)wav->frame_count / wav->sample_rate);
+    compare_json_int(json, "frame_count", (int64_t)wav->frame_count);
+    compare_json_path_name(json, "path_name", wav->path);
+    compare_json_int(json, "sample_rate", wav->sample_rate);
+    compare_json_int(json, "sample_width_bits", wav->sample_width * 8u);
+    compare_json_end(json, '}');
+}
+
+static void compare_json_stats(compare_json *json, const compare_stats *stats, uint32_t sample_rate) {
+    double rms = compare_stats_rms(stats);
+    uint32_t channel;
+
+    compare_json_begin(json, "stats", '{');
+    compare_json_int(json, "clipping_count", (int64_t)stats->clipping_count);
+    compare_json_float(json, "duration_analyzed_seconds", (double)stats->frames / sample_rate);
+    compare_json_int(json, "frames_analyzed", (int64_t)stats->frames);
+    compare_json_int(json, "near_silence_count", (int64_t)stats->near_silence_count);
+    compare_json_float(
+        json,
+        "near_silence_ratio",
+        stats->sample_count > 0u ? (double)stats->near_silence_count / (double)stats->sample_count : 0.0
+    );
+    compare_json_float(json, "overall_peak", stats->peak);
+    compare_json_optional_float(json, "overall_peak_dbfs", stats->peak > 0.0, stats->peak > 0.0 ? compare_dbfs(stats->peak) : 0.0);
+    compare_json_float(json, "overall_rms", rms);
+    compare_json_optional_float(json, "overall_rms_dbfs", rms > 0.0, rms > 0.0 ? compare_dbfs(rms) : 0.0);
+    compare_json_begin(json, "per_channel_peak", '[');
+    for (channel = 0; channel < stats->channel_count; channel++) {
+        compare_json_float(json, NULL, stats->channel_peak[channel]);
+    }
+    compare_json_end(json, ']');
+    compare_json_begin(json, "per_channel_rms", '[');
+    for (channel = 0; channel < stats->channel_count; channel++) {
+        compare_json_float(json, NULL, compare_stats_channel_rms(stats, channel));
+    }
+    compare_json_end(json, ']');
+    compare_json_begin(json, "stereo_balance", '{');
+    if (stats->channel_count < 2u) {
+        compare_json_null(json, "left_minus_right_rms");
+        compare_json_null(json, "left_right_energy_difference");
+        compare_json_null(json, "left_rms");
+        compare_json_null(json, "right_rms");
+    } else {
+        double left = compare_stats_channel_rms(stats, 0u);
+        double right = compare_stats_channel_rms(stats, 1u);
+        double left_energy = left * left;
+        double right_energy = right * right;
+        compare_json_float(json, "left_minus_right_rms", left - right);
+        compare_json_float(json, "left_right_energy_difference", left_energy - right_energy);
+        compare_json_float(json, "left_rms", left);
+        compare_json_float(json, "right_rms", right);
+    }
+    compare_json_end(json, '}');
+    compare_json_end(json, '}');
+}
+
+static void compare_json_clicks(compare_json *json, compare_clicks *clicks) {
+    double duration = (double)clicks->frames / clicks->sample_rate;
+    size_t index;
+    uint32_t channel;
+
+    qsort(clicks->heap, clicks->heap_count, sizeof(*clicks->heap), compare_jump_rank_order);
+    compare_json_begin(json, "clicks", '{');
+    compare_json_int(json, "threshold_jump_count", (int64_t)clicks->total);
+    compare_json_begin(json, "threshold_jump_count_by_channel", '[');
+    for (channel = 0; channel < clicks->channel_count; channel++) {
+        compare_json_int(json, NULL, (int64_t)clicks->count_by_channel[channel]);
+    }
+    compare_json_end(json, ']');
+    compare_json_begin(json, "threshold_jump_counts_by_second", '[');
+    for (index = 0; index < clicks->second_capacity; index++) {
+        if (clicks->count_by_second[index] == 0u) {
+            continue;
+        }
+        compare_json_begin(json, NULL, '{');
+        compare_json_int(json, "count", (int64_t)clicks->count_by_second[index]);
+        compare_json_int(json, "end_second", (int64_t)index + 1);
+        compare_json_int(json, "start_second", (int64_t)index);
+        compare_json_end(json, '}');
+    }
+    compare_json_end(json, ']');
+    compare_json_float(json, "threshold_jumps_per_second", duration > 0.0 ? clicks->total / duration : 0.0);
+    compare_json_int(json, "threshold_pcm16", clicks->threshold_pcm16);
+    compare_json_begin(json, "top_adjacent_sample_jumps", '[');
+    for (index = 0; index < clicks->heap_count; index++) {
+        const compare_jump *jump = &clicks->heap[index];
+        compare_json_begin(json, NULL, '{');
+        compare_json_int(json, "after_frame", (int64_t)jump->frame);
+        compare_json_float(json, "after_sample_normalized", jump->after_normalized);
+        compare_json_int(json, "after_sample_pcm16", jump->after_pcm16);
+        compare_json_int(json, "before_frame", (int64_t)jump->frame - 1);
+        compare_json_float(json, "before_sample_normalized", jump->before_normalized);
+        compare_json_int(json, "before_sample_pcm16", jump->before_pcm16);
+        compare_json_int(json, "channel_index", jump->channel);
+        compare_json_int(json, "frame", (int64_t)jump->frame);
+        compare_json_int(json, "jump_magnitude", jump->magnitude_pcm16);
+        compare_json_float(json, "jump_magnitude_normalized", jump->magnitude_normalized);
+        compare_json_int(json, "jump_magnitude_pcm16", jump->magnitude_pcm16);
+        compare_json_int(json, "rank", (int64_t)index + 1);
+        compare_json_float(json, "time_seconds", (double)jump->frame / clicks->sample_rate);
+        compare_json_end(json, '}');
+    }
+    compare_json_end(json, ']');
+    compare_json_int(json, "top_requested", clicks->top_limit);
+    compare_json_end(json, '}');
+}
+
+static void compare_json_file(
+    compare_json *json,
+    const char *key,
+    const compare_wav *wav,
+    const compare_stats *stats,
+    compare_clicks *clicks
+) {
+    compare_json_begin(json, key, '{');
+    if (clicks != NULL) {
+        compare_json_clicks(json, clicks);
+    }
+    compare_json_wav_info(json, wav);
+    compare_json_stats(json, stats, wav->sample_rate);
+    compare_json_end(json, '}');
+}
+
+static void compare_json_alignment(compare_json *json, const compare_align *align) {
+    double denominator = sqrt(align->reference_energy * align->candidate_energy);
+    uint32_t span = 2u * align->max_lag + 1u;
+    uint32_t best = align->max_lag;
+    uint32_t index;
+
+    for (index = 0; index < span; index++) {
+        int64_t lag = (int64_t)index - align->max_lag;
+        int64_t best_lag = (int64_t)best - align->max_lag;
+        double value = align->correlation[index];
+        double best_value = align->correlation[best];
+        if (value > best_value ||
+            (value == best_value && (llabs(lag) < llabs(best_lag) || (llabs(lag) == llabs(best_lag) && lag < best_lag)))) {
+            best = index;
+        }
+    }
+    compare_json_begin(json, "alignment", '{');
+    if (denominator > 0.0) {
+        int64_t best_lag = (int64_t)best - align->max_lag;
+        double at_best = align->correlation[best] / denominator;
+        double at_zero = align->correlation[align->max_lag] / denominator;
+        compare_json_int(json, "best_offset_frames", best_lag);
+        compare_json_float(json, "best_offset_seconds", (double)best_lag / align->sample_rate);
+        compare_json_float(json, "correlation_at_best", at_best > 1.0 ? 1.0 : at_best < -1.0 ? -1.0 : at_best);
+        compare_json_float(json, "correlation_at_zero", at_zero > 1.0 ? 1.0 : at_zero < -1.0 ? -1.0 : at_zero);
+    } else {
+        compare_json_null(json, "best_offset_frames");
+        compare_json_null(json, "best_offset_seconds");
+        compare_json_null(json, "correlation_at_best");
+        compare_json_null(json, "correlation_at_zero");
+    }
+    compare_json_int(json, "max_lag_frames", align->max_lag);
+    compare_json_end(json, '}');
+}
+
+static void compare_json_sample_comparison(
+    compare_json *json,
+    const compare_pair *pair,
+    const compare_align *align,
+    const compare_stats *reference_stats,
+    const compare_stats *candidate_stats,
+    uint32_t sample_rate
+) {
+    double overall = pair->sample_count > 0u ? sqrt(pair->diff_square_sum / (double)pair->sample_count) : 0.0;
+    double reference_rms = compare_stats_rms(reference_stats);
+    double denominator = sqrt(pair->reference_square_sum * pair->candidate_square_sum);
+    uint64_t reference_samples = reference_stats->sample_count;
+    uint64_t candidate_samples = candidate_stats->sample_count;
+    size_t index;
+    uint32_t channel;
+
+    compare_json_begin(json, "sample_comparison", '{');
+    if (align != NULL) {
+        compare_json_alignment(json, align);
+    }
+    compare_json_begin(json, "diff", '{');
+    compare_json_float(json, "max_abs_sample_difference", pair->max_abs_difference);
+    if (reference_rms > 0.0) {
+        compare_json_float(json, "normalized_rms_difference", overall / reference_rms);
+    } else {
+        compare_json_optional_float(json, "normalized_rms_difference", overall == 0.0, 0.0);
+    }
+    compare_json_float(json, "overall_rms_difference", overall);
+    compare_json_begin(json, "per_channel_rms_difference", '[');
+    for (channel = 0; channel < pair->channel_count; channel++) {
+        compare_json_float(
+            json,
+            NULL,
+            pair->frames > 0u ? sqrt(pair->channel_diff_square_sum[channel] / (double)pair->frames) : 0.0
+        );
+    }
+    compare_json_end(json, ']');
+    compare_json_end(json, '}');
+    if (pair->has_first_difference) {
+        compare_json_float(json, "first_difference_seconds", (double)(pair->first_difference_sample / pair->channel_count) / sample_rate);
+    } else if (reference_samples != candidate_samples) {
+        compare_json_float(json, "first_difference_seconds", (double)(pair->sample_count / pair->channel_count) / sample_rate);
+    } else {
+        compare_json_null(json, "first_difference_seconds");
+    }
+    compare_json_optional_float(
+        json,
+        "normalized_correlation",
+        pair->sample_count > 0u && denominator != 0.0,
+        denominator != 0.0 ? pair->dot / denominator : 0.0
+    );
+    compare_json_int(json, "overlap_frames", (int64_t)pair->frames);
+    compare_json_begin(json, "worst_windows", '[');
+    for (index = 0; index < pair->top_count; index++) {
+        const compare_window *window = &pair->top[index];
+        compare_json_begin(json, NULL, '{');
+        compare_json_int(json, "end_frame", (int64_t)window->end_frame);
+        compare_json_float(json, "end_seconds", (double)window->end_frame / sample_rate);
+        compare_json_float(json, "max_abs_sample_difference", window->max_abs_difference);
+        compare_json_float(json, "rms_difference", window->rms_difference);
+        compare_json_int(json, "start_frame", (int64_t)window->start_frame);
+        compare_json_float(json, "start_seconds", (double)window->start_frame / sample_rate);
+        compare_json_end(json, '}');
+    }
+    compare_json_end(json, ']');
+    compare_json_end(json, '}');
+}
+
+int main(int argc, char **argv) {
+    compare_options options;
+    compare_wav reference;
+    compare_wav candidate;
+    compare_stats reference_stats;
+    compare_stats candidate_stats;
+    compare_pair pair;
+    compare_clicks reference_clicks;
+    compare_clicks candidate_clicks;
+    compare_align align;
+    compare_json json;
+    double *reference_block = NULL;
+    double *candidate_block = NULL;
+    char error[256];
+    int comparable;
+    int ok = 1;
+    int i;
+
+    memset(&options, 0, sizeof(options));
+    options.seconds = COMPARE_DEFAULT_SECONDS;
+    options.diff_threshold = COMPARE_DEFAULT_DIFF_THRESHOLD;
+    options.near_silence_threshold = COMPARE_DEFAULT_NEAR_SILENCE_THRESHOLD;
+    options.window_ms = COMPARE_DEFAULT_WINDOW_MS;
+    options.top_windows = COMPARE_DEFAULT_TOP_WINDOWS;
+    options.click_threshold_pcm16 = COMPARE_DEFAULT_CLICK_THRESHOLD_PCM16;
+    options.top_clicks = COMPARE_DEFAULT_TOP_CLICKS;
+
+    for (i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        int valid = 1;
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (strcmp(arg, "--clicks") == 0) {
+            options.clicks = 1;
+            continue;
+        }
+        if (arg[0] != '-' || value == NULL) {
+            fprintf(stderr, "error: unknown or incomplete option '%s'\n", arg);
+            return 2;
+        }
+        i++;
+        if (strcmp(arg, "--reference") == 0) {
+            options.reference_path = value;
+        } else if (strcmp(arg, "--candidate") == 0) {
+            options.candidate_path = value;
+        } else if (strcmp(arg, "--json") == 0) {
+            options.json_path = value;
+        } else if (strcmp(arg, "--seconds") == 0) {
+            valid = parse_double(value, 1e-9, 1e9, &options.seconds);
+        } else if (strcmp(arg, "--diff-threshold") == 0) {
+            valid = parse_double(value, 0.0, 1e9, &options.diff_threshold);
+        } else if (strcmp(arg, "--near-silence-threshold") == 0) {
+            valid = parse_double(value, 0.0, 1e9, &options.near_silence_threshold);
+        } else if (strcmp(arg, "--window-ms") == 0) {
+            valid = parse_double(value, 1e-9, 1e9, &options.window_ms);
+        } else if (strcmp(arg, "--top-windows") == 0) {
+            valid = parse_u32(value, 0, 1u << 24, &options.top_windows);
+        } else if (strcmp(arg, "--align-max-ms") == 0) {
+            valid = parse_double(value, 1e-9, COMPARE_MAX_ALIGN_MS, &options.align_max_ms);
+        } else if (strcmp(arg, "--click-threshold-pcm16") == 0) {
+            valid = parse_u32(value, 0, 65535u, &options.click_threshold_pcm16);
+        } else if (strcmp(arg, "--top-clicks") == 0) {
+            valid = parse_u32(value, 0, 1u << 24, &options.top_clicks);
+        } else {
+            fprintf(stderr, "error: unknown option '%s'\n", arg);
+            return 2;
+        }
+        if (!valid) {
+            fprintf(stderr, "error: invalid value '%s' for %s\n", value, arg);
+            return 2;
+        }
+    }
+    if (options.reference_path == NULL || options.candidate_path == NULL) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    if (!compare_wav_open(&reference, options.reference_path, error, sizeof(error))) {
+        fprintf(stderr, "error: %s: %s\n", options.reference_path, error);
+        compare_wav_close(&reference);
+        return 1;
+    }
+    if (!compare_wav_open(&candidate, options.candidate_path, error, sizeof(error))) {
+        fprintf(stderr, "error: %s: %s\n", options.candidate_path, error);
+        compare_wav_close(&reference);
+        compare_wav_close(&candidate);
+        return 1;
+    }
+    reference.frames_remaining = (uint64_t)(options.seconds * reference.sample_rate);
+    if (reference.frames_remaining > reference.frame_count) {
+        reference.frames_remaining = reference.frame_count;
+    }
+    candidate.frames_remaining = (uint64_t)(options.seconds * candidate.sample_rate);
+    if (candidate.frames_remaining > candidate.frame_count) {
+        candidate.frames_remaining = candidate.frame_count;
+    }
+    comparable = reference.sample_rate == candidate.sample_rate && reference.channel_count == candidate.channel_count;
+
+    memset(&pair, 0, sizeof(pair));
+    memset(&reference_clicks, 0, sizeof(reference_clicks));
+    memset(&candidate_clicks, 0, sizeof(candidate_clicks));
+    memset(&align, 0, sizeof(align));
+    reference_block = (double *)malloc((size_t)COMPARE_CHUNK_FRAMES * reference.channel_count * sizeof(double));
+    candidate_block = (double *)malloc((size_t)COMPARE_CHUNK_FRAMES * candidate.channel_count * sizeof(double));
+    ok = reference_block != NULL && candidate_block != NULL;
+    ok = compare_stats_init(&reference_stats, &reference, options.near_silence_threshold) && ok;
+    ok = compare_stats_init(&candidate_stats, &candidate, options.near_silence_threshold) && ok;
+    if (comparable) {
+        ok = compare_pair_init(&pair, reference.channel_count, reference.sample_rate, &options) && ok;
+        if (options.align_max_ms > 0.0) {
+            ok = compare_align_init(&align, reference.sample_rate, options.align_max_ms) && ok;
+        }
+    }
+    if (options.clicks) {
+        ok = compare_clicks_init(&reference_clicks, &reference, &options) && ok;
+        ok = compare_clicks_init(&candidate_clicks, &candidate, &options) && ok;
+    }
+    if (!ok) {
+        fprintf(stderr, "error: out of memory\n");
+    }
+
+    while (ok) {
+        uint32_t reference_frames = compare_wav_read(&reference, reference_block);
+        uint32_t candidate_frames = compare_wav_read(&candidate, candidate_block);
+        uint32_t overlap = reference_frames < candidate_frames ? reference_frames : candidate_frames;
+
+        if (reference_frames == 0u && candidate_frames == 0u) {
+            break;
+        }
+        compare_stats_add(&reference_stats, reference_block, reference_frames);
+        compare_stats_add(&candidate_stats, candidate_block, candidate_frames);
+        if (options.clicks) {
+            ok = compare_clicks_add(&reference_clicks, reference_block, reference_frames) && ok;
+            ok = compare_clicks_add(&candidate_clicks, candidate_block, candidate_frames) && ok;
+        }
+        if (comparable && pair.frames == reference_stats.frames - reference_frames &&
+            pair.frames == candidate_stats.frames - candidate_frames) {
+            ok = compare_pair_add(&pair, reference_block, candidate_block, overlap) && ok;
+        }
+        if (comparable && options.align_max_ms > 0.0) {
+            align.reference_ended = align.reference_ended || reference_frames < COMPARE_CHUNK_FRAMES;
+            compare_align_push(&align, reference_block, reference_frames, reference.channel_count, 1);
+            compare_align_push(&align, candidate_block, candidate_frames, candidate.channel_count, 0);
+            align.candidate_ended = align.candidate_ended || candidate_frames < COMPARE_CHUNK_FRAMES;
+            compare_align_process(&align);
+        }
+        if (!ok) {
+            fprintf(stderr, "error: out of memory\n");
+        }
+    }
+    if (ok && (ferror(reference.file) || ferror(candidate.file))) {
+        fprintf(stderr, "error: read failed\n");
+        ok = 0;
+    }
+    if (ok && comparable) {
+        ok = compare_pair_close_window(&pair);
+        if (options.align_max_ms > 0.0) {
+            align.reference_ended = 1;
+            align.candidate_ended = 1;
+            compare_align_process(&align);
+        }
+    }
+
+    if (ok) {
+        json.out = options.json_path != NULL ? fopen(options.json_path, "w") : stdout;
+        json.depth = 0;
+        if (json.out == NULL) {
+            fprintf(stderr, "error: cannot open '%s'\n", options.json_path);
+            ok = 0;
+        }
+    }
+    if (ok) {
+        double reference_duration = (double)reference.frame_count / reference.sample_rate;
+        double candidate_duration = (double)candidate.frame_count / candidate.sample_rate;
+        double reference_analyzed = (double)reference_stats.frames / reference.sample_rate;
+        double candidate_analyzed = (double)candidate_stats.frames / candidate.sample_rate;
+
+        compare_json_begin(&json, NULL, '{');
+        compare_json_file(&json, "candidate", &candidate, &candidate_stats, options.clicks ? &candidate_clicks : NULL);
+        compare_json_float(&json, "diff_threshold", options.diff_threshold);
+        compare_json_begin(&json, "format", '{');
+        compare_json_float(&json, "analyzed_duration_delta_seconds", candidate_analyzed - reference_analyzed);
+        compare_json_int(&json, "analyzed_frame_count_delta", (int64_t)candidate_stats.frames - (int64_t)reference_stats.frames);
+        compare_json_bool(&json, "channel_count_matches", reference.channel_count == candidate.channel_count);
+        compare_json_float(&json, "duration_delta_seconds", candidate_duration - reference_duration);
+        compare_json_int(&json, "frame_count_delta", (int64_t)candidate.frame_count - (int64_t)reference.frame_count);
+        compare_json_bool(&json, "sample_comparison_available", comparable);
+        compare_json_bool(&json, "sample_rate_matches", reference.sample_rate == candidate.sample_rate);
+        compare_json_bool(&json, "sample_width_matches", reference.sample_width == candidate.sample_width);
+        compare_json_end(&json, '}');
+        compare_json_float(&json, "near_silence_threshold", options.near_silence_threshold);
+        compare_json_begin(&json, "notes", '[');
+        compare_json_string(&json, NULL, "Diagnostic metrics only; they do not prove tracker semantic correctness.");
+        compare_json_string(&json, NULL, "No resampling, downmixing, time alignment, or renderer-latency compensation is applied.");
+        compare_json_end(&json, ']');
+        compare_json_file(&json, "reference", &reference, &reference_stats, options.clicks ? &reference_clicks : NULL);
+        compare_json_float(&json, "requested_seconds", options.seconds);
+        if (comparable) {
+            compare_json_sample_comparison(
+                &json,
+                &pair,
+                options.align_max_ms > 0.0 ? &align : NULL,
+                &reference_stats,
+                &candidate_stats,
+                reference.sample_rate
+            );
+        } else {
+            compare_json_null(&json, "sample_comparison");
+        }
+        compare_json_int(&json, "schema_version", 1);
+        compare_json_string(&json, "tool", "tools/vtx_audio_compare");
+        compare_json_int(&json, "top_window_count", options.top_windows);
+        compare_json_float(&json, "window_ms", options.window_ms);
+        compare_json_end(&json, '}');
+        fputc('\n', json.out);
+        if (json.out != stdout && fclose(json.out) != 0) {
+            fprintf(stderr, "error: write to '%s' failed\n", options.json_path);
+            ok = 0;
+        }
+    }
+
+    free(reference_block);
+    free(candidate_block);
+    compare_stats_free(&reference_stats);
+    compare_stats_free(&candidate_stats);
+    compare_pair_free(&pair);
+    compare_clicks_free(&reference_clicks);
+    compare_clicks_free(&candidate_clicks);
+    compare_align_free(&align);
+    compare_wav_close(&reference);
+    compare_wav_close(&candidate);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,761 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "vtx_c_mixer.h"
+
+#define BENCH_FORMAT_VERSION 1
+#define BENCH_MAX_ITERATIONS 64u
+#define BENCH_DEFAULT_MAX_REGRESSION 0.15
+
+typedef struct {
+    uint32_t voice_count;
+    double loop_none_weight;
+    double loop_forward_weight;
+    double loop_ping_pong_weight;
+    double step_min;
+    double step_max;
+    double envelope_fraction;
+    double event_density;
+    uint32_t channel_count;
+    uint32_t block_size;
+    double seconds;
+    double sample_rate;
+    uint32_t sample_frames;
+    uint32_t iterations;
+    uint64_t seed;
+    VTXCMixerRenderEngine engine;
+    uint32_t tap_channel_tags;
+    uint32_t sample_pyramid_levels;
+} bench_scenario;
+
+typedef struct {
+    uint64_t elapsed_ns;
+    uint64_t rendered_frames;
+    uint64_t active_voice_frames;
+    uint64_t scheduled_events;
+    uint64_t dropped_events;
+    uint64_t setup_allocations;
+    uint64_t setup_allocation_bytes;
+    uint64_t render_allocations;
+    double output_checksum;
+} bench_run;
+
+typedef struct {
+    int present;
+    int comparable;
+    double ns_per_voice_frame;
+    char scenario_key[256];
+} bench_baseline;
+
+static uint64_t bench_next_random(uint64_t *state) {
+    uint64_t z;
+    *state += 0x9E3779B97F4A7C15ull;
+    z = *state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static double bench_random_unit(uint64_t *state) {
+    return (double)(bench_next_random(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double bench_random_range(uint64_t *state, double minimum, double maximum) {
+    return minimum + ((maximum - minimum) * bench_random_unit(state));
+}
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_default_scenario(bench_scenario *scenario) {
+    memset(scenario, 0, sizeof(*scenario));
+    scenario->voice_count = 64;
+    scenario->loop_none_weight = 1.0;
+    scenario->loop_forward_weight = 1.0;
+    scenario->loop_ping_pong_weight = 1.0;
+    scenario->step_min = 0.25;
+    scenario->step_max = 2.5;
+    scenario->envelope_fraction = 0.5;
+    scenario->event_density = 8.0;
+    scenario->channel_count = 2;
+    scenario->block_size = 512;
+    scenario->seconds = 5.0;
+    scenario->sample_rate = VTX_C_MIXER_DEFAULT_SAMPLE_RATE;
+    scenario->sample_frames = 32768;
+    scenario->iterations = 3;
+    scenario->seed = 1;
+    scenario->engine = VTX_C_MIXER_RENDER_ENGINE_REFERENCE;
+}
+
+static void bench_scenario_key(const bench_scenario *scenario, char *out, size_t out_size) {
+    int length = snprintf(
+        out,
+        out_size,
+        "v%u-l%g:%g:%g-s%g:%g-e%g-d%g-c%u-b%u-t%g-r%g-f%u-seed%llu-%s",
+        scenario->voice_count,
+        scenario->loop_none_weight,
+        scenario->loop_forward_weight,
+        scenario->loop_ping_pong_weight,
+        scenario->step_min,
+        scenario->step_max,
+        scenario->envelope_fraction,
+        scenario->event_density,
+        scenario->channel_count,
+        scenario->block_size,
+        scenario->seconds,
+        scenario->sample_rate,
+        scenario->sample_frames,
+        (unsigned long long)scenario->seed,
+        vtx_c_mixer_render_engine_name(scenario->engine)
+    );
+    // Untapped keys keep their original spelling so stored baselines still match.
+    if (scenario->tap_channel_tags > 0u && length > 0 && (size_t)length < out_size) {
+        length += snprintf(out + length, out_size - (size_t)length, "-taps%u", scenario->tap_channel_tags);
+    }
+    if (scenario->sample_pyramid_levels > 0u && length > 0 && (size_t)length < out_size) {
+        snprintf(out + length, out_size - (size_t)length, "-pyramid%u", scenario->sample_pyramid_levels);
+    }
+}
+
+static float *bench_make_source_pcm(uint32_t frame_count, uint64_t seed) {
+    float *pcm;
+    uint32_t i;
+    uint64_t noise_state = seed ^ 0xA5A5A5A5A5A5A5A5ull;
+
+    pcm = (float *)malloc((size_t)frame_count * sizeof(float));
+    if (pcm == NULL) {
+        return NULL;
+    }
+    // Deterministic synthetic material: two partials plus a little noise so
+    // interpolation and loop seams see non-trivial data. No module content.
+    for (i = 0; i < frame_count; i++) {
+        double t = (double)i;
+        double value = 0.55 * sin(t * 0.0625) + 0.25 * sin(t * 0.173) +
+            0.1 * (bench_random_unit(&noise_state) * 2.0 - 1.0);
+        pcm[i] = (float)value;
+    }
+    return pcm;
+}
+
+static VTXCMixerLoopMode bench_pick_loop_mode(const bench_scenario *scenario, uint64_t *rng) {
+    double total = scenario->loop_none_weight + scenario->loop_forward_weight + scenario->loop_ping_pong_weight;
+    double pick;
+
+    if (total <= 0.0) {
+        return VTX_C_MIXER_LOOP_NONE;
+    }
+    pick = bench_random_unit(rng) * total;
+    if (pick < scenario->loop_none_weight) {
+        return VTX_C_MIXER_LOOP_NONE;
+    }
+    if (pick < scenario->loop_none_weight + scenario->loop_forward_weight) {
+        return VTX_C_MIXER_LOOP_FORWARD;
+    }
+    return VTX_C_MIXER_LOOP_PING_PONG;
+}
+
+static void bench_attach_envelopes(
+    VTXCMixerState *state,
+    uint32_t voice_index,
+    uint64_t total_frames,
+    uint64_t *rng
+) {
+    VTXCMixerEnvelopePoint volume_points[4];
+    VTXCMixerEnvelopePoint pan_points[3];
+    VTXCMixerEnvelope volume;
+    VTXCMixerEnvelope pan;
+    uint64_t key_off_frame;
+
+    volume_points[0].position_frame = 0;
+    volume_points[0].value = 0.0f;
+    volume_points[1].position_frame = 256;
+    volume_points[1].value = 1.0f;
+    volume_points[2].position_frame = 4096;
+    volume_points[2].value = 0.6f;
+    volume_points[3].position_frame = 16384;
+    volume_points[3].value = 0.3f;
+    memset(&volume, 0, sizeof(volume));
+    volume.points = volume_points;
+    volume.point_count = 4;
+    volume.loop_enabled = 1;
+    volume.loop_start_frame = 256;
+    volume.loop_end_frame = 4096;
+
+    pan_points[0].position_frame = 0;
+    pan_points[0].value = -0.5f;
+    pan_points[1].position_frame = 2048;
+    pan_points[1].value = 0.5f;
+    pan_points[2].position_frame = 8192;
+    pan_points[2].value = 0.0f;
+    memset(&pan, 0, sizeof(pan));
+    pan.points = pan_points;
+    pan.point_count = 3;
+    pan.sustain_enabled = 1;
+    pan.sustain_frame = 2048;
+
+    vtx_c_mixer_set_voice_volume_envelope(state, voice_index, &volume);
+    vtx_c_mixer_set_voice_pan_envelope(state, voice_index, &pan);
+
+    key_off_frame = (uint64_t)(bench_random_range(rng, 0.25, 0.9) * (double)total_frames);
+    vtx_c_mixer_set_voice_key_off_frame(state, voice_index, key_off_frame, 1.0f / 22050.0f);
+}
+
+// shared_samples, when set, holds the source with a pyramid for each loop
+// mode, indexed by VTXCMixerLoopMode.
+static int bench_setup(
+    const bench_scenario *scenario,
+    VTXCMixerState *state,
+    const float *source_pcm,
+    const VTXCMixerSharedSample *shared_samples,
+    uint64_t total_frames,
+    uint64_t *rng
+) {
+    VTXCMixerConfig config;
+    uint32_t voice;
+
+    config.sample_rate = scenario->sample_rate;
+    config.channel_count = scenario->channel_count;
+    if (vtx_c_mixer_init(state, config) != VTX_C_MIXER_STATUS_OK ||
+        vtx_c_mixer_set_render_engine(state, scenario->engine) != VTX_C_MIXER_STATUS_OK) {
+        return 0;
+    }
+    for (voice = 0; voice < scenario->voice_count; voice++) {
+        VTXCMixerLoopMode loop_mode = bench_pick_loop_mode(scenario, rng);
+        double step = bench_random_range(rng, scenario->step_min, scenario->step_max);
+        float gain = (float)bench_random_range(rng, 0.1, 0.9) / (float)scenario->voice_count;
+        float pan = (float)bench_random_range(rng, -1.0, 1.0);
+        uint32_t loop_start = scenario->sample_frames / 4u;
+        uint32_t voice_index = 0;
+        VTXCMixerStatus status;
+
+        if (shared_samples != NULL) {
+            status = vtx_c_mixer_add_scheduled_shared_sample_voice(
+                state,
+                &shared_samples[loop_mode],
+                step,
+                0u,
+                gain,
+                pan,
+                loop_mode,
+                loop_start,
+                scenario->sample_frames,
+                0u,
+                &voice_index
+            );
+        } else {
+            status = vtx_c_mixer_add_sample_voice_with_step(
+                state,
+                source_pcm,
+                scenario->sample_frames,
+                step,
+                gain,
+                pan,
+                loop_mode,
+                loop_start,
+                scenario->sample_frames,
+                &voice_index
+            );
+        }
+        if (status != VTX_C_MIXER_STATUS_OK) {
+            return 0;
+        }
+        vtx_c_mixer_set_voice_channel_tag(state, voice_index, voice % 32u);
+        if (bench_random_unit(rng) < scenario->envelope_fraction) {
+            bench_attach_envelopes(state, voice_index, total_frames, rng);
+        }
+    }
+    return 1;
+}
+
+static void bench_schedule_block_events(
+    const bench_scenario *scenario,
+    VTXCMixerState *state,
+    double *event_budget,
+    uint64_t block_start,
+    uint32_t block_frames,
+    uint64_t *rng,
+    bench_run *run
+) {
+    double per_block = scenario->event_density * (double)block_frames / scenario->sample_rate;
+    uint32_t voice;
+
+    for (voice = 0; voice < scenario->voice_count; voice++) {
+        event_budget[voice] += per_block;
+        while (event_budget[voice] >= 1.0) {
+            uint64_t frame = block_start + (uint64_t)(bench_random_unit(rng) * (double)block_frames);
+            float gain = (float)bench_random_range(rng, 0.05, 0.9) / (float)scenario->voice_count;
+            float pan = (float)bench_random_range(rng, -1.0, 1.0);
+            double step = bench_random_range(rng, scenario->step_min, scenario->step_max);
+            VTXCMixerStatus status;
+
+            event_budget[voice] -= 1.0;
+            switch (bench_next_random(rng) % 4u) {
+            case 0:
+                status = vtx_c_mixer_schedule_voice_gain_pan_update(state, voice, frame, 1, gain, 1, pan);
+                break;
+            case 1:
+                status = vtx_c_mixer_schedule_voice_sample_step_update(state, voice, frame, step);
+                break;
+            case 2:
+                status = vtx_c_mixer_schedule_voice_gain_pan_sample_step_update(state, voice, frame, 1, gain, 0, 0.0f, step);
+                break;
+            default:
+                status = vtx_c_mixer_schedule_voice_gain_pan_update_immediate(state, voice, frame, 1, gain, 0, 0.0f);
+                break;
+            }
+            if (status == VTX_C_MIXER_STATUS_OK) {
+                run->scheduled_events++;
+            } else {
+                run->dropped_events++;
+            }
+        }
+    }
+}
+
+static int bench_run_once(
+    const bench_scenario *scenario,
+    const float *source_pcm,
+    const VTXCMixerSharedSample *shared_samples,
+    bench_run *run
+) {
+    VTXCMixerState *state;
+    VTXCMixerTaps *taps = NULL;
+    float *block;
+    double *event_budget;
+    uint64_t total_frames = (uint64_t)(scenario->seconds * scenario->sample_rate);
+    uint64_t rng = scenario->seed;
+    uint64_t allocations_before_render;
+    size_t i;
+
+    memset(run, 0, sizeof(*run));
+    state = (VTXCMixerState *)malloc(sizeof(*state));
+    block = (float *)malloc((size_t)scenario->block_size * scenario->channel_count * sizeof(float));
+    event_budget = (double *)calloc(scenario->voice_count, sizeof(double));
+    if (state == NULL || block == NULL || event_budget == NULL) {
+        free(state);
+        free(block);
+        free(event_budget);
+        return 0;
+    }
+    if (!bench_setup(scenario, state, source_pcm, shared_samples, total_frames, &rng)) {
+        vtx_c_mixer_clear_voices(state);
+        free(state);
+        free(block);
+        free(event_budget);
+        return 0;
+    }
+    if (scenario->tap_channel_tags > 0u) {
+        if (vtx_c_mixer_taps_create(scenario->tap_channel_tags, 4096u, &taps) != VTX_C_MIXER_STATUS_OK) {
+            vtx_c_mixer_clear_voices(state);
+            free(state);
+            free(block);
+            free(event_budget);
+            return 0;
+        }
+        vtx_c_mixer_set_taps(state, taps);
+    }
+    run->setup_allocations = vtx_c_mixer_sample_allocation_count(state);
+    run->setup_allocation_bytes = vtx_c_mixer_sample_allocation_byte_count(state);
+    allocations_before_render = run->setup_allocations;
+
+    while (run->rendered_frames < total_frames) {
+        uint64_t remaining = total_frames - run->rendered_frames;
+        uint32_t frames = remaining < scenario->block_size ? (uint32_t)remaining : scenario->block_size;
+        uint64_t started;
+
+        // Event scheduling stays outside the timed region; only the render call
+        // is measured so results track the mixer kernel itself.
+        bench_schedule_block_events(scenario, state, event_budget, run->rendered_frames, frames, &rng, run);
+        run->active_voice_frames += (uint64_t)vtx_c_mixer_active_voice_count(state) * frames;
+        started = bench_now_ns();
+        vtx_c_mixer_render(state, block, frames);
+        run->elapsed_ns += bench_now_ns() - started;
+        run->rendered_frames += frames;
+        for (i = 0; i < (size_t)frames * scenario->channel_count; i += 97) {
+            run->output_checksum += block[i];
+        }
+    }
+    run->render_allocations = vtx_c_mixer_sample_allocation_count(state) - allocations_before_render;
+
+    vtx_c_mixer_clear_voices(state);
+    vtx_c_mixer_taps_free(taps);
+    free(state);
+    free(block);
+    free(event_budget);
+    return 1;
+}
+
+static int bench_compare_runs(const void *a, const void *b) {
+    const bench_run *left = (const bench_run *)a;
+    const bench_run *right = (const bench_run *)b;
+    if (left->elapsed_ns < right->elapsed_ns) {
+        return -1;
+    }
+    return left->elapsed_ns > right->elapsed_ns ? 1 : 0;
+}
+
+static int bench_read_file(const char *path, char **out_text) {
+    FILE *f;
+    long size;
+    char *text;
+
+    f = fopen(path, "rb");
+    if (f == NULL) {
+        return 0;
+    }
+    if (fseek(f, 0, SEEK_END) != 0 || (size = ftell(f)) < 0 || fseek(f, 0, SEEK_SET) != 0) {
+        fclose(f);
+        return 0;
+    }
+    text = (char *)malloc((size_t)size + 1u);
+    if (text == NULL) {
+        fclose(f);
+        return 0;
+    }
+    if (fread(text, 1, (size_t)size, f) != (size_t)size) {
+        free(text);
+        fclose(f);
+        return 0;
+    }
+    fclose(f);
+    text[size] = '\0';
+    *out_text = text;
+    return 1;
+}
+
+static const char *bench_json_value(const char *text, const char *key) {
+    char needle[96];
+    const char *p;
+
+    snprintf(needle, sizeof(needle), "\"%s\":", key);
+    p = strstr(text, needle);
+    if (p == NULL) {
+        return NULL;
+    }
+    p += strlen(needle);
+    while (*p == ' ') {
+        p++;
+    }
+    return p;
+}
+
+static int bench_load_baseline(const char *path, const char *scenario_key, bench_baseline *out) {
+    char *text = NULL;
+    const char *value;
+    size_t length = 0;
+
+    memset(out, 0, sizeof(*out));
+    if (!bench_read_file(path, &text)) {
+        return 0;
+    }
+    value = bench_json_value(text, "ns_per_voice_frame");
+    if (value == NULL) {
+        free(text);
+        return 0;
+    }
+    out->ns_per_voice_frame = strtod(value, NULL);
+    value = bench_json_value(text, "scenario_key");
+    if (value != NULL && *value == '"') {
+        value++;
+        while (value[length] != '\0' && value[length] != '"' && length + 1 < sizeof(out->scenario_key)) {
+            length++;
+        }
+        memcpy(out->scenario_key, value, length);
+    }
+    out->scenario_key[length] = '\0';
+    out->present = 1;
+    out->comparable = strcmp(out->scenario_key, scenario_key) == 0 && out->ns_per_voice_frame > 0.0;
+    free(text);
+    return 1;
+}
+
+static void bench_print_json(
+    FILE *out,
+    const bench_scenario *scenario,
+    const char *scenario_key,
+    const bench_run *runs,
+    uint32_t run_count,
+    const bench_baseline *baseline,
+    double max_regression
+) {
+    const bench_run *best = &runs[0];
+    const bench_run *median = &runs[run_count / 2u];
+    double best_seconds = (double)best->elapsed_ns / 1e9;
+    double ns_per_frame = best->rendered_frames > 0 ? (double)best->elapsed_ns / (double)best->rendered_frames : 0.0;
+    double ns_per_voice_frame = best->active_voice_frames > 0
+        ? (double)best->elapsed_ns / (double)best->active_voice_frames
+        : 0.0;
+    double voice_frames_per_second = best_seconds > 0.0 ? (double)best->active_voice_frames / best_seconds : 0.0;
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"tool\": \"vtx_mixer_bench\",\n");
+    fprintf(out, "  \"format_version\": %d,\n", BENCH_FORMAT_VERSION);
+    fprintf(out, "  \"scenario_key\": \"%s\",\n", scenario_key);
+    fprintf(out, "  \"scenario\": {\n");
+    fprintf(out, "    \"voices\": %u,\n", scenario->voice_count);
+    fprintf(out, "    \"loop_mix\": { \"none\": %g, \"forward\": %g, \"ping_pong\": %g },\n",
+        scenario->loop_none_weight, scenario->loop_forward_weight, scenario->loop_ping_pong_weight);
+    fprintf(out, "    \"step_min\": %g,\n", scenario->step_min);
+    fprintf(out, "    \"step_max\": %g,\n", scenario->step_max);
+    fprintf(out, "    \"envelope_fraction\": %g,\n", scenario->envelope_fraction);
+    fprintf(out, "    \"event_density\": %g,\n", scenario->event_density);
+    fprintf(out, "    \"channels\": %u,\n", scenario->channel_count);
+    fprintf(out, "    \"block_size\": %u,\n", scenario->block_size);
+    fprintf(out, "    \"seconds\": %g,\n", scenario->seconds);
+    fprintf(out, "    \"sample_rate\": %g,\n", scenario->sample_rate);
+    fprintf(out, "    \"sample_frames\": %u,\n", scenario->sample_frames);
+    fprintf(out, "    \"iterations\": %u,\n", run_count);
+    fprintf(out, "    \"seed\": %llu,\n", (unsigned long long)scenario->seed);
+    fprintf(out, "    \"engine\": \"%s\",\n", vtx_c_mixer_render_engine_name(scenario->engine));
+    fprintf(out, "    \"tap_channel_tags\": %u,\n", scenario->tap_channel_tags);
+    fprintf(out, "    \"sample_pyramid_levels\": %u\n", scenario->sample_pyramid_levels);
+    fprintf(out, "  },\n");
+    fprintf(out, "  \"results\": {\n");
+    fprintf(out, "    \"rendered_frames\": %llu,\n", (unsigned long long)best->rendered_frames);
+    fprintf(out, "    \"active_voice_frames\": %llu,\n", (unsigned long long)best->active_voice_frames);
+    fprintf(out, "    \"best_elapsed_ns\": %llu,\n", (unsigned long long)best->elapsed_ns);
+    fprintf(out, "    \"median_elapsed_ns\": %llu,\n", (unsigned long long)median->elapsed_ns);
+    fprintf(out, "    \"voice_frames_per_second\": %.1f,\n", voice_frames_per_second);
+    fprintf(out, "    \"ns_per_frame\": %.3f,\n", ns_per_frame);
+    fprintf(out, "    \"ns_per_voice_frame\": %.4f,\n", ns_per_voice_frame);
+    fprintf(out, "    \"realtime_factor\": %.2f,\n",
+        best_seconds > 0.0 ? ((double)best->rendered_frames / scenario->sample_rate) / best_seconds : 0.0);
+    fprintf(out, "    \"scheduled_events\": %llu,\n", (unsigned long long)best->scheduled_events);
+    fprintf(out, "    \"dropped_events\": %llu,\n", (unsigned long long)best->dropped_events);
+    fprintf(out, "    \"setup_allocations\": %llu,\n", (unsigned long long)best->setup_allocations);
+    fprintf(out, "    \"setup_allocation_bytes\": %llu,\n", (unsigned long long)best->setup_allocation_bytes);
+    fprintf(out, "    \"render_allocations\": %llu,\n", (unsigned long long)best->render_allocations);
+    fprintf(out, "    \"output_checksum\": %.6f\n", best->output_checksum);
+    fprintf(out, "  },\n");
+    fprintf(out, "  \"baseline\": ");
+    if (baseline == NULL || !baseline->present) {
+        fprintf(out, "null\n");
+    } else {
+        double ratio = baseline->comparable ? ns_per_voice_frame / baseline->ns_per_voice_frame : 0.0;
+        fprintf(out, "{\n");
+        fprintf(out, "    \"comparable\": %s,\n", baseline->comparable ? "true" : "false");
+        fprintf(out, "    \"scenario_key\": \"%s\",\n", baseline->scenario_key);
+        fprintf(out, "    \"ns_per_voice_frame\": %.4f,\n", baseline->ns_per_voice_frame);
+        fprintf(out, "    \"ratio\": %.4f,\n", ratio);
+        fprintf(out, "    \"max_regression\": %g,\n", max_regression);
+        fprintf(out, "    \"regressed\": %s\n",
+            baseline->comparable && ratio > 1.0 + max_regression ? "true" : "false");
+        fprintf(out, "  }\n");
+    }
+    fprintf(out, "}\n");
+}
+
+static void print_usage(const char *argv0) {
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  --voices N              voice count, 1..%u (default 64)\n"
+        "  --loop-mix A:B:C        none:forward:ping-pong weights (default 1:1:1)\n"
+        "  --step-min X            minimum source step per output frame (default 0.25)\n"
+        "  --step-max X            maximum source step per output frame (default 2.5)\n"
+        "  --envelope-fraction X   fraction of voices with envelopes and key-off (default 0.5)\n"
+        "  --event-density X       scheduled updates per voice per second (default 8)\n"
+        "  --channels N            output channel count (default 2)\n"
+        "  --block-size N          frames per render call (default 512)\n"
+        "  --seconds X             rendered duration per iteration (default 5)\n"
+        "  --sample-rate X         output sample rate (default 44100)\n"
+        "  --sample-frames N       synthetic sample length (default 32768)\n"
+        "  --iterations N          timed iterations, best is reported (default 3)\n"
+        "  --seed N                scenario seed (default 1)\n"
+        "  --engine NAME           render engine: reference or voice_major (default reference)\n"
+        "  --taps N                attach scope/VU taps to channel tags 0..N-1 of 32 (default 0: off)\n"
+        "  --sample-pyramid N      play a shared source with an N-level pyramid, 0..%u (default 0: copied source)\n"
+        "  --baseline PATH         compare against a stored result JSON\n"
+        "  --max-regression X      allowed ns/voice-frame slowdown vs baseline (default %g)\n"
+        "  --write-baseline PATH   also write the result JSON to PATH\n",
+        argv0,
+        (unsigned)VTX_C_MIXER_MAX_VOICES,
+        VTX_C_MIXER_MAX_SAMPLE_PYRAMID_LEVELS,
+        BENCH_DEFAULT_MAX_REGRESSION);
+}
+
+static int parse_u32(const char *text, uint32_t minimum, uint32_t maximum, uint32_t *out) {
+    char *end = NULL;
+    unsigned long value = strtoul(text, &end, 10);
+    if (end == NULL || *end != '\0' || text[0] == '-' || value < minimum || value > maximum) {
+        return 0;
+    }
+    *out = (uint32_t)value;
+    return 1;
+}
+
+static int parse_double(const char *text, double minimum, double maximum, double *out) {
+    char *end = NULL;
+    double value = strtod(text, &end);
+    if (end == NULL || *end != '\0' || !isfinite(value) || value < minimum || value > maximum) {
+        return 0;
+    }
+    *out = value;
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    bench_scenario scenario;
+    bench_run runs[BENCH_MAX_ITERATIONS];
+    bench_baseline baseline;
+    char scenario_key[256];
+    const char *baseline_path = NULL;
+    const char *write_baseline_path = NULL;
+    double max_regression = BENCH_DEFAULT_MAX_REGRESSION;
+    float *source_pcm;
+    VTXCMixerSharedSample shared_samples[3];
+    VTXCMixerSamplePyramid *pyramids[3] = { NULL, NULL, NULL };
+    uint32_t iteration;
+    uint32_t loop_mode;
+    int ok = 1;
+    int i;
+
+    bench_default_scenario(&scenario);
+    memset(&baseline, 0, sizeof(baseline));
+
+    for (i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        int ok = 1;
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (arg[0] != '-' || value == NULL) {
+            fprintf(stderr, "error: unknown or incomplete option '%s'\n", arg);
+            return 2;
+        }
+        i++;
+        if (strcmp(arg, "--voices") == 0) {
+            ok = parse_u32(value, 1, VTX_C_MIXER_MAX_VOICES, &scenario.voice_count);
+        } else if (strcmp(arg, "--loop-mix") == 0) {
+            ok = sscanf(value, "%lf:%lf:%lf", &scenario.loop_none_weight, &scenario.loop_forward_weight, &scenario.loop_ping_pong_weight) == 3 &&
+                scenario.loop_none_weight >= 0.0 && scenario.loop_forward_weight >= 0.0 && scenario.loop_ping_pong_weight >= 0.0;
+        } else if (strcmp(arg, "--step-min") == 0) {
+            ok = parse_double(value, 1e-6, 1024.0, &scenario.step_min);
+        } else if (strcmp(arg, "--step-max") == 0) {
+            ok = parse_double(value, 1e-6, 1024.0, &scenario.step_max);
+        } else if (strcmp(arg, "--envelope-fraction") == 0) {
+            ok = parse_double(value, 0.0, 1.0, &scenario.envelope_fraction);
+        } else if (strcmp(arg, "--event-density") == 0) {
+            ok = parse_double(value, 0.0, 10000.0, &scenario.event_density);
+        } else if (strcmp(arg, "--channels") == 0) {
+            ok = parse_u32(value, 1, 8, &scenario.channel_count);
+        } else if (strcmp(arg, "--block-size") == 0) {
+            ok = parse_u32(value, 1, 1u << 20, &scenario.block_size);
+        } else if (strcmp(arg, "--seconds") == 0) {
+            ok = parse_double(value, 0.001, 3600.0, &scenario.seconds);
+        } else if (strcmp(arg, "--sample-rate") == 0) {
+            ok = parse_double(value, 1000.0, 384000.0, &scenario.sample_rate);
+        } else if (strcmp(arg, "--sample-frames") == 0) {
+            ok = parse_u32(value, 16, 1u << 24, &scenario.sample_frames);
+        } else if (strcmp(arg, "--iterations") == 0) {
+            ok = parse_u32(value, 1, BENCH_MAX_ITERATIONS, &scenario.iterations);
+        } else if (strcmp(arg, "--seed") == 0) {
+            char *end = NULL;
+            scenario.seed = strtoull(value, &end, 10);
+            ok = end != NULL && *end == '\0';
+        } else if (strcmp(arg, "--sample-pyramid") == 0) {
+            ok = parse_u32(value, 0, VTX_C_MIXER_MAX_SAMPLE_PYRAMID_LEVELS, &scenario.sample_pyramid_levels);
+        } else if (strcmp(arg, "--taps") == 0) {
+            ok = parse_u32(value, 0, 32, &scenario.tap_channel_tags);
+        } else if (strcmp(arg, "--engine") == 0) {
+            if (strcmp(value, "reference") == 0) {
+                scenario.engine = VTX_C_MIXER_RENDER_ENGINE_REFERENCE;
+            } else if (strcmp(value, "voice_major") == 0) {
+                scenario.engine = VTX_C_MIXER_RENDER_ENGINE_VOICE_MAJOR;
+            } else {
+                ok = 0;
+            }
+        } else if (strcmp(arg, "--baseline") == 0) {
+            baseline_path = value;
+        } else if (strcmp(arg, "--write-baseline") == 0) {
+            write_baseline_path = value;
+        } else if (strcmp(arg, "--max-regression") == 0) {
+            ok = parse_double(value, 0.0, 100.0, &max_regression);
+        } else {
+            fprintf(stderr, "error: unknown option '%s'\n", arg);
+            return 2;
+        }
+        if (!ok) {
+            fprintf(stderr, "error: invalid value '%s' for %s\n", value, arg);
+            return 2;
+        }
+    }
+    if (scenario.step_max < scenario.step_min) {
+        fprintf(stderr, "error: --step-max must be >= --step-min\n");
+        return 2;
+    }
+
+    bench_scenario_key(&scenario, scenario_key, sizeof(scenario_key));
+    if (baseline_path != NULL && !bench_load_baseline(baseline_path, scenario_key, &baseline)) {
+        fprintf(stderr, "error: could not read baseline '%s'\n", baseline_path);
+        return 2;
+    }
+
+    source_pcm = bench_make_source_pcm(scenario.sample_frames, scenario.seed);
+    if (source_pcm == NULL) {
+        fprintf(stderr, "error: out of memory\n");
+        return 1;
+    }
+    for (loop_mode = 0u; loop_mode < 3u && scenario.sample_pyramid_levels > 0u; loop_mode++) {
+        shared_samples[loop_mode].pcm = source_pcm;
+        shared_samples[loop_mode].frame_count = scenario.sample_frames;
+        shared_samples[loop_mode].pyramid = NULL;
+        ok = ok && vtx_c_mixer_sample_pyramid_create(
+            &shared_samples[loop_mode],
+            (VTXCMixerLoopMode)loop_mode,
+            scenario.sample_frames / 4u,
+            scenario.sample_frames,
+            scenario.sample_pyramid_levels,
+            &pyramids[loop_mode]
+        ) == VTX_C_MIXER_STATUS_OK;
+        shared_samples[loop_mode].pyramid = pyramids[loop_mode];
+    }
+    for (iteration = 0; ok && iteration < scenario.iterations; iteration++) {
+        ok = bench_run_once(
+            &scenario,
+            source_pcm,
+            scenario.sample_pyramid_levels > 0u ? shared_samples : NULL,
+            &runs[iteration]
+        );
+    }
+    for (loop_mode = 0u; loop_mode < 3u; loop_mode++) {
+        vtx_c_mixer_sample_pyramid_free(pyramids[loop_mode]);
+    }
+    free(source_pcm);
+    if (!ok) {
+        fprintf(stderr, "error: scenario setup failed\n");
+        return 1;
+    }
+    qsort(runs, scenario.iterations, sizeof(runs[0]), bench_compare_runs);
+
+    bench_print_json(stdout, &scenario, scenario_key, runs, scenario.iterations, &baseline, max_regression);
+    if (write_baseline_path != NULL) {
+        FILE *out = fopen(write_baseline_path, "w");
+        if (out == NULL) {
+            fprintf(stderr, "error: could not write baseline '%s'\n", write_baseline_path);
+            return 1;
+        }
+        bench_print_json(out, &scenario, scenario_key, runs, scenario.iterations, NULL, max_regression);
+        fclose(out);
+    }
+
+    if (baseline.present && baseline.comparable) {
+        double ns_per_voice_frame = runs[0].active_voice_frames > 0
+            ? (double)runs[0].elapsed_ns / (double)runs[0].active_voice_frames
+            : 0.0;
+        if (ns_per_voice_frame > baseline.ns_per_voice_frame * (1.0 + max_regression)) {
+            fprintf(stderr, "error: ns/voice-frame regressed beyond %.0f%% of baseline\n", max_regression * 100.0);
+            return 3;
+        }
+    }
+    return 0;
+}
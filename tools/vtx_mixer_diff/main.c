@@ -0,0 +1,641 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vtx_c_mixer.h"
+
+#define DIFF_MAX_CASE_VOICES 48u
+#define DIFF_MAX_SAMPLE_FRAMES 4096u
+#define DIFF_MAX_BLOCK_FRAMES 2048u
+#define DIFF_TAG_COUNT 8u
+// With --taps, the last two tags stay untapped so both render paths run.
+#define DIFF_TAPPED_TAG_COUNT (DIFF_TAG_COUNT - 2u)
+#define DIFF_TAP_SCOPE_FRAMES 4096u
+
+typedef enum {
+    DIFF_KIND_NONE = 0,
+    DIFF_KIND_SAMPLES,
+    DIFF_KIND_STATUS,
+    DIFF_KIND_ACTIVE_VOICES,
+} diff_kind;
+
+typedef struct {
+    uint32_t case_count;
+    uint64_t frames_per_case;
+    uint64_t seed;
+    double tolerance;
+    int tolerance_mode;
+    uint32_t channel_count;
+    VTXCMixerRenderEngine engine;
+    VTXCMixerTaps *taps;
+} diff_options;
+
+typedef struct {
+    diff_kind kind;
+    uint32_t case_index;
+    uint64_t case_seed;
+    uint64_t frame;
+    uint32_t channel;
+    float reference;
+    float candidate;
+    double abs_error;
+    char operation[64];
+} diff_divergence;
+
+typedef struct {
+    uint64_t frames_compared;
+    uint64_t samples_compared;
+    uint64_t mismatched_samples;
+    uint32_t diverging_cases;
+    double max_abs_error;
+    diff_divergence first;
+} diff_report;
+
+// Both mixers are always driven with identical calls. Any status mismatch is
+// itself a divergence, since optimized engines must not change API behaviour.
+// Each case also shares one sample with a pyramid between both mixers, so
+// high-step voices exercise the decimated-level reads.
+typedef struct {
+    VTXCMixerState *reference;
+    VTXCMixerState *candidate;
+    diff_divergence *divergence;
+    uint64_t rng;
+    VTXCMixerSharedSample shared;
+    VTXCMixerLoopMode shared_loop_mode;
+    uint32_t shared_loop_start;
+    uint32_t shared_loop_end;
+} diff_pair;
+
+static uint64_t diff_next_random(uint64_t *state) {
+    uint64_t z;
+    *state += 0x9E3779B97F4A7C15ull;
+    z = *state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static double diff_random_unit(uint64_t *state) {
+    return (double)(diff_next_random(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static double diff_random_range(uint64_t *state, double minimum, double maximum) {
+    return minimum + ((maximum - minimum) * diff_random_unit(state));
+}
+
+static uint32_t diff_random_below(uint64_t *state, uint32_t bound) {
+    return bound == 0u ? 0u : (uint32_t)(diff_next_random(state) % bound);
+}
+
+static void diff_note_status(
+    diff_pair *pair,
+    const char *operation,
+    VTXCMixerStatus reference_status,
+    VTXCMixerStatus candidate_status
+) {
+    if (reference_status == candidate_status || pair->divergence->kind != DIFF_KIND_NONE) {
+        return;
+    }
+    pair->divergence->kind = DIFF_KIND_STATUS;
+    pair->divergence->frame = vtx_c_mixer_current_frame(pair->reference);
+    snprintf(pair->divergence->operation, sizeof(pair->divergence->operation), "%s", operation);
+}
+
+static float *diff_make_sample(uint64_t *rng, uint32_t frame_count) {
+    float *pcm = (float *)malloc((size_t)frame_count * sizeof(float));
+    double phase_step = diff_random_range(rng, 0.01, 0.7);
+    uint32_t i;
+
+    if (pcm == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < frame_count; i++) {
+        pcm[i] = (float)(0.7 * sin((double)i * phase_step) + 0.3 * (diff_random_unit(rng) * 2.0 - 1.0));
+    }
+    return pcm;
+}
+
+static VTXCMixerEnvelope diff_make_envelope(
+    uint64_t *rng,
+    VTXCMixerEnvelopePoint *points,
+    float minimum,
+    float maximum
+) {
+    VTXCMixerEnvelope envelope;
+    uint32_t point_count = 1u + diff_random_below(rng, 6u);
+    uint32_t position = 0u;
+    uint32_t i;
+
+    memset(&envelope, 0, sizeof(envelope));
+    for (i = 0; i < point_count; i++) {
+        points[i].position_frame = position;
+        points[i].value = (float)diff_random_range(rng, minimum, maximum);
+        position += 1u + diff_random_below(rng, 3000u);
+    }
+    envelope.points = points;
+    envelope.point_count = point_count;
+    if (diff_random_below(rng, 2u) == 0u) {
+        envelope.sustain_enabled = 1;
+        envelope.sustain_frame = points[diff_random_below(rng, point_count)].position_frame;
+    }
+    if (point_count > 1u && diff_random_below(rng, 2u) == 0u) {
+        uint32_t start = diff_random_below(rng, point_count - 1u);
+        envelope.loop_enabled = 1;
+        envelope.loop_start_frame = points[start].position_frame;
+        envelope.loop_end_frame = points[start + 1u + diff_random_below(rng, point_count - start - 1u)].position_frame;
+    }
+    return envelope;
+}
+
+static void diff_add_voice(diff_pair *pair, uint64_t earliest_frame, uint64_t horizon_frames) {
+    uint64_t *rng = &pair->rng;
+    uint32_t frame_count = 16u + diff_random_below(rng, DIFF_MAX_SAMPLE_FRAMES - 16u);
+    float *pcm = diff_make_sample(rng, frame_count);
+    VTXCMixerLoopMode loop_mode = (VTXCMixerLoopMode)diff_random_below(rng, 3u);
+    uint32_t loop_start = diff_random_below(rng, frame_count);
+    uint32_t loop_end = loop_start + diff_random_below(rng, frame_count - loop_start + 1u);
+    double step = diff_random_below(rng, 4u) == 0u ? 1.0 : diff_random_range(rng, 0.05, 3.5);
+    uint32_t source_frame = diff_random_below(rng, 4u) == 0u ? diff_random_below(rng, frame_count + 8u) : 0u;
+    uint64_t start_frame = earliest_frame + (uint64_t)diff_random_below(rng, (uint32_t)(horizon_frames + 1u));
+    float gain = (float)diff_random_range(rng, 0.0, 0.4);
+    float pan = (float)diff_random_range(rng, -1.0, 1.0);
+    uint32_t reference_index = 0u;
+    uint32_t candidate_index = 0u;
+    VTXCMixerStatus reference_status;
+    VTXCMixerStatus candidate_status;
+
+    if (pcm == NULL) {
+        return;
+    }
+    if (pair->shared.pyramid != NULL && diff_random_below(rng, 4u) == 0u) {
+        step = diff_random_range(rng, 0.05, 12.0);
+        source_frame = diff_random_below(rng, pair->shared.frame_count);
+        reference_status = vtx_c_mixer_add_scheduled_shared_sample_voice(
+            pair->reference, &pair->shared, step, source_frame, gain, pan,
+            pair->shared_loop_mode, pair->shared_loop_start, pair->shared_loop_end, start_frame, &reference_index);
+        candidate_status = vtx_c_mixer_add_scheduled_shared_sample_voice(
+            pair->candidate, &pair->shared, step, source_frame, gain, pan,
+            pair->shared_loop_mode, pair->shared_loop_start, pair->shared_loop_end, start_frame, &candidate_index);
+    } else {
+        reference_status = vtx_c_mixer_add_scheduled_sample_voice_with_step_at_source_frame(
+            pair->reference, pcm, frame_count, step, source_frame, gain, pan,
+            loop_mode, loop_start, loop_end, start_frame, &reference_index);
+        candidate_status = vtx_c_mixer_add_scheduled_sample_voice_with_step_at_source_frame(
+            pair->candidate, pcm, frame_count, step, source_frame, gain, pan,
+            loop_mode, loop_start, loop_end, start_frame, &candidate_index);
+    }
+    free(pcm);
+    diff_note_status(pair, "add_voice", reference_status, candidate_status);
+    if (reference_status != VTX_C_MIXER_STATUS_OK || candidate_status != VTX_C_MIXER_STATUS_OK) {
+        return;
+    }
+    if (reference_index != candidate_index) {
+        diff_note_status(pair, "add_voice_index", VTX_C_MIXER_STATUS_OK, VTX_C_MIXER_STATUS_INVALID_ARGUMENT);
+        return;
+    }
+
+    diff_note_status(
+        pair,
+        "set_channel_tag",
+        vtx_c_mixer_set_voice_channel_tag(pair->reference, reference_index, reference_index % DIFF_TAG_COUNT),
+        vtx_c_mixer_set_voice_channel_tag(pair->candidate, reference_index, reference_index % DIFF_TAG_COUNT)
+    );
+    if (diff_random_below(rng, 2u) == 0u) {
+        VTXCMixerEnvelopePoint points[8];
+        VTXCMixerEnvelope envelope = diff_make_envelope(rng, points, 0.0f, 1.0f);
+        diff_note_status(
+            pair,
+            "set_volume_envelope",
+            vtx_c_mixer_set_voice_volume_envelope(pair->reference, reference_index, &envelope),
+            vtx_c_mixer_set_voice_volume_envelope(pair->candidate, reference_index, &envelope)
+        );
+    }
+    if (diff_random_below(rng, 3u) == 0u) {
+        VTXCMixerEnvelopePoint points[8];
+        VTXCMixerEnvelope envelope = diff_make_envelope(rng, points, -1.0f, 1.0f);
+        diff_note_status(
+            pair,
+            "set_pan_envelope",
+            vtx_c_mixer_set_voice_pan_envelope(pair->reference, reference_index, &envelope),
+            vtx_c_mixer_set_voice_pan_envelope(pair->candidate, reference_index, &envelope)
+        );
+    }
+    if (diff_random_below(rng, 2u) == 0u) {
+        uint64_t key_off_frame = start_frame + (uint64_t)diff_random_below(rng, (uint32_t)(horizon_frames + 1u));
+        float fadeout = diff_random_below(rng, 3u) == 0u ? 0.0f : (float)diff_random_range(rng, 1e-5, 2e-3);
+        diff_note_status(
+            pair,
+            "set_key_off_frame",
+            vtx_c_mixer_set_voice_key_off_frame(pair->reference, reference_index, key_off_frame, fadeout),
+            vtx_c_mixer_set_voice_key_off_frame(pair->candidate, reference_index, key_off_frame, fadeout)
+        );
+    }
+}
+
+static void diff_schedule_operations(diff_pair *pair, uint64_t block_start, uint32_t block_frames) {
+    uint64_t *rng = &pair->rng;
+    uint32_t operation_count = diff_random_below(rng, 6u);
+    uint32_t operation;
+
+    for (operation = 0; operation < operation_count; operation++) {
+        uint32_t voice_count = pair->reference->voice_count;
+        uint32_t voice = diff_random_below(rng, voice_count + 1u);
+        uint64_t frame = block_start + (uint64_t)diff_random_below(rng, block_frames * 2u);
+        float gain = (float)diff_random_range(rng, 0.0, 0.5);
+        float pan = (float)diff_random_range(rng, -1.0, 1.0);
+        double step = diff_random_range(rng, 0.05, 9.0);
+        uint32_t tag = diff_random_below(rng, DIFF_TAG_COUNT);
+        uint32_t ramp_frames = diff_random_below(rng, 512u);
+        uint32_t reference_count = 0u;
+        uint32_t candidate_count = 0u;
+
+        switch (diff_random_below(rng, 8u)) {
+        case 0:
+            diff_note_status(
+                pair,
+                "gain_pan_update",
+                vtx_c_mixer_schedule_voice_gain_pan_update(pair->reference, voice, frame, 1, gain, 1, pan),
+                vtx_c_mixer_schedule_voice_gain_pan_update(pair->candidate, voice, frame, 1, gain, 1, pan)
+            );
+            break;
+        case 1:
+            diff_note_status(
+                pair,
+                "sample_step_update",
+                vtx_c_mixer_schedule_voice_sample_step_update(pair->reference, voice, frame, step),
+                vtx_c_mixer_schedule_voice_sample_step_update(pair->candidate, voice, frame, step)
+            );
+            break;
+        case 2:
+            diff_note_status(
+                pair,
+                "gain_pan_sample_step_update",
+                vtx_c_mixer_schedule_voice_gain_pan_sample_step_update(pair->reference, voice, frame, 0, 0.0f, 1, pan, step),
+                vtx_c_mixer_schedule_voice_gain_pan_sample_step_update(pair->candidate, voice, frame, 0, 0.0f, 1, pan, step)
+            );
+            break;
+        case 3:
+            diff_note_status(
+                pair,
+                "gain_pan_update_immediate",
+                vtx_c_mixer_schedule_voice_gain_pan_update_immediate(pair->reference, voice, frame, 1, gain, 0, 0.0f),
+                vtx_c_mixer_schedule_voice_gain_pan_update_immediate(pair->candidate, voice, frame, 1, gain, 0, 0.0f)
+            );
+            break;
+        case 4:
+            diff_note_status(
+                pair,
+                "ramp_down_tag",
+                vtx_c_mixer_ramp_down_voices_for_channel_tag(pair->reference, tag, ramp_frames, &reference_count),
+                vtx_c_mixer_ramp_down_voices_for_channel_tag(pair->candidate, tag, ramp_frames, &candidate_count)
+            );
+            break;
+        case 5:
+            if (diff_random_below(rng, 4u) == 0u) {
+                diff_note_status(
+                    pair,
+                    "stop_tag",
+                    vtx_c_mixer_stop_voices_for_channel_tag(pair->reference, tag, &reference_count),
+                    vtx_c_mixer_stop_voices_for_channel_tag(pair->candidate, tag, &candidate_count)
+                );
+            }
+            break;
+        default:
+            if (voice_count < DIFF_MAX_CASE_VOICES) {
+                diff_add_voice(pair, block_start, (uint64_t)block_frames * 2u);
+            }
+            break;
+        }
+        if (reference_count != candidate_count) {
+            diff_note_status(pair, "tag_match_count", VTX_C_MIXER_STATUS_OK, VTX_C_MIXER_STATUS_INVALID_ARGUMENT);
+        }
+    }
+}
+
+static int diff_same_sample(float reference, float candidate, const diff_options *options, double *abs_error) {
+    double error;
+
+    if (isnan(reference) || isnan(candidate)) {
+        *abs_error = INFINITY;
+        return isnan(reference) && isnan(candidate);
+    }
+    error = fabs((double)reference - (double)candidate);
+    *abs_error = error;
+    if (options->tolerance_mode) {
+        return error <= options->tolerance;
+    }
+    return memcmp(&reference, &candidate, sizeof(float)) == 0;
+}
+
+static int diff_run_case(
+    const diff_options *options,
+    uint32_t case_index,
+    float *reference_block,
+    float *candidate_block,
+    VTXCMixerState *reference,
+    VTXCMixerState *candidate,
+    diff_report *report
+) {
+    diff_pair pair;
+    diff_divergence divergence;
+    VTXCMixerConfig config;
+    uint64_t case_seed = options->seed + ((uint64_t)case_index * 0x9E3779B97F4A7C15ull);
+    uint64_t rendered = 0u;
+    uint32_t initial_voices;
+    uint32_t voice;
+    float *shared_pcm;
+    VTXCMixerSamplePyramid *pyramid = NULL;
+
+    memset(&divergence, 0, sizeof(divergence));
+    memset(&pair, 0, sizeof(pair));
+    pair.reference = reference;
+    pair.candidate = candidate;
+    pair.divergence = &divergence;
+    pair.rng = case_seed;
+
+    config.sample_rate = VTX_C_MIXER_DEFAULT_SAMPLE_RATE;
+    config.channel_count = options->channel_count != 0u ? options->channel_count : 1u + (case_index % 2u);
+    if (vtx_c_mixer_init(reference, config) != VTX_C_MIXER_STATUS_OK ||
+        vtx_c_mixer_init(candidate, config) != VTX_C_MIXER_STATUS_OK ||
+        vtx_c_mixer_set_render_engine(candidate, options->engine) != VTX_C_MIXER_STATUS_OK ||
+        vtx_c_mixer_set_taps(candidate, options->taps) != VTX_C_MIXER_STATUS_OK) {
+        return 0;
+    }
+
+    pair.shared.frame_count = 64u + diff_random_below(&pair.rng, DIFF_MAX_SAMPLE_FRAMES - 64u);
+    shared_pcm = diff_make_sample(&pair.rng, pair.shared.frame_count);
+    if (shared_pcm == NULL) {
+        return 0;
+    }
+    pair.shared.pcm = shared_pcm;
+    pair.shared_loop_mode = (VTXCMixerLoopMode)diff_random_below(&pair.rng, 3u);
+    pair.shared_loop_start = diff_random_below(&pair.rng, pair.shared.frame_count);
+    pair.shared_loop_end = pair.shared_loop_start +
+        diff_random_below(&pair.rng, pair.shared.frame_count - pair.shared_loop_start + 1u);
+    if (vtx_c_mixer_sample_pyramid_create(
+            &pair.shared,
+            pair.shared_loop_mode,
+            pair.shared_loop_start,
+            pair.shared_loop_end,
+            1u + diff_random_below(&pair.rng, VTX_C_MIXER_MAX_SAMPLE_PYRAMID_LEVELS),
+            &pyramid) != VTX_C_MIXER_STATUS_OK) {
+        free(shared_pcm);
+        return 0;
+    }
+    pair.shared.pyramid = pyramid;
+
+    initial_voices = 1u + diff_random_below(&pair.rng, DIFF_MAX_CASE_VOICES / 2u);
+    for (voice = 0; voice < initial_voices; voice++) {
+        diff_add_voice(&pair, 0u, options->frames_per_case / 4u);
+    }
+
+    while (rendered < options->frames_per_case && divergence.kind == DIFF_KIND_NONE) {
+        uint64_t remaining = options->frames_per_case - rendered;
+        uint32_t frames = 1u + diff_random_below(&pair.rng, DIFF_MAX_BLOCK_FRAMES);
+        uint64_t block_start = vtx_c_mixer_current_frame(reference);
+        size_t sample_count;
+        size_t i;
+
+        if ((uint64_t)frames > remaining) {
+            frames = (uint32_t)remaining;
+        }
+        diff_schedule_operations(&pair, block_start, frames);
+        diff_note_status(
+            &pair,
+            "render",
+            vtx_c_mixer_render_reference(reference, reference_block, frames),
+            vtx_c_mixer_render(candidate, candidate_block, frames)
+        );
+        if (divergence.kind != DIFF_KIND_NONE) {
+            break;
+        }
+
+        sample_count = (size_t)frames * config.channel_count;
+        for (i = 0; i < sample_count; i++) {
+            double abs_error = 0.0;
+            if (!diff_same_sample(reference_block[i], candidate_block[i], options, &abs_error)) {
+                report->mismatched_samples++;
+                if (divergence.kind == DIFF_KIND_NONE) {
+                    divergence.kind = DIFF_KIND_SAMPLES;
+                    divergence.frame = block_start + (uint64_t)(i / config.channel_count);
+                    divergence.channel = (uint32_t)(i % config.channel_count);
+                    divergence.reference = reference_block[i];
+                    divergence.candidate = candidate_block[i];
+                    divergence.abs_error = abs_error;
+                }
+            }
+            if (abs_error > report->max_abs_error) {
+                report->max_abs_error = abs_error;
+            }
+        }
+        report->samples_compared += sample_count;
+        report->frames_compared += frames;
+        rendered += frames;
+
+        if (divergence.kind == DIFF_KIND_NONE &&
+            vtx_c_mixer_active_voice_count(reference) != vtx_c_mixer_active_voice_count(candidate)) {
+            divergence.kind = DIFF_KIND_ACTIVE_VOICES;
+            divergence.frame = vtx_c_mixer_current_frame(reference);
+        }
+    }
+
+    vtx_c_mixer_clear_voices(reference);
+    vtx_c_mixer_clear_voices(candidate);
+    vtx_c_mixer_sample_pyramid_free(pyramid);
+    free(shared_pcm);
+    if (divergence.kind != DIFF_KIND_NONE) {
+        report->diverging_cases++;
+        if (report->first.kind == DIFF_KIND_NONE) {
+            report->first = divergence;
+            report->first.case_index = case_index;
+            report->first.case_seed = case_seed;
+        }
+    }
+    return 1;
+}
+
+static const char *diff_kind_name(diff_kind kind) {
+    switch (kind) {
+    case DIFF_KIND_SAMPLES:
+        return "samples";
+    case DIFF_KIND_STATUS:
+        return "status";
+    case DIFF_KIND_ACTIVE_VOICES:
+        return "active_voices";
+    case DIFF_KIND_NONE:
+    default:
+        return "none";
+    }
+}
+
+static void diff_print_json(FILE *out, const diff_options *options, const diff_report *report) {
+    fprintf(out, "{\n");
+    fprintf(out, "  \"tool\": \"vtx_mixer_diff\",\n");
+    fprintf(out, "  \"reference_engine\": \"%s\",\n", vtx_c_mixer_render_engine_name(VTX_C_MIXER_RENDER_ENGINE_REFERENCE));
+    fprintf(out, "  \"candidate_engine\": \"%s\",\n", vtx_c_mixer_render_engine_name(options->engine));
+    fprintf(out, "  \"taps\": %s,\n", options->taps != NULL ? "true" : "false");
+    fprintf(out, "  \"mode\": \"%s\",\n", options->tolerance_mode ? "tolerance" : "bit_exact");
+    fprintf(out, "  \"tolerance\": %.9g,\n", options->tolerance_mode ? options->tolerance : 0.0);
+    fprintf(out, "  \"cases\": %u,\n", options->case_count);
+    fprintf(out, "  \"seed\": %llu,\n", (unsigned long long)options->seed);
+    fprintf(out, "  \"frames_compared\": %llu,\n", (unsigned long long)report->frames_compared);
+    fprintf(out, "  \"samples_compared\": %llu,\n", (unsigned long long)report->samples_compared);
+    fprintf(out, "  \"mismatched_samples\": %llu,\n", (unsigned long long)report->mismatched_samples);
+    fprintf(out, "  \"diverging_cases\": %u,\n", report->diverging_cases);
+    fprintf(out, "  \"max_abs_error\": %.9g,\n", isinf(report->max_abs_error) ? -1.0 : report->max_abs_error);
+    if (report->first.kind == DIFF_KIND_NONE) {
+        fprintf(out, "  \"first_divergence\": null,\n");
+    } else {
+        fprintf(out, "  \"first_divergence\": {\n");
+        fprintf(out, "    \"kind\": \"%s\",\n", diff_kind_name(report->first.kind));
+        fprintf(out, "    \"case\": %u,\n", report->first.case_index);
+        fprintf(out, "    \"case_seed\": %llu,\n", (unsigned long long)report->first.case_seed);
+        fprintf(out, "    \"frame\": %llu,\n", (unsigned long long)report->first.frame);
+        if (report->first.kind == DIFF_KIND_STATUS) {
+            fprintf(out, "    \"operation\": \"%s\"\n", report->first.operation);
+        } else {
+            fprintf(out, "    \"channel\": %u,\n", report->first.channel);
+            fprintf(out, "    \"reference\": %.9g,\n", (double)report->first.reference);
+            fprintf(out, "    \"candidate\": %.9g,\n", (double)report->first.candidate);
+            fprintf(out, "    \"abs_error\": %.9g\n", report->first.abs_error);
+        }
+        fprintf(out, "  },\n");
+    }
+    fprintf(out, "  \"passed\": %s\n", report->diverging_cases == 0u ? "true" : "false");
+    fprintf(out, "}\n");
+}
+
+static void print_usage(const char *argv0) {
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  --engine NAME           candidate engine compared with reference (default voice_major)\n"
+        "  --cases N               randomized schedules to run (default 200)\n"
+        "  --frames N              rendered frames per schedule (default 88200)\n"
+        "  --channels N            1 or 2; default alternates per case\n"
+        "  --seed N                base seed (default 1)\n"
+        "  --tolerance X           accept |reference - candidate| <= X instead of bit-exact output\n"
+        "  --taps                  render the candidate with per-channel-tag scope/VU taps attached\n",
+        argv0);
+}
+
+static int parse_u32(const char *text, uint32_t minimum, uint32_t maximum, uint32_t *out) {
+    char *end = NULL;
+    unsigned long value = strtoul(text, &end, 10);
+    if (end == NULL || *end != '\0' || text[0] == '-' || value < minimum || value > maximum) {
+        return 0;
+    }
+    *out = (uint32_t)value;
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    diff_options options;
+    diff_report report;
+    VTXCMixerState *reference;
+    VTXCMixerState *candidate;
+    float *reference_block;
+    float *candidate_block;
+    uint32_t frames_per_case = 88200u;
+    uint32_t case_index;
+    int use_taps = 0;
+    int i;
+
+    memset(&options, 0, sizeof(options));
+    memset(&report, 0, sizeof(report));
+    options.case_count = 200u;
+    options.seed = 1u;
+    options.engine = VTX_C_MIXER_RENDER_ENGINE_VOICE_MAJOR;
+
+    for (i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        int ok = 1;
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (strcmp(arg, "--taps") == 0) {
+            use_taps = 1;
+            continue;
+        }
+        if (arg[0] != '-' || value == NULL) {
+            fprintf(stderr, "error: unknown or incomplete option '%s'\n", arg);
+            return 2;
+        }
+        i++;
+        if (strcmp(arg, "--engine") == 0) {
+            if (strcmp(value, "reference") == 0) {
+                options.engine = VTX_C_MIXER_RENDER_ENGINE_REFERENCE;
+            } else if (strcmp(value, "voice_major") == 0) {
+                options.engine = VTX_C_MIXER_RENDER_ENGINE_VOICE_MAJOR;
+            } else {
+                ok = 0;
+            }
+        } else if (strcmp(arg, "--cases") == 0) {
+            ok = parse_u32(value, 1, 1000000, &options.case_count);
+        } else if (strcmp(arg, "--frames") == 0) {
+            ok = parse_u32(value, 1, 1u << 26, &frames_per_case);
+        } else if (strcmp(arg, "--channels") == 0) {
+            ok = parse_u32(value, 1, 2, &options.channel_count);
+        } else if (strcmp(arg, "--seed") == 0) {
+            char *end = NULL;
+            options.seed = strtoull(value, &end, 10);
+            ok = end != NULL && *end == '\0';
+        } else if (strcmp(arg, "--tolerance") == 0) {
+            char *end = NULL;
+            options.tolerance = strtod(value, &end);
+            ok = end != NULL && *end == '\0' && isfinite(options.tolerance) && options.tolerance >= 0.0;
+            options.tolerance_mode = 1;
+        } else {
+            fprintf(stderr, "error: unknown option '%s'\n", arg);
+            return 2;
+        }
+        if (!ok) {
+            fprintf(stderr, "error: invalid value '%s' for %s\n", value, arg);
+            return 2;
+        }
+    }
+    options.frames_per_case = frames_per_case;
+    if (use_taps &&
+        vtx_c_mixer_taps_create(DIFF_TAPPED_TAG_COUNT, DIFF_TAP_SCOPE_FRAMES, &options.taps) != VTX_C_MIXER_STATUS_OK) {
+        fprintf(stderr, "error: out of memory\n");
+        return 1;
+    }
+
+    reference = (VTXCMixerState *)malloc(sizeof(*reference));
+    candidate = (VTXCMixerState *)malloc(sizeof(*candidate));
+    reference_block = (float *)malloc((size_t)DIFF_MAX_BLOCK_FRAMES * 2u * sizeof(float));
+    candidate_block = (float *)malloc((size_t)DIFF_MAX_BLOCK_FRAMES * 2u * sizeof(float));
+    if (reference == NULL || candidate == NULL || reference_block == NULL || candidate_block == NULL) {
+        fprintf(stderr, "error: out of memory\n");
+        free(reference);
+        free(candidate);
+        free(reference_block);
+        free(candidate_block);
+        vtx_c_mixer_taps_free(options.taps);
+        return 1;
+    }
+
+    for (case_index = 0; case_index < options.case_count; case_index++) {
+        if (!diff_run_case(&options, case_index, reference_block, candidate_block, reference, candidate, &report)) {
+            fprintf(stderr, "error: mixer setup failed for case %u\n", case_index);
+            free(reference);
+            free(candidate);
+            free(reference_block);
+            free(candidate_block);
+            vtx_c_mixer_taps_free(options.taps);
+            return 1;
+        }
+    }
+
+    diff_print_json(stdout, &options, &report);
+    free(reference);
+    free(candidate);
+    free(reference_block);
+    free(candidate_block);
+    vtx_c_mixer_taps_free(options.taps);
+    return report.diverging_cases == 0u ? 0 : 1;
+}
@@ -0,0 +1,276 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "module_handle.h"
+#include "vtx_c_player.h"
+#include "vtx_c_sink.h"
+
+#define RENDER_DEFAULT_SAMPLE_RATE 44100.0
+#define RENDER_DEFAULT_BLOCK_FRAMES 4096u
+
+typedef struct {
+    const char *input_path;
+    const char *output_path;
+    const char *trace_path;
+    uint32_t order;
+    uint32_t order_count;
+    double seconds;
+    double sample_rate;
+    VTXCSinkFormat format;
+    uint32_t block_frames;
+    uint32_t sample_pyramid_levels;
+    int raw;
+    int sync_writes;
+} render_options;
+
+static void print_usage(const char *argv0) {
+    fprintf(stderr,
+        "usage: %s --input PATH --output PATH [options]\n"
+        "  --input PATH          XM or MOD module\n"
+        "  --output PATH         WAV file, or - for raw PCM on stdout\n"
+        "  --order N             first order to play (default 0)\n"
+        "  --order-count N       stop when playback leaves N orders from --order (default: song end)\n"
+        "  --seconds X           stop after X seconds\n"
+        "  --sample-rate X       output sample rate (default 44100)\n"
+        "  --format NAME         s16 or f32 (default s16)\n"
+        "  --block-frames N      frames rendered per block (default %u)\n"
+        "  --raw                 write headerless PCM to a file too\n"
+        "  --sync-writes         write on the render thread instead of a background writer\n"
+        "  --trace PATH          write a binary mixer event trace (see scripts/decode-mixer-trace.py)\n"
+        "  --sample-pyramids N   read high notes from up to N decimated sample levels, 0..%u (default 0)\n",
+        argv0,
+        RENDER_DEFAULT_BLOCK_FRAMES,
+        VTX_C_MIXER_MAX_SAMPLE_PYRAMID_LEVELS);
+}
+
+static int parse_u32(const char *text, uint32_t minimum, uint32_t maximum, uint32_t *out) {
+    char *end = NULL;
+    unsigned long value = strtoul(text, &end, 10);
+    if (end == NULL || *end != '\0' || text[0] == '-' || value < minimum || value > maximum) {
+        return 0;
+    }
+    *out = (uint32_t)value;
+    return 1;
+}
+
+static int parse_double(const char *text, double minimum, double maximum, double *out) {
+    char *end = NULL;
+    double value = strtod(text, &end);
+    if (end == NULL || *end != '\0' || !isfinite(value) || value < minimum || value > maximum) {
+        return 0;
+    }
+    *out = value;
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    render_options options;
+    VTXCSinkConfig sink_config;
+    VTXCSink *sink = NULL;
+    VTXCSinkStatus sink_status;
+    VTXCPlayerConfig config;
+    VTXCPlayer *player = NULL;
+    VTXCPlayerStatus status;
+    VTXCTraceRing *trace_ring = NULL;
+    VTXCTraceWriter *trace_writer = NULL;
+    mc_module *module;
+    char error[256];
+    float *block;
+    uint64_t frame_limit = UINT64_MAX;
+    uint64_t rendered_frames = 0;
+    int ok = 1;
+    int i;
+
+    memset(&options, 0, sizeof(options));
+    options.sample_rate = RENDER_DEFAULT_SAMPLE_RATE;
+    options.block_frames = RENDER_DEFAULT_BLOCK_FRAMES;
+
+    for (i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        int valid = 1;
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (strcmp(arg, "--raw") == 0) {
+            options.raw = 1;
+            continue;
+        }
+        if (strcmp(arg, "--sync-writes") == 0) {
+            options.sync_writes = 1;
+            continue;
+        }
+        if (arg[0] != '-' || value == NULL) {
+            fprintf(stderr, "error: unknown or incomplete option '%s'\n", arg);
+            return 2;
+        }
+        i++;
+        if (strcmp(arg, "--input") == 0) {
+            options.input_path = value;
+        } else if (strcmp(arg, "--output") == 0) {
+            options.output_path = value;
+        } else if (strcmp(arg, "--trace") == 0) {
+            options.trace_path = value;
+        } else if (strcmp(arg, "--order") == 0) {
+            valid = parse_u32(value, 0, MC_MAX_ORDER_ENTRIES - 1, &options.order);
+        } else if (strcmp(arg, "--order-count") == 0) {
+            valid = parse_u32(value, 1, MC_MAX_ORDER_ENTRIES, &options.order_count);
+        } else if (strcmp(arg, "--seconds") == 0) {
+            valid = parse_double(value, 0.001, 1e7, &options.seconds);
+        } else if (strcmp(arg, "--sample-rate") == 0) {
+            valid = parse_double(value, 1000.0, 384000.0, &options.sample_rate);
+        } else if (strcmp(arg, "--format") == 0) {
+            if (strcmp(value, "s16") == 0) {
+                options.format = VTX_C_SINK_FORMAT_PCM16;
+            } else if (strcmp(value, "f32") == 0) {
+                options.format = VTX_C_SINK_FORMAT_FLOAT32;
+            } else {
+                valid = 0;
+            }
+        } else if (strcmp(arg, "--block-frames") == 0) {
+            valid = parse_u32(value, 1, 1u << 20, &options.block_frames);
+        } else if (strcmp(arg, "--sample-pyramids") == 0) {
+            valid = parse_u32(value, 0, VTX_C_MIXER_MAX_SAMPLE_PYRAMID_LEVELS, &options.sample_pyramid_levels);
+        } else {
+            fprintf(stderr, "error: unknown option '%s'\n", arg);
+            return 2;
+        }
+        if (!valid) {
+            fprintf(stderr, "error: invalid value '%s' for %s\n", value, arg);
+            return 2;
+        }
+    }
+    if (options.input_path == NULL || options.output_path == NULL) {
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    module = mc_module_open(options.input_path, error, sizeof(error));
+    if (module == NULL) {
+        fprintf(stderr, "error: %s: %s\n", options.input_path, error);
+        return 1;
+    }
+    config = vtx_c_player_default_config();
+    config.sample_rate = options.sample_rate;
+    config.start_order = (uint16_t)options.order;
+    config.order_count = (uint16_t)options.order_count;
+    config.sample_pyramid_levels = options.sample_pyramid_levels;
+    status = vtx_c_player_create(module, NULL, config, &player);
+    if (status != VTX_C_PLAYER_STATUS_OK) {
+        fprintf(stderr, "error: %s: cannot play from order %u (status %d)\n", options.input_path, options.order, (int)status);
+        mc_module_close(module);
+        return 1;
+    }
+    if (options.seconds > 0.0) {
+        frame_limit = (uint64_t)llround(options.seconds * options.sample_rate);
+    }
+
+    sink_config = vtx_c_sink_default_config();
+    sink_config.sample_rate = (uint32_t)lround(options.sample_rate);
+    sink_config.channel_count = config.channel_count;
+    sink_config.format = options.format;
+    sink_config.background_writer = !options.sync_writes;
+    if (strcmp(options.output_path, "-") == 0) {
+        sink_config.container = VTX_C_SINK_CONTAINER_RAW;
+        sink_status = vtx_c_sink_open_fd(1, sink_config, &sink);
+    } else {
+        sink_config.container = options.raw ? VTX_C_SINK_CONTAINER_RAW : VTX_C_SINK_CONTAINER_WAV;
+        sink_status = vtx_c_sink_open_path(options.output_path, sink_config, &sink);
+    }
+    block = (float *)malloc((size_t)options.block_frames * config.channel_count * sizeof(float));
+    if (sink_status != VTX_C_SINK_STATUS_OK || block == NULL) {
+        fprintf(stderr, "error: cannot open '%s'\n", options.output_path);
+        free(block);
+        if (sink != NULL) {
+            vtx_c_sink_close(sink);
+        }
+        vtx_c_player_free(player);
+        mc_module_close(module);
+        return 1;
+    }
+
+    if (options.trace_path != NULL) {
+        if (vtx_c_trace_ring_create(VTX_C_TRACE_DEFAULT_RING_RECORDS, &trace_ring) != VTX_C_TRACE_STATUS_OK ||
+            vtx_c_trace_writer_open_path(
+                options.trace_path,
+                trace_ring,
+                sink_config.sample_rate,
+                config.channel_count,
+                0u,
+                &trace_writer
+            ) != VTX_C_TRACE_STATUS_OK) {
+            fprintf(stderr, "error: cannot open '%s'\n", options.trace_path);
+            ok = 0;
+        } else {
+            vtx_c_mixer_set_trace_ring(vtx_c_player_mixer(player), trace_ring);
+        }
+    }
+
+    while (ok && rendered_frames < frame_limit) {
+        uint32_t request = options.block_frames;
+        uint32_t rendered = 0;
+
+        if (frame_limit - rendered_frames < request) {
+            request = (uint32_t)(frame_limit - rendered_frames);
+        }
+        if (vtx_c_player_render(player, block, request, &rendered) != VTX_C_PLAYER_STATUS_OK) {
+            fprintf(stderr, "error: render failed\n");
+            ok = 0;
+            break;
+        }
+        if (vtx_c_sink_write_float32(sink, block, rendered) != VTX_C_SINK_STATUS_OK) {
+            fprintf(stderr, "error: write to '%s' failed\n", options.output_path);
+            ok = 0;
+            break;
+        }
+        rendered_frames += rendered;
+        // Drained after every block so the ring never fills on long renders.
+        if (trace_writer != NULL && vtx_c_trace_writer_drain(trace_writer) != VTX_C_TRACE_STATUS_OK) {
+            fprintf(stderr, "error: write to '%s' failed\n", options.trace_path);
+            ok = 0;
+            break;
+        }
+        if (rendered < request) {
+            break;
+        }
+    }
+    if (vtx_c_sink_close(sink) != VTX_C_SINK_STATUS_OK && ok) {
+        fprintf(stderr, "error: write to '%s' failed\n", options.output_path);
+        ok = 0;
+    }
+    if (trace_writer != NULL) {
+        vtx_c_mixer_set_trace_ring(vtx_c_player_mixer(player), NULL);
+        if (vtx_c_trace_writer_close(trace_writer) != VTX_C_TRACE_STATUS_OK && ok) {
+            fprintf(stderr, "error: write to '%s' failed\n", options.trace_path);
+            ok = 0;
+        }
+        if (ok && vtx_c_trace_ring_dropped_count(trace_ring) > 0u) {
+            fprintf(stderr, "warning: %llu trace records dropped\n",
+                (unsigned long long)vtx_c_trace_ring_dropped_count(trace_ring));
+        }
+    }
+    vtx_c_trace_ring_free(trace_ring);
+    if (ok) {
+        VTXCMixerOutputMeter meter = vtx_c_mixer_cumulative_output_meter(vtx_c_player_mixer(player));
+        fprintf(stderr,
+            "rendered %llu frames (%.3f s) at %u Hz %s, %llu dropped notes, peak %.4f, rms %.4f, %llu clipped samples\n",
+            (unsigned long long)rendered_frames,
+            (double)rendered_frames / options.sample_rate,
+            sink_config.sample_rate,
+            options.format == VTX_C_SINK_FORMAT_FLOAT32 ? "f32" : "s16",
+            (unsigned long long)vtx_c_player_dropped_note_count(player),
+            meter.peak,
+            vtx_c_mixer_output_meter_rms(&meter),
+            (unsigned long long)meter.clipping_sample_count);
+    }
+
+    free(block);
+    vtx_c_player_free(player);
+    mc_module_close(module);
+    return ok ? 0 : 1;
+}